@@ -0,0 +1,279 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "allocprofiler.h"
+
+#ifdef PNA_ALLOC_PROFILING
+
+#include "constants.h"
+
+#include <QDebug>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+
+#include <cstdlib>
+#include <new>
+
+#ifdef Q_OS_WIN
+#include <malloc.h> // _aligned_malloc
+#endif
+
+// --- Counting hooks ---
+// Plain thread_local integers: the executable's TLS block is set up without allocating,
+// so the hooks can run during thread start-up and static initialisation.
+
+namespace {
+
+thread_local quint64 t_allocations = 0;
+thread_local quint64 t_bytes = 0;
+
+inline void countAllocation(std::size_t size)
+{
+	++t_allocations;
+	t_bytes += size;
+}
+
+} // namespace
+
+#ifdef __GLIBC__
+// glibc exports its allocator under these names, so malloc can be interposed from the
+// executable: Qt's container buffers then go through the counting versions below.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void __libc_free(void* pointer);
+
+void* malloc(size_t size) noexcept
+{
+	countAllocation(size);
+	return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept
+{
+	countAllocation(count * size);
+	return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept
+{
+	countAllocation(size); // May move the block: counted like a new allocation
+	return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) noexcept
+{
+	__libc_free(pointer);
+}
+} // extern "C"
+
+// operator new counts itself and must not be counted again by malloc
+static inline void* rawAllocate(std::size_t size) { return __libc_malloc(size); }
+static inline void rawFree(void* pointer) { __libc_free(pointer); }
+#else
+static inline void* rawAllocate(std::size_t size) { return std::malloc(size); }
+static inline void rawFree(void* pointer) { std::free(pointer); }
+#endif
+
+static void* countedNew(std::size_t size)
+{
+	countAllocation(size);
+	if (void* pointer = rawAllocate(size ? size : 1)) return pointer;
+	throw std::bad_alloc();
+}
+
+static void* countedNewNoThrow(std::size_t size) noexcept
+{
+	countAllocation(size);
+	return rawAllocate(size ? size : 1);
+}
+
+static void* countedAlignedNew(std::size_t size, std::align_val_t alignment)
+{
+	countAllocation(size);
+	void* pointer = nullptr;
+#ifdef Q_OS_WIN
+	pointer = _aligned_malloc(size ? size : 1, std::size_t(alignment));
+#else
+	if (posix_memalign(&pointer, qMax(std::size_t(alignment), sizeof(void*)), size ? size : 1) != 0) pointer = nullptr;
+#endif
+	if (!pointer) throw std::bad_alloc();
+	return pointer;
+}
+
+static void alignedFree(void* pointer) noexcept
+{
+#ifdef Q_OS_WIN
+	_aligned_free(pointer);
+#else
+	std::free(pointer);
+#endif
+}
+
+void* operator new(std::size_t size) { return countedNew(size); }
+void* operator new[](std::size_t size) { return countedNew(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedNewNoThrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedNewNoThrow(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAlignedNew(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return countedAlignedNew(size, alignment); }
+
+void operator delete(void* pointer) noexcept { rawFree(pointer); }
+void operator delete[](void* pointer) noexcept { rawFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { rawFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { rawFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { rawFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { rawFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { alignedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { alignedFree(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { alignedFree(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { alignedFree(pointer); }
+
+// --- Scope statistics ---
+// A fixed table searched by name pointer: updating it must not allocate itself.
+
+namespace {
+
+constexpr int MaxScopes = 64;
+
+struct ScopeTable {
+	QMutex mutex;
+	AllocProfiler::ScopeStats entries[MaxScopes];
+	int count = 0;
+	bool overflowWarned = false;
+};
+
+ScopeTable& table()
+{
+	static ScopeTable scopes;
+	return scopes;
+}
+
+} // namespace
+
+namespace AllocProfiler {
+
+quint64 threadAllocations()
+{
+	return t_allocations;
+}
+
+quint64 threadBytes()
+{
+	return t_bytes;
+}
+
+QVector<ScopeStats> stats()
+{
+	ScopeTable& scopes = table();
+	QMutexLocker locker(&scopes.mutex);
+	QVector<ScopeStats> result;
+	result.reserve(scopes.count);
+	for (int i = 0; i < scopes.count; ++i) result.append(scopes.entries[i]);
+	return result;
+}
+
+void reset()
+{
+	ScopeTable& scopes = table();
+	QMutexLocker locker(&scopes.mutex);
+	for (int i = 0; i < scopes.count; ++i) {
+		ScopeStats& entry = scopes.entries[i];
+		const char* name = entry.name;
+		const bool expectNone = entry.expectNone;
+		entry = ScopeStats();
+		entry.name = name;
+		entry.expectNone = expectNone;
+		entry.calls = quint64(Constants::ALLOC_WARMUP_CALLS); // Already warmed up
+	}
+}
+
+QString report()
+{
+	QStringList lines;
+	for (const ScopeStats& entry : stats()) {
+		QString line = QString("%1: %2 call(s), %3 allocation(s) (%4 per call, max %5), %6 bytes")
+						   .arg(QLatin1String(entry.name)).arg(entry.calls).arg(entry.allocations)
+						   .arg(entry.calls ? double(entry.allocations) / entry.calls : 0.0, 0, 'f', 2)
+						   .arg(entry.maxAllocationsPerCall).arg(entry.bytes);
+		if (entry.expectNone) {
+			line += entry.violations ? QString(", %1 VIOLATION(S) of zero-allocation").arg(entry.violations) : QString(", zero-allocation OK");
+		}
+		lines << line;
+	}
+	return lines.join('\n');
+}
+
+Scope::Scope(const char* name, Expectation expectation)
+	: m_name(name)
+	, m_expectation(expectation)
+	, m_startAllocations(t_allocations)
+	, m_startBytes(t_bytes)
+{
+}
+
+Scope::~Scope()
+{
+	const quint64 allocations = t_allocations - m_startAllocations;
+	const quint64 bytes = t_bytes - m_startBytes;
+
+	bool firstViolation = false;
+	{
+		ScopeTable& scopes = table();
+		QMutexLocker locker(&scopes.mutex);
+		ScopeStats* entry = nullptr;
+		for (int i = 0; i < scopes.count && !entry; ++i) {
+			if (scopes.entries[i].name == m_name) entry = &scopes.entries[i];
+		}
+		if (!entry) {
+			if (scopes.count == MaxScopes) {
+				if (scopes.overflowWarned) return;
+				scopes.overflowWarned = true;
+				locker.unlock();
+				qWarning() << "AllocProfiler: too many scopes, not recording" << m_name;
+				return;
+			}
+			entry = &scopes.entries[scopes.count++];
+			entry->name = m_name;
+			entry->expectNone = m_expectation == ExpectNone;
+		}
+		entry->calls++;
+		entry->allocations += allocations;
+		entry->bytes += bytes;
+		entry->maxAllocationsPerCall = qMax(entry->maxAllocationsPerCall, allocations);
+		if (m_expectation == ExpectNone && allocations > 0 && entry->calls > quint64(Constants::ALLOC_WARMUP_CALLS)) {
+			firstViolation = entry->violations++ == 0;
+		}
+	}
+	if (firstViolation) {
+		qWarning().noquote() << QString("AllocProfiler: %1 allocated %2 time(s) (%3 bytes) in a zero-allocation scope")
+									.arg(QLatin1String(m_name)).arg(allocations).arg(bytes);
+	}
+}
+
+} // namespace AllocProfiler
+
+#endif // PNA_ALLOC_PROFILING
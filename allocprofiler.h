@@ -0,0 +1,108 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef ALLOCPROFILER_H
+#define ALLOCPROFILER_H
+
+#include <QString>
+#include <QVector>
+
+/*
+ * Heap allocation counting for diagnostics builds.
+ *
+ * Built with qmake CONFIG+=alloc_profiling (defines PNA_ALLOC_PROFILING), the
+ * global operator new / delete are replaced by counting versions; on glibc the
+ * malloc family is interposed as well, so QString / QVector buffers, which Qt
+ * allocates with malloc, are counted too. Allocations are counted per thread
+ * and attributed to the instrumented scopes active on that thread (inclusive:
+ * a nested scope also counts for its parents).
+ *
+ * Scopes marked ExpectNone are steady-state paths that must not allocate once
+ * warmed up (the first ALLOC_WARMUP_CALLS calls create the persistent items and
+ * reserve buffers); any allocation after that is reported as a violation.
+ *
+ * In regular builds every call compiles to nothing.
+ */
+namespace AllocProfiler {
+
+struct ScopeStats {
+	const char* name = nullptr;
+	quint64 calls = 0;
+	quint64 allocations = 0;
+	quint64 bytes = 0;
+	quint64 maxAllocationsPerCall = 0;
+	bool expectNone = false;
+	quint64 violations = 0; // ExpectNone calls that allocated after warm-up
+};
+
+#ifdef PNA_ALLOC_PROFILING
+
+constexpr bool Enabled = true;
+
+quint64 threadAllocations(); // Allocations of the calling thread since it started
+quint64 threadBytes();
+QVector<ScopeStats> stats(); // Only scopes that ran, in first-use order
+void reset();
+QString report(); // One line per scope
+
+class Scope
+{
+public:
+	enum Expectation { Measure, ExpectNone };
+
+	// name must point to a string literal
+	explicit Scope(const char* name, Expectation expectation = Measure);
+	~Scope();
+
+private:
+	Q_DISABLE_COPY(Scope)
+	const char* m_name;
+	Expectation m_expectation;
+	quint64 m_startAllocations;
+	quint64 m_startBytes;
+};
+
+#else
+
+constexpr bool Enabled = false;
+
+inline quint64 threadAllocations() { return 0; }
+inline quint64 threadBytes() { return 0; }
+inline QVector<ScopeStats> stats() { return QVector<ScopeStats>(); }
+inline void reset() {}
+inline QString report() { return QString(); }
+
+class Scope
+{
+public:
+	enum Expectation { Measure, ExpectNone };
+	explicit Scope(const char*, Expectation = Measure) {}
+};
+
+#endif // PNA_ALLOC_PROFILING
+
+} // namespace AllocProfiler
+
+#endif // ALLOCPROFILER_H
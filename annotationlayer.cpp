@@ -0,0 +1,390 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "annotationlayer.h"
+
+#include <QFontMetricsF>
+#include <QTextOption>
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.h"
+
+AnnotationLayer::AnnotationLayer(QCustomPlot* parentPlot)
+	: QCPAbstractItem(parentPlot),
+	  m_keyAxis(parentPlot->xAxis),
+	  m_valueAxis(parentPlot->yAxis)
+{
+	setSelectable(false);
+}
+
+void AnnotationLayer::setAxes(QCPAxis* keyAxis, QCPAxis* valueAxis)
+{
+	m_keyAxis = keyAxis;
+	m_valueAxis = valueAxis;
+}
+
+AnnotationLayer::Group& AnnotationLayer::groupAt(int group)
+{
+	if (group >= m_groups.size()) m_groups.resize(group + 1);
+	return m_groups[group];
+}
+
+void AnnotationLayer::setGroupStyle(int group, const MarkerStyle& marker, const LabelStyle& label)
+{
+	Group& entry = groupAt(group);
+	const bool fontChanged = entry.label.font != label.font;
+	entry.marker = marker;
+	entry.label = label;
+	entry.textPen = QPen(label.color);
+	entry.boxed = label.pen.style() != Qt::NoPen || label.brush.style() != Qt::NoBrush;
+	entry.sprite = QPixmap();
+	entry.used = true;
+	if (!fontChanged) return;
+	for (Annotation& annotation : m_annotations) {
+		if (annotation.group == group) annotation.layoutValid = false;
+	}
+}
+
+// --- Annotations ---
+
+int AnnotationLayer::add(int group, double key, double value, const QString& text,
+						 const QPointF& labelOffset, Qt::Alignment textAlignment, int priority)
+{
+	if (group < 0) return -1;
+	groupAt(group).used = true;
+	int id;
+	if (!m_freeSlots.isEmpty()) {
+		id = m_freeSlots.takeLast();
+	} else {
+		id = m_annotations.size();
+		m_annotations.append(Annotation());
+	}
+	Annotation& annotation = m_annotations[id];
+	annotation.group = group;
+	annotation.key = key;
+	annotation.value = value;
+	annotation.text = text;
+	annotation.labelOffset = labelOffset;
+	annotation.textAlignment = textAlignment;
+	annotation.priority = priority;
+	annotation.visible = true;
+	annotation.layoutValid = false;
+	m_count++;
+	if (!text.isEmpty()) m_labelOrderValid = false;
+	return id;
+}
+
+void AnnotationLayer::remove(int id)
+{
+	if (!contains(id)) return;
+	if (!m_annotations.at(id).text.isEmpty()) m_labelOrderValid = false;
+	m_annotations[id] = Annotation();
+	m_freeSlots.append(id);
+	m_count--;
+}
+
+void AnnotationLayer::removeGroup(int group)
+{
+	for (int id = 0; id < m_annotations.size(); ++id) {
+		if (m_annotations.at(id).group == group) remove(id);
+	}
+}
+
+void AnnotationLayer::clearAnnotations()
+{
+	m_annotations.clear();
+	m_freeSlots.clear();
+	m_labelOrder.clear();
+	m_labelOrderValid = true;
+	m_count = 0;
+}
+
+bool AnnotationLayer::contains(int id) const
+{
+	return id >= 0 && id < m_annotations.size() && m_annotations.at(id).group >= 0;
+}
+
+void AnnotationLayer::setPosition(int id, double key, double value)
+{
+	if (!contains(id)) return;
+	Annotation& annotation = m_annotations[id];
+	annotation.key = key;
+	annotation.value = value;
+}
+
+void AnnotationLayer::setText(int id, const QString& text)
+{
+	if (!contains(id)) return;
+	Annotation& annotation = m_annotations[id];
+	if (annotation.text == text) return;
+	if (annotation.text.isEmpty() != text.isEmpty()) m_labelOrderValid = false;
+	annotation.text = text;
+	annotation.layoutValid = false;
+}
+
+void AnnotationLayer::setLabelPlacement(int id, const QPointF& labelOffset, Qt::Alignment textAlignment)
+{
+	if (!contains(id)) return;
+	Annotation& annotation = m_annotations[id];
+	annotation.labelOffset = labelOffset;
+	if (annotation.textAlignment == textAlignment) return;
+	annotation.textAlignment = textAlignment;
+	annotation.layoutValid = false;
+}
+
+void AnnotationLayer::setAnnotationVisible(int id, bool visible)
+{
+	if (contains(id)) m_annotations[id].visible = visible;
+}
+
+double AnnotationLayer::selectTest(const QPointF& pos, bool onlySelectable, QVariant* details) const
+{
+	Q_UNUSED(pos)
+	Q_UNUSED(onlySelectable)
+	Q_UNUSED(details)
+	return -1.0;
+}
+
+// --- Drawing ---
+
+void AnnotationLayer::draw(QCPPainter* painter)
+{
+	QCPAxis* keyAxis = m_keyAxis.data();
+	QCPAxis* valueAxis = m_valueAxis.data();
+	if (!keyAxis || !valueAxis || m_count == 0) return;
+	const QRectF clip = clipRect();
+
+	const bool horizontalKey = keyAxis->orientation() == Qt::Horizontal;
+	m_pixels.resize(m_annotations.size());
+	for (int id = 0; id < m_annotations.size(); ++id) {
+		const Annotation& annotation = m_annotations.at(id);
+		if (annotation.group < 0 || !annotation.visible) continue;
+		const double keyPixel = keyAxis->coordToPixel(annotation.key);
+		const double valuePixel = valueAxis->coordToPixel(annotation.value);
+		m_pixels[id] = horizontalKey ? QPointF(keyPixel, valuePixel) : QPointF(valuePixel, keyPixel);
+	}
+
+	drawMarkers(painter, clip);
+	placeLabels(clip);
+
+	// Culled labels do not overlap each other: all boxes, then all texts, switching state per group only
+	int currentGroup = -1;
+	for (int i = 0; i < m_drawnLabels.size(); ++i) {
+		const Annotation& annotation = m_annotations.at(m_drawnLabels.at(i));
+		const Group& group = m_groups.at(annotation.group);
+		if (!group.label.cull || !group.boxed) continue;
+		if (annotation.group != currentGroup) {
+			painter->setPen(group.label.pen);
+			painter->setBrush(group.label.brush);
+			currentGroup = annotation.group;
+		}
+		painter->drawRect(m_drawnBoxes.at(i));
+	}
+	currentGroup = -1;
+	for (int i = 0; i < m_drawnLabels.size(); ++i) {
+		const Annotation& annotation = m_annotations.at(m_drawnLabels.at(i));
+		const Group& group = m_groups.at(annotation.group);
+		if (!group.label.cull) continue;
+		if (annotation.group != currentGroup) {
+			painter->setFont(group.label.font);
+			painter->setPen(group.textPen);
+			currentGroup = annotation.group;
+		}
+		const QMargins& padding = group.label.padding;
+		painter->drawStaticText(m_drawnBoxes.at(i).topLeft() + QPointF(padding.left(), padding.top()), annotation.layout);
+	}
+	// Labels that may overlap (crosshair readout, measurement) go on top, the first placed last
+	for (int i = m_drawnLabels.size() - 1; i >= 0; --i) {
+		const Annotation& annotation = m_annotations.at(m_drawnLabels.at(i));
+		const Group& group = m_groups.at(annotation.group);
+		if (group.label.cull) continue;
+		const QRectF& box = m_drawnBoxes.at(i);
+		if (group.boxed) {
+			painter->setPen(group.label.pen);
+			painter->setBrush(group.label.brush);
+			painter->drawRect(box);
+		}
+		painter->setFont(group.label.font);
+		painter->setPen(group.textPen);
+		const QMargins& padding = group.label.padding;
+		painter->drawStaticText(box.topLeft() + QPointF(padding.left(), padding.top()), annotation.layout);
+	}
+}
+
+void AnnotationLayer::drawMarkers(QCPPainter* painter, const QRectF& clip)
+{
+	// Vector exports and unbuffered exports get real ellipses, screen frames a blitted sprite
+	const bool sprites = !painter->modes().testFlag(QCPPainter::pmVectorized) && !painter->modes().testFlag(QCPPainter::pmNoCaching);
+	const qreal devicePixelRatio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+	for (int g = 0; g < m_groups.size(); ++g) {
+		Group& group = m_groups[g];
+		if (!group.used || group.marker.size <= 0.0) continue;
+		const double radius = group.marker.size / 2.0;
+		const QRectF markerClip = clip.adjusted(-radius, -radius, radius, radius);
+		const QPixmap* sprite = sprites ? &markerSprite(group, devicePixelRatio) : nullptr;
+		QPointF spriteCenter;
+		if (sprite) {
+			spriteCenter = QPointF(sprite->width(), sprite->height()) / (2.0 * sprite->devicePixelRatio());
+		} else {
+			painter->setPen(group.marker.pen);
+			painter->setBrush(group.marker.brush);
+		}
+		for (int id = 0; id < m_annotations.size(); ++id) {
+			const Annotation& annotation = m_annotations.at(id);
+			if (annotation.group != g || !annotation.visible) continue;
+			const QPointF& center = m_pixels.at(id);
+			if (!markerClip.contains(center)) continue;
+			if (sprite) painter->drawPixmap(center - spriteCenter, *sprite);
+			else painter->drawEllipse(center, radius, radius);
+		}
+	}
+}
+
+const QPixmap& AnnotationLayer::markerSprite(Group& group, qreal devicePixelRatio)
+{
+	if (!group.sprite.isNull() && group.sprite.devicePixelRatio() == devicePixelRatio) return group.sprite;
+	// Marker plus pen and one pixel of antialiasing on each side, odd so the center is a pixel center
+	const double extent = group.marker.size + qMax(1.0, group.marker.pen.widthF()) + 2.0;
+	const int side = (int(std::ceil(extent * devicePixelRatio)) / 2) * 2 + 1;
+	QPixmap sprite(side, side);
+	sprite.setDevicePixelRatio(devicePixelRatio);
+	sprite.fill(Qt::transparent);
+	QPainter painter(&sprite);
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.setPen(group.marker.pen);
+	painter.setBrush(group.marker.brush);
+	const double center = side / devicePixelRatio / 2.0;
+	painter.drawEllipse(QPointF(center, center), group.marker.size / 2.0, group.marker.size / 2.0);
+	painter.end();
+	group.sprite = sprite;
+	return group.sprite;
+}
+
+// --- Label placement ---
+
+void AnnotationLayer::layoutLabel(Annotation& annotation, const LabelStyle& style)
+{
+	// Same box as QCPItemText: the font metrics bounding rect of the text
+	const QFontMetricsF metrics(style.font);
+	annotation.textSize = metrics.boundingRect(QRectF(), Qt::TextDontClip | annotation.textAlignment, annotation.text).size();
+	QString text = annotation.text;
+	text.replace(QLatin1Char('\n'), QChar::LineSeparator); // QStaticText breaks lines on separators only
+	QTextOption option(annotation.textAlignment & Qt::AlignHorizontal_Mask);
+	option.setWrapMode(QTextOption::NoWrap);
+	annotation.layout.setTextFormat(Qt::PlainText);
+	annotation.layout.setTextOption(option);
+	annotation.layout.setTextWidth(annotation.textSize.width());
+	annotation.layout.setText(text);
+	annotation.layout.prepare(QTransform(), style.font);
+	annotation.layoutValid = true;
+}
+
+void AnnotationLayer::placeLabels(const QRectF& clip)
+{
+	if (!m_labelOrderValid) {
+		m_labelOrder.resize(0);
+		for (int id = 0; id < m_annotations.size(); ++id) {
+			if (m_annotations.at(id).group >= 0 && !m_annotations.at(id).text.isEmpty()) m_labelOrder.append(id);
+		}
+		std::stable_sort(m_labelOrder.begin(), m_labelOrder.end(), [this](int a, int b) {
+			return m_annotations.at(a).priority > m_annotations.at(b).priority;
+		});
+		m_labelOrderValid = true;
+	}
+
+	m_drawnLabels.resize(0);
+	m_drawnBoxes.resize(0);
+	m_placedBoxes.resize(0);
+	m_nodeNext.resize(0);
+	m_nodeBox.resize(0);
+	m_culledLabels = 0;
+	const double cell = Constants::ANNOTATION_GRID_CELL_PX;
+	m_gridOrigin = clip.topLeft();
+	m_gridColumns = qMax(1, int(std::ceil(clip.width() / cell)));
+	m_gridRows = qMax(1, int(std::ceil(clip.height() / cell)));
+	m_cellHead.fill(-1, m_gridColumns * m_gridRows);
+
+	for (int id : std::as_const(m_labelOrder)) {
+		Annotation& annotation = m_annotations[id];
+		if (!annotation.visible) continue;
+		const LabelStyle& style = m_groups.at(annotation.group).label;
+		if (!annotation.layoutValid) layoutLabel(annotation, style);
+		QRectF box(0.0, 0.0,
+				   annotation.textSize.width() + style.padding.left() + style.padding.right(),
+				   annotation.textSize.height() + style.padding.top() + style.padding.bottom());
+		box.moveCenter(m_pixels.at(id) + annotation.labelOffset);
+		if (!clip.intersects(box)) continue; // Also rejects NaN positions (non-positive keys on a log axis)
+		if (style.cull) {
+			if (overlapsPlaced(box)) {
+				m_culledLabels++;
+				continue;
+			}
+			addPlaced(box);
+		}
+		m_drawnLabels.append(id);
+		m_drawnBoxes.append(box);
+	}
+}
+
+void AnnotationLayer::cellSpan(const QRectF& box, int* left, int* top, int* right, int* bottom) const
+{
+	const double cell = Constants::ANNOTATION_GRID_CELL_PX;
+	*left = int(qBound(0.0, std::floor((box.left() - m_gridOrigin.x()) / cell), double(m_gridColumns - 1)));
+	*right = int(qBound(0.0, std::floor((box.right() - m_gridOrigin.x()) / cell), double(m_gridColumns - 1)));
+	*top = int(qBound(0.0, std::floor((box.top() - m_gridOrigin.y()) / cell), double(m_gridRows - 1)));
+	*bottom = int(qBound(0.0, std::floor((box.bottom() - m_gridOrigin.y()) / cell), double(m_gridRows - 1)));
+}
+
+bool AnnotationLayer::overlapsPlaced(const QRectF& box) const
+{
+	int left, top, right, bottom;
+	cellSpan(box, &left, &top, &right, &bottom);
+	for (int row = top; row <= bottom; ++row) {
+		for (int column = left; column <= right; ++column) {
+			for (int node = m_cellHead.at(row * m_gridColumns + column); node >= 0; node = m_nodeNext.at(node)) {
+				if (m_placedBoxes.at(m_nodeBox.at(node)).intersects(box)) return true;
+			}
+		}
+	}
+	return false;
+}
+
+void AnnotationLayer::addPlaced(const QRectF& box)
+{
+	const int boxIndex = m_placedBoxes.size();
+	m_placedBoxes.append(box);
+	int left, top, right, bottom;
+	cellSpan(box, &left, &top, &right, &bottom);
+	for (int row = top; row <= bottom; ++row) {
+		for (int column = left; column <= right; ++column) {
+			const int cellIndex = row * m_gridColumns + column;
+			m_nodeNext.append(m_cellHead.at(cellIndex));
+			m_nodeBox.append(boxIndex);
+			m_cellHead[cellIndex] = m_nodeNext.size() - 1;
+		}
+	}
+}
@@ -0,0 +1,157 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef ANNOTATIONLAYER_H
+#define ANNOTATIONLAYER_H
+
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+#include <QPixmap>
+#include <QStaticText>
+
+#include "qcustomplot.h"
+
+/*
+ * All point annotations of the plot (spot noise markers and labels, the
+ * crosshair tracer and readout, the measurement points and text) in a single
+ * QCustomPlot item.
+ *
+ * One QCPItemTracer + QCPItemText per annotation costs two items with their
+ * QCPItemPosition objects, a layer entry each, font metrics and a text layout
+ * per label on every replot, and overlapping labels are all drawn.
+ *
+ * Here annotations are plain entries (key/value in plot coordinates, text,
+ * label offset in pixels) sharing the marker and label style of their group.
+ * Text layouts are kept as QStaticText until the text or the group font
+ * changes. A frame draws the markers of each group from one cached sprite,
+ * places the labels by priority through a uniform grid of the ones already
+ * placed and drops those that would overlap (groups with culling off, like the
+ * crosshair readout, are always drawn), then draws the boxes and texts.
+ *
+ * Ids returned by add() stay valid until the annotation or its group is
+ * removed. The item is not selectable.
+ */
+class AnnotationLayer : public QCPAbstractItem
+{
+	Q_OBJECT
+public:
+	struct MarkerStyle {
+		QPen pen = QPen(Qt::NoPen);
+		QBrush brush = QBrush(Qt::NoBrush);
+		double size = 0.0; // Circle diameter in pixels, 0 draws no marker
+	};
+	struct LabelStyle {
+		QFont font;
+		QColor color = Qt::black;
+		QPen pen = QPen(Qt::NoPen); // Box border
+		QBrush brush = QBrush(Qt::NoBrush);
+		QMargins padding;
+		bool cull = true; // Dropped where it would overlap a label placed before it
+	};
+
+	explicit AnnotationLayer(QCustomPlot* parentPlot);
+
+	void setAxes(QCPAxis* keyAxis, QCPAxis* valueAxis);
+	void setGroupStyle(int group, const MarkerStyle& marker, const LabelStyle& label);
+
+	// The label box is centered labelOffset pixels away from the marker; higher priorities are placed first
+	int add(int group, double key, double value, const QString& text = QString(),
+			const QPointF& labelOffset = QPointF(), Qt::Alignment textAlignment = Qt::AlignCenter, int priority = 0);
+	void remove(int id);
+	void removeGroup(int group);
+	void clearAnnotations();
+
+	bool contains(int id) const;
+	int annotationCount() const { return m_count; }
+	int culledLabelCount() const { return m_culledLabels; } // In the last frame drawn
+
+	void setPosition(int id, double key, double value);
+	void setText(int id, const QString& text);
+	void setLabelPlacement(int id, const QPointF& labelOffset, Qt::Alignment textAlignment);
+	void setAnnotationVisible(int id, bool visible);
+
+	double selectTest(const QPointF& pos, bool onlySelectable, QVariant* details = nullptr) const override;
+
+protected:
+	void draw(QCPPainter* painter) override;
+
+private:
+	struct Group {
+		MarkerStyle marker;
+		LabelStyle label;
+		QPen textPen;
+		bool boxed = false; // Label box has a border or a fill
+		QPixmap sprite; // Marker rendered once, null until needed
+		bool used = false;
+	};
+	struct Annotation {
+		int group = -1; // -1: free slot
+		double key = 0.0;
+		double value = 0.0;
+		QString text;
+		QPointF labelOffset;
+		Qt::Alignment textAlignment = Qt::AlignCenter;
+		int priority = 0;
+		bool visible = true;
+		// Label layout, rebuilt when the text or the group font changes
+		QStaticText layout;
+		QSizeF textSize;
+		bool layoutValid = false;
+	};
+
+	Group& groupAt(int group);
+	static void layoutLabel(Annotation& annotation, const LabelStyle& style);
+	const QPixmap& markerSprite(Group& group, qreal devicePixelRatio);
+	void drawMarkers(QCPPainter* painter, const QRectF& clip);
+	void placeLabels(const QRectF& clip);
+	bool overlapsPlaced(const QRectF& box) const;
+	void addPlaced(const QRectF& box);
+	void cellSpan(const QRectF& box, int* left, int* top, int* right, int* bottom) const;
+
+	QPointer<QCPAxis> m_keyAxis;
+	QPointer<QCPAxis> m_valueAxis;
+	QVector<Group> m_groups;
+	QVector<Annotation> m_annotations;
+	QVector<int> m_freeSlots;
+	int m_count = 0;
+	QVector<int> m_labelOrder; // Ids with a label, by decreasing priority
+	bool m_labelOrderValid = true;
+
+	// Per-frame state, kept between frames so a steady-state replot does not allocate
+	QVector<QPointF> m_pixels; // Marker pixel position per id
+	QVector<int> m_drawnLabels; // Ids of the labels placed this frame, in placement order
+	QVector<QRectF> m_drawnBoxes;
+	QVector<QRectF> m_placedBoxes; // Culled groups only, referenced by the grid
+	QVector<int> m_cellHead; // Grid cell -> first node, -1 if empty
+	QVector<int> m_nodeNext;
+	QVector<int> m_nodeBox;
+	QPointF m_gridOrigin;
+	int m_gridColumns = 0;
+	int m_gridRows = 0;
+	int m_culledLabels = 0;
+};
+
+#endif // ANNOTATIONLAYER_H
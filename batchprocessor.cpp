@@ -0,0 +1,627 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "batchprocessor.h"
+#include "coreconstants.h"
+#include "datasetparser.h"
+#include "packfile.h"
+#include "utils.h"
+
+#include <QAtomicInt>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+#include <QTextStream>
+#include <QThreadPool>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace BatchProcessor {
+
+namespace {
+
+constexpr quint32 PartialMagic = 0x504E4150; // "PNAP"
+constexpr quint32 PartialVersion = 2; // 2: value storage in the options
+constexpr QDataStream::Version PartialStreamVersion = QDataStream::Qt_5_15;
+
+// What a run writes; never picked up as input when a directory is expanded again
+const char* const ProcessedSuffix = "_processed.csv";
+const char* const SpotNoiseSuffix = "_spot_noise.csv";
+const char* const SummaryFileName = "batch_summary.csv";
+const char* const StatisticsFileName = "batch_statistics.csv";
+
+bool isBatchOutput(const QString& fileName)
+{
+	return fileName.endsWith(QLatin1String(ProcessedSuffix)) || fileName.endsWith(QLatin1String(SpotNoiseSuffix))
+		|| fileName == QLatin1String(SummaryFileName) || fileName == QLatin1String(StatisticsFileName);
+}
+
+// Output directory of an input: outputDir, or next to the file (pack members: next to the pack)
+QString outputDirectory(const QString& input, const QString& outputDir)
+{
+	if (!outputDir.isEmpty()) return outputDir;
+	QString packPath;
+	return QFileInfo(PackFile::splitMemberPath(input, &packPath, nullptr) ? packPath : input).absolutePath();
+}
+
+// Same layout as File > Export Data for a single dataset
+bool writeProcessedCsv(const QString& path, const QString& name, const DatasetColumns& data, const QVector<double>& noise,
+					   bool hasReferenceData, bool referenceFiltered)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+	QTextStream out(&file);
+	const QVector<double> ref = referenceFiltered ? data.referenceNoiseFiltered
+												  : data.withReferenceNoise([](const auto& column) { return Utils::toVector(column); });
+	out << "Frequency Offset (Hz)," << name << " Phase Noise (dBc/Hz)";
+	if (hasReferenceData) out << "," << name << " Reference Noise (dBc/Hz)";
+	out << "\n";
+	for (int i = 0; i < data.frequencyOffset.size(); ++i) {
+		out << QString::number(data.frequencyOffset[i], 'g', 9) << "," << QString::number(noise[i], 'f', 3);
+		if (hasReferenceData) {
+			out << "," << (i < ref.size() && !std::isnan(ref[i]) ? QString::number(ref[i], 'f', 3) : "");
+		}
+		out << "\n";
+	}
+	return file.error() == QFile::NoError;
+}
+
+// Same layout as File > Export Spot Noise
+bool writeSpotNoiseCsv(const QString& path, const QVector<SpotNoisePoint>& spots)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+	QTextStream out(&file);
+	out << "Frequency Point,Actual Frequency (Hz),Phase Noise (dBc/Hz)\n";
+	for (const SpotNoisePoint& spot : spots) {
+		out << spot.label << "," << QString::number(spot.frequency, 'g', 9) << "," << QString::number(spot.noise, 'f', 3) << "\n";
+	}
+	return file.error() == QFile::NoError;
+}
+
+bool writeSummary(const QString& path, const QVector<BatchResult>& results, const BatchOptions& options)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+	QTextStream out(&file);
+	out << "File,Status,Points";
+	for (const auto& info : Constants::FREQ_POINT_INFOS) {
+		out << "," << info.displayName << " (dBc/Hz)";
+	}
+	out << ",Integrated From (Hz),Integrated To (Hz),Integrated Noise (dBc),RMS Phase (rad)";
+	if (options.carrierFrequency > 0) out << ",RMS Jitter (s)";
+	if (!options.mask.isEmpty()) out << ",Mask,Mask Margin (dB),Worst Frequency (Hz)";
+	out << ",Time (ms)\n";
+
+	for (const BatchResult& r : results) {
+		out << QFileInfo(r.input).fileName() << "," << (r.ok ? QStringLiteral("ok") : QString(r.error).replace(',', ';'))
+			<< "," << r.points;
+		for (const auto& info : Constants::FREQ_POINT_INFOS) {
+			out << ",";
+			for (const SpotNoisePoint& spot : r.spots) {
+				if (spot.targetFrequency == info.value) out << QString::number(spot.noise, 'f', 3);
+			}
+		}
+		if (r.integrated.valid) {
+			out << "," << QString::number(r.integrated.from, 'g', 9) << "," << QString::number(r.integrated.to, 'g', 9)
+				<< "," << QString::number(r.integrated.integratedDbc, 'f', 3) << "," << QString::number(r.integrated.rmsPhaseRad, 'g', 6);
+		} else {
+			out << ",,,,";
+		}
+		if (options.carrierFrequency > 0) out << "," << (r.integrated.valid ? QString::number(r.rmsJitter, 'g', 6) : QString());
+		if (!options.mask.isEmpty()) {
+			if (r.mask.checked) {
+				out << "," << (r.mask.pass ? "pass" : "fail") << "," << QString::number(r.mask.worstMargin, 'f', 3)
+					<< "," << QString::number(r.mask.worstFrequency, 'g', 9);
+			} else {
+				out << ",,,";
+			}
+		}
+		out << "," << r.elapsedMs << "\n";
+	}
+	return file.error() == QFile::NoError;
+}
+
+bool writeStatistics(const QString& path, const BatchStatistics& stats, const BatchOptions& options)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+	QTextStream out(&file);
+	auto number = [](double value) { return std::isnan(value) ? QString() : QString::number(value, 'f', 3); };
+	auto row = [&](const QString& name, const RunningStatistics& s) {
+		out << name << "," << s.count();
+		if (s.count() > 0) {
+			out << "," << number(s.mean()) << "," << number(s.stddev()) << "," << number(s.min())
+				<< "," << number(s.quantile(0.1)) << "," << number(s.quantile(0.5)) << "," << number(s.quantile(0.9))
+				<< "," << number(s.max());
+		} else {
+			out << ",,,,,,,";
+		}
+		out << "\n";
+	};
+
+	out << "Quantity,Count,Mean,Std Dev,Min,P10,Median,P90,Max\n";
+	for (int i = 0; i < Constants::FREQ_POINT_COUNT; ++i) {
+		row(QString("Spot Noise %1 (dBc/Hz)").arg(Constants::FREQ_POINT_INFOS[size_t(i)].displayName), stats.spotNoise[size_t(i)]);
+	}
+	row("Integrated Noise (dBc)", stats.integratedNoise);
+	out << "Files," << stats.files << "\n";
+	out << "Failed," << stats.failed << "\n";
+	if (!options.mask.isEmpty()) {
+		out << "Mask Checked," << stats.maskChecked << "\n";
+		out << "Mask Failed," << stats.maskFailed << "\n";
+	}
+	return file.error() == QFile::NoError;
+}
+
+// Settings that change the results; partials are only merged when these are identical
+QByteArray serializeOptions(const BatchOptions& options)
+{
+	QByteArray bytes;
+	QDataStream out(&bytes, QIODevice::WriteOnly);
+	out.setVersion(PartialStreamVersion);
+	out << options.filterType << qint32(options.filterWindow) << options.removeSpurs
+		<< options.integrateFrom << options.integrateTo << options.carrierFrequency << options.maskName
+		<< quint32(options.mask.size());
+	for (const MaskPoint& point : options.mask) out << point.frequency << point.limit;
+	out << quint32(options.valueStorage);
+	return bytes;
+}
+
+bool deserializeOptions(const QByteArray& bytes, BatchOptions* options)
+{
+	QDataStream in(bytes);
+	in.setVersion(PartialStreamVersion);
+	qint32 filterWindow = 0;
+	quint32 maskSize = 0;
+	in >> options->filterType >> filterWindow >> options->removeSpurs
+	   >> options->integrateFrom >> options->integrateTo >> options->carrierFrequency >> options->maskName >> maskSize;
+	if (in.status() != QDataStream::Ok || maskSize > 1000000) return false;
+	options->filterWindow = filterWindow;
+	options->mask.resize(int(maskSize));
+	for (MaskPoint& point : options->mask) in >> point.frequency >> point.limit;
+	quint32 valueStorage = 0;
+	in >> valueStorage;
+	if (valueStorage > quint32(ValueStorage::CentiDb16)) return false;
+	options->valueStorage = ValueStorage(valueStorage);
+	return in.status() == QDataStream::Ok;
+}
+
+QDataStream& operator<<(QDataStream& out, const BatchResult& r)
+{
+	out << r.input << r.ok << r.error << qint32(r.points) << r.hasReferenceData << quint32(r.spots.size());
+	for (const SpotNoisePoint& spot : r.spots) {
+		out << spot.label << spot.targetFrequency << spot.frequency << spot.noise;
+	}
+	out << r.integrated.from << r.integrated.to << r.integrated.integratedDbc << r.integrated.rmsPhaseRad << r.integrated.valid
+		<< r.rmsJitter << r.mask.checked << r.mask.pass << r.mask.worstMargin << r.mask.worstFrequency << r.elapsedMs;
+	return out;
+}
+
+QDataStream& operator>>(QDataStream& in, BatchResult& r)
+{
+	qint32 points = 0;
+	quint32 spotCount = 0;
+	in >> r.input >> r.ok >> r.error >> points >> r.hasReferenceData >> spotCount;
+	if (spotCount > quint32(Constants::FREQ_POINT_COUNT)) {
+		in.setStatus(QDataStream::ReadCorruptData);
+		return in;
+	}
+	r.points = points;
+	r.spots.resize(int(spotCount));
+	for (SpotNoisePoint& spot : r.spots) {
+		in >> spot.label >> spot.targetFrequency >> spot.frequency >> spot.noise;
+	}
+	in >> r.integrated.from >> r.integrated.to >> r.integrated.integratedDbc >> r.integrated.rmsPhaseRad >> r.integrated.valid
+	   >> r.rmsJitter >> r.mask.checked >> r.mask.pass >> r.mask.worstMargin >> r.mask.worstFrequency >> r.elapsedMs;
+	return in;
+}
+
+struct Partial {
+	qint32 shardIndex = 0;
+	qint32 shardCount = 1;
+	QByteArray options;
+	QVector<BatchResult> results;
+	BatchStatistics statistics;
+};
+
+bool writePartial(const QString& path, const Partial& partial, QString* errorString)
+{
+	QDir().mkpath(QFileInfo(path).absolutePath());
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly)) {
+		if (errorString) *errorString = file.errorString();
+		return false;
+	}
+	QDataStream out(&file);
+	out << PartialMagic << PartialVersion;
+	out.setVersion(PartialStreamVersion);
+	out << partial.shardIndex << partial.shardCount << partial.options << quint32(partial.results.size());
+	for (const BatchResult& r : partial.results) out << r;
+	out << partial.statistics;
+	if (out.status() != QDataStream::Ok || !file.commit()) {
+		if (errorString) *errorString = file.errorString();
+		return false;
+	}
+	return true;
+}
+
+bool readPartial(const QString& path, Partial* partial, QString* errorString)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		if (errorString) *errorString = file.errorString();
+		return false;
+	}
+	QDataStream in(&file);
+	quint32 magic = 0, version = 0;
+	in >> magic >> version;
+	if (magic != PartialMagic || version != PartialVersion) {
+		if (errorString) *errorString = QStringLiteral("Not a batch partial file (or unsupported version)");
+		return false;
+	}
+	in.setVersion(PartialStreamVersion);
+	quint32 resultCount = 0;
+	in >> partial->shardIndex >> partial->shardCount >> partial->options >> resultCount;
+	if (in.status() != QDataStream::Ok || quint64(resultCount) * 16 > quint64(file.size())) {
+		if (errorString) *errorString = QStringLiteral("Corrupted batch partial file");
+		return false;
+	}
+	partial->results.resize(int(resultCount));
+	for (BatchResult& r : partial->results) in >> r;
+	in >> partial->statistics;
+	if (in.status() != QDataStream::Ok) {
+		if (errorString) *errorString = QStringLiteral("Corrupted batch partial file");
+		return false;
+	}
+	return true;
+}
+
+// Rows sorted by input path, so a single run and the merge of its shards list the same rows;
+// only the time column, and the last digit of statistics mean / std dev, can differ
+bool writeReport(const QString& outputDir, QVector<BatchResult> results, const BatchStatistics& statistics,
+				 const BatchOptions& options)
+{
+	std::stable_sort(results.begin(), results.end(), [](const BatchResult& a, const BatchResult& b) { return a.input < b.input; });
+
+	const QString dir = outputDir.isEmpty() ? QDir::currentPath() : outputDir;
+	const QString summaryPath = dir + "/" + SummaryFileName;
+	const QString statisticsPath = dir + "/" + StatisticsFileName;
+	if (!writeSummary(summaryPath, results, options) || !writeStatistics(statisticsPath, statistics, options)) {
+		qWarning() << "Batch mode: could not write" << summaryPath << "or" << statisticsPath;
+		return false;
+	}
+	qInfo().noquote() << "Batch mode: report in" << summaryPath << "and" << statisticsPath;
+	return true;
+}
+
+} // namespace
+
+QString filterTypeFromArgument(const QString& argument)
+{
+	const QString key = argument.trimmed().toLower();
+	if (key == "moving-average") return QStringLiteral("Moving Average");
+	if (key == "median") return QStringLiteral("Median Filter");
+	if (key == "savitzky-golay") return QStringLiteral("Savitzky-Golay");
+	for (const QString& name : Processing::filterTypes()) {
+		if (name.toLower() == key) return name;
+	}
+	return QString();
+}
+
+QStringList readManifest(const QString& path, QString* errorString)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		if (errorString) *errorString = file.errorString();
+		return QStringList();
+	}
+	const QDir base = QFileInfo(path).absoluteDir();
+	QStringList files;
+	QTextStream in(&file);
+	while (!in.atEnd()) {
+		const QString line = in.readLine().trimmed();
+		if (line.isEmpty() || line.startsWith('#')) continue;
+		files << (QDir::isAbsolutePath(line) ? line : base.filePath(line));
+	}
+	return files;
+}
+
+QStringList expandInputs(const QStringList& arguments)
+{
+	QStringList files;
+	// A pack stands for all its members, in index order
+	auto add = [&files](const QString& path) {
+		QString errorString;
+		const QSharedPointer<PackFile> pack = PackFile::isPackFile(path) ? PackFile::shared(path, &errorString) : nullptr;
+		if (!pack) {
+			if (!errorString.isEmpty()) qWarning().noquote() << QString("Could not open pack %1: %2").arg(path, errorString);
+			files << path; // Fails, and is reported, like any unreadable input
+			return;
+		}
+		files.reserve(files.size() + pack->count());
+		for (int i = 0; i < pack->count(); ++i) {
+			files << PackFile::memberPath(path, pack->name(i));
+		}
+	};
+	for (const QString& argument : arguments) {
+		const QFileInfo info(argument);
+		if (info.isDir()) {
+			const QStringList entries = QDir(argument).entryList({"*.csv", "*.txt", "*.csv.gz", "*.txt.gz", "*.csv.zst", "*.txt.zst", "*.pnapack"},
+																 QDir::Files, QDir::Name);
+			for (const QString& entry : entries) {
+				if (!isBatchOutput(entry)) add(QDir(argument).filePath(entry));
+			}
+		} else {
+			add(argument);
+		}
+	}
+	return files;
+}
+
+QStringList outputStems(const QStringList& files, const QString& outputDir)
+{
+	// Output names are compared case-insensitively, as the file system may
+	auto key = [](const QString& stem) { return stem.toLower(); };
+	QStringList stems;
+	stems.reserve(files.size());
+	QHash<QString, int> uses;
+	for (const QString& file : files) {
+		stems << outputDirectory(file, outputDir) + "/" + DatasetParser::baseName(file);
+		uses[key(stems.last())]++;
+	}
+
+	// Colliding inputs (run.csv and run.txt) keep their whole name, numbered if that is taken too
+	QSet<QString> taken;
+	for (const QString& stem : std::as_const(stems)) {
+		if (uses.value(key(stem)) == 1) taken.insert(key(stem));
+	}
+	for (int i = 0; i < files.size(); ++i) {
+		if (uses.value(key(stems[i])) == 1) continue;
+		QString memberName;
+		const QString name = PackFile::splitMemberPath(files[i], nullptr, &memberName) ? memberName : QFileInfo(files[i]).fileName();
+		const QString base = outputDirectory(files[i], outputDir) + "/" + QFileInfo(name).fileName();
+		QString stem = base;
+		for (int n = 2; taken.contains(key(stem)); ++n) {
+			stem = base + "_" + QString::number(n);
+		}
+		taken.insert(key(stem));
+		stems[i] = stem;
+	}
+	return stems;
+}
+
+BatchResult processFile(const QString& filename, const BatchOptions& options, const QString& outputStem)
+{
+	QElapsedTimer timer;
+	timer.start();
+	BatchResult result;
+	result.input = filename;
+
+	ParsedDataset parsed;
+	DatasetParser::StitchOptions stitch;
+	stitch.overlap = options.overlap;
+	if (!DatasetParser::parseFile(filename, &parsed, &result.error, stitch)) {
+		result.elapsedMs = timer.elapsed();
+		return result;
+	}
+
+	DatasetColumns data;
+	data.frequencyOffset = std::move(parsed.frequencyOffset);
+	data.phaseNoise = std::move(parsed.phaseNoise);
+	data.referenceNoise = std::move(parsed.referenceNoise);
+	data.setStorage(options.valueStorage); // The kernels below read compact columns in place
+	result.points = data.frequencyOffset.size();
+	result.hasReferenceData = parsed.hasReferenceData;
+
+	// Same steps as the GUI: filter, then spur removal on the filtered columns
+	DerivedSettings settings;
+	settings.filtering = !options.filterType.isEmpty();
+	settings.filterType = options.filterType;
+	settings.filterWindow = options.filterWindow;
+	settings.spurRemoval = options.removeSpurs;
+	DerivedColumns derived = Processing::deriveColumns(data, parsed.hasReferenceData, settings);
+	data.phaseNoiseFiltered = std::move(derived.phaseNoiseFiltered);
+	data.referenceNoiseFiltered = std::move(derived.referenceNoiseFiltered);
+	const QVector<double>& noise = data.phaseNoiseFiltered;
+
+	result.spots = Processing::spotNoise(data.frequencyOffset, noise, 0.0, std::numeric_limits<double>::max());
+	result.integrated = Processing::integrateNoise(data.frequencyOffset, noise,
+												   options.integrateFrom > 0 ? options.integrateFrom : data.frequencyOffset.first(),
+												   options.integrateTo > 0 ? options.integrateTo : data.frequencyOffset.last());
+	result.rmsJitter = Processing::rmsJitter(result.integrated, options.carrierFrequency);
+	result.mask = Processing::checkMask(data.frequencyOffset, noise, options.mask);
+
+	if (options.writePerFile) {
+		const QString name = DatasetParser::baseName(filename);
+		const QString stem = outputStem.isEmpty() ? outputDirectory(filename, options.outputDir) + "/" + name : outputStem;
+		if (!writeProcessedCsv(stem + ProcessedSuffix, name, data, noise, parsed.hasReferenceData, settings.filtering)
+			|| !writeSpotNoiseCsv(stem + SpotNoiseSuffix, result.spots)) {
+			result.error = QStringLiteral("Could not write results");
+			result.elapsedMs = timer.elapsed();
+			return result;
+		}
+	}
+
+	result.ok = true;
+	result.elapsedMs = timer.elapsed();
+	return result;
+}
+
+int run(const QStringList& inputs, const BatchOptions& options)
+{
+	const QStringList allFiles = expandInputs(inputs);
+	// From the whole list, so every shard names the outputs the same way
+	const QStringList allStems = outputStems(allFiles, options.outputDir);
+	QStringList files;
+	QStringList stems;
+	for (int i = 0; i < allFiles.size(); ++i) {
+		if (i % options.shardCount == options.shardIndex) {
+			files << allFiles[i];
+			stems << allStems[i];
+		}
+	}
+	if (options.shardCount > 1) {
+		qInfo() << "Batch mode: shard" << options.shardIndex << "of" << options.shardCount << "-" << files.size() << "of" << allFiles.size() << "file(s)";
+	}
+	if (files.isEmpty() && options.partialPath.isEmpty()) {
+		qWarning() << "Batch mode: no input files";
+		return 2;
+	}
+	if (!options.outputDir.isEmpty() && !QDir().mkpath(options.outputDir)) {
+		qWarning() << "Batch mode: could not create output directory" << options.outputDir;
+		return 2;
+	}
+
+	QThreadPool* pool = QThreadPool::globalInstance();
+	if (options.threads > 0) pool->setMaxThreadCount(options.threads);
+	const int workers = qMin(pool->maxThreadCount(), int(files.size()));
+	qInfo() << "Batch mode:" << files.size() << "file(s) on" << workers << "thread(s)";
+
+	QElapsedTimer timer;
+	timer.start();
+
+	// Workers pull the next index themselves, so a few large files do not leave cores idle.
+	// Each result slot is written by exactly one worker.
+	QVector<BatchResult> results(files.size());
+	QAtomicInt next(0);
+	QAtomicInt done(0);
+	QMutex progressMutex;
+	const int progressStep = qMax(1, int(files.size()) / 20);
+	for (int w = 0; w < workers; ++w) {
+		pool->start([&]() {
+			for (int i = next.fetchAndAddRelaxed(1); i < files.size(); i = next.fetchAndAddRelaxed(1)) {
+				results[i] = processFile(files[i], options, stems[i]);
+				const int finished = done.fetchAndAddRelaxed(1) + 1;
+				if (finished % progressStep == 0 || finished == files.size()) {
+					QMutexLocker locker(&progressMutex);
+					qInfo().noquote() << QString("Batch mode: %1/%2").arg(finished).arg(files.size());
+				}
+			}
+		});
+	}
+	pool->waitForDone();
+
+	// Statistics in input order, so a run always produces the same numbers
+	BatchStatistics statistics;
+	int failed = 0;
+	for (const BatchResult& r : std::as_const(results)) {
+		statistics.add(r);
+		if (!r.ok) {
+			++failed;
+			qWarning().noquote() << "Failed:" << r.input << "-" << r.error;
+		}
+	}
+
+	const double seconds = timer.elapsed() / 1000.0;
+	qInfo().noquote() << QString("Batch mode: %1 processed, %2 failed in %3 s (%4 files/s)")
+							 .arg(files.size() - failed).arg(failed).arg(seconds, 0, 'f', 2)
+							 .arg(seconds > 0 ? files.size() / seconds : 0.0, 0, 'f', 1);
+
+	if (!options.partialPath.isEmpty()) {
+		Partial partial;
+		partial.shardIndex = options.shardIndex;
+		partial.shardCount = options.shardCount;
+		partial.options = serializeOptions(options);
+		partial.results = results;
+		partial.statistics = statistics;
+		QString errorString;
+		if (!writePartial(options.partialPath, partial, &errorString)) {
+			qWarning() << "Batch mode: could not write partial" << options.partialPath << errorString;
+			return 1;
+		}
+		qInfo().noquote() << "Batch mode: partial result in" << options.partialPath;
+	} else if (!writeReport(options.outputDir, results, statistics, options)) {
+		return 1;
+	}
+	return failed == 0 ? 0 : 1;
+}
+
+int merge(const QStringList& partialPaths, const QString& outputDir)
+{
+	QVector<Partial> partials;
+	for (const QString& path : partialPaths) {
+		Partial partial;
+		QString errorString;
+		if (!readPartial(path, &partial, &errorString)) {
+			qWarning() << "Merge:" << path << "-" << errorString;
+			return 2;
+		}
+		if (!partials.isEmpty() && (partial.shardCount != partials.first().shardCount || partial.options != partials.first().options)) {
+			qWarning() << "Merge:" << path << "was produced with a different shard count or different options";
+			return 2;
+		}
+		partials.append(partial);
+	}
+	if (partials.isEmpty()) {
+		qWarning() << "Merge: no partial files";
+		return 2;
+	}
+
+	// Shard order, not argument order: the merged statistics do not depend on how the files were listed
+	std::sort(partials.begin(), partials.end(), [](const Partial& a, const Partial& b) { return a.shardIndex < b.shardIndex; });
+	const int shardCount = partials.first().shardCount;
+	for (int i = 1; i < partials.size(); ++i) {
+		if (partials[i].shardIndex == partials[i - 1].shardIndex) {
+			qWarning() << "Merge: shard" << partials[i].shardIndex << "given twice";
+			return 2;
+		}
+	}
+	if (partials.size() != shardCount) {
+		qWarning() << "Merge: only" << partials.size() << "of" << shardCount << "shards, the report is incomplete";
+	}
+
+	BatchOptions options;
+	if (!deserializeOptions(partials.first().options, &options)) {
+		qWarning() << "Merge: corrupted options in partial file";
+		return 2;
+	}
+	BatchStatistics statistics;
+	QVector<BatchResult> results;
+	for (const Partial& partial : std::as_const(partials)) {
+		statistics.merge(partial.statistics);
+		results += partial.results;
+	}
+
+	if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) {
+		qWarning() << "Merge: could not create output directory" << outputDir;
+		return 2;
+	}
+	qInfo() << "Merge:" << partials.size() << "shard(s)," << results.size() << "file(s)," << statistics.failed << "failed";
+	if (!writeReport(outputDir, results, statistics, options)) return 1;
+	return (statistics.failed == 0 && partials.size() == shardCount) ? 0 : 1;
+}
+
+} // namespace BatchProcessor
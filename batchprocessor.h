@@ -0,0 +1,119 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "batchstatistics.h"
+#include "datasetparser.h"
+#include "processing.h"
+
+struct BatchOptions {
+	QString outputDir;           // Empty: next to each input file
+	QString filterType;          // Empty: no filtering, else one of Processing::filterTypes()
+	int filterWindow = 5;
+	bool removeSpurs = false;
+	double integrateFrom = 0.0;  // Hz, 0 = first data point
+	double integrateTo = 0.0;    // Hz, 0 = last data point
+	double carrierFrequency = 0.0; // Hz, jitter is only reported when set
+	int threads = 0;             // 0 = one per core
+	// Raw noise columns while a file is processed: Float32 / CentiDb16 cut their memory per
+	// worker to a half / a quarter, at the quantization error of CompactColumn
+	ValueStorage valueStorage = ValueStorage::Float64;
+	bool writePerFile = true;    // <name>_processed.csv and <name>_spot_noise.csv
+	QVector<MaskPoint> mask;     // Empty: no mask check
+	QString maskName;
+	// Overlapping segments and repeated sweeps in one file are merged (never split: one result per file)
+	DatasetParser::StitchOptions::Overlap overlap = DatasetParser::StitchOptions::Overlap::PreferLater;
+
+	// Sharding: this run processes the inputs at positions i with i % shardCount == shardIndex
+	// and writes a partial result file instead of the final report
+	int shardIndex = 0;
+	int shardCount = 1;
+	QString partialPath;
+};
+
+struct BatchResult {
+	QString input;
+	bool ok = false;
+	QString error;
+	int points = 0;
+	bool hasReferenceData = false;
+	QVector<SpotNoisePoint> spots;
+	IntegratedNoise integrated;
+	double rmsJitter = 0.0; // Seconds
+	MaskVerdict mask;
+	qint64 elapsedMs = 0;
+};
+
+/*
+ * Headless processing (pna_qt --batch): load, filter, remove spurs, spot noise and
+ * integrated noise / jitter for every input file, without any widget.
+ *
+ * Files are independent and processed on the global QThreadPool; each worker only
+ * touches its own file and columns, so throughput scales with the core count until
+ * the disk is the limit. The summary lists files sorted by path and is deterministic.
+ *
+ * To scale out, each machine runs one shard of the same input list and writes a
+ * partial (.pnapart: per-file results plus BatchStatistics, portable QDataStream).
+ * merge() combines the partials of all shards in shard order into the same report
+ * as a single run: batch_summary.csv and batch_statistics.csv (processing times and
+ * the rounding of mean / std dev aside, see RunningStatistics).
+ */
+namespace BatchProcessor {
+
+// Filter name from the command line: a filter combo name or moving-average, median, savitzky-golay.
+// Empty if unknown.
+QString filterTypeFromArgument(const QString& argument);
+
+// Directories are expanded to their *.csv and *.txt files, also compressed, and packs (sorted),
+// leaving out what a batch run writes (*_processed.csv, *_spot_noise.csv, the report);
+// packs to their members ("archive.pnapack#member"). Other arguments are kept.
+QStringList expandInputs(const QStringList& arguments);
+
+// Per-file output path without suffix, one per input: "<dir>/<baseName>", or the whole file
+// (or member) name, numbered if needed, for inputs whose base names collide
+QStringList outputStems(const QStringList& files, const QString& outputDir);
+
+// One path per line, empty lines and # comments skipped, relative paths resolved against the manifest
+QStringList readManifest(const QString& path, QString* errorString = nullptr);
+
+// outputStem from outputStems(); empty for "<dir>/<baseName>"
+BatchResult processFile(const QString& filename, const BatchOptions& options, const QString& outputStem = QString());
+
+// Processes all files (or this run's shard) in parallel and writes the report, or the
+// partial for a shard. Returns the process exit code.
+int run(const QStringList& inputs, const BatchOptions& options);
+
+// Combines shard partials into the final report in outputDir. Returns the process exit code.
+int merge(const QStringList& partialPaths, const QString& outputDir);
+
+} // namespace BatchProcessor
+
+#endif // BATCHPROCESSOR_H
@@ -0,0 +1,155 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "batchstatistics.h"
+#include "batchprocessor.h"
+
+#include <cmath>
+#include <limits>
+
+void RunningStatistics::add(double value)
+{
+	if (std::isnan(value)) return;
+	if (m_histogram.isEmpty()) m_histogram.fill(0, BinCount);
+	if (m_count == 0) {
+		m_min = m_max = value;
+	} else {
+		m_min = qMin(m_min, value);
+		m_max = qMax(m_max, value);
+	}
+	++m_count;
+	const double delta = value - m_mean;
+	m_mean += delta / double(m_count);
+	m_m2 += delta * (value - m_mean);
+
+	const int bin = qBound(0, int(std::floor((value - HistogramMin) / BinWidth)), BinCount - 1);
+	++m_histogram[bin];
+}
+
+void RunningStatistics::merge(const RunningStatistics& other)
+{
+	if (other.m_count == 0) return;
+	if (m_count == 0) {
+		*this = other;
+		return;
+	}
+	const double total = double(m_count + other.m_count);
+	const double delta = other.m_mean - m_mean;
+	m_mean += delta * double(other.m_count) / total;
+	m_m2 += other.m_m2 + delta * delta * double(m_count) * double(other.m_count) / total;
+	m_count += other.m_count;
+	m_min = qMin(m_min, other.m_min);
+	m_max = qMax(m_max, other.m_max);
+	for (int i = 0; i < BinCount; ++i) {
+		m_histogram[i] += other.m_histogram[i];
+	}
+}
+
+double RunningStatistics::stddev() const
+{
+	return m_count > 1 ? std::sqrt(m_m2 / double(m_count - 1)) : 0.0;
+}
+
+double RunningStatistics::quantile(double p) const
+{
+	if (m_count == 0) return std::numeric_limits<double>::quiet_NaN();
+	const quint64 rank = quint64(std::ceil(qBound(0.0, p, 1.0) * double(m_count)));
+	quint64 seen = 0;
+	for (int i = 0; i < BinCount; ++i) {
+		seen += m_histogram[i];
+		if (seen >= qMax<quint64>(rank, 1)) {
+			// Clamp to the observed range so the end bins do not report values never seen
+			return qBound(m_min, HistogramMin + (i + 0.5) * BinWidth, m_max);
+		}
+	}
+	return m_max;
+}
+
+QDataStream& operator<<(QDataStream& out, const RunningStatistics& s)
+{
+	out << s.m_count << s.m_mean << s.m_m2 << s.m_min << s.m_max << s.m_histogram;
+	return out;
+}
+
+QDataStream& operator>>(QDataStream& in, RunningStatistics& s)
+{
+	in >> s.m_count >> s.m_mean >> s.m_m2 >> s.m_min >> s.m_max >> s.m_histogram;
+	if (s.m_count > 0 && s.m_histogram.size() != RunningStatistics::BinCount) {
+		in.setStatus(QDataStream::ReadCorruptData);
+	}
+	return in;
+}
+
+void BatchStatistics::add(const BatchResult& result)
+{
+	++files;
+	if (!result.ok) {
+		++failed;
+		return;
+	}
+	for (const SpotNoisePoint& spot : result.spots) {
+		for (int i = 0; i < Constants::FREQ_POINT_COUNT; ++i) {
+			if (Constants::FREQ_POINT_INFOS[size_t(i)].value == spot.targetFrequency) spotNoise[size_t(i)].add(spot.noise);
+		}
+	}
+	if (result.integrated.valid) integratedNoise.add(result.integrated.integratedDbc);
+	if (result.mask.checked) {
+		++maskChecked;
+		if (!result.mask.pass) ++maskFailed;
+	}
+}
+
+void BatchStatistics::merge(const BatchStatistics& other)
+{
+	for (size_t i = 0; i < spotNoise.size(); ++i) {
+		spotNoise[i].merge(other.spotNoise[i]);
+	}
+	integratedNoise.merge(other.integratedNoise);
+	files += other.files;
+	failed += other.failed;
+	maskChecked += other.maskChecked;
+	maskFailed += other.maskFailed;
+}
+
+QDataStream& operator<<(QDataStream& out, const BatchStatistics& s)
+{
+	out << quint32(s.spotNoise.size());
+	for (const RunningStatistics& spot : s.spotNoise) out << spot;
+	out << s.integratedNoise << s.files << s.failed << s.maskChecked << s.maskFailed;
+	return out;
+}
+
+QDataStream& operator>>(QDataStream& in, BatchStatistics& s)
+{
+	quint32 spotCount = 0;
+	in >> spotCount;
+	if (spotCount != s.spotNoise.size()) {
+		in.setStatus(QDataStream::ReadCorruptData);
+		return in;
+	}
+	for (RunningStatistics& spot : s.spotNoise) in >> spot;
+	in >> s.integratedNoise >> s.files >> s.failed >> s.maskChecked >> s.maskFailed;
+	return in;
+}
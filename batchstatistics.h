@@ -0,0 +1,90 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef BATCHSTATISTICS_H
+#define BATCHSTATISTICS_H
+
+#include <QDataStream>
+#include <QVector>
+#include <array>
+
+#include "coreconstants.h"
+
+struct BatchResult;
+
+/*
+ * Mergeable summary of one quantity over many files: count, mean and variance
+ * (Welford, combined with Chan's formula), min, max and a fixed-bin histogram for
+ * quantiles. Partials from different shards merge exactly for everything but the
+ * last bits of mean/variance, which depend on the merge order (kept fixed by the
+ * caller: shard index order).
+ */
+class RunningStatistics
+{
+public:
+	static constexpr double HistogramMin = -250.0; // dB, values outside land in the end bins
+	static constexpr double HistogramMax = 50.0;
+	static constexpr double BinWidth = 0.1;
+	static constexpr int BinCount = 3000;
+
+	void add(double value);
+	void merge(const RunningStatistics& other);
+
+	quint64 count() const { return m_count; }
+	double mean() const { return m_mean; }
+	double stddev() const;
+	double min() const { return m_min; }
+	double max() const { return m_max; }
+	double quantile(double p) const; // From the histogram, bin centre, BinWidth resolution
+
+	friend QDataStream& operator<<(QDataStream& out, const RunningStatistics& s);
+	friend QDataStream& operator>>(QDataStream& in, RunningStatistics& s);
+
+private:
+	quint64 m_count = 0;
+	double m_mean = 0.0;
+	double m_m2 = 0.0;
+	double m_min = 0.0;
+	double m_max = 0.0;
+	QVector<quint32> m_histogram; // Allocated on first use
+};
+
+// Statistics of a batch run, one RunningStatistics per decade point plus integrated noise
+struct BatchStatistics {
+	std::array<RunningStatistics, Constants::FREQ_POINT_COUNT> spotNoise;
+	RunningStatistics integratedNoise;
+	quint64 files = 0;
+	quint64 failed = 0;
+	quint64 maskChecked = 0;
+	quint64 maskFailed = 0;
+
+	void add(const BatchResult& result);
+	void merge(const BatchStatistics& other);
+};
+
+QDataStream& operator<<(QDataStream& out, const BatchStatistics& s);
+QDataStream& operator>>(QDataStream& in, BatchStatistics& s);
+
+#endif // BATCHSTATISTICS_H
@@ -0,0 +1,172 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+// Drives the steady-state plot interactions of the real window (offscreen) and checks
+// with the allocation profiler that their handlers do not allocate once warmed up:
+// crosshair moves, range drags (pan) and Y range changes from the spin boxes.
+// Also prints the allocations per frame of the whole process for reference; those
+// include Qt's event, timer and paint machinery, which the zero-allocation scopes exclude.
+// Exits with status 1 if a zero-allocation scope allocated.
+
+#include "phasenoiseanalyzerapp.h"
+#include "allocprofiler.h"
+#include "qcustomplot.h"
+
+#include <QApplication>
+#include <QDoubleSpinBox>
+#include <QEventLoop>
+#include <QFile>
+#include <QMouseEvent>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+
+#include <cmath>
+#include <functional>
+
+namespace {
+
+constexpr int PointCount = 20000;
+constexpr int WarmupFrames = 20;
+constexpr int MeasuredFrames = 500;
+
+bool writeDataset(const QString& path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+	QTextStream out(&file);
+	for (int i = 0; i < PointCount; ++i) {
+		const double frequency = std::pow(10.0, 1.0 + 6.0 * i / (PointCount - 1)); // 10 Hz .. 10 MHz
+		const double decades = std::log10(frequency);
+		out << frequency << ',' << -60.0 - 15.0 * decades << ',' << -75.0 - 15.0 * decades << '\n';
+	}
+	return true;
+}
+
+void sendMouse(QWidget* widget, QEvent::Type type, const QPointF& position, Qt::MouseButton button, Qt::MouseButtons buttons)
+{
+	QMouseEvent event(type, position, widget->mapToGlobal(position.toPoint()), button, buttons, Qt::NoModifier);
+	QApplication::sendEvent(widget, &event);
+}
+
+// One frame: the interaction step, then everything it queued (replot, status bar readout)
+void processFrame()
+{
+	QApplication::processEvents();
+	QApplication::processEvents();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+	QApplication::setApplicationName("pna_allocbench"); // Own settings / autosave location
+	QTextStream out(stdout);
+
+	QTemporaryDir dir;
+	const QString dataPath = dir.path() + "/allocbench.csv";
+	if (!dir.isValid() || !writeDataset(dataPath)) {
+		out << "Could not write the test dataset\n";
+		return 2;
+	}
+
+	// Light theme with reference: the reference fill baseline follows the Y range
+	PhaseNoiseAnalyzerApp window(QStringList() << dataPath, true, false);
+	window.setRestoreWorkspaceOnStartup(false);
+	QEventLoop startup;
+	QObject::connect(&window, &PhaseNoiseAnalyzerApp::startupFinished, &startup, &QEventLoop::quit);
+	window.showMaximizedWithDelay();
+	startup.exec();
+
+	QCustomPlot* plot = window.findChild<QCustomPlot*>();
+	QDoubleSpinBox* yMinSpin = nullptr;
+	for (QDoubleSpinBox* spin : window.findChildren<QDoubleSpinBox*>()) {
+		if (spin->suffix() == " dBc/Hz") { yMinSpin = spin; break; } // Created before the max spin box
+	}
+	if (!plot || !yMinSpin) {
+		out << "Plot or Y range controls not found\n";
+		return 2;
+	}
+	QMetaObject::invokeMethod(&window, "toggleCrosshair", Q_ARG(bool, true));
+	plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+
+	const QRect area = plot->axisRect()->rect();
+	const double baseMin = yMinSpin->value();
+	auto crosshair = [&](int frame) {
+		const double x = area.left() + 1 + (frame * 7) % (area.width() - 2);
+		sendMouse(plot, QEvent::MouseMove, QPointF(x, area.center().y()), Qt::NoButton, Qt::NoButton);
+	};
+	auto pan = [&](int frame) {
+		const QPointF start = area.center();
+		sendMouse(plot, QEvent::MouseButtonPress, start, Qt::LeftButton, Qt::LeftButton);
+		sendMouse(plot, QEvent::MouseMove, start + QPointF((frame % 2) ? 12 : -12, (frame % 2) ? 8 : -8), Qt::NoButton, Qt::LeftButton);
+		sendMouse(plot, QEvent::MouseButtonRelease, start, Qt::LeftButton, Qt::NoButton);
+	};
+	auto yRange = [&](int frame) {
+		yMinSpin->setValue(baseMin + ((frame % 2) ? 10.0 : 0.0));
+	};
+
+	struct Interaction {
+		const char* name;
+		std::function<void(int)> step;
+	};
+	const Interaction interactions[] = {{"crosshair move", crosshair}, {"pan", pan}, {"Y range change", yRange}};
+
+	out << QString("%1 points, %2 frames per interaction\n").arg(PointCount).arg(MeasuredFrames);
+	for (const Interaction& interaction : interactions) {
+		for (int frame = 0; frame < WarmupFrames; ++frame) {
+			interaction.step(frame);
+			processFrame();
+		}
+	}
+	AllocProfiler::reset();
+
+	for (const Interaction& interaction : interactions) {
+		const quint64 before = AllocProfiler::threadAllocations();
+		for (int frame = 0; frame < MeasuredFrames; ++frame) {
+			interaction.step(frame);
+			processFrame();
+		}
+		const double perFrame = double(AllocProfiler::threadAllocations() - before) / MeasuredFrames;
+		out << QString("%1 %2 allocations per frame (whole GUI thread)\n").arg(QString::fromLatin1(interaction.name), -16).arg(perFrame, 0, 'f', 1);
+	}
+
+	out << AllocProfiler::report() << '\n';
+	quint64 violations = 0;
+	int checkedScopes = 0; // crosshairMove, yAxisRangeChanged, yRangeSpin
+	for (const AllocProfiler::ScopeStats& scope : AllocProfiler::stats()) {
+		if (!scope.expectNone) continue;
+		violations += scope.violations;
+		if (scope.calls > quint64(MeasuredFrames)) checkedScopes++;
+	}
+	if (checkedScopes < 3) {
+		out << "FAIL: not every steady-state handler ran, check the interaction setup\n";
+		return 1;
+	}
+	out << (violations ? "FAIL: steady-state handlers allocated\n" : "OK: steady-state handlers did not allocate\n");
+	out.flush();
+	return violations ? 1 : 0;
+}
@@ -0,0 +1,53 @@
+# Stand-alone allocation check of the steady-state plot interactions, not part of the application build:
+#   cd benchmarks && qmake allocbench.pro && make && QT_QPA_PLATFORM=offscreen ./allocbench
+# Builds the GUI sources with the allocation profiler (see allocprofiler.h).
+QT += core gui widgets printsupport svg network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = allocbench
+TEMPLATE = app
+
+DEFINES += PNA_ALLOC_PROFILING
+
+include(../pnacore.pri)
+
+SOURCES += \
+    allocbench.cpp \
+    ../allocprofiler.cpp \
+    ../phasenoiseanalyzerapp.cpp \
+    ../qcustomplot.cpp \
+    ../plotexporter.cpp \
+    ../startupprofiler.cpp \
+    ../singleinstance.cpp \
+    ../workspace.cpp \
+    ../datasetregistry.cpp \
+    ../legendpanel.cpp \
+    ../mappedgraph.cpp \
+    ../memorybudget.cpp \
+    ../memorypanel.cpp \
+    ../pngstreamwriter.cpp \
+    ../stallwatchdog.cpp \
+    ../stallpanel.cpp \
+    ../siaxisticker.cpp \
+    ../indexedgraph.cpp \
+    ../monotonelinerasterizer.cpp \
+    ../annotationlayer.cpp
+
+HEADERS += \
+    ../phasenoiseanalyzerapp.h \
+    ../qcustomplot.h \
+    ../plotexporter.h \
+    ../singleinstance.h \
+    ../legendpanel.h \
+    ../mappedgraph.h \
+    ../memorypanel.h \
+    ../stallwatchdog.h \
+    ../stallpanel.h \
+    ../siaxisticker.h \
+    ../indexedgraph.h \
+    ../monotonelinerasterizer.h \
+    ../annotationlayer.h
+
+RESOURCES += ../phasenoiseanalyzerapp.qrc
@@ -0,0 +1,145 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+// Compares plot annotations made of one QCPItemTracer + QCPItemText per point
+// (the way spot noise markers were drawn) against a single AnnotationLayer with
+// the same markers and labels: creation, first frame, redraws and pans.
+// The AnnotationLayer drops overlapping labels, the item version draws them all.
+
+#include "annotationlayer.h"
+#include "qcustomplot.h"
+#include "benchutil.h"
+
+#include <QApplication>
+#include <QTextStream>
+
+#include <cmath>
+
+namespace {
+
+constexpr int Annotations = 10000;
+constexpr int Frames = 20;
+
+double annotationKey(int i)
+{
+	return std::pow(10.0, 1.0 + 6.0 * i / (Annotations - 1)); // 10 Hz .. 10 MHz
+}
+
+double annotationValue(int i)
+{
+	return -80.0 - 10.0 * std::log10(annotationKey(i)) + 20.0 * std::sin(0.37 * i);
+}
+
+QString annotationText(int i)
+{
+	return QString("%1 Hz\n%2 dBc/Hz").arg(annotationKey(i), 0, 'g', 4).arg(annotationValue(i), 0, 'f', 1);
+}
+
+void setupPlot(QCustomPlot& plot)
+{
+	plot.resize(1600, 900);
+	plot.xAxis->setScaleType(QCPAxis::stLogarithmic);
+	plot.xAxis->setRange(10.0, 1e7);
+	plot.yAxis->setRange(-200.0, -50.0);
+	plot.show();
+}
+
+void addItems(QCustomPlot& plot, const QFont& font)
+{
+	for (int i = 0; i < Annotations; ++i) {
+		QCPItemTracer* tracer = new QCPItemTracer(&plot);
+		tracer->position->setCoords(annotationKey(i), annotationValue(i));
+		tracer->setStyle(QCPItemTracer::tsCircle);
+		tracer->setPen(QPen(Qt::blue));
+		tracer->setBrush(Qt::blue);
+		tracer->setSize(6);
+		QCPItemText* label = new QCPItemText(&plot);
+		label->setText(annotationText(i));
+		label->setFont(font);
+		label->setBrush(QBrush(Qt::white));
+		label->setPen(QPen(Qt::NoPen));
+		label->setPadding(QMargins(3, 3, 3, 3));
+		label->position->setParentAnchor(tracer->position);
+		label->position->setCoords(0, -25);
+	}
+}
+
+AnnotationLayer* addLayer(QCustomPlot& plot, const QFont& font)
+{
+	AnnotationLayer* layer = new AnnotationLayer(&plot);
+	AnnotationLayer::MarkerStyle marker;
+	marker.pen = QPen(Qt::blue);
+	marker.brush = QBrush(Qt::blue);
+	marker.size = 6;
+	AnnotationLayer::LabelStyle label;
+	label.font = font;
+	label.brush = QBrush(Qt::white);
+	label.padding = QMargins(3, 3, 3, 3);
+	layer->setGroupStyle(0, marker, label);
+	for (int i = 0; i < Annotations; ++i) {
+		layer->add(0, annotationKey(i), annotationValue(i), annotationText(i), QPointF(0, -25));
+	}
+	return layer;
+}
+
+// Average time of Frames replots, with an optional axis change before each
+qint64 replotNs(QCustomPlot& plot, bool pan)
+{
+	return Bench::averageNs(Frames, [&](int frame) {
+		if (pan) plot.xAxis->setRange(10.0 * std::pow(1.1, frame % 2 ? 1 : -1), 1e7);
+		plot.replot(QCustomPlot::rpImmediateRefresh);
+	});
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+	QTextStream out(stdout);
+	const QFont font(QStringLiteral("Liberation Sans"), 8);
+
+	QCustomPlot itemPlot;
+	QCustomPlot layerPlot;
+	setupPlot(itemPlot);
+	setupPlot(layerPlot);
+
+	const qint64 itemCreateNs = Bench::elapsedNs([&]() { addItems(itemPlot, font); });
+	AnnotationLayer* layer = nullptr;
+	const qint64 layerCreateNs = Bench::elapsedNs([&]() { layer = addLayer(layerPlot, font); });
+
+	// First frame: text layouts of every label
+	const qint64 itemFirstNs = Bench::elapsedNs([&]() { itemPlot.replot(QCustomPlot::rpImmediateRefresh); });
+	const qint64 layerFirstNs = Bench::elapsedNs([&]() { layerPlot.replot(QCustomPlot::rpImmediateRefresh); });
+
+	out << QString("%1 markers with labels\n").arg(Annotations);
+	Bench::header(out, "QCPItems", "AnnotationLayer");
+	Bench::report(out, "create", itemCreateNs, layerCreateNs);
+	Bench::report(out, "first frame", itemFirstNs, layerFirstNs);
+	Bench::report(out, "redraw", replotNs(itemPlot, false), replotNs(layerPlot, false));
+	Bench::report(out, "pan", replotNs(itemPlot, true), replotNs(layerPlot, true));
+	out << QString("AnnotationLayer: %1 labels dropped as overlapping in the last frame\n").arg(layer->culledLabelCount());
+	return 0;
+}
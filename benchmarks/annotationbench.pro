@@ -0,0 +1,21 @@
+# Stand-alone benchmark of plot annotations (markers with labels), not part of the application build:
+#   cd benchmarks && qmake annotationbench.pro && make && QT_QPA_PLATFORM=offscreen ./annotationbench
+QT += core gui widgets printsupport
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = annotationbench
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    annotationbench.cpp \
+    ../annotationlayer.cpp \
+    ../qcustomplot.cpp
+
+HEADERS += \
+    benchutil.h \
+    ../annotationlayer.h \
+    ../qcustomplot.h
@@ -0,0 +1,74 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef BENCHUTIL_H
+#define BENCHUTIL_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTextStream>
+
+// Shared by the stand-alone benchmarks that time an old and a new implementation of
+// the same operation and print them side by side (header() once, then report() rows)
+namespace Bench {
+
+// Nanoseconds taken by one call of function()
+template <typename Function>
+qint64 elapsedNs(Function&& function)
+{
+	QElapsedTimer timer;
+	timer.start();
+	function();
+	return timer.nsecsElapsed();
+}
+
+// Average nanoseconds of function(i) for i in [0, repeats)
+template <typename Function>
+qint64 averageNs(int repeats, Function&& function)
+{
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < repeats; ++i) function(i);
+	return timer.nsecsElapsed() / repeats;
+}
+
+inline void header(QTextStream& out, const char* oldName, const char* newName)
+{
+	out << QString("%1 %2     %3\n").arg("operation", -28).arg(QString::fromLatin1(oldName), 13).arg(QString::fromLatin1(newName));
+}
+
+// Old and new time in ms, then the speedup
+inline void report(QTextStream& out, const char* name, qint64 oldNs, qint64 newNs)
+{
+	out << QString("%1 %2 ms  %3 ms  x%4\n")
+			   .arg(QString::fromLatin1(name), -28)
+			   .arg(oldNs / 1e6, 10, 'f', 3)
+			   .arg(newNs / 1e6, 10, 'f', 3)
+			   .arg(newNs > 0 ? double(oldNs) / double(newNs) : 0.0, 0, 'f', 1);
+}
+
+} // namespace Bench
+
+#endif // BENCHUTIL_H
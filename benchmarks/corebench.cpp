@@ -0,0 +1,282 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+// Timing of the analysis core on a synthetic capture: parsing, parse cache,
+// filters, spur removal, spot and integrated noise, mask check, the batch
+// processor on one thread versus all cores, many small captures as files versus
+// as members of a pack, and the live simulator source drained through its ring buffer.
+// First checks the parser's number fast path against strtod.
+
+#include "batchprocessor.h"
+#include "coreconstants.h"
+#include "datasetcache.h"
+#include "datasetparser.h"
+#include "mappedcolumnfile.h"
+#include "packfile.h"
+#include "processing.h"
+#include "simulatorsource.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QtMath>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+namespace {
+
+constexpr int PointsPerFile = 200000;
+constexpr int BatchFiles = 32;
+constexpr int PointsPerBatchFile = 50000;
+constexpr int SmallFiles = 5000;
+constexpr int PointsPerSmallFile = 400;
+constexpr int LiveSeconds = 2;
+constexpr int LiveDisplayIntervalMs = 33; // Same as the GUI consumer
+constexpr int NumberChecks = 2000000;
+
+// Log-spaced 1 Hz .. 10 MHz, 1/f^2 then flat noise, a flat reference with a spur every 5000 points
+void writeCapture(const QString& path, int points, int seed)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return;
+	QTextStream out(&file);
+	out << "# Synthetic capture " << seed << "\n";
+	for (int i = 0; i < points; ++i) {
+		const double f = qPow(10.0, 7.0 * i / (points - 1));
+		const double noise = qMax(-170.0, -60.0 - 20.0 * std::log10(f)) + 0.5 * std::sin(i * 0.37 + seed);
+		const double ref = (i % 5000 == 2500) ? -120.0 : -175.0;
+		out << QString::number(f, 'g', 9) << "," << QString::number(noise, 'f', 3) << "," << QString::number(ref, 'f', 3) << "\n";
+	}
+}
+
+// Random numbers as %g, %f and %e with 1..17 digits and as long decimals, parsed as the
+// noise column by StreamParser and by strtod; returns how many differ in any bit
+int checkNumbers()
+{
+	std::setlocale(LC_NUMERIC, "C");
+	std::mt19937_64 random(1);
+	std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+	std::uniform_int_distribution<int> exponent(-30, 30);
+	std::uniform_int_distribution<int> digits(1, 17);
+	QByteArray text;
+	QVector<double> expected;
+	expected.reserve(NumberChecks);
+	char number[64];
+	for (int i = 0; i < NumberChecks; ++i) {
+		const double value = mantissa(random) * std::pow(10.0, exponent(random));
+		switch (i % 4) {
+		case 0: std::snprintf(number, sizeof(number), "%.*g", digits(random), value); break;
+		case 1: std::snprintf(number, sizeof(number), "%.*f", digits(random) % 10, value); break;
+		case 2: std::snprintf(number, sizeof(number), "%.*e", digits(random), value); break;
+		default:
+			std::snprintf(number, sizeof(number), "%llu.%llu", static_cast<unsigned long long>(random() % 1000000),
+						  static_cast<unsigned long long>(random() % 1000000000));
+			break;
+		}
+		expected.append(std::strtod(number, nullptr));
+		text += "1,";
+		text += number;
+		text += '\n';
+	}
+
+	DatasetParser::StreamParser parser;
+	parser.feed(text.constData(), text.size());
+	parser.finish();
+	ParsedDataset parsed;
+	if (!parser.takeSweep(&parsed) || parsed.phaseNoise.size() != expected.size()) return NumberChecks;
+	int mismatches = 0;
+	for (int i = 0; i < expected.size(); ++i) {
+		if (std::memcmp(&parsed.phaseNoise[i], &expected[i], sizeof(double)) != 0) mismatches++;
+	}
+	return mismatches;
+}
+
+template <typename Function>
+void measure(QTextStream& out, const char* name, Function&& function)
+{
+	QElapsedTimer timer;
+	timer.start();
+	function();
+	out << QString("%1 %2 ms\n").arg(QString::fromLatin1(name), -32).arg(timer.nsecsElapsed() / 1e6, 10, 'f', 3);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QTemporaryDir dir;
+	if (!dir.isValid()) return 1;
+
+	const int numberMismatches = checkNumbers();
+	out << QString("number parsing: %1 of %2 differ from strtod\n").arg(numberMismatches).arg(NumberChecks);
+	if (numberMismatches != 0) return 1;
+
+	const QString capture = dir.filePath("capture.csv");
+	writeCapture(capture, PointsPerFile, 0);
+	out << QString("%1 points per file\n").arg(PointsPerFile);
+
+	ParsedDataset parsed;
+	measure(out, "parse", [&]() { DatasetParser::parseFile(capture, &parsed); });
+	DatasetCache::instance().load(capture);
+	measure(out, "parse cache hit", [&]() { DatasetCache::instance().load(capture); });
+
+	DatasetColumns data;
+	data.frequencyOffset = parsed.frequencyOffset;
+	data.phaseNoise = parsed.phaseNoise;
+	data.referenceNoise = parsed.referenceNoise;
+	for (const QString& filter : Processing::filterTypes()) {
+		const QByteArray name = ("filter " + filter).toLatin1();
+		measure(out, name.constData(), [&]() { Processing::filterDataset(data, true, filter, 11); });
+	}
+
+	QVector<double> cleaned;
+	measure(out, "spur removal", [&]() { cleaned = Processing::removeSpurs(data.frequencyOffset, data.phaseNoise, data.referenceNoise); });
+	QVector<SpotNoisePoint> spots;
+	measure(out, "spot noise", [&]() { spots = Processing::spotNoise(data.frequencyOffset, cleaned, 0.0, 1e12); });
+	IntegratedNoise integrated;
+	measure(out, "integrated noise", [&]() { integrated = Processing::integrateNoise(data.frequencyOffset, cleaned, 10.0, 1e6); });
+	const QVector<MaskPoint> mask = {{1.0, -50.0}, {1e3, -110.0}, {1e7, -160.0}};
+	MaskVerdict verdict;
+	measure(out, "mask check", [&]() { verdict = Processing::checkMask(data.frequencyOffset, cleaned, mask); });
+
+	// Compact noise columns: memory, quantization and the kernels reading them in place
+	DerivedSettings derive;
+	derive.filtering = true;
+	derive.filterType = QStringLiteral("Median Filter");
+	derive.filterWindow = 11;
+	derive.spurRemoval = true;
+	DerivedColumns reference;
+	for (ValueStorage storage : {ValueStorage::Float64, ValueStorage::Float32, ValueStorage::CentiDb16}) {
+		DatasetColumns compact;
+		compact.frequencyOffset = parsed.frequencyOffset;
+		compact.phaseNoise = parsed.phaseNoise;
+		compact.referenceNoise = parsed.referenceNoise;
+		compact.setStorage(storage);
+		const qint64 bytes = compact.isCompact() ? compact.phaseNoiseCompact.bytes() + compact.referenceNoiseCompact.bytes()
+												 : 2 * qint64(compact.phaseNoise.size()) * qint64(sizeof(double));
+		DerivedColumns derived;
+		const QByteArray name = ("median + spurs " + MappedColumnFile::storageName(storage)).toLatin1();
+		measure(out, name.constData(), [&]() { derived = Processing::deriveColumns(compact, true, derive); });
+		if (storage == ValueStorage::Float64) reference = derived;
+		double deviation = 0.0;
+		for (int i = 0; i < derived.phaseNoiseFiltered.size(); ++i) {
+			deviation = qMax(deviation, qAbs(derived.phaseNoiseFiltered[i] - reference.phaseNoiseFiltered[i]));
+		}
+		out << QString("  %1 bytes, max quantization error %2 dB, derived curve within %3 dB of float64\n")
+				   .arg(bytes).arg(compact.phaseNoiseCompact.maxError()).arg(deviation);
+	}
+
+	// Batch: the same work per file, one thread versus the whole pool
+	QStringList files;
+	for (int i = 0; i < BatchFiles; ++i) {
+		files << dir.filePath(QString("batch_%1.csv").arg(i));
+		writeCapture(files.last(), PointsPerBatchFile, i);
+	}
+	BatchOptions options;
+	options.outputDir = dir.filePath("results");
+	options.filterType = "Median Filter";
+	options.removeSpurs = true;
+	options.writePerFile = false;
+	QDir().mkpath(options.outputDir);
+
+	options.threads = 1;
+	QElapsedTimer timer;
+	timer.start();
+	BatchProcessor::run(files, options);
+	const qint64 singleNs = timer.nsecsElapsed();
+	options.threads = QThread::idealThreadCount();
+	timer.start();
+	BatchProcessor::run(files, options);
+	const qint64 parallelNs = timer.nsecsElapsed();
+	out << QString("batch %1 files, 1 thread            %2 ms\n").arg(BatchFiles).arg(singleNs / 1e6, 10, 'f', 3);
+	out << QString("batch %1 files, %2 threads          %3 ms  x%4\n").arg(BatchFiles).arg(options.threads)
+			   .arg(parallelNs / 1e6, 10, 'f', 3).arg(parallelNs > 0 ? double(singleNs) / double(parallelNs) : 0.0, 0, 'f', 1);
+
+	// Small captures: one file each versus members of one pack (written here, read back by name)
+	QStringList smallFiles;
+	for (int i = 0; i < SmallFiles; ++i) {
+		smallFiles << dir.filePath(QString("small_%1.csv").arg(i));
+		writeCapture(smallFiles.last(), PointsPerSmallFile, i);
+	}
+	qint64 smallPoints = 0;
+	measure(out, "small files, parse each", [&]() {
+		for (const QString& file : std::as_const(smallFiles)) {
+			DatasetParser::parseFile(file, &parsed);
+			smallPoints += parsed.frequencyOffset.size();
+		}
+	});
+	const QString pack = dir.filePath("small.pnapack");
+	measure(out, "small files, pack append", [&]() { PackArchive::append(pack, smallFiles, DatasetParser::StitchOptions()); });
+	measure(out, "pack open, read every member", [&]() {
+		const QSharedPointer<PackFile> packFile = PackFile::open(pack);
+		for (int i = 0; packFile && i < packFile->count(); ++i) {
+			packFile->read(i, &parsed);
+			smallPoints += parsed.frequencyOffset.size();
+		}
+	});
+	measure(out, "pack members by path", [&]() {
+		for (int i = 0; i < SmallFiles; i += 7) {
+			DatasetParser::parseFile(PackFile::memberPath(pack, QString("small_%1.csv").arg(i)), &parsed);
+			smallPoints += parsed.frequencyOffset.size();
+		}
+	});
+
+	// Live: simulator paced at display-like and unpaced rates, consumer polling like the GUI timer
+	for (double rate : {100.0, 0.0}) {
+		SimulatorSource::Settings settings;
+		settings.sweepsPerSecond = rate;
+		SimulatorSource source(settings);
+		source.start();
+		QVector<SweepFrame> frames;
+		double latencySumMs = 0.0;
+		timer.start();
+		while (timer.elapsed() < LiveSeconds * 1000) {
+			QThread::msleep(LiveDisplayIntervalMs);
+			frames.clear();
+			source.drain(&frames, Constants::LIVE_BUFFER_FRAMES);
+			latencySumMs += frames.isEmpty() ? 0.0 : source.stats().lastLatencyMs;
+		}
+		source.stop();
+		const LiveDataSource::Stats stats = source.stats();
+		const double ticks = double(LiveSeconds * 1000) / LiveDisplayIntervalMs;
+		out << QString("live %1 sweeps/s (%2 points)  %3 sweeps/s produced, %4 dropped, latency %5 ms avg %6 ms max\n")
+				   .arg(rate > 0 ? QString::number(rate) : QString("max")).arg(settings.points)
+				   .arg(double(stats.produced) / LiveSeconds, 0, 'f', 0).arg(stats.dropped)
+				   .arg(latencySumMs / ticks, 0, 'f', 2).arg(stats.maxLatencyMs, 0, 'f', 2);
+	}
+
+	out << QString("(checksum %1 %2 %3 %4 %5)\n").arg(spots.size()).arg(integrated.integratedDbc, 0, 'f', 3)
+			   .arg(verdict.worstMargin, 0, 'f', 3).arg(cleaned.size()).arg(smallPoints);
+	return 0;
+}
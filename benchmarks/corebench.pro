@@ -0,0 +1,14 @@
+# Stand-alone benchmark of the analysis core (QtCore only), not part of the application build:
+#   cd benchmarks && qmake corebench.pro && make && ./corebench
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = corebench
+TEMPLATE = app
+
+include(../pnacore.pri)
+
+SOURCES += \
+    corebench.cpp
@@ -0,0 +1,143 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+// Compares click and rectangle hit testing of plain QCPGraphs against IndexedGraph
+// on two identical plots with many dense traces, the way QCustomPlot runs them for
+// a mouse click (plottableAt over every plottable) and a selection rectangle
+// (selectTestRect per graph). Also counts clicks / rectangles where both disagree.
+
+#include "indexedgraph.h"
+#include "qcustomplot.h"
+#include "benchutil.h"
+
+#include <QApplication>
+#include <QTextStream>
+
+#include <cmath>
+#include <functional>
+
+namespace {
+
+constexpr int GraphCount = 300;
+constexpr int PointsPerGraph = 20000;
+constexpr int Clicks = 200;
+constexpr int Rects = 50;
+
+void fillGraph(QCPGraph* graph, int seed)
+{
+	QVector<double> keys(PointsPerGraph);
+	QVector<double> values(PointsPerGraph);
+	for (int i = 0; i < PointsPerGraph; ++i) {
+		keys[i] = std::pow(10.0, 1.0 + 6.0 * i / (PointsPerGraph - 1)); // 10 Hz .. 10 MHz
+		const double decades = std::log10(keys[i]);
+		values[i] = -60.0 - 15.0 * decades - 0.2 * seed + 3.0 * std::sin(0.01 * i + seed);
+	}
+	graph->setData(keys, values, true);
+	graph->setSelectable(QCP::stDataRange);
+}
+
+void setupPlot(QCustomPlot& plot, const std::function<QCPGraph*()>& addGraph)
+{
+	plot.resize(1600, 900);
+	plot.xAxis->setScaleType(QCPAxis::stLogarithmic);
+	plot.xAxis->setRange(10.0, 1e7);
+	plot.yAxis->setRange(-240.0, -50.0);
+	for (int i = 0; i < GraphCount; ++i) fillGraph(addGraph(), i);
+	plot.show();
+	plot.replot();
+}
+
+QPointF clickPosition(const QRect& area, int i)
+{
+	return QPointF(area.left() + 1 + (i * 37) % (area.width() - 2), area.top() + 1 + (i * 53) % (area.height() - 2));
+}
+
+QRectF selectionRect(const QRect& area, int i)
+{
+	const QPointF topLeft = clickPosition(area, i * 3);
+	return QRectF(topLeft, QSizeF(40 + (i * 17) % 200, 30 + (i * 11) % 150)).intersected(QRectF(area));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+	QTextStream out(stdout);
+
+	QCustomPlot plainPlot;
+	QCustomPlot indexedPlot;
+	setupPlot(plainPlot, [&]() { return plainPlot.addGraph(); });
+	setupPlot(indexedPlot, [&]() { return new IndexedGraph(indexedPlot.xAxis, indexedPlot.yAxis); });
+	const QRect area = plainPlot.axisRect()->rect();
+
+	out << QString("%1 graphs x %2 points\n").arg(GraphCount).arg(PointsPerGraph);
+	Bench::header(out, "QCPGraph", "IndexedGraph");
+
+	// --- Clicks: the plottable under the cursor, as QCustomPlot looks it up on mouse release ---
+	QVector<QCPAbstractPlottable*> plainHits(Clicks);
+	QVector<QCPAbstractPlottable*> indexedHits(Clicks);
+	const qint64 plainClickNs = Bench::elapsedNs([&]() {
+		for (int i = 0; i < Clicks; ++i) plainHits[i] = plainPlot.plottableAt(clickPosition(area, i), true);
+	});
+	const qint64 indexedClickNs = Bench::elapsedNs([&]() {
+		for (int i = 0; i < Clicks; ++i) indexedHits[i] = indexedPlot.plottableAt(clickPosition(area, i), true);
+	});
+	const QList<QCPAbstractPlottable*> plainGraphs = plainPlot.axisRect()->plottables();
+	const QList<QCPAbstractPlottable*> indexedGraphs = indexedPlot.axisRect()->plottables();
+	int hits = 0;
+	int clickMismatches = 0;
+	for (int i = 0; i < Clicks; ++i) {
+		if (indexedHits[i]) hits++;
+		if (indexedGraphs.indexOf(indexedHits[i]) != plainGraphs.indexOf(plainHits[i])) clickMismatches++;
+	}
+	Bench::report(out, "click hit test", plainClickNs, indexedClickNs);
+
+	// --- Selection rectangles: data ranges of every graph inside the rect ---
+	QVector<QVector<QCPDataSelection>> plainSelections(Rects);
+	const qint64 plainRectNs = Bench::elapsedNs([&]() {
+		for (int i = 0; i < Rects; ++i) {
+			const QRectF rect = selectionRect(area, i);
+			for (int g = 0; g < GraphCount; ++g) plainSelections[i].append(plainPlot.graph(g)->selectTestRect(rect, true));
+		}
+	});
+	int selectedRanges = 0;
+	int rectMismatches = 0;
+	const qint64 indexedRectNs = Bench::elapsedNs([&]() {
+		for (int i = 0; i < Rects; ++i) {
+			const QRectF rect = selectionRect(area, i);
+			for (int g = 0; g < GraphCount; ++g) {
+				const QCPDataSelection selection = indexedPlot.graph(g)->selectTestRect(rect, true);
+				selectedRanges += selection.dataRangeCount();
+				if (selection != plainSelections[i][g]) rectMismatches++;
+			}
+		}
+	});
+	Bench::report(out, "rectangle selection", plainRectNs, indexedRectNs);
+
+	out << QString("%1 of %2 clicks hit a graph, %3 differ; %4 ranges selected, %5 of %6 rect tests differ\n")
+			   .arg(hits).arg(Clicks).arg(clickMismatches).arg(selectedRanges).arg(rectMismatches).arg(Rects * GraphCount);
+	return 0;
+}
@@ -0,0 +1,23 @@
+# Stand-alone benchmark of click / rectangle hit testing with many graphs, not part of the application build:
+#   cd benchmarks && qmake hittestbench.pro && make && QT_QPA_PLATFORM=offscreen ./hittestbench
+QT += core gui widgets printsupport
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = hittestbench
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    hittestbench.cpp \
+    ../indexedgraph.cpp \
+    ../monotonelinerasterizer.cpp \
+    ../qcustomplot.cpp
+
+HEADERS += \
+    benchutil.h \
+    ../indexedgraph.h \
+    ../monotonelinerasterizer.h \
+    ../qcustomplot.h
@@ -0,0 +1,126 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+// Draws the same dense traces (1.5 px antialiased pens, as the measured graphs)
+// with QPainter and with IndexedGraph's fast lines (MonotoneLineRasterizer), on
+// two identical plots: replots into QCustomPlot's pixmap paint buffers, renders
+// into a QImage, and how far the two images are apart.
+
+#include "indexedgraph.h"
+#include "qcustomplot.h"
+#include "benchutil.h"
+
+#include <QApplication>
+#include <QTextStream>
+
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+constexpr int GraphCount = 50;
+constexpr int PointsPerGraph = 20000;
+constexpr int Frames = 10;
+
+void setupPlot(QCustomPlot& plot, bool fastLines)
+{
+	plot.resize(1600, 900);
+	plot.xAxis->setScaleType(QCPAxis::stLogarithmic);
+	plot.xAxis->setRange(10.0, 1e7);
+	plot.yAxis->setRange(-200.0, -50.0);
+	for (int g = 0; g < GraphCount; ++g) {
+		IndexedGraph* graph = new IndexedGraph(plot.xAxis, plot.yAxis);
+		graph->setFastLines(fastLines);
+		graph->setPen(QPen(QColor::fromHsv((g * 37) % 360, 200, 200), 1.5));
+		QVector<double> keys(PointsPerGraph);
+		QVector<double> values(PointsPerGraph);
+		for (int i = 0; i < PointsPerGraph; ++i) {
+			keys[i] = std::pow(10.0, 1.0 + 6.0 * i / (PointsPerGraph - 1)); // 10 Hz .. 10 MHz
+			values[i] = -70.0 - 12.0 * std::log10(keys[i]) - 0.5 * g + 2.0 * std::sin(0.05 * i + g) + 1.5 * std::sin(1.3 * i);
+		}
+		graph->setData(keys, values, true);
+	}
+	plot.show();
+}
+
+qint64 replotNs(QCustomPlot& plot)
+{
+	return Bench::averageNs(Frames, [&](int) { plot.replot(QCustomPlot::rpImmediateRefresh); });
+}
+
+QImage renderImage(QCustomPlot& plot, qint64* ns)
+{
+	QImage image(plot.size(), QImage::Format_ARGB32_Premultiplied);
+	*ns = Bench::averageNs(Frames, [&](int) {
+		image.fill(Qt::white);
+		QCPPainter painter(&image);
+		plot.toPainter(&painter, image.width(), image.height());
+	});
+	return image;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+	QTextStream out(stdout);
+
+	QCustomPlot painterPlot;
+	QCustomPlot fastPlot;
+	setupPlot(painterPlot, false);
+	setupPlot(fastPlot, true);
+	painterPlot.replot(QCustomPlot::rpImmediateRefresh);
+	fastPlot.replot(QCustomPlot::rpImmediateRefresh);
+
+	out << QString("%1 graphs x %2 points, 1.5 px antialiased\n").arg(GraphCount).arg(PointsPerGraph);
+	Bench::header(out, "QPainter", "fast lines");
+	Bench::report(out, "replot (pixmap buffers)", replotNs(painterPlot), replotNs(fastPlot));
+	qint64 painterImageNs = 0;
+	qint64 fastImageNs = 0;
+	const QImage painterImage = renderImage(painterPlot, &painterImageNs);
+	const QImage fastImage = renderImage(fastPlot, &fastImageNs);
+	Bench::report(out, "render into QImage", painterImageNs, fastImageNs);
+
+	// Largest channel difference per pixel
+	qint64 differenceSum = 0;
+	int differing = 0;
+	int maxDifference = 0;
+	for (int y = 0; y < painterImage.height(); ++y) {
+		const QRgb* a = reinterpret_cast<const QRgb*>(painterImage.constScanLine(y));
+		const QRgb* b = reinterpret_cast<const QRgb*>(fastImage.constScanLine(y));
+		for (int x = 0; x < painterImage.width(); ++x) {
+			const int difference = qMax(qMax(std::abs(qRed(a[x]) - qRed(b[x])), std::abs(qGreen(a[x]) - qGreen(b[x]))),
+										std::abs(qBlue(a[x]) - qBlue(b[x])));
+			differenceSum += difference;
+			if (difference > 64) differing++;
+			maxDifference = qMax(maxDifference, difference);
+		}
+	}
+	const double pixels = double(painterImage.width()) * painterImage.height();
+	out << QString("pixel difference: mean %1, max %2, %3% of pixels over 64\n")
+			   .arg(differenceSum / pixels, 0, 'f', 3).arg(maxDifference).arg(100.0 * differing / pixels, 0, 'f', 3);
+	return 0;
+}
@@ -0,0 +1,23 @@
+# Stand-alone benchmark of trace line drawing, QPainter against MonotoneLineRasterizer, not part of the application build:
+#   cd benchmarks && qmake linebench.pro && make && QT_QPA_PLATFORM=offscreen ./linebench
+QT += core gui widgets printsupport
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = linebench
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    linebench.cpp \
+    ../indexedgraph.cpp \
+    ../monotonelinerasterizer.cpp \
+    ../qcustomplot.cpp
+
+HEADERS += \
+    benchutil.h \
+    ../indexedgraph.h \
+    ../monotonelinerasterizer.h \
+    ../qcustomplot.h
@@ -0,0 +1,182 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+// Compares DatasetRegistry against the former QList<PlotData> storage for the
+// operations the application performs per dataset: append, plottable lookup
+// (legend click / context menu), per-update iteration and removal.
+
+#include "datasetregistry.h"
+#include "qcustomplot.h"
+#include "benchutil.h"
+
+#include <QCoreApplication>
+#include <QList>
+#include <QTextStream>
+
+#include <utility>
+
+namespace {
+
+constexpr int DatasetCount = 5000;
+constexpr int PointsPerDataset = 1000;
+
+// Layout of the storage before the registry
+struct PlotData {
+	QString filename;
+	QString displayName;
+	QVector<double> frequencyOffset;
+	QVector<double> phaseNoise;
+	QVector<double> referenceNoise;
+	QVector<double> phaseNoiseFiltered;
+	QVector<double> referenceNoiseFiltered;
+	bool hasReferenceData = false;
+	bool isVisible = true;
+	QColor measuredColor;
+	QColor referenceColor;
+	QCPGraph* graphMeasured = nullptr;
+	QCPGraph* graphReference = nullptr;
+	QCPGraph* graphReferenceOutline = nullptr;
+	QCPGraph* fillReferenceBase = nullptr;
+};
+
+// Graph pointers are only used as lookup keys here, never dereferenced
+QCPGraph* fakeGraph(int datasetIndex, int which)
+{
+	return reinterpret_cast<QCPGraph*>(quintptr(0x10000) + quintptr(datasetIndex * 4 + which) * 64);
+}
+
+void fillColumns(QVector<double>& freq, QVector<double>& noise, QVector<double>& ref, int seed)
+{
+	freq.resize(PointsPerDataset);
+	noise.resize(PointsPerDataset);
+	ref.resize(PointsPerDataset);
+	for (int i = 0; i < PointsPerDataset; ++i) {
+		freq[i] = 10.0 * (i + 1);
+		noise[i] = -80.0 - 0.01 * i - seed % 7;
+		ref[i] = -150.0;
+	}
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	qint64 oldNs = 0;
+	qint64 newNs = 0;
+
+	out << QString("%1 datasets x %2 points\n").arg(DatasetCount).arg(PointsPerDataset);
+	Bench::header(out, "QList<PlotData>", "DatasetRegistry");
+
+	// --- Append (loadData) ---
+	QList<PlotData> oldStorage;
+	oldNs = Bench::elapsedNs([&]() {
+		for (int i = 0; i < DatasetCount; ++i) {
+			PlotData data;
+			data.filename = QString("/data/capture_%1.csv").arg(i);
+			data.displayName = QString("capture_%1").arg(i);
+			fillColumns(data.frequencyOffset, data.phaseNoise, data.referenceNoise, i);
+			data.hasReferenceData = true;
+			data.phaseNoiseFiltered = data.phaseNoise;
+			data.referenceNoiseFiltered = data.referenceNoise;
+			data.graphMeasured = fakeGraph(i, 0);
+			data.graphReference = fakeGraph(i, 1);
+			oldStorage.append(data);
+		}
+	});
+
+	DatasetRegistry registry;
+	newNs = Bench::elapsedNs([&]() {
+		registry.reserve(DatasetCount);
+		for (int i = 0; i < DatasetCount; ++i) {
+			DatasetColumns columns;
+			fillColumns(columns.frequencyOffset, columns.phaseNoise, columns.referenceNoise, i);
+			columns.phaseNoiseFiltered = columns.phaseNoise;
+			columns.referenceNoiseFiltered = columns.referenceNoise;
+			const DatasetRegistry::Handle handle = registry.add(QString("/data/capture_%1.csv").arg(i), QString("capture_%1").arg(i), true, std::move(columns));
+			DatasetGraphs graphs;
+			graphs.measured = fakeGraph(i, 0);
+			graphs.reference = fakeGraph(i, 1);
+			registry.setGraphs(handle, graphs);
+		}
+	});
+	Bench::report(out, "append", oldNs, newNs);
+
+	// --- Plottable -> dataset for every legend entry ---
+	int found = 0;
+	oldNs = Bench::elapsedNs([&]() {
+		for (int i = 0; i < DatasetCount; ++i) {
+			const QCPAbstractPlottable* plottable = fakeGraph(i, 1);
+			for (int j = 0; j < oldStorage.size(); ++j) {
+				if (oldStorage[j].graphMeasured == plottable || oldStorage[j].graphReference == plottable) {
+					found++;
+					break;
+				}
+			}
+		}
+	});
+	newNs = Bench::elapsedNs([&]() {
+		for (int i = 0; i < DatasetCount; ++i) {
+			if (registry.handleForPlottable(fakeGraph(i, 1)) != DatasetRegistry::InvalidHandle) found++;
+		}
+	});
+	Bench::report(out, "lookup by plottable (all)", oldNs, newNs);
+
+	// --- Per-update scan of metadata ---
+	constexpr int Passes = 1000;
+	int visibleCount = 0;
+	oldNs = Bench::elapsedNs([&]() {
+		for (int pass = 0; pass < Passes; ++pass) {
+			for (const PlotData& data : std::as_const(oldStorage)) {
+				if (data.isVisible && data.hasReferenceData) visibleCount++;
+			}
+		}
+	});
+	newNs = Bench::elapsedNs([&]() {
+		for (int pass = 0; pass < Passes; ++pass) {
+			for (DatasetRegistry::Handle handle : registry.handles()) {
+				if (registry.isVisible(handle) && registry.hasReferenceData(handle)) visibleCount++;
+			}
+		}
+	});
+	Bench::report(out, "visibility scan x1000", oldNs, newNs);
+
+	// --- Remove every other dataset, front to back ---
+	oldNs = Bench::elapsedNs([&]() {
+		for (int i = 0; i < DatasetCount / 2; ++i) {
+			oldStorage.removeAt(i);
+		}
+	});
+	newNs = Bench::elapsedNs([&]() {
+		for (int i = 0; i < DatasetCount; i += 2) {
+			registry.remove(i); // Handles are 0..N-1 in insertion order
+		}
+	});
+	Bench::report(out, "remove half", oldNs, newNs);
+
+	out << QString("(checksum %1 %2 %3)\n").arg(found).arg(visibleCount).arg(registry.size() + oldStorage.size());
+	return 0;
+}
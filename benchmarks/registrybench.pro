@@ -0,0 +1,21 @@
+# Stand-alone benchmark of the dataset registry, not part of the application build:
+#   cd benchmarks && qmake registrybench.pro && make && ./registrybench
+QT += core gui widgets printsupport
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = registrybench
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    registrybench.cpp \
+    ../datasetregistry.cpp \
+    ../qcustomplot.cpp
+
+HEADERS += \
+    benchutil.h \
+    ../datasetregistry.h \
+    ../qcustomplot.h
@@ -0,0 +1,98 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "compactcolumn.h"
+
+template <typename T>
+void CompactColumn::encodeValues(const QVector<double>& values, QVector<T>& stored)
+{
+	stored.resize(values.size());
+	double sumSquaredError = 0.0;
+	qint64 measured = 0;
+	for (int i = 0; i < values.size(); ++i) {
+		const T v = ValueCodec<T>::encode(values[i], m_offset);
+		stored[i] = v;
+		if (!ValueCodec<T>::missing(v)) { // Missing stays missing, nothing to measure
+			const double error = qAbs(ValueCodec<T>::decode(v, m_offset) - values[i]);
+			m_maxError = qMax(m_maxError, error);
+			sumSquaredError += error * error;
+			++measured;
+		}
+	}
+	m_rmsError = measured > 0 ? std::sqrt(sumSquaredError / double(measured)) : 0.0;
+}
+
+CompactColumn CompactColumn::encode(const QVector<double>& values, ValueStorage storage)
+{
+	CompactColumn column;
+	column.m_size = values.size();
+
+	if (storage == ValueStorage::CentiDb16) {
+		double minValue = std::numeric_limits<double>::infinity();
+		double maxValue = -std::numeric_limits<double>::infinity();
+		for (double v : values) {
+			if (v < minValue) minValue = v;
+			if (v > maxValue) maxValue = v;
+		}
+		if (minValue <= maxValue && !ValueCodec<qint16>::offsetFor(minValue, maxValue, &column.m_offset)) {
+			column.m_offset = 0.0;
+			storage = ValueStorage::Float32;
+		}
+	}
+
+	column.m_storage = storage;
+	switch (storage) {
+	case ValueStorage::Float32: column.encodeValues(values, column.m_float); break;
+	case ValueStorage::CentiDb16: column.encodeValues(values, column.m_centiDb); break;
+	default: column.m_double = values; break; // Shared, exact
+	}
+	return column;
+}
+
+QVector<double> CompactColumn::decode() const
+{
+	if (m_storage == ValueStorage::Float64) return m_double;
+	return visit([](const auto& view) {
+		QVector<double> values(view.size());
+		for (int i = 0; i < view.size(); ++i) values[i] = view[i];
+		return values;
+	});
+}
+
+double CompactColumn::value(int index) const
+{
+	switch (m_storage) {
+	case ValueStorage::Float32: return ValueCodec<float>::decode(m_float[index], 0.0);
+	case ValueStorage::CentiDb16: return ValueCodec<qint16>::decode(m_centiDb[index], m_offset);
+	default: return m_double[index];
+	}
+}
+
+qint64 CompactColumn::bytes() const
+{
+	return qint64(m_double.capacity()) * qint64(sizeof(double))
+		+ qint64(m_float.capacity()) * qint64(sizeof(float))
+		+ qint64(m_centiDb.capacity()) * qint64(sizeof(qint16));
+}
@@ -0,0 +1,140 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef COMPACTCOLUMN_H
+#define COMPACTCOLUMN_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <cmath>
+#include <limits>
+
+// Storage type of noise values (dBc/Hz), in column files (.pnacol) and in memory (CompactColumn)
+enum class ValueStorage : quint32 {
+	Float64 = 0,
+	Float32 = 1,
+	CentiDb16 = 2 // qint16 hundredths of a dB relative to the column offset, ValueCodec<qint16>::Missing for NaN
+};
+
+// Encoding of one stored value type; kernels reading compact values are instantiated per type
+template <typename T> struct ValueCodec;
+
+template <> struct ValueCodec<double> {
+	static bool missing(double v) { return std::isnan(v); }
+	static double decode(double v, double) { return v; }
+	static double encode(double v, double) { return v; }
+};
+
+template <> struct ValueCodec<float> {
+	static bool missing(float v) { return std::isnan(v); }
+	static double decode(float v, double) { return double(v); }
+	static float encode(double v, double) { return float(v); }
+};
+
+template <> struct ValueCodec<qint16> {
+	static constexpr qint16 Missing = -32768;
+	static bool missing(qint16 v) { return v == Missing; }
+	static double decode(qint16 v, double offset) { return missing(v) ? std::numeric_limits<double>::quiet_NaN() : offset + v * 0.01; }
+	static qint16 encode(double v, double offset) {
+		if (std::isnan(v)) return Missing;
+		const double steps = std::round((v - offset) * 100.0);
+		return qint16(qBound(-32767.0, steps, 32767.0));
+	}
+	// Offset centring [minValue, maxValue] on whole dB. False if the range does not fit in +-327.67 dB.
+	static bool offsetFor(double minValue, double maxValue, double* offset) {
+		*offset = std::round((minValue + maxValue) / 2.0);
+		return (maxValue - *offset) * 100.0 <= 32767.0 && (*offset - minValue) * 100.0 <= 32767.0;
+	}
+};
+
+// Read-only view of stored values, decoded on access. The filter and spur removal
+// kernels (Utils, Processing) are templates over a column with size() and a
+// double-returning operator[]: QVector<double> or one of these views.
+template <typename T>
+class CompactView
+{
+public:
+	CompactView(const T* data, int size, double offset) : m_data(data), m_size(size), m_offset(offset) {}
+
+	int size() const { return m_size; }
+	bool isEmpty() const { return m_size == 0; }
+	double operator[](int index) const { return ValueCodec<T>::decode(m_data[index], m_offset); }
+
+private:
+	const T* m_data;
+	int m_size;
+	double m_offset;
+};
+
+/*
+ * Noise column held in memory in one of the ValueStorage types: float32 halves and
+ * int16 centi-dB quarters the bytes of the float64 column. encode() records the
+ * quantization error it introduced, like MappedColumnWriter does for files.
+ *
+ * Kernels read the values in their stored type through visit(), which calls a
+ * generic function with the matching CompactView; no float64 copy is made.
+ */
+class CompactColumn
+{
+public:
+	// CentiDb16 falls back to Float32 when the values span more than +-327.67 dB around their centre
+	static CompactColumn encode(const QVector<double>& values, ValueStorage storage);
+	QVector<double> decode() const;
+
+	ValueStorage storage() const { return m_storage; }
+	int size() const { return m_size; }
+	bool isEmpty() const { return m_size == 0; }
+	double value(int index) const;
+	qint64 bytes() const; // Allocated, for memory accounting
+
+	// Error introduced by the encoding, in dB (0 for float64)
+	double maxError() const { return m_maxError; }
+	double rmsError() const { return m_rmsError; }
+
+	template <typename Function>
+	auto visit(Function&& function) const
+	{
+		switch (m_storage) {
+		case ValueStorage::Float32: return function(CompactView<float>(m_float.constData(), m_size, 0.0));
+		case ValueStorage::CentiDb16: return function(CompactView<qint16>(m_centiDb.constData(), m_size, m_offset));
+		default: return function(CompactView<double>(m_double.constData(), m_size, 0.0));
+		}
+	}
+
+private:
+	template <typename T>
+	void encodeValues(const QVector<double>& values, QVector<T>& stored);
+
+	ValueStorage m_storage = ValueStorage::Float64;
+	int m_size = 0;
+	double m_offset = 0.0; // CentiDb16 only
+	double m_maxError = 0.0;
+	double m_rmsError = 0.0;
+	QVector<double> m_double;
+	QVector<float> m_float;
+	QVector<qint16> m_centiDb;
+};
+
+#endif // COMPACTCOLUMN_H
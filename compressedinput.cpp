@@ -0,0 +1,685 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "compressedinput.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+
+#ifdef PNA_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+constexpr qint64 BLOCK_BYTES = 1 << 20; // Per pipeline buffer, like the plain-text read chunks
+
+// --- Inflate (RFC 1951) ---
+
+constexpr int WINDOW_BYTES = 32768;
+constexpr int FLUSH_BYTES = 256 * 1024; // Output collected before it is handed on
+constexpr int MAX_MATCH = 258;
+constexpr int FAST_BITS = 9; // Codes up to this length decode with one table lookup
+constexpr int MAX_SYMBOLS = 288;
+
+constexpr int LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+								 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr int LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr int DIST_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+							   1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr int DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr int CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+int reverseBits(int value, int bits)
+{
+	int result = 0;
+	for (int i = 0; i < bits; ++i, value >>= 1) result = (result << 1) | (value & 1);
+	return result;
+}
+
+quint32 crc32Update(quint32 crc, const char* data, qint64 size)
+{
+	static const std::array<quint32, 256> table = [] {
+		std::array<quint32, 256> t{};
+		for (quint32 n = 0; n < 256; ++n) {
+			quint32 c = n;
+			for (int k = 0; k < 8; ++k) c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+			t[n] = c;
+		}
+		return t;
+	}();
+	for (qint64 i = 0; i < size; ++i) {
+		crc = table[(crc ^ static_cast<quint8>(data[i])) & 0xff] ^ (crc >> 8);
+	}
+	return crc;
+}
+
+// Canonical Huffman code: a FAST_BITS lookup table (bit-reversed, as the codes arrive
+// LSB first), then the codes ordered by length for the rare longer ones
+struct HuffmanTable {
+	quint16 fast[1 << FAST_BITS]; // (length << 9) | symbol, 0 = longer code
+	int firstCode[16];
+	int maxCode[17]; // Shifted to 16 bits
+	int firstSymbol[16];
+	quint8 length[MAX_SYMBOLS];
+	quint16 symbol[MAX_SYMBOLS];
+
+	bool build(const quint8* lengths, int count)
+	{
+		int counts[16] = {};
+		std::memset(fast, 0, sizeof(fast));
+		for (int i = 0; i < count; ++i) counts[lengths[i]]++;
+		counts[0] = 0;
+		int nextCode[16];
+		int code = 0;
+		int index = 0;
+		for (int bits = 1; bits < 16; ++bits) {
+			nextCode[bits] = code;
+			firstCode[bits] = code;
+			firstSymbol[bits] = index;
+			code += counts[bits];
+			if (counts[bits] && code - 1 >= (1 << bits)) return false; // Oversubscribed
+			maxCode[bits] = code << (16 - bits);
+			code <<= 1;
+			index += counts[bits];
+		}
+		maxCode[16] = 0x10000;
+		for (int i = 0; i < count; ++i) {
+			const int bits = lengths[i];
+			if (!bits) continue;
+			const int slot = nextCode[bits] - firstCode[bits] + firstSymbol[bits];
+			length[slot] = quint8(bits);
+			symbol[slot] = quint16(i);
+			if (bits <= FAST_BITS) {
+				for (int j = reverseBits(nextCode[bits], bits); j < (1 << FAST_BITS); j += (1 << bits)) {
+					fast[j] = quint16((bits << 9) | i);
+				}
+			}
+			nextCode[bits]++;
+		}
+		return true;
+	}
+};
+
+/*
+ * Decoder for one gzip file held in memory (mapped). The output goes through a
+ * buffer keeping the last 32 KiB for back references and is handed to `output`
+ * every FLUSH_BYTES.
+ */
+class Inflater
+{
+public:
+	explicit Inflater(std::function<void(const char*, qint64)> output)
+		: m_output(std::move(output)),
+		  m_buffer(WINDOW_BYTES + FLUSH_BYTES + MAX_MATCH, Qt::Uninitialized),
+		  m_out(m_buffer.data())
+	{
+	}
+
+	bool gunzip(const quint8* data, qint64 size, QString* error);
+
+private:
+	bool inflate(const quint8* data, qint64 size, qint64* consumed, QString* error);
+	bool inflateBlock(const HuffmanTable& literals, const HuffmanTable& distances);
+	bool readDynamicTables(HuffmanTable* literals, HuffmanTable* distances);
+
+	void refill()
+	{
+		while (m_bitCount <= 56) {
+			const quint64 byte = (m_pos < m_size) ? m_in[m_pos] : 0; // Zeros past the end, caught by the overrun check
+			m_pos++;
+			m_bits |= byte << m_bitCount;
+			m_bitCount += 8;
+		}
+	}
+	int bits(int count)
+	{
+		if (m_bitCount < count) refill();
+		const int value = int(m_bits & ((quint64(1) << count) - 1));
+		m_bits >>= count;
+		m_bitCount -= count;
+		return value;
+	}
+	int decode(const HuffmanTable& table)
+	{
+		if (m_bitCount < 16) refill();
+		const int entry = table.fast[m_bits & ((1 << FAST_BITS) - 1)];
+		if (entry) {
+			m_bits >>= (entry >> 9);
+			m_bitCount -= (entry >> 9);
+			return entry & 511;
+		}
+		const int code = reverseBits(int(m_bits & 0xffff), 16);
+		int length = FAST_BITS + 1;
+		while (code >= table.maxCode[length]) length++;
+		if (length >= 16) return -1;
+		const int slot = (code >> (16 - length)) - table.firstCode[length] + table.firstSymbol[length];
+		if (slot >= MAX_SYMBOLS || table.length[slot] != length) return -1;
+		m_bits >>= length;
+		m_bitCount -= length;
+		return table.symbol[slot];
+	}
+	bool overrun() const { return m_pos - m_bitCount / 8 > m_size; }
+
+	// Output
+	void reserve(int count)
+	{
+		if (m_used + count > m_buffer.size()) flush();
+	}
+	void flush()
+	{
+		emitPending();
+		const int keep = qMin(m_used, WINDOW_BYTES);
+		std::memmove(m_out, m_out + m_used - keep, size_t(keep));
+		m_used = keep;
+		m_emitted = keep;
+	}
+	void emitPending()
+	{
+		const int count = m_used - m_emitted;
+		if (count <= 0) return;
+		m_crc = crc32Update(m_crc, m_out + m_emitted, count);
+		m_total += count;
+		m_output(m_out + m_emitted, count);
+		m_emitted = m_used;
+	}
+
+	std::function<void(const char*, qint64)> m_output;
+	QByteArray m_buffer;
+	char* m_out; // m_buffer's data, never reallocated
+	int m_used = 0;
+	int m_emitted = 0;
+	quint32 m_crc = 0xffffffffu;
+	quint64 m_total = 0;
+
+	const quint8* m_in = nullptr;
+	qint64 m_size = 0;
+	qint64 m_pos = 0;
+	quint64 m_bits = 0;
+	int m_bitCount = 0;
+};
+
+bool Inflater::gunzip(const quint8* data, qint64 size, QString* error)
+{
+	auto le32 = [](const quint8* p) { return quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16) | (quint32(p[3]) << 24); };
+	qint64 pos = 0;
+	int members = 0;
+	while (pos < size) {
+		const bool magic = size - pos >= 2 && data[pos] == 0x1f && data[pos + 1] == 0x8b;
+		if (!magic && members > 0 && std::all_of(data + pos, data + size, [](quint8 byte) { return byte == 0; })) {
+			break; // Zero padding after the last member (tape and block device images)
+		}
+		if (!magic || size - pos < 18) {
+			*error = magic ? QStringLiteral("truncated gzip file")
+						   : (members > 0) ? QStringLiteral("unexpected data after the gzip stream") : QStringLiteral("not a gzip file");
+			return false;
+		}
+		if (data[pos + 2] != 8) {
+			*error = QStringLiteral("unsupported gzip compression method");
+			return false;
+		}
+		const quint8 flags = data[pos + 3];
+		qint64 p = pos + 10;
+		if ((flags & 0x04) && p + 2 <= size) p += 2 + (qint64(data[p]) | (qint64(data[p + 1]) << 8)); // FEXTRA
+		for (const quint8 nameFlag : {quint8(0x08), quint8(0x10)}) { // FNAME, FCOMMENT: zero terminated
+			if (!(flags & nameFlag)) continue;
+			while (p < size && data[p]) ++p;
+			++p;
+		}
+		if (flags & 0x02) p += 2; // FHCRC
+		if (p > size) {
+			*error = QStringLiteral("truncated gzip header");
+			return false;
+		}
+
+		m_crc = 0xffffffffu;
+		m_total = 0;
+		qint64 consumed = 0;
+		if (!inflate(data + p, size - p, &consumed, error)) return false;
+		p += consumed;
+		if (p + 8 > size) {
+			*error = QStringLiteral("truncated gzip file");
+			return false;
+		}
+		if ((m_crc ^ 0xffffffffu) != le32(data + p) || quint32(m_total) != le32(data + p + 4)) {
+			*error = QStringLiteral("gzip checksum mismatch");
+			return false;
+		}
+		pos = p + 8;
+		members++;
+	}
+	return true;
+}
+
+bool Inflater::inflate(const quint8* data, qint64 size, qint64* consumed, QString* error)
+{
+	m_in = data;
+	m_size = size;
+	m_pos = 0;
+	m_bits = 0;
+	m_bitCount = 0;
+	m_used = 0;
+	m_emitted = 0;
+
+	bool last = false;
+	while (!last) {
+		last = bits(1);
+		const int type = bits(2);
+		bool ok = true;
+		if (type == 0) {
+			// Stored: byte aligned LEN, NLEN, then LEN raw bytes
+			m_bits = 0;
+			m_pos -= m_bitCount / 8;
+			m_bitCount = 0;
+			if (m_pos + 4 > m_size) {
+				*error = QStringLiteral("truncated deflate stream");
+				return false;
+			}
+			const int length = m_in[m_pos] | (m_in[m_pos + 1] << 8);
+			const int check = m_in[m_pos + 2] | (m_in[m_pos + 3] << 8);
+			m_pos += 4;
+			ok = (length == (~check & 0xffff)) && m_pos + length <= m_size;
+			for (int copied = 0; ok && copied < length;) {
+				const int count = qMin(length - copied, FLUSH_BYTES);
+				reserve(count);
+				std::memcpy(m_out + m_used, m_in + m_pos, size_t(count));
+				m_used += count;
+				m_pos += count;
+				copied += count;
+			}
+		} else if (type == 1) {
+			static const std::array<HuffmanTable, 2> fixed = [] {
+				std::array<HuffmanTable, 2> tables;
+				quint8 lengths[MAX_SYMBOLS];
+				for (int i = 0; i < MAX_SYMBOLS; ++i) lengths[i] = (i < 144) ? 8 : (i < 256) ? 9 : (i < 280) ? 7 : 8;
+				tables[0].build(lengths, MAX_SYMBOLS);
+				for (int i = 0; i < 32; ++i) lengths[i] = 5;
+				tables[1].build(lengths, 32);
+				return tables;
+			}();
+			ok = inflateBlock(fixed[0], fixed[1]);
+		} else if (type == 2) {
+			HuffmanTable literals;
+			HuffmanTable distances;
+			ok = readDynamicTables(&literals, &distances) && inflateBlock(literals, distances);
+		} else {
+			ok = false;
+		}
+		if (!ok || overrun()) {
+			*error = QStringLiteral("corrupt deflate stream");
+			return false;
+		}
+	}
+	emitPending();
+	*consumed = m_pos - m_bitCount / 8; // The rest of the last byte is padding
+	return true;
+}
+
+bool Inflater::readDynamicTables(HuffmanTable* literals, HuffmanTable* distances)
+{
+	const int literalCount = bits(5) + 257;
+	const int distanceCount = bits(5) + 1;
+	const int codeLengthCount = bits(4) + 4;
+	if (literalCount > 286 || distanceCount > 30) return false;
+
+	quint8 codeLengthLengths[19] = {};
+	for (int i = 0; i < codeLengthCount; ++i) codeLengthLengths[CODE_LENGTH_ORDER[i]] = quint8(bits(3));
+	HuffmanTable codeLengths;
+	if (!codeLengths.build(codeLengthLengths, 19)) return false;
+
+	quint8 lengths[286 + 30];
+	const int total = literalCount + distanceCount;
+	for (int n = 0; n < total;) {
+		const int symbol = decode(codeLengths);
+		if (symbol < 0) return false;
+		if (symbol < 16) {
+			lengths[n++] = quint8(symbol);
+			continue;
+		}
+		int repeat = 0;
+		quint8 value = 0;
+		if (symbol == 16) {
+			if (n == 0) return false;
+			repeat = 3 + bits(2);
+			value = lengths[n - 1];
+		} else if (symbol == 17) {
+			repeat = 3 + bits(3);
+		} else {
+			repeat = 11 + bits(7);
+		}
+		if (n + repeat > total) return false;
+		std::memset(lengths + n, value, size_t(repeat));
+		n += repeat;
+	}
+	if (lengths[256] == 0) return false; // No end-of-block code
+	return literals->build(lengths, literalCount) && distances->build(lengths + literalCount, distanceCount);
+}
+
+bool Inflater::inflateBlock(const HuffmanTable& literals, const HuffmanTable& distances)
+{
+	for (;;) {
+		int symbol = decode(literals);
+		if (symbol < 0 || overrun()) return false;
+		if (symbol < 256) {
+			reserve(1);
+			m_out[m_used++] = char(symbol);
+			continue;
+		}
+		if (symbol == 256) return true;
+		symbol -= 257;
+		if (symbol >= 29) return false;
+		const int length = LENGTH_BASE[symbol] + bits(LENGTH_EXTRA[symbol]);
+		const int distanceSymbol = decode(distances);
+		if (distanceSymbol < 0 || distanceSymbol >= 30) return false;
+		const int distance = DIST_BASE[distanceSymbol] + bits(DIST_EXTRA[distanceSymbol]);
+		reserve(length);
+		if (distance > m_used) return false; // Before the start of the stream
+		char* out = m_out + m_used;
+		const char* from = out - distance;
+		if (distance >= length) {
+			std::memcpy(out, from, size_t(length));
+		} else {
+			for (int i = 0; i < length; ++i) out[i] = from[i]; // Overlapping: repeats the last `distance` bytes
+		}
+		m_used += length;
+	}
+}
+
+// --- Pipeline ---
+
+// Two buffers alternating between the decompressing thread and the parsing thread
+class BlockPipe
+{
+public:
+	BlockPipe()
+	{
+		for (QByteArray& block : m_blocks) block.resize(int(BLOCK_BYTES));
+	}
+
+	// Producer: the next buffer to fill, once the consumer has released it
+	char* acquire(qint64* capacity)
+	{
+		QMutexLocker locker(&m_mutex);
+		while (m_published - m_released >= 2) m_changed.wait(&m_mutex);
+		*capacity = BLOCK_BYTES;
+		return m_blocks[m_published % 2].data();
+	}
+	void publish(qint64 size)
+	{
+		QMutexLocker locker(&m_mutex);
+		m_sizes[m_published % 2] = size;
+		m_published++;
+		m_changed.wakeAll();
+	}
+	void close(bool ok, const QString& error)
+	{
+		QMutexLocker locker(&m_mutex);
+		m_closed = true;
+		m_ok = ok;
+		m_error = error;
+		m_changed.wakeAll();
+	}
+
+	// Consumer: the oldest filled buffer, false once the producer closed and all were taken
+	bool next(const char** data, qint64* size)
+	{
+		QMutexLocker locker(&m_mutex);
+		while (m_released == m_published && !m_closed) m_changed.wait(&m_mutex);
+		if (m_released == m_published) return false;
+		*data = m_blocks[m_released % 2].constData();
+		*size = m_sizes[m_released % 2];
+		return true;
+	}
+	void release()
+	{
+		QMutexLocker locker(&m_mutex);
+		m_released++;
+		m_changed.wakeAll();
+	}
+
+	bool ok() const { QMutexLocker locker(&m_mutex); return m_ok; }
+	QString error() const { QMutexLocker locker(&m_mutex); return m_error; }
+
+private:
+	mutable QMutex m_mutex;
+	QWaitCondition m_changed;
+	QByteArray m_blocks[2];
+	qint64 m_sizes[2] = {0, 0};
+	quint64 m_published = 0;
+	quint64 m_released = 0;
+	bool m_closed = false;
+	bool m_ok = true;
+	QString m_error;
+};
+
+// Producer side: fills the pipe's buffers and publishes each one when full
+class BlockWriter
+{
+public:
+	explicit BlockWriter(BlockPipe* pipe) : m_pipe(pipe) {}
+
+	char* space(qint64* available)
+	{
+		if (!m_block) m_block = m_pipe->acquire(&m_capacity);
+		*available = m_capacity - m_used;
+		return m_block + m_used;
+	}
+	void commit(qint64 count)
+	{
+		m_used += count;
+		if (m_used == m_capacity) flush();
+	}
+	void write(const char* data, qint64 size)
+	{
+		while (size > 0) {
+			qint64 available = 0;
+			char* out = space(&available);
+			const qint64 count = qMin(size, available);
+			std::memcpy(out, data, size_t(count));
+			commit(count);
+			data += count;
+			size -= count;
+		}
+	}
+	void flush()
+	{
+		if (m_block && m_used > 0) m_pipe->publish(m_used);
+		if (m_used > 0) m_block = nullptr;
+		m_used = 0;
+	}
+
+private:
+	BlockPipe* m_pipe;
+	char* m_block = nullptr;
+	qint64 m_capacity = 0;
+	qint64 m_used = 0;
+};
+
+#ifdef PNA_HAVE_ZSTD
+bool decompressZstd(const quint8* data, qint64 size, BlockWriter* writer, QString* error)
+{
+	std::unique_ptr<ZSTD_DStream, size_t (*)(ZSTD_DStream*)> stream(ZSTD_createDStream(), ZSTD_freeDStream);
+	if (!stream) {
+		*error = QStringLiteral("out of memory");
+		return false;
+	}
+	ZSTD_initDStream(stream.get());
+	ZSTD_inBuffer input = {data, size_t(size), 0};
+	for (;;) {
+		qint64 available = 0;
+		char* out = writer->space(&available);
+		ZSTD_outBuffer output = {out, size_t(available), 0};
+		const size_t before = input.pos;
+		const size_t hint = ZSTD_decompressStream(stream.get(), &output, &input);
+		if (ZSTD_isError(hint)) {
+			*error = QString::fromLatin1(ZSTD_getErrorName(hint));
+			return false;
+		}
+		writer->commit(qint64(output.pos));
+		if (input.pos == input.size && hint == 0) return true; // Every frame decoded and flushed
+		if (input.pos == before && output.pos == 0) {
+			*error = QStringLiteral("truncated zstd file");
+			return false;
+		}
+	}
+}
+#endif
+
+// Runs on the decompression thread
+bool decompress(const QString& filename, CompressedInput::Format format, BlockWriter* writer, QString* error)
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly)) {
+		*error = file.errorString();
+		return false;
+	}
+	const qint64 size = file.size();
+	QByteArray contents;
+	const quint8* data = (size > 0) ? file.map(0, size) : nullptr;
+	if (!data) {
+		contents = file.readAll(); // Not mappable (special file system): the compressed size is small anyway
+		data = reinterpret_cast<const quint8*>(contents.constData());
+	}
+
+	bool ok = false;
+	if (format == CompressedInput::Format::Gzip) {
+		Inflater inflater([writer](const char* block, qint64 count) { writer->write(block, count); });
+		ok = inflater.gunzip(data, contents.isNull() ? size : contents.size(), error);
+	}
+#ifdef PNA_HAVE_ZSTD
+	else if (format == CompressedInput::Format::Zstd) {
+		ok = decompressZstd(data, contents.isNull() ? size : contents.size(), writer, error);
+	}
+#endif
+	writer->flush();
+	return ok;
+}
+
+} // namespace
+
+namespace CompressedInput {
+
+Format detect(const QByteArray& header)
+{
+	const auto byte = [&header](int i) { return quint8(header.at(i)); };
+	if (header.size() >= 2 && byte(0) == 0x1f && byte(1) == 0x8b) return Format::Gzip;
+	if (header.size() >= 4 && byte(0) == 0x28 && byte(1) == 0xb5 && byte(2) == 0x2f && byte(3) == 0xfd) return Format::Zstd;
+	return Format::None;
+}
+
+Format detect(const QString& filename)
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly)) return Format::None;
+	return detect(file.read(4));
+}
+
+bool isSupported(Format format)
+{
+	switch (format) {
+	case Format::Gzip:
+		return true;
+	case Format::Zstd:
+#ifdef PNA_HAVE_ZSTD
+		return true;
+#else
+		return false;
+#endif
+	case Format::None:
+		break;
+	}
+	return false;
+}
+
+QString formatName(Format format)
+{
+	switch (format) {
+	case Format::Gzip: return QStringLiteral("gzip");
+	case Format::Zstd: return QStringLiteral("zstd");
+	case Format::None: break;
+	}
+	return QStringLiteral("plain text");
+}
+
+QString baseName(const QString& filename)
+{
+	QString name = QFileInfo(filename).fileName();
+	for (const QLatin1String suffix : {QLatin1String(".gz"), QLatin1String(".zst")}) {
+		if (name.endsWith(suffix, Qt::CaseInsensitive)) {
+			name.chop(suffix.size());
+			break;
+		}
+	}
+	return QFileInfo(name).completeBaseName();
+}
+
+bool read(const QString& filename, const std::function<void(const char* data, qint64 size)>& consume, QString* errorString)
+{
+	const Format format = detect(filename);
+	if (!isSupported(format)) {
+		if (errorString) {
+			*errorString = (format == Format::Zstd)
+							   ? QString("%1 is zstd compressed; this build has no zstd support (qmake CONFIG+=zstd)").arg(QFileInfo(filename).fileName())
+							   : QString("%1 is not a compressed file").arg(QFileInfo(filename).fileName());
+		}
+		return false;
+	}
+
+	BlockPipe pipe;
+	std::unique_ptr<QThread> thread(QThread::create([&pipe, &filename, format]() {
+		BlockWriter writer(&pipe);
+		QString error;
+		const bool ok = decompress(filename, format, &writer, &error);
+		pipe.close(ok, error);
+	}));
+	thread->setObjectName(QStringLiteral("Decompress"));
+	thread->start();
+
+	const char* data = nullptr;
+	qint64 size = 0;
+	while (pipe.next(&data, &size)) {
+		consume(data, size);
+		pipe.release();
+	}
+	thread->wait();
+
+	if (!pipe.ok()) {
+		if (errorString) *errorString = QString("Could not decompress %1: %2").arg(QFileInfo(filename).fileName(), pipe.error());
+		qWarning() << "Failed to decompress" << filename << ":" << pipe.error();
+		return false;
+	}
+	return true;
+}
+
+} // namespace CompressedInput
@@ -0,0 +1,68 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef COMPRESSEDINPUT_H
+#define COMPRESSEDINPUT_H
+
+#include <QByteArray>
+#include <QString>
+#include <functional>
+
+/*
+ * Compressed dataset files (.csv.gz, .csv.zst), recognized by their magic bytes.
+ *
+ * read() decompresses on a worker thread and hands the output to the caller's
+ * thread in blocks, in order, through two alternating buffers: while the caller
+ * parses one block, the next one is being decompressed. The bytes are exactly the
+ * decompressed file, so feeding them to DatasetParser::StreamParser gives the same
+ * columns as the plain-text file.
+ *
+ * gzip (RFC 1952, several members allowed, CRC and length checked) is decoded by
+ * the built-in inflater, like pngstreamwriter.cpp encodes without zlib. zstd needs
+ * libzstd: build with qmake CONFIG+=zstd (defines PNA_HAVE_ZSTD); without it a
+ * .zst file is reported as unsupported.
+ */
+namespace CompressedInput {
+
+enum class Format { None, Gzip, Zstd };
+
+// From the first bytes of the file; None for plain text or unreadable files
+Format detect(const QByteArray& header);
+Format detect(const QString& filename);
+bool isSupported(Format format);
+QString formatName(Format format);
+
+// File name without directory, compression suffix and extension: "run1" for
+// "run1.csv.gz", like QFileInfo::completeBaseName() for plain files
+QString baseName(const QString& filename);
+
+// Calls consume with every decompressed block, on the calling thread. False on a
+// read or format error (consume may have been called for the blocks before it).
+bool read(const QString& filename, const std::function<void(const char* data, qint64 size)>& consume,
+		  QString* errorString = nullptr);
+
+} // namespace CompressedInput
+
+#endif // COMPRESSEDINPUT_H
@@ -27,15 +27,10 @@
 
 #include <QColor>
 #include <QString>
-#include <QVector>
-#include <QMap>
-#include <QPair>
 
-namespace Constants {
+#include "coreconstants.h"
 
-// Application settings
-constexpr double SPUR_THRESHOLD = 5.0; // dB above local baseline for spur
-constexpr int DEFAULT_SPUR_WINDOW_SIZE = 21;
+namespace Constants {
 
 // Y-axis limits constants
 constexpr double Y_AXIS_MIN = -200.0;
@@ -49,73 +44,33 @@ constexpr double Y_AXIS_MINOR_TICK = 5.0;
 constexpr double X_AXIS_MIN = 0.1; // Min positive value for log scale
 constexpr double X_AXIS_MAX = 1e7; // Max default value
 
-// Forward declare the frequency points
-inline const QVector<double> FREQ_POINTS = {0.1, 1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0, 10000000.0};
-
-struct FrequencyPointInfo {
-    double value;
-    QString displayName;
-    QString formattedName;
-};
-
-// Forward declarations
-inline FrequencyPointInfo getFreqInfo(double freq);
-inline QVector<FrequencyPointInfo> generateFreqPointInfos();
-
-// Function implementations
-inline FrequencyPointInfo getFreqInfo(double freq) {
-    FrequencyPointInfo info;
-    info.value = freq;
-    if (freq >= 1e6) {
-        info.displayName = QStringLiteral("%1 MHz").arg(freq / 1e6, 0, 'f', 0);
-        info.formattedName = QStringLiteral("%1 MHz").arg(freq / 1e6, 0, 'f', 3);
-    } else if (freq >= 1e3) {
-        info.displayName = QStringLiteral("%1 kHz").arg(freq / 1e3, 0, 'f', 0);
-        info.formattedName = QStringLiteral("%1 kHz").arg(freq / 1e3, 0, 'f', 3);
-    } else {
-        info.displayName = QStringLiteral("%1 Hz").arg(freq, 0, 'f', 0);
-        info.formattedName = QStringLiteral("%1 Hz").arg(freq, 0, 'f', 3);
-    }
-    return info;
-}
-
-inline QVector<FrequencyPointInfo> generateFreqPointInfos() {
-    QVector<FrequencyPointInfo> infos;
-    for(double freq : FREQ_POINTS) {
-        infos.append(getFreqInfo(freq));
-    }
-    return infos;
-}
-
-inline const QVector<FrequencyPointInfo> FREQ_POINT_INFOS = generateFreqPointInfos();
-
-inline QMap<QString, double> createFreqDisplayToValueMap() {
-    QMap<QString, double> map;
-    for(const auto& info : FREQ_POINT_INFOS) {
-        map[info.displayName] = info.value;
-    }
-    return map;
-}
-
-inline const QMap<QString, double> FREQ_DISPLAY_TO_VALUE = createFreqDisplayToValueMap();
-
-inline QMap<QString, QString> createFreqDisplayToFormattedMap() {
-    QMap<QString, QString> map;
-    for(const auto& info : FREQ_POINT_INFOS) {
-        map[info.displayName] = info.formattedName;
-    }
-    return map;
-}
-
-inline const QMap<QString, QString> FREQ_DISPLAY_TO_FORMATTED = createFreqDisplayToFormattedMap();
-
 // UI constants
 constexpr int DEFAULT_WINDOW_SIZE = 11; // Filter window
 constexpr int MIN_WINDOW_SIZE = 3;
 constexpr int MAX_WINDOW_SIZE = 51;
 constexpr int DEFAULT_DPI = 150; // Default DPI for plot saving
+constexpr int EXPORT_REFERENCE_DPI = 96; // Logical DPI of the on-screen plot, exports scale by dpi / this
 constexpr int WINDOW_WIDTH = 1200;
 constexpr int WINDOW_HEIGHT = 800;
+constexpr int SINGLE_INSTANCE_CONNECT_TIMEOUT_MS = 200; // Local socket, answers at once when an instance runs
+constexpr int SINGLE_INSTANCE_ACK_TIMEOUT_MS = 2000; // Running instance may be busy repainting
+constexpr int DEFAULT_MEMORY_BUDGET_MB = 0; // 0 = unlimited, see MemoryBudget
+constexpr int LIVE_DISPLAY_INTERVAL_MS = 33; // Live sources are drained at ~30 Hz
+constexpr int LIVE_STATS_INTERVAL_MS = 1000; // Status bar rate / latency refresh
+constexpr double SIMULATOR_DEFAULT_RATE = 10.0; // Sweeps per second
+constexpr double SIMULATOR_MAX_RATE = 1000.0;
+constexpr int STALL_THRESHOLD_MS = 250; // GUI event loop blocked longer than this is logged, see StallWatchdog
+constexpr int STALL_HEARTBEAT_MS = 50; // Also the resolution of the recorded durations
+constexpr int STALL_POLL_MS = 25; // Watchdog thread check interval
+constexpr int STALL_HISTORY_SIZE = 1000; // Stalls kept in memory for the diagnostics panel
+constexpr qint64 STALL_LOG_MAX_BYTES = 256 * 1024; // Rotation size of stalls.log
+constexpr int STALL_LOG_FILES = 3; // stalls.log, stalls.log.1, stalls.log.2
+constexpr int CURSOR_READOUT_INTERVAL_MS = 16; // Status bar coordinates follow the mouse at most at ~60 Hz
+constexpr int ALLOC_WARMUP_CALLS = 3; // AllocProfiler: calls of a zero-allocation scope that may still allocate
+constexpr int HIT_INDEX_BIN_WIDTH_PX = 8; // Column width of the IndexedGraph hit-test index
+constexpr int ANNOTATION_GRID_CELL_PX = 64; // Cell size of the AnnotationLayer label collision grid
+constexpr int LINE_RASTER_SUBSAMPLES = 4; // MonotoneLineRasterizer coverage samples per pixel column
+constexpr double LINE_RASTER_MAX_PEN_PX = 4.0; // Wider pens are stroked by QPainter (joins matter more)
 
 // Theme color constants (Using QColor for direct use in Qt)
 const QColor DARK_BG_COLOR = QColor("#1c1c1c");
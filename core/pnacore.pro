@@ -0,0 +1,14 @@
+# libpnacore: CSV parsing, parse cache, filters, spur removal, the background derived
+# pipeline, spot / integrated noise, mask checks, column files, live sources and batch
+# processing. Depends on QtCore only, so test-station software and batch tools can
+# link it without QtWidgets.
+QT = core
+
+CONFIG += c++17 staticlib
+
+TARGET = pnacore
+TEMPLATE = lib
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../pnacore.pri)
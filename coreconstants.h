@@ -0,0 +1,86 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef CORECONSTANTS_H
+#define CORECONSTANTS_H
+
+#include <QLatin1String>
+#include <QString>
+#include <array>
+
+// Constants of the analysis core (libpnacore): QtCore only. GUI constants are in constants.h.
+namespace Constants {
+
+// Spur removal
+constexpr double SPUR_THRESHOLD = 5.0; // dB above local baseline for spur
+constexpr int DEFAULT_SPUR_WINDOW_SIZE = 21;
+
+// Spot noise / slider frequency points, one per decade. Compile-time data so
+// nothing has to be built during static initialization.
+constexpr std::array<double, 9> FREQ_POINTS = {0.1, 1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0, 10000000.0};
+constexpr int FREQ_POINT_COUNT = static_cast<int>(FREQ_POINTS.size());
+
+struct FrequencyPointInfo {
+    double value;
+    const char* displayName;   // Short label, also used as the spot noise key
+    const char* formattedName; // Three decimals, used in the spot noise table
+};
+
+constexpr std::array<FrequencyPointInfo, FREQ_POINT_COUNT> FREQ_POINT_INFOS = {{
+    {0.1, "0.1 Hz", "0.100 Hz"},
+    {1.0, "1 Hz", "1.000 Hz"},
+    {10.0, "10 Hz", "10.000 Hz"},
+    {100.0, "100 Hz", "100.000 Hz"},
+    {1000.0, "1 kHz", "1.000 kHz"},
+    {10000.0, "10 kHz", "10.000 kHz"},
+    {100000.0, "100 kHz", "100.000 kHz"},
+    {1000000.0, "1 MHz", "1.000 MHz"},
+    {10000000.0, "10 MHz", "10.000 MHz"},
+}};
+
+// Display name -> frequency value, 0.0 if unknown
+inline double freqDisplayToValue(const QString& displayName) {
+    for (const auto& info : FREQ_POINT_INFOS) {
+        if (displayName == QLatin1String(info.displayName)) return info.value;
+    }
+    return 0.0;
+}
+
+// Display name -> formatted name, the display name itself if unknown
+inline QString freqDisplayToFormatted(const QString& displayName) {
+    for (const auto& info : FREQ_POINT_INFOS) {
+        if (displayName == QLatin1String(info.displayName)) return QLatin1String(info.formattedName);
+    }
+    return displayName;
+}
+
+constexpr int DATASET_CACHE_BUDGET_MB = 256; // Parsed files kept for re-loading, see DatasetCache
+
+// Live sources: sweeps buffered between the producer thread and the display
+constexpr int LIVE_BUFFER_FRAMES = 64;
+
+} // namespace Constants
+
+#endif // CORECONSTANTS_H
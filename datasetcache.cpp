@@ -0,0 +1,192 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "datasetcache.h"
+#include "coreconstants.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStringList>
+
+DatasetCache::DatasetCache()
+	: m_budget(qint64(Constants::DATASET_CACHE_BUDGET_MB) * 1024 * 1024)
+{
+}
+
+DatasetCache& DatasetCache::instance()
+{
+	static DatasetCache cache;
+	return cache;
+}
+
+QByteArray DatasetCache::contentHash(const QString& path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	if (!hash.addData(&file)) return QByteArray();
+	return hash.result();
+}
+
+QSharedPointer<const ParsedDataset> DatasetCache::load(const QString& filename, QString* errorString,
+													   const DatasetParser::StitchOptions& stitch)
+{
+	const QFileInfo info(filename);
+	const QString key = info.canonicalFilePath();
+	const qint64 size = info.size();
+	const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+	QByteArray hash;
+	if (!key.isEmpty()) {
+		QMutexLocker locker(&m_mutex);
+		auto it = m_entries.find(key);
+		if (it != m_entries.end() && it->size == size && it->modified == modified && it->stitch == stitch) {
+			it->lastUse = ++m_clock;
+			++m_hits;
+			return it->data;
+		}
+
+		// Same path with a new timestamp, or another path: compare contents with cached files of that
+		// size. The old contents of this path are only known through a hash taken earlier.
+		QStringList candidates;
+		for (auto e = m_entries.cbegin(); e != m_entries.cend(); ++e) {
+			if (e->size == size && e->stitch == stitch && (e.key() != key || !e->hash.isEmpty())) candidates.append(e.key());
+		}
+		if (!candidates.isEmpty()) {
+			locker.unlock(); // Hashing reads the whole file
+			hash = contentHash(key);
+			locker.relock();
+		}
+		for (const QString& candidate : std::as_const(candidates)) {
+			if (hash.isEmpty()) break;
+			auto e = m_entries.find(candidate);
+			if (e == m_entries.end() || e->size != size || e->stitch != stitch) continue;
+			if (e->hash.isEmpty()) {
+				// First comparison with this entry: hash its file, if that still holds the cached contents
+				const QFileInfo cachedInfo(candidate);
+				const qint64 cachedModified = e->modified;
+				if (cachedInfo.size() != size || cachedInfo.lastModified().toMSecsSinceEpoch() != cachedModified) continue;
+				locker.unlock();
+				const QByteArray cachedHash = contentHash(candidate);
+				locker.relock();
+				e = m_entries.find(candidate);
+				if (e == m_entries.end() || e->modified != cachedModified) continue;
+				e->hash = cachedHash;
+			}
+			if (e->hash != hash) continue;
+			Entry entry = e.value();
+			entry.modified = modified;
+			entry.lastUse = ++m_clock;
+			++m_hits;
+			++m_hashHits;
+			insert(key, entry);
+			qInfo() << "Parse cache: content match for" << info.fileName();
+			return entry.data;
+		}
+
+		// The entry of this path describes contents that are gone: drop it now rather than
+		// holding its columns until the new parse replaces it (or fails)
+		it = m_entries.find(key);
+		if (it != m_entries.end() && (it->size != size || it->modified != modified)) {
+			m_bytes -= it->data->bytes();
+			m_entries.erase(it);
+		}
+	}
+
+	// Miss: parse outside the lock so other threads can use the cache meanwhile
+	QSharedPointer<ParsedDataset> parsed(new ParsedDataset);
+	if (!DatasetParser::parseFile(filename, parsed.data(), errorString, stitch)) {
+		return QSharedPointer<const ParsedDataset>();
+	}
+
+	QMutexLocker locker(&m_mutex);
+	++m_misses;
+	if (!key.isEmpty() && m_budget > 0 && parsed->bytes() <= m_budget) {
+		Entry entry;
+		entry.data = parsed;
+		entry.size = size;
+		entry.modified = modified;
+		entry.hash = hash; // Empty unless a comparison above needed it: the file is read once
+		entry.stitch = stitch;
+		entry.lastUse = ++m_clock;
+		insert(key, entry);
+	}
+	return parsed;
+}
+
+void DatasetCache::insert(const QString& key, const Entry& entry)
+{
+	auto it = m_entries.find(key);
+	if (it != m_entries.end()) {
+		m_bytes -= it->data->bytes();
+	}
+	m_entries.insert(key, entry);
+	m_bytes += entry.data->bytes();
+	evictToBudget(key);
+}
+
+void DatasetCache::evictToBudget(const QString& keep)
+{
+	while (m_bytes > m_budget && !m_entries.isEmpty()) {
+		auto oldest = m_entries.end();
+		for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+			if (it.key() == keep && m_entries.size() > 1) continue;
+			if (oldest == m_entries.end() || it->lastUse < oldest->lastUse) oldest = it;
+		}
+		m_bytes -= oldest->data->bytes();
+		m_entries.erase(oldest);
+	}
+}
+
+void DatasetCache::setBudget(qint64 bytes)
+{
+	QMutexLocker locker(&m_mutex);
+	m_budget = qMax<qint64>(0, bytes);
+	evictToBudget(QString());
+}
+
+void DatasetCache::clear()
+{
+	QMutexLocker locker(&m_mutex);
+	m_entries.clear();
+	m_bytes = 0;
+}
+
+DatasetCache::Stats DatasetCache::stats() const
+{
+	QMutexLocker locker(&m_mutex);
+	Stats s;
+	s.entries = m_entries.size();
+	s.bytes = m_bytes;
+	s.budget = m_budget;
+	s.hits = m_hits;
+	s.hashHits = m_hashHits;
+	s.misses = m_misses;
+	return s;
+}
@@ -0,0 +1,101 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef DATASETCACHE_H
+#define DATASETCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+
+#include "datasetparser.h"
+
+/*
+ * Process-wide cache of parsed dataset files.
+ *
+ * Entries are keyed by canonical path and validated by file size and modification
+ * time. When that does not match (file touched, copied or opened through another
+ * path) but a cached file of the same size exists, the content hash decides, so an
+ * unchanged file is never parsed twice. Hashes are taken lazily, only for such a
+ * comparison: a plain miss reads the file once, for parsing. A hit hands out the same immutable columns;
+ * the QVectors in the registry share them until something writes to them.
+ *
+ * Bytes are counted per entry (conservative when one file is cached under two paths)
+ * and the least recently used entries are dropped above the budget. Thread safe.
+ */
+class DatasetCache
+{
+public:
+	struct Stats {
+		int entries = 0;
+		qint64 bytes = 0;
+		qint64 budget = 0;
+		int hits = 0;
+		int hashHits = 0; // Included in hits
+		int misses = 0;
+		double hitRate() const { return (hits + misses) > 0 ? double(hits) / double(hits + misses) : 0.0; }
+	};
+
+	static DatasetCache& instance();
+
+	// Cached columns for the file, parsing it on a miss. Null on error.
+	// Entries parsed with other stitch options do not match.
+	QSharedPointer<const ParsedDataset> load(const QString& filename, QString* errorString = nullptr,
+											 const DatasetParser::StitchOptions& stitch = DatasetParser::StitchOptions());
+
+	void setBudget(qint64 bytes); // 0 disables the cache
+	void clear();
+	Stats stats() const;
+
+private:
+	DatasetCache();
+	Q_DISABLE_COPY(DatasetCache)
+
+	struct Entry {
+		QSharedPointer<const ParsedDataset> data;
+		qint64 size = 0;
+		qint64 modified = 0; // msecs since epoch
+		QByteArray hash; // Content hash, empty until a comparison needed it
+		DatasetParser::StitchOptions stitch;
+		quint64 lastUse = 0;
+	};
+
+	static QByteArray contentHash(const QString& path);
+	void insert(const QString& key, const Entry& entry);
+	void evictToBudget(const QString& keep);
+
+	mutable QMutex m_mutex;
+	QHash<QString, Entry> m_entries; // By canonical path
+	qint64 m_budget = 0;
+	qint64 m_bytes = 0;
+	quint64 m_clock = 0;
+	int m_hits = 0;
+	int m_hashHits = 0;
+	int m_misses = 0;
+};
+
+#endif // DATASETCACHE_H
@@ -0,0 +1,97 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef DATASETCOLUMNS_H
+#define DATASETCOLUMNS_H
+
+#include <QVector>
+#include <utility>
+
+#include "compactcolumn.h"
+
+// Sample columns of one dataset. Move-only: the (potentially large) columns are
+// never duplicated by accident when datasets are added or reordered.
+//
+// The raw noise columns can be held compact (setStorage): phaseNoise / referenceNoise
+// are then empty and the values live in phaseNoiseCompact / referenceNoiseCompact.
+// withPhaseNoise / withReferenceNoise hand either form to the templated kernels
+// (Processing::deriveColumns). Frequencies and derived columns stay float64.
+struct DatasetColumns {
+	QVector<double> frequencyOffset;
+	QVector<double> phaseNoise;
+	QVector<double> referenceNoise;
+	QVector<double> phaseNoiseFiltered;     // For filtering/spur removal
+	QVector<double> referenceNoiseFiltered; // For filtering
+
+	ValueStorage storage = ValueStorage::Float64; // Of the raw noise columns
+	CompactColumn phaseNoiseCompact;     // storage != Float64 only
+	CompactColumn referenceNoiseCompact;
+
+	bool isCompact() const { return storage != ValueStorage::Float64; }
+
+	// Re-encodes the raw noise columns (Float64 decodes them back). Derived columns that
+	// share the raw float64 storage are released with it: derive after compacting.
+	void setStorage(ValueStorage newStorage)
+	{
+		if (newStorage == storage) return;
+		QVector<double> noise = isCompact() ? phaseNoiseCompact.decode() : std::move(phaseNoise);
+		QVector<double> reference = isCompact() ? referenceNoiseCompact.decode() : std::move(referenceNoise);
+		if (phaseNoiseFiltered.constData() == noise.constData()) phaseNoiseFiltered.clear();
+		if (referenceNoiseFiltered.constData() == reference.constData()) referenceNoiseFiltered.clear();
+
+		storage = newStorage;
+		if (isCompact()) {
+			phaseNoiseCompact = CompactColumn::encode(noise, newStorage);
+			referenceNoiseCompact = CompactColumn::encode(reference, newStorage);
+			phaseNoise.clear();
+			referenceNoise.clear();
+		} else {
+			phaseNoise = std::move(noise);
+			referenceNoise = std::move(reference);
+			phaseNoiseCompact = CompactColumn();
+			referenceNoiseCompact = CompactColumn();
+		}
+	}
+
+	// function(column) with the raw noise column: the QVector<double>, or a CompactView
+	template <typename Function>
+	auto withPhaseNoise(Function&& function) const
+	{
+		return isCompact() ? phaseNoiseCompact.visit(function) : function(phaseNoise);
+	}
+	template <typename Function>
+	auto withReferenceNoise(Function&& function) const
+	{
+		return isCompact() ? referenceNoiseCompact.visit(function) : function(referenceNoise);
+	}
+
+	DatasetColumns() = default;
+	DatasetColumns(DatasetColumns&&) = default;
+	DatasetColumns& operator=(DatasetColumns&&) = default;
+	DatasetColumns(const DatasetColumns&) = delete;
+	DatasetColumns& operator=(const DatasetColumns&) = delete;
+};
+
+#endif // DATASETCOLUMNS_H
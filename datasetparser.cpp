@@ -0,0 +1,719 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "datasetparser.h"
+
+#include "compressedinput.h"
+#include "packfile.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+qint64 ParsedDataset::bytes() const
+{
+	return (qint64(frequencyOffset.capacity()) + qint64(phaseNoise.capacity()) + qint64(referenceNoise.capacity()))
+		   * qint64(sizeof(double));
+}
+
+namespace {
+
+constexpr qint64 READ_CHUNK_BYTES = 1 << 20;
+constexpr qint64 MAX_REPORTED_SKIPS = 10; // Per parser, the rest is only counted
+constexpr int BYTE_ORDER_MARK_BYTES = 3; // Longest one checked: UTF-8
+constexpr double RESTART_TOLERANCE = 1e-3; // Relative: a segment starting this close to the sweep start may restart the sweep
+constexpr double RESTART_MIN_DROP = 0.5; // ... if it jumps back over at least this fraction of the sweep's log frequency span
+constexpr int MIN_POINTS_PER_SEGMENT = 4; // Fewer on average: rows in no order, sorted instead of stitched
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f'; }
+inline bool isSeparator(char c) { return c == ',' || isSpace(c); }
+
+// Powers of ten that are exact in a double
+constexpr double EXACT_POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+								  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// C locale number in [begin, end). Plain decimals with at most 15 significant digits and
+// a small exponent (everything instruments write) are converted with one exact
+// multiplication or division, which is correctly rounded. Anything else (long mantissas,
+// nan, inf) goes through QByteArray::toDouble.
+bool parseNumber(const char* begin, const char* end, double* out)
+{
+	const char* p = begin;
+	const bool negative = (p < end && *p == '-');
+	if (p < end && (*p == '-' || *p == '+')) ++p;
+
+	quint64 mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool anyDigit = false;
+	for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+		anyDigit = true;
+		mantissa = mantissa * 10 + quint64(*p - '0');
+		if (mantissa != 0) significantDigits++;
+		if (significantDigits > 15) break;
+	}
+	if (p < end && *p == '.' && significantDigits <= 15) {
+		for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+			anyDigit = true;
+			mantissa = mantissa * 10 + quint64(*p - '0');
+			exponent--;
+			if (mantissa != 0) significantDigits++;
+			if (significantDigits > 15) break;
+		}
+	}
+	if (anyDigit && significantDigits <= 15 && p < end && (*p == 'e' || *p == 'E')) {
+		const char* e = p + 1;
+		const bool negativeExponent = (e < end && *e == '-');
+		if (e < end && (*e == '-' || *e == '+')) ++e;
+		int value = 0;
+		int digits = 0;
+		for (; e < end && *e >= '0' && *e <= '9' && digits < 4; ++e, ++digits) {
+			value = value * 10 + (*e - '0');
+		}
+		if (digits > 0) {
+			exponent += negativeExponent ? -value : value;
+			p = e;
+		}
+	}
+
+	if (anyDigit && p == end && significantDigits <= 15 && exponent >= -22 && exponent <= 22) {
+		const double value = exponent < 0 ? double(mantissa) / EXACT_POW10[-exponent] : double(mantissa) * EXACT_POW10[exponent];
+		*out = negative ? -value : value;
+		return true;
+	}
+
+	bool ok = false;
+	*out = QByteArray(begin, int(end - begin)).toDouble(&ok);
+	return ok;
+}
+
+// --- Sweep stitching ---
+
+/*
+ * Owner of each frequency: the last segment whose range covers it. Built in one
+ * pass over the segment bounds sorted by frequency (a max-heap of the segments
+ * open at each bound), so it has two entries per segment whatever the overlaps.
+ */
+class SegmentOwners
+{
+public:
+	SegmentOwners(const QVector<double>& lower, const QVector<double>& upper)
+	{
+		struct Bound { double frequency; bool start; int segment; };
+		QVector<Bound> bounds;
+		bounds.reserve(2 * lower.size());
+		for (int s = 0; s < lower.size(); ++s) {
+			bounds.append({lower[s], true, s});
+			bounds.append({upper[s], false, s});
+		}
+		std::sort(bounds.begin(), bounds.end(), [](const Bound& a, const Bound& b) {
+			return a.frequency < b.frequency || (a.frequency == b.frequency && a.start && !b.start); // Closed ranges
+		});
+
+		std::priority_queue<int> open;
+		QVector<bool> closed(lower.size(), false);
+		auto top = [&]() {
+			while (!open.empty() && closed[open.top()]) open.pop();
+			return open.empty() ? -1 : open.top();
+		};
+		for (int b = 0; b < bounds.size();) {
+			const double f = bounds[b].frequency;
+			for (; b < bounds.size() && bounds[b].frequency == f && bounds[b].start; ++b) open.push(bounds[b].segment);
+			const int ownerAt = top();
+			for (; b < bounds.size() && bounds[b].frequency == f; ++b) closed[bounds[b].segment] = true;
+			m_bounds.append({f, ownerAt, top()});
+		}
+	}
+
+	// -1 outside every segment
+	int ownerAt(double f) const
+	{
+		auto it = std::upper_bound(m_bounds.cbegin(), m_bounds.cend(), f,
+								   [](double value, const Owner& owner) { return value < owner.frequency; });
+		if (it == m_bounds.cbegin()) return -1;
+		--it;
+		return f == it->frequency ? it->ownerAt : it->ownerAfter;
+	}
+
+private:
+	struct Owner {
+		double frequency;
+		int ownerAt; // Owner at the bound itself
+		int ownerAfter; // Owner up to the next bound
+	};
+	QVector<Owner> m_bounds;
+};
+
+// Value of a column at frequency f within the sorted index range [begin, end), linear in log frequency
+double interpolateLog(const QVector<double>& freq, const QVector<double>& column, int begin, int end, double f)
+{
+	const double* const data = freq.constData();
+	const double* it = std::lower_bound(data + begin, data + end, f);
+	if (it == data + end) return column[end - 1];
+	const int i = int(it - data);
+	if (*it == f || i == begin) return column[i];
+	const double t = (std::log(f) - std::log(freq[i - 1])) / (std::log(freq[i]) - std::log(freq[i - 1]));
+	return column[i - 1] + t * (column[i] - column[i - 1]);
+}
+
+// Values (dB) combined into one output point; NaN (no reference column) is ignored
+class MergedValue
+{
+public:
+	void reset() { m_power = 0.0; m_count = 0; m_last = std::numeric_limits<double>::quiet_NaN(); }
+	void add(double db)
+	{
+		if (std::isnan(db)) return;
+		m_power += std::pow(10.0, db / 10.0);
+		m_count++;
+		m_last = db;
+	}
+	double last() const { return m_last; }
+	double average() const { return m_count > 0 ? 10.0 * std::log10(m_power / m_count) : std::numeric_limits<double>::quiet_NaN(); }
+
+private:
+	double m_power = 0.0;
+	int m_count = 0;
+	double m_last = std::numeric_limits<double>::quiet_NaN();
+};
+
+// k-way merge of the sorted segments [first, last) (segment s spans segmentStarts[s] ..
+// segmentStarts[s + 1]) of `in`, appended to the columns of `out`
+void mergeSegments(const ParsedDataset& in, const QVector<int>& segmentStarts, int first, int last,
+				   DatasetParser::StitchOptions::Overlap overlap, ParsedDataset* out)
+{
+	const QVector<double>& freq = in.frequencyOffset;
+	const int count = last - first;
+	auto segmentBegin = [&](int s) { return segmentStarts[first + s]; };
+	auto segmentEnd = [&](int s) { return segmentStarts[first + s + 1]; };
+	QVector<double> lower(count);
+	QVector<double> upper(count);
+	for (int s = 0; s < count; ++s) {
+		lower[s] = freq[segmentBegin(s)];
+		upper[s] = freq[segmentEnd(s) - 1];
+	}
+
+	// Points are kept in the last segment covering their frequency only
+	const SegmentOwners owners(lower, upper);
+
+	// One head per segment: its next point that it owns
+	using Head = std::pair<double, int>; // Frequency, segment; equal frequencies pop in segment order
+	std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+	QVector<int> cursor(count);
+	auto pushNext = [&](int s) {
+		int& i = cursor[s];
+		for (const int end = segmentEnd(s); i < end; ++i) {
+			if (owners.ownerAt(freq[i]) == s) {
+				heads.push(Head(freq[i], s));
+				return;
+			}
+		}
+	};
+	for (int s = 0; s < count; ++s) {
+		cursor[s] = segmentBegin(s);
+		pushNext(s);
+	}
+
+	// AveragePower: segments whose range covers the current frequency, opened in order of their lower bound
+	const bool average = (overlap == DatasetParser::StitchOptions::Overlap::AveragePower);
+	QVector<int> byLower(count);
+	std::iota(byLower.begin(), byLower.end(), 0);
+	std::sort(byLower.begin(), byLower.end(), [&](int a, int b) { return lower[a] < lower[b]; });
+	int nextLower = 0;
+	QVector<int> covering;
+
+	MergedValue noise;
+	MergedValue reference;
+	bool pending = false;
+	double pendingFreq = 0.0;
+	auto flush = [&]() {
+		if (!pending) return;
+		out->frequencyOffset.append(pendingFreq);
+		out->phaseNoise.append(average ? noise.average() : noise.last());
+		out->referenceNoise.append(average ? reference.average() : reference.last());
+	};
+
+	while (!heads.empty()) {
+		const Head head = heads.top();
+		heads.pop();
+		const double f = head.first;
+		const int s = head.second;
+		const int i = cursor[s]++;
+		pushNext(s);
+
+		// Points sharing a frequency all come from one segment (the owner)
+		if (!pending || f != pendingFreq) {
+			flush();
+			pending = true;
+			pendingFreq = f;
+			noise.reset();
+			reference.reset();
+			if (average) {
+				while (nextLower < count && lower[byLower[nextLower]] <= f) covering.append(byLower[nextLower++]);
+				covering.erase(std::remove_if(covering.begin(), covering.end(), [&](int t) { return upper[t] < f; }), covering.end());
+				for (int t : std::as_const(covering)) { // Earlier segments overlapping here
+					if (t >= s) continue;
+					noise.add(interpolateLog(freq, in.phaseNoise, segmentBegin(t), segmentEnd(t), f));
+					reference.add(interpolateLog(freq, in.referenceNoise, segmentBegin(t), segmentEnd(t), f));
+				}
+			}
+		}
+		noise.add(in.phaseNoise[i]);
+		reference.add(in.referenceNoise[i]);
+	}
+	flush();
+}
+
+// Files that are not made of sweeps or segments (rows in no particular order): a stable
+// sort by frequency, repeated frequencies combined with the overlap policy in file order
+void sortUnordered(const ParsedDataset& in, DatasetParser::StitchOptions::Overlap overlap, ParsedDataset* out)
+{
+	const QVector<double>& freq = in.frequencyOffset;
+	QVector<int> order(freq.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return freq[a] < freq[b]; });
+
+	const bool average = (overlap == DatasetParser::StitchOptions::Overlap::AveragePower);
+	MergedValue noise;
+	MergedValue reference;
+	for (int k = 0; k < order.size();) {
+		const double f = freq[order[k]];
+		noise.reset();
+		reference.reset();
+		for (; k < order.size() && freq[order[k]] == f; ++k) {
+			noise.add(in.phaseNoise[order[k]]);
+			reference.add(in.referenceNoise[order[k]]);
+		}
+		out->frequencyOffset.append(f);
+		out->phaseNoise.append(average ? noise.average() : noise.last());
+		out->referenceNoise.append(average ? reference.average() : reference.last());
+	}
+}
+
+} // namespace
+
+namespace DatasetParser {
+
+StreamParser::StreamParser(SweepMode mode, const QByteArray& delimiter)
+	: m_mode(mode), m_delimiter(delimiter.trimmed())
+{
+}
+
+void StreamParser::feed(const char* data, qint64 size)
+{
+	if (!m_error.isEmpty()) return;
+	if (m_streamStart) {
+		const qint64 head = qMin(size, qint64(BYTE_ORDER_MARK_BYTES - m_partial.size()));
+		m_partial.append(data, int(head));
+		if (m_partial.size() < BYTE_ORDER_MARK_BYTES) return;
+		startStream();
+		data += head;
+		size -= head;
+		if (!m_error.isEmpty()) return;
+	}
+
+	const char* p = data;
+	const char* const end = data + size;
+
+	// Finish the line started by the previous chunk
+	if (!m_partial.isEmpty()) {
+		const char* newline = static_cast<const char*>(memchr(p, '\n', size_t(size)));
+		if (!newline) {
+			m_partial.append(data, int(size));
+			return;
+		}
+		m_partial.append(p, int(newline - p));
+		parseLine(m_partial.constData(), m_partial.constData() + m_partial.size());
+		m_partial.clear();
+		p = newline + 1;
+	}
+
+	while (p < end) {
+		const char* newline = static_cast<const char*>(memchr(p, '\n', size_t(end - p)));
+		if (!newline) {
+			m_partial.append(p, int(end - p));
+			break;
+		}
+		parseLine(p, newline);
+		p = newline + 1;
+	}
+}
+
+void StreamParser::finish()
+{
+	if (m_streamStart) startStream(); // Input shorter than a byte order mark
+	m_streamStart = true;
+	if (!m_error.isEmpty()) return;
+	if (!m_partial.isEmpty()) {
+		parseLine(m_partial.constData(), m_partial.constData() + m_partial.size());
+		m_partial.clear();
+	}
+	completeSweep();
+}
+
+bool StreamParser::takeSweep(ParsedDataset* out)
+{
+	if (!hasSweep()) return false;
+	*out = std::move(m_sweeps[m_next++]);
+	if (m_next == m_sweeps.size()) {
+		m_sweeps.clear();
+		m_next = 0;
+	}
+	return true;
+}
+
+// Checks the first bytes (held in m_partial) for a byte order mark, then feeds the rest
+void StreamParser::startStream()
+{
+	m_streamStart = false;
+	QByteArray head;
+	head.swap(m_partial);
+	if (head.startsWith("\xEF\xBB\xBF")) {
+		head.remove(0, 3);
+	} else if (head.startsWith("\xFF\xFE") || head.startsWith("\xFE\xFF")) {
+		m_error = QStringLiteral("UTF-16 encoded input is not supported, save it as UTF-8 or ASCII");
+		qWarning() << "Input is UTF-16 encoded (byte order mark), not parsed";
+		return;
+	}
+	feed(head.constData(), head.size());
+}
+
+void StreamParser::parseLine(const char* begin, const char* end)
+{
+	m_lineCount++;
+	while (begin < end && isSpace(*begin)) ++begin;
+	while (end > begin && isSpace(end[-1])) --end;
+
+	if (m_mode == SweepMode::Delimiter && end - begin == m_delimiter.size()
+		&& memcmp(begin, m_delimiter.constData(), size_t(m_delimiter.size())) == 0) {
+		completeSweep();
+		return;
+	}
+	if (begin == end) {
+		if (m_mode == SweepMode::BlankLine) completeSweep();
+		return; // Skip empty lines
+	}
+	if (*begin == '#' || *begin == ';') {
+		return; // Skip comments
+	}
+
+	// Split by comma or whitespace; only the first three fields are used
+	const char* fieldBegin[3];
+	const char* fieldEnd[3];
+	int fieldCount = 0;
+	for (const char* p = begin; p < end;) {
+		while (p < end && isSeparator(*p)) ++p;
+		if (p == end) break;
+		const char* start = p;
+		while (p < end && !isSeparator(*p)) ++p;
+		if (fieldCount < 3) {
+			fieldBegin[fieldCount] = start;
+			fieldEnd[fieldCount] = p;
+		}
+		fieldCount++;
+	}
+
+	if (m_firstDataLine) {
+		m_current.hasReferenceData = (fieldCount >= 3); // Assume ref data if 3+ columns
+		if (m_mode == SweepMode::WholeInput) {
+			if (m_current.hasReferenceData) {
+				qInfo() << "Detected 3 or more columns, attempting to read reference noise.";
+			} else {
+				qInfo() << "Detected fewer than 3 columns, reading only frequency and measured noise.";
+			}
+		}
+		m_firstDataLine = false;
+	}
+
+	if (fieldCount < 2) {
+		skipLine("Not enough data fields");
+		return;
+	}
+
+	double freq = 0.0, noise = 0.0;
+	double ref = std::numeric_limits<double>::quiet_NaN(); // Default to NaN
+	bool ok = parseNumber(fieldBegin[0], fieldEnd[0], &freq) && parseNumber(fieldBegin[1], fieldEnd[1], &noise);
+	if (ok && m_current.hasReferenceData && fieldCount >= 3) {
+		ok = parseNumber(fieldBegin[2], fieldEnd[2], &ref);
+	}
+	if (!ok) {
+		skipLine("Could not parse numeric data");
+		return;
+	}
+
+	// Add data (ensure frequency is positive for log scale)
+	if (freq > 0 && m_rowSink) {
+		m_rowSink(freq, noise, ref);
+	} else if (freq > 0) {
+		m_current.frequencyOffset.append(freq);
+		m_current.phaseNoise.append(noise);
+		m_current.referenceNoise.append(ref); // NaN if no ref data
+	} else {
+		skipLine("Frequency offset must be positive for log scale");
+	}
+}
+
+void StreamParser::completeSweep()
+{
+	m_firstDataLine = true;
+	if (m_current.frequencyOffset.isEmpty()) return; // Repeated separators
+	m_sweeps.append(std::move(m_current));
+	m_current = ParsedDataset();
+}
+
+void StreamParser::skipLine(const char* reason)
+{
+	m_skippedLines++;
+	if (m_skippedLines <= MAX_REPORTED_SKIPS) {
+		qWarning() << "Skipping line" << m_lineCount << ":" << reason;
+	}
+	if (m_skippedLines == MAX_REPORTED_SKIPS) {
+		qWarning() << "Further skipped lines are only counted";
+	}
+}
+
+bool parseFile(const QString& filename, ParsedDataset* out, QString* errorString, const StitchOptions& stitch)
+{
+	// Pack member: one lookup in the shared, mapped pack, then a copy of its columns
+	QString packPath;
+	QString member;
+	if (PackFile::splitMemberPath(filename, &packPath, &member)) {
+		const QSharedPointer<PackFile> pack = PackFile::shared(packPath, errorString);
+		if (!pack) {
+			qWarning() << "Failed to open pack:" << packPath << (errorString ? *errorString : QString());
+			return false;
+		}
+		const int index = pack->find(member);
+		if (index < 0 || !pack->read(index, out)) {
+			if (errorString) *errorString = QString("No member %1 in %2").arg(member, QFileInfo(packPath).fileName());
+			qWarning() << "No member" << member << "in pack" << packPath;
+			return false;
+		}
+		return true;
+	}
+
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly)) {
+		if (errorString) *errorString = QString("Could not open file: %1").arg(filename);
+		qWarning() << "Failed to open file:" << filename << file.errorString();
+		return false;
+	}
+
+	StreamParser parser;
+	const CompressedInput::Format format = CompressedInput::detect(file.peek(4));
+	if (format != CompressedInput::Format::None) {
+		// Decompressed on a worker thread while this one parses the previous block
+		file.close();
+		if (!CompressedInput::isSupported(format)) {
+			if (errorString) {
+				*errorString = QString("%1 is %2 compressed; rebuild with qmake CONFIG+=zstd to read it")
+								   .arg(QFileInfo(filename).fileName(), CompressedInput::formatName(format));
+			}
+			qWarning() << "No decompressor for" << CompressedInput::formatName(format) << "file" << filename;
+			return false;
+		}
+		if (!CompressedInput::read(filename, [&parser](const char* data, qint64 size) { parser.feed(data, size); }, errorString)) {
+			return false;
+		}
+	} else {
+		// Chunked reads: the parser never needs the whole file in memory
+		QByteArray chunk(int(READ_CHUNK_BYTES), Qt::Uninitialized);
+		for (;;) {
+			const qint64 bytes = file.read(chunk.data(), chunk.size());
+			if (bytes < 0) {
+				if (errorString) *errorString = QString("Could not read file: %1").arg(filename);
+				qWarning() << "Failed to read file:" << filename << file.errorString();
+				return false;
+			}
+			if (bytes == 0) break;
+			parser.feed(chunk.constData(), bytes);
+		}
+		file.close();
+	}
+	parser.finish();
+	if (!parser.errorString().isEmpty()) {
+		if (errorString) *errorString = QString("%1: %2").arg(QFileInfo(filename).fileName(), parser.errorString());
+		return false;
+	}
+
+	ParsedDataset parsed;
+	if (!parser.takeSweep(&parsed)) {
+		if (errorString) *errorString = QString("No valid data points found in file: %1").arg(QFileInfo(filename).fileName());
+		qWarning() << "No valid data loaded from" << filename;
+		return false;
+	}
+	if (parser.skippedLines() > 0) {
+		qWarning() << "Skipped" << parser.skippedLines() << "of" << parser.lineCount() << "lines in" << QFileInfo(filename).fileName();
+	}
+	stitchSweeps(&parsed, stitch);
+
+	*out = std::move(parsed);
+	return true;
+}
+
+QString baseName(const QString& filename)
+{
+	QString member;
+	return CompressedInput::baseName(PackFile::splitMemberPath(filename, nullptr, &member) ? member : filename);
+}
+
+void stitchSweeps(ParsedDataset* dataset, const StitchOptions& options)
+{
+	QVector<double>& freq = dataset->frequencyOffset;
+	dataset->sweepStarts.clear();
+	const int n = freq.size();
+	if (n < 2) return;
+
+	// One pass: monotone runs, a run ends where the frequency turns back
+	QVector<int> segmentStarts{0};
+	QVector<int> directions; // Per segment: 1 increasing, -1 decreasing, 0 a single frequency
+	int direction = 0;
+	bool duplicates = false;
+	for (int i = 1; i < n; ++i) {
+		const int step = freq[i] > freq[i - 1] ? 1 : (freq[i] < freq[i - 1] ? -1 : 0);
+		if (step == 0) {
+			duplicates = true;
+		} else if (direction == 0) {
+			direction = step;
+		} else if (step != direction) {
+			directions.append(direction);
+			segmentStarts.append(i);
+			direction = 0;
+		}
+	}
+	directions.append(direction);
+	const int segmentCount = segmentStarts.size();
+	segmentStarts.append(n);
+
+	ParsedDataset merged;
+	merged.hasReferenceData = dataset->hasReferenceData;
+	merged.frequencyOffset.reserve(n);
+	merged.phaseNoise.reserve(n);
+	merged.referenceNoise.reserve(n);
+
+	// Hardly longer runs than random rows would give: no sweep structure to keep
+	if (qint64(segmentCount) * MIN_POINTS_PER_SEGMENT > n) {
+		sortUnordered(*dataset, options.overlap, &merged);
+		qInfo() << "Sorted unordered rows:" << n << "->" << merged.frequencyOffset.size() << "points";
+		*dataset = std::move(merged);
+		return;
+	}
+
+	// Decreasing runs (sweeps from the highest offset down) are reversed in place
+	for (int s = 0; s < segmentCount; ++s) {
+		if (directions[s] >= 0) continue;
+		std::reverse(freq.begin() + segmentStarts[s], freq.begin() + segmentStarts[s + 1]);
+		std::reverse(dataset->phaseNoise.begin() + segmentStarts[s], dataset->phaseNoise.begin() + segmentStarts[s + 1]);
+		std::reverse(dataset->referenceNoise.begin() + segmentStarts[s], dataset->referenceNoise.begin() + segmentStarts[s + 1]);
+	}
+	if (segmentCount == 1 && !duplicates) return; // One sweep
+
+	// Sweep restarts: a segment that jumps back (against the sweep's own direction) to where the
+	// sweep started, over a large part of its span. Segments of one sweep only overlap at their edges.
+	auto lower = [&](int s) { return freq[segmentStarts[s]]; };
+	auto upper = [&](int s) { return freq[segmentStarts[s + 1] - 1]; };
+	QVector<int> sweepSegments{0}; // First segment of each sweep
+	int sweepDirection = directions[0] < 0 ? -1 : 1;
+	double sweepLower = lower(0);
+	double sweepUpper = upper(0);
+	for (int s = 1; s < segmentCount; ++s) {
+		// In file order a decreasing segment starts at its upper frequency
+		const double previousEnd = directions[s - 1] < 0 ? lower(s - 1) : upper(s - 1);
+		const double start = directions[s] < 0 ? upper(s) : lower(s);
+		const double span = std::log(sweepUpper / sweepLower);
+		const bool restart = sweepDirection > 0
+			? start <= sweepLower * (1.0 + RESTART_TOLERANCE) && std::log(previousEnd / start) >= RESTART_MIN_DROP * span
+			: start >= sweepUpper / (1.0 + RESTART_TOLERANCE) && std::log(start / previousEnd) >= RESTART_MIN_DROP * span;
+		if (restart && span > 0.0) {
+			sweepSegments.append(s);
+			if (directions[s] != 0) sweepDirection = directions[s];
+			sweepLower = lower(s);
+			sweepUpper = upper(s);
+		} else {
+			sweepLower = qMin(sweepLower, lower(s));
+			sweepUpper = qMax(sweepUpper, upper(s));
+		}
+	}
+	const int sweepCount = sweepSegments.size();
+	sweepSegments.append(segmentCount);
+
+	const bool split = options.splitRestarts && sweepCount > 1;
+	if (split) {
+		for (int sweep = 0; sweep < sweepCount; ++sweep) {
+			merged.sweepStarts.append(merged.frequencyOffset.size());
+			mergeSegments(*dataset, segmentStarts, sweepSegments[sweep], sweepSegments[sweep + 1], options.overlap, &merged);
+		}
+	} else {
+		mergeSegments(*dataset, segmentStarts, 0, segmentCount, options.overlap, &merged);
+	}
+	qInfo() << "Stitched" << segmentCount << "segments in" << sweepCount << (split ? "separate sweeps:" : "sweeps:")
+			<< n << "->" << merged.frequencyOffset.size() << "points";
+	*dataset = std::move(merged);
+}
+
+bool parseMaskFile(const QString& filename, QVector<MaskPoint>* out, QString* errorString)
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		if (errorString) *errorString = QString("Could not open mask file: %1").arg(filename);
+		return false;
+	}
+
+	static const QRegularExpression separators(QStringLiteral("[,\\s]+"));
+	QVector<MaskPoint> mask;
+	QTextStream in(&file);
+	while (!in.atEnd()) {
+		const QString line = in.readLine().trimmed();
+		if (line.isEmpty() || line.startsWith('#') || line.startsWith(';')) continue;
+		const QStringList fields = line.split(separators, Qt::SkipEmptyParts);
+		bool okFreq = false, okLimit = false;
+		const double freq = fields.value(0).toDouble(&okFreq);
+		const double limit = fields.value(1).toDouble(&okLimit);
+		if (okFreq && okLimit && freq > 0) {
+			mask.append({freq, limit});
+		}
+	}
+	if (mask.size() < 2) {
+		if (errorString) *errorString = QString("Mask file needs at least two points: %1").arg(QFileInfo(filename).fileName());
+		return false;
+	}
+	std::sort(mask.begin(), mask.end(), [](const MaskPoint& a, const MaskPoint& b) { return a.frequency < b.frequency; });
+	*out = std::move(mask);
+	return true;
+}
+
+} // namespace DatasetParser
@@ -0,0 +1,164 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef DATASETPARSER_H
+#define DATASETPARSER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+#include "processing.h"
+
+// Columns of one phase noise file as read from disk, before any filtering
+struct ParsedDataset {
+	QVector<double> frequencyOffset;
+	QVector<double> phaseNoise;
+	QVector<double> referenceNoise; // NaN when the file has no reference column
+	bool hasReferenceData = false;
+	QVector<int> sweepStarts; // First index of each sweep when a multi-sweep file was split, else empty
+
+	qint64 bytes() const; // Allocated column bytes
+};
+
+namespace DatasetParser {
+
+// How files whose frequency column is not one increasing sweep are arranged, see stitchSweeps()
+struct StitchOptions {
+	enum class Overlap {
+		PreferLater,  // Where segments overlap, the later segment's points replace the earlier ones
+		AveragePower  // Later segment's frequencies, noise averaged in power over all covering segments
+	};
+	Overlap overlap = Overlap::PreferLater;
+	bool splitRestarts = false; // Each sweep its own dataset (sweepStarts) instead of merging them
+
+	bool operator==(const StitchOptions& other) const { return overlap == other.overlap && splitRestarts == other.splitRestarts; }
+	bool operator!=(const StitchOptions& other) const { return !(*this == other); }
+};
+
+/*
+ * Incremental reader for the phase noise text format, shared by parseFile() and the
+ * streaming inputs (stdin, pipes). Bytes can be fed in chunks of any size; complete
+ * lines are tokenized in place (comma / whitespace separators, C locale numbers, no
+ * per-line allocation) and appended to the current sweep.
+ *
+ * In WholeInput mode everything is one sweep, completed by finish(). In the streaming
+ * modes a blank line, or a line equal to the delimiter, completes the current sweep;
+ * finished sweeps are queued until taken. The first data line of each sweep decides
+ * whether it has a reference column. Lines that do not parse or have a frequency <= 0
+ * are skipped; the first few are reported with a warning, the rest only counted.
+ *
+ * A UTF-8 byte order mark at the start of the input is skipped. UTF-16 input (byte
+ * order mark FF FE or FE FF) cannot be read: the parser fails (errorString()) and
+ * ignores the rest of the stream. finish() ends the stream; the next feed() starts one.
+ *
+ * With a row sink set, accepted rows are handed to it as they are parsed instead of being
+ * collected into sweeps (for writers that never hold the whole trace, see
+ * MappedColumnFile::convertCsv); no sweep is ever completed then.
+ */
+class StreamParser
+{
+public:
+	enum class SweepMode { WholeInput, BlankLine, Delimiter };
+
+	explicit StreamParser(SweepMode mode = SweepMode::WholeInput, const QByteArray& delimiter = QByteArray());
+
+	// reference is NaN when the sweep has no reference column
+	using RowSink = std::function<void(double frequency, double noise, double reference)>;
+	void setRowSink(RowSink sink) { m_rowSink = std::move(sink); }
+
+	void feed(const char* data, qint64 size);
+	void finish(); // End of input: parses an unterminated last line and completes the sweep
+
+	bool hasSweep() const { return m_next < m_sweeps.size(); }
+	bool takeSweep(ParsedDataset* out); // Oldest completed sweep, false if none
+	qint64 lineCount() const { return m_lineCount; }
+	qint64 skippedLines() const { return m_skippedLines; }
+	bool hasReferenceData() const { return m_current.hasReferenceData; } // As decided by the current sweep's first data line
+	const QString& errorString() const { return m_error; } // Empty unless the input cannot be parsed at all
+
+private:
+	void startStream();
+	void parseLine(const char* begin, const char* end);
+	void completeSweep();
+	void skipLine(const char* reason);
+
+	SweepMode m_mode;
+	QByteArray m_delimiter;
+	QByteArray m_partial; // Incomplete last line of the previous chunk (or the first bytes, until the byte order mark is checked)
+	bool m_streamStart = true;
+	QString m_error;
+	RowSink m_rowSink;
+	ParsedDataset m_current;
+	bool m_firstDataLine = true;
+	QVector<ParsedDataset> m_sweeps;
+	int m_next = 0; // First sweep not taken yet
+	qint64 m_lineCount = 0;
+	qint64 m_skippedLines = 0;
+};
+
+// Reads a CSV / whitespace separated file: frequency, noise [, reference noise].
+// Comment lines (# or ;) and empty lines are skipped, the first data line decides
+// whether a reference column is read. Lines that do not parse or have a frequency
+// <= 0 are skipped (see StreamParser). No GUI access, safe to call from any thread.
+// The columns are sorted by frequency and de-duplicated on return, see stitchSweeps().
+// gzip / zstd files are decompressed on the fly (CompressedInput); "archive.pnapack#member"
+// reads a pack member's stored columns (PackFile), stitched when they were packed.
+bool parseFile(const QString& filename, ParsedDataset* out, QString* errorString = nullptr,
+			   const StitchOptions& stitch = StitchOptions());
+
+// Name for legends and output files: "run1" for run1.csv, run1.csv.gz and archive.pnapack#run1.csv
+QString baseName(const QString& filename);
+
+/*
+ * Sorts the columns of a dataset read in file order.
+ *
+ * Analyzer exports are often several segments (one per decade, overlapping at the
+ * edges) or several sweeps written one after the other, increasing or decreasing.
+ * One pass splits the rows into monotone runs (segments); decreasing ones are
+ * reversed. Each sweep takes the direction of its first segment, and a segment
+ * restarts the sweep only when it jumps back to where the sweep started, over at
+ * least half of the sweep's span. The segments are then combined by a k-way merge.
+ * Each frequency belongs to the last segment covering it (found in one pass over
+ * the segment bounds), so overlaps do not interleave into a zig-zag; with
+ * AveragePower the kept points carry the power average of every segment covering
+ * them (interpolated in log frequency). Repeated frequencies are combined the same way.
+ *
+ * Restarts are merged like segments, or with splitRestarts every sweep is merged on
+ * its own and the sweeps are stored one after the other (sweepStarts). A dataset
+ * that is already one increasing sweep is left as it is after the scan. Rows in no
+ * particular order (about as many segments as points) get a stable sort by
+ * frequency instead, repeated frequencies combined in file order.
+ */
+void stitchSweeps(ParsedDataset* dataset, const StitchOptions& options);
+
+// Reads a limit mask: frequency (Hz), limit (dBc/Hz) per line, same separators and comments.
+// Sorted by frequency on return.
+bool parseMaskFile(const QString& filename, QVector<MaskPoint>* out, QString* errorString = nullptr);
+
+} // namespace DatasetParser
+
+#endif // DATASETPARSER_H
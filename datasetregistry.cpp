@@ -0,0 +1,169 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "datasetregistry.h"
+#include "qcustomplot.h"
+
+#include <utility>
+
+namespace {
+
+// Removes element 'slot' by moving the last one into its place
+template <typename Container>
+void swapRemove(Container& container, int slot)
+{
+	const int last = int(container.size()) - 1;
+	if (slot != last) {
+		container[slot] = std::move(container[last]);
+	}
+	container.pop_back();
+}
+
+} // namespace
+
+DatasetRegistry::Handle DatasetRegistry::add(const QString& filename, const QString& displayName, bool hasReferenceData, DatasetColumns&& columns)
+{
+	const Handle handle = m_nextHandle++;
+	const int slot = m_slotHandles.size();
+
+	m_handleToSlot.append(slot);
+	m_order.append(handle);
+
+	m_slotHandles.append(handle);
+	m_filenames.append(filename);
+	m_displayNames.append(displayName);
+	m_hasReferenceData.append(hasReferenceData);
+	m_visible.append(true);
+	m_measuredColors.append(QColor());
+	m_referenceColors.append(QColor());
+	m_graphs.append(DatasetGraphs());
+	m_versions.append(++m_versionClock);
+	m_columns.push_back(std::move(columns));
+
+	if (hasReferenceData) m_referenceCount++;
+	return handle;
+}
+
+void DatasetRegistry::remove(Handle handle)
+{
+	const int slot = slotOf(handle);
+	if (slot < 0) return;
+
+	unmapGraphs(m_graphs[slot]);
+	if (m_hasReferenceData[slot]) m_referenceCount--;
+
+	// The dataset in the last slot moves into the freed one
+	const Handle movedHandle = m_slotHandles.last();
+	m_handleToSlot[movedHandle] = slot;
+	m_handleToSlot[handle] = -1;
+
+	swapRemove(m_slotHandles, slot);
+	swapRemove(m_filenames, slot);
+	swapRemove(m_displayNames, slot);
+	swapRemove(m_hasReferenceData, slot);
+	swapRemove(m_visible, slot);
+	swapRemove(m_measuredColors, slot);
+	swapRemove(m_referenceColors, slot);
+	swapRemove(m_graphs, slot);
+	swapRemove(m_versions, slot);
+	swapRemove(m_columns, slot);
+
+	m_order.removeOne(handle);
+}
+
+void DatasetRegistry::clear()
+{
+	// Handles keep increasing so stale handles held elsewhere never alias a new dataset
+	m_handleToSlot.fill(-1);
+	m_order.clear();
+	m_slotHandles.clear();
+	m_filenames.clear();
+	m_displayNames.clear();
+	m_hasReferenceData.clear();
+	m_visible.clear();
+	m_measuredColors.clear();
+	m_referenceColors.clear();
+	m_graphs.clear();
+	m_versions.clear();
+	m_columns.clear();
+	m_referenceCount = 0;
+	m_plottableToHandle.clear();
+}
+
+void DatasetRegistry::reserve(int count)
+{
+	m_handleToSlot.reserve(m_nextHandle + count);
+	m_order.reserve(count);
+	m_slotHandles.reserve(count);
+	m_filenames.reserve(count);
+	m_displayNames.reserve(count);
+	m_hasReferenceData.reserve(count);
+	m_visible.reserve(count);
+	m_measuredColors.reserve(count);
+	m_referenceColors.reserve(count);
+	m_graphs.reserve(count);
+	m_versions.reserve(count);
+	m_columns.reserve(size_t(count));
+	m_plottableToHandle.reserve(count * 2);
+}
+
+qint64 DatasetRegistry::pointCount() const
+{
+	qint64 points = 0;
+	for (const DatasetColumns& columns : m_columns) points += columns.frequencyOffset.size();
+	return points;
+}
+
+void DatasetRegistry::setColors(Handle handle, const QColor& measured, const QColor& reference)
+{
+	const int slot = slotOf(handle);
+	m_measuredColors[slot] = measured;
+	m_referenceColors[slot] = reference;
+}
+
+void DatasetRegistry::setGraphs(Handle handle, const DatasetGraphs& graphs)
+{
+	const int slot = slotOf(handle);
+	unmapGraphs(m_graphs[slot]);
+	m_graphs[slot] = graphs;
+
+	// Only the graphs that have legend entries need a reverse mapping
+	if (graphs.measured) m_plottableToHandle.insert(graphs.measured, handle);
+	if (graphs.reference) m_plottableToHandle.insert(graphs.reference, handle);
+}
+
+void DatasetRegistry::clearGraphs()
+{
+	for (DatasetGraphs& graphs : m_graphs) {
+		graphs = DatasetGraphs();
+	}
+	m_plottableToHandle.clear();
+}
+
+void DatasetRegistry::unmapGraphs(const DatasetGraphs& graphs)
+{
+	if (graphs.measured) m_plottableToHandle.remove(graphs.measured);
+	if (graphs.reference) m_plottableToHandle.remove(graphs.reference);
+}
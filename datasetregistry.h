@@ -0,0 +1,135 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef DATASETREGISTRY_H
+#define DATASETREGISTRY_H
+
+#include <QColor>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <vector>
+
+#include "datasetcolumns.h"
+
+class QCPGraph;
+class QCPAbstractPlottable;
+
+// Plottables currently showing one dataset (owned by QCustomPlot)
+struct DatasetGraphs {
+	QCPGraph* measured = nullptr;
+	QCPGraph* reference = nullptr;        // Reference line (dark) or fill graph (light)
+	QCPGraph* referenceOutline = nullptr; // Outline for light theme fill
+	QCPGraph* referenceBase = nullptr;    // Baseline for light theme fill
+};
+
+/*
+ * Storage for all loaded datasets.
+ *
+ * Each dataset gets a stable integer handle that stays valid until the dataset is
+ * removed (handles are never reused). Metadata is kept as parallel arrays indexed
+ * by an internal slot, so loops over one attribute (visibility, reference flag...)
+ * touch contiguous memory. Removal swaps the last slot into the hole, so it is O(1)
+ * apart from updating the display order. Plottable -> dataset lookups (legend
+ * clicks, context menu) go through a hash maintained by setGraphs().
+ *
+ * Every dataset also carries a version number, taken from a registry-wide counter
+ * whenever its derived columns are invalidated (new data, filter or spur settings).
+ * Background work is tagged with the version it was computed from, so a result
+ * that arrives after the dataset changed again can be recognised and dropped.
+ */
+class DatasetRegistry
+{
+public:
+	using Handle = int;
+	static constexpr Handle InvalidHandle = -1;
+
+	Handle add(const QString& filename, const QString& displayName, bool hasReferenceData, DatasetColumns&& columns);
+	void remove(Handle handle);
+	void clear();
+	void reserve(int count);
+
+	int size() const { return m_order.size(); }
+	bool isEmpty() const { return m_order.isEmpty(); }
+	qint64 pointCount() const; // Frequency points over all datasets
+	bool contains(Handle handle) const { return slotOf(handle) >= 0; }
+
+	// Handles in display (insertion) order
+	const QVector<Handle>& handles() const { return m_order; }
+	Handle first() const { return m_order.isEmpty() ? InvalidHandle : m_order.first(); }
+	Handle handleAt(int position) const { return m_order.value(position, InvalidHandle); }
+	int positionOf(Handle handle) const { return m_order.indexOf(handle); }
+
+	// Metadata (handle must be valid)
+	const QString& filename(Handle handle) const { return m_filenames[slotOf(handle)]; }
+	const QString& displayName(Handle handle) const { return m_displayNames[slotOf(handle)]; }
+	bool hasReferenceData(Handle handle) const { return m_hasReferenceData[slotOf(handle)]; }
+	bool isVisible(Handle handle) const { return m_visible[slotOf(handle)]; }
+	void setVisible(Handle handle, bool visible) { m_visible[slotOf(handle)] = visible; }
+	QColor measuredColor(Handle handle) const { return m_measuredColors[slotOf(handle)]; }
+	QColor referenceColor(Handle handle) const { return m_referenceColors[slotOf(handle)]; }
+	void setColors(Handle handle, const QColor& measured, const QColor& reference);
+	bool anyHasReferenceData() const { return m_referenceCount > 0; }
+
+	// Versions (handle must be valid). bumpVersion() supersedes any pending derived result.
+	quint64 version(Handle handle) const { return m_versions[slotOf(handle)]; }
+	quint64 bumpVersion(Handle handle) { return m_versions[slotOf(handle)] = ++m_versionClock; }
+
+	// Columns (handle must be valid)
+	DatasetColumns& columns(Handle handle) { return m_columns[size_t(slotOf(handle))]; }
+	const DatasetColumns& columns(Handle handle) const { return m_columns[size_t(slotOf(handle))]; }
+
+	// Plottables
+	const DatasetGraphs& graphs(Handle handle) const { return m_graphs[slotOf(handle)]; }
+	void setGraphs(Handle handle, const DatasetGraphs& graphs);
+	void clearGraphs(); // Forget all plottables (after QCustomPlot::clearGraphs or removal)
+	Handle handleForPlottable(const QCPAbstractPlottable* plottable) const { return m_plottableToHandle.value(plottable, InvalidHandle); }
+
+private:
+	int slotOf(Handle handle) const { return (handle >= 0 && handle < m_handleToSlot.size()) ? m_handleToSlot[handle] : -1; }
+	void unmapGraphs(const DatasetGraphs& graphs);
+
+	Handle m_nextHandle = 0;
+	QVector<int> m_handleToSlot; // Indexed by handle, -1 once removed
+	QVector<Handle> m_order;     // Display order
+
+	// Parallel arrays indexed by slot
+	QVector<Handle> m_slotHandles;
+	QVector<QString> m_filenames;
+	QVector<QString> m_displayNames;
+	QVector<bool> m_hasReferenceData;
+	QVector<bool> m_visible;
+	QVector<QColor> m_measuredColors;
+	QVector<QColor> m_referenceColors;
+	QVector<DatasetGraphs> m_graphs;
+	QVector<quint64> m_versions;
+	std::vector<DatasetColumns> m_columns; // std::vector: QVector requires copyable elements
+
+	int m_referenceCount = 0;
+	quint64 m_versionClock = 0; // Never reset, so versions are unique for the session
+	QHash<const QCPAbstractPlottable*, Handle> m_plottableToHandle;
+};
+
+#endif // DATASETREGISTRY_H
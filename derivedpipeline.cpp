@@ -0,0 +1,112 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "derivedpipeline.h"
+
+#include <QDebug>
+#include <QMetaObject>
+#include <QPointer>
+#include <QThread>
+#include <exception>
+#include <utility>
+
+DerivedPipeline::DerivedPipeline(QObject* parent)
+	: QObject(parent)
+{
+	// Leave a core for the GUI thread
+	m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+DerivedPipeline::~DerivedPipeline()
+{
+	cancelAll();
+	m_pool.waitForDone();
+}
+
+void DerivedPipeline::submit(const DatasetSnapshotPtr& snapshot, const DerivedSettings& settings)
+{
+	if (!snapshot) return;
+	const int handle = snapshot->handle;
+	const quint64 version = snapshot->version;
+
+	LatestVersion& latest = m_latest[handle];
+	if (!latest) latest = LatestVersion::create(0);
+	latest->storeRelease(version);
+	m_pending.insert(handle, version);
+
+	const LatestVersion guard = latest;
+	QPointer<DerivedPipeline> self(this);
+	m_pool.start([self, guard, snapshot, settings]() {
+		DerivedColumns columns;
+		QString error;
+		// Superseded before it started: nothing to compute, finish() drops it
+		if (guard->loadAcquire() == snapshot->version) {
+			try {
+				columns = Processing::deriveColumns(snapshot->frequencyOffset, snapshot->phaseNoise, snapshot->referenceNoise,
+													snapshot->hasReferenceData, settings);
+			} catch (const std::exception& e) {
+				error = QString::fromLocal8Bit(e.what());
+			}
+		}
+
+		// The destructor waits for the pool, so the pipeline outlives this call
+		QMetaObject::invokeMethod(self.data(), [self, snapshot, columns, error]() {
+			if (self) self->finish(snapshot->handle, snapshot->version, columns, error);
+		}, Qt::QueuedConnection);
+	});
+}
+
+void DerivedPipeline::cancel(int handle)
+{
+	// Version 0 is never handed out, so every in-flight result for the handle is stale
+	if (LatestVersion latest = m_latest.value(handle)) latest->storeRelease(0);
+	if (m_pending.remove(handle) && m_pending.isEmpty()) emit idle();
+}
+
+void DerivedPipeline::cancelAll()
+{
+	for (const LatestVersion& latest : std::as_const(m_latest)) latest->storeRelease(0);
+	const bool wasPending = !m_pending.isEmpty();
+	m_pending.clear();
+	if (wasPending) emit idle();
+}
+
+void DerivedPipeline::finish(int handle, quint64 version, const DerivedColumns& columns, const QString& error)
+{
+	// Runs on the pipeline's thread, so m_pending is never touched concurrently
+	if (m_pending.value(handle) != version) {
+		m_dropped++;
+		return;
+	}
+	m_pending.remove(handle);
+
+	if (error.isEmpty()) {
+		emit derivedReady(handle, version, columns);
+	} else {
+		qWarning() << "Derived columns failed for dataset" << handle << ":" << error;
+		emit derivedFailed(handle, version, error);
+	}
+	if (m_pending.isEmpty()) emit idle();
+}
@@ -0,0 +1,94 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef DERIVEDPIPELINE_H
+#define DERIVEDPIPELINE_H
+
+#include <QAtomicInteger>
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include "processing.h"
+
+// Immutable view of a dataset's raw columns at one version. The QVectors share
+// their data with the registry (implicit sharing), so taking a snapshot is cheap
+// and a later write on the GUI side detaches instead of racing with a worker.
+struct DatasetSnapshot {
+	int handle = -1;
+	quint64 version = 0;
+	bool hasReferenceData = false;
+	QVector<double> frequencyOffset;
+	QVector<double> phaseNoise;
+	QVector<double> referenceNoise;
+};
+using DatasetSnapshotPtr = QSharedPointer<const DatasetSnapshot>;
+
+/*
+ * Computes derived columns (filtering, spur removal) off the GUI thread.
+ *
+ * submit() queues a snapshot on a private thread pool; the result is handed back
+ * on the pipeline's thread through derivedReady(), tagged with the snapshot version.
+ * Submitting a newer version for the same handle supersedes the older one: a task
+ * that has not started yet is skipped, and a result that finishes late is dropped
+ * instead of being published. The receiver still compares the version with its own
+ * store, since the dataset may have changed in ways the pipeline does not know about.
+ */
+class DerivedPipeline : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit DerivedPipeline(QObject* parent = nullptr);
+	~DerivedPipeline() override; // Waits for running tasks
+
+	void submit(const DatasetSnapshotPtr& snapshot, const DerivedSettings& settings);
+	void cancel(int handle); // Drops whatever is pending for the handle
+	void cancelAll();
+
+	int pendingCount() const { return m_pending.size(); }
+	bool isPending(int handle) const { return m_pending.contains(handle); }
+	int droppedCount() const { return m_dropped; }
+
+signals:
+	void derivedReady(int handle, quint64 version, const DerivedColumns& columns);
+	void derivedFailed(int handle, quint64 version, const QString& message);
+	void idle(); // Last pending result delivered or dropped
+
+private:
+	using LatestVersion = QSharedPointer<QAtomicInteger<quint64>>;
+
+	void finish(int handle, quint64 version, const DerivedColumns& columns, const QString& error);
+
+	QThreadPool m_pool;
+	QHash<int, LatestVersion> m_latest; // Newest submitted version per handle, read by the workers
+	QHash<int, quint64> m_pending;      // Handles with a result still to come
+	int m_dropped = 0;
+};
+
+#endif // DERIVEDPIPELINE_H
@@ -0,0 +1,335 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "indexedgraph.h"
+
+#include <QPaintEngine>
+
+#include <cmath>
+#include <limits>
+
+#include "constants.h"
+#include "monotonelinerasterizer.h"
+
+namespace {
+
+// Scratch layer for pixmap devices, shared by all graphs: drawing happens on the GUI
+// thread one graph at a time, and each draw leaves it transparent again
+struct LineLayer {
+	MonotoneLineRasterizer rasterizer;
+	QImage image;
+	QVector<QPointF> points; // One gap-free run in device pixels
+};
+
+LineLayer& lineLayer()
+{
+	static LineLayer layer;
+	return layer;
+}
+
+} // namespace
+
+IndexedGraph::IndexedGraph(QCPAxis* keyAxis, QCPAxis* valueAxis)
+	: QCPGraph(keyAxis, valueAxis)
+{
+}
+
+// --- Drawing ---
+
+void IndexedGraph::draw(QCPPainter* painter)
+{
+	m_indexValid = false;
+	m_lines.resize(0);
+	m_collecting = true;
+	QCPGraph::draw(painter);
+	m_collecting = false;
+	buildIndex();
+}
+
+void IndexedGraph::drawLinePlot(QCPPainter* painter, const QVector<QPointF>& lines) const
+{
+	// Called once per selected/unselected data segment with its pixel polyline
+	if (m_collecting) {
+		if (!m_lines.isEmpty()) m_lines.append(QPointF(qQNaN(), qQNaN()));
+		m_lines += lines;
+	}
+	if (m_fastLines && drawRasterizedLine(painter, lines)) return;
+	QCPGraph::drawLinePlot(painter, lines);
+}
+
+bool IndexedGraph::drawRasterizedLine(QCPPainter* painter, const QVector<QPointF>& lines) const
+{
+	// Only where QPainter would produce the same pixels, see MonotoneLineRasterizer
+	const QPen pen = painter->pen();
+	if (pen.style() != Qt::SolidLine || pen.brush().style() != Qt::SolidPattern || pen.color().alpha() == 0) return false;
+	applyDefaultAntialiasingHint(painter);
+	if (!painter->testRenderHint(QPainter::Antialiasing) || painter->modes().testFlag(QCPPainter::pmVectorized)) return false;
+	if (painter->compositionMode() != QPainter::CompositionMode_SourceOver || painter->opacity() < 1.0) return false;
+	if (painter->worldTransform().type() > QTransform::TxTranslate) return false;
+	QPaintDevice* device = painter->device();
+	if (!device || !painter->paintEngine() || painter->paintEngine()->type() != QPaintEngine::Raster) return false;
+	if (device->devType() != QInternal::Image && device->devType() != QInternal::Pixmap) return false;
+
+	// x must not decrease over the whole line (gaps included), or nothing is drawn here
+	double lastX = -std::numeric_limits<double>::infinity();
+	for (const QPointF& point : lines) {
+		if (!qIsFinite(point.x()) || !qIsFinite(point.y())) continue;
+		if (point.x() < lastX) return false;
+		lastX = point.x();
+	}
+
+	const double devicePixelRatio = device->devicePixelRatioF();
+	double width = pen.widthF();
+	if (width == 0.0 || qFuzzyCompare(width, 1.0)) width = 1.0; // QCPAbstractPlottable1D::drawPolyline draws 1 px pens cosmetic
+	else if (!pen.isCosmetic()) width *= devicePixelRatio;
+	if (width > Constants::LINE_RASTER_MAX_PEN_PX) return false;
+
+	// Clip in device pixels
+	const QPointF translation(painter->worldTransform().dx(), painter->worldTransform().dy());
+	QRect clip(0, 0, device->width(), device->height());
+	if (painter->hasClipping()) {
+		const QRectF logical = painter->clipBoundingRect().translated(translation);
+		clip &= QRectF(logical.topLeft() * devicePixelRatio, logical.size() * devicePixelRatio).toAlignedRect();
+	}
+	if (clip.isEmpty()) return true;
+
+	// Target: the device itself if it is an image we may write to, else the scratch layer covering the clip
+	LineLayer& layer = lineLayer();
+	QImage* target = nullptr;
+	QRect targetClip = clip;
+	QPointF origin; // Device pixel of the target's (0, 0)
+	if (device->devType() == QInternal::Image) {
+		QImage* image = static_cast<QImage*>(device);
+		if ((image->format() == QImage::Format_ARGB32_Premultiplied || image->format() == QImage::Format_RGB32) && image->isDetached()) {
+			target = image;
+		}
+	}
+	if (!target) {
+		if (layer.image.size() != clip.size()) {
+			layer.image = QImage(clip.size(), QImage::Format_ARGB32_Premultiplied);
+			layer.image.fill(0);
+			layer.rasterizer.resetTouched();
+		}
+		target = &layer.image;
+		targetClip = QRect(QPoint(0, 0), clip.size());
+		origin = clip.topLeft();
+	}
+
+	const QRgb color = qPremultiply(pen.color().rgba());
+	const bool squareCap = pen.capStyle() == Qt::SquareCap;
+	auto drawRun = [&]() {
+		if (layer.points.size() > 1) {
+			layer.rasterizer.drawPolyline(target, targetClip, layer.points.constData(), layer.points.size(), width, color, squareCap);
+		}
+		layer.points.resize(0);
+	};
+	layer.points.resize(0);
+	for (const QPointF& point : lines) {
+		if (!qIsFinite(point.x()) || !qIsFinite(point.y())) { // NaNs create a gap in the line
+			drawRun();
+			continue;
+		}
+		layer.points.append((point + translation) * devicePixelRatio - origin);
+	}
+	drawRun();
+
+	if (target == &layer.image) {
+		const QRect touched = layer.rasterizer.touchedRect();
+		if (!touched.isEmpty()) {
+			layer.image.setDevicePixelRatio(devicePixelRatio);
+			painter->drawImage((origin + touched.topLeft()) / devicePixelRatio - translation, layer.image, QRectF(touched));
+			layer.rasterizer.clearTouched(&layer.image);
+		}
+	} else {
+		layer.rasterizer.resetTouched();
+	}
+	return true;
+}
+
+void IndexedGraph::binSpan(double left, double right, int* first, int* last) const
+{
+	const double width = Constants::HIT_INDEX_BIN_WIDTH_PX;
+	const double maxBin = m_binCount - 1;
+	*first = int(qBound(0.0, std::floor((left - m_binOrigin) / width), maxBin));
+	*last = int(qBound(0.0, std::floor((right - m_binOrigin) / width), maxBin));
+}
+
+void IndexedGraph::buildIndex()
+{
+	if (!mKeyAxis || !mValueAxis || mKeyAxis->orientation() != Qt::Horizontal) return;
+	if (mLineStyle == lsNone || mLineStyle == lsImpulse || !mScatterStyle.isNone()) return;
+	const QRect axisRect = mKeyAxis->axisRect()->rect();
+	if (axisRect.width() <= 0) return;
+
+	const double width = Constants::HIT_INDEX_BIN_WIDTH_PX;
+	m_binOrigin = axisRect.left();
+	m_binCount = int(std::ceil(axisRect.width() / width)) + 1;
+	const double extentRight = m_binOrigin + m_binCount * width;
+	m_binStart.fill(0, m_binCount + 1);
+	m_binTop.fill(std::numeric_limits<double>::max(), m_binCount);
+	m_binBottom.fill(std::numeric_limits<double>::lowest(), m_binCount);
+
+	// Columns covered by segment i, false for gaps and segments outside the axis rect
+	auto segmentBins = [&](int i, int* first, int* last) {
+		const QPointF& a = m_lines.at(i);
+		const QPointF& b = m_lines.at(i + 1);
+		if (!qIsFinite(a.x()) || !qIsFinite(a.y()) || !qIsFinite(b.x()) || !qIsFinite(b.y())) return false;
+		const double left = qMin(a.x(), b.x());
+		const double right = qMax(a.x(), b.x());
+		if (right < m_binOrigin || left > extentRight) return false;
+		binSpan(left, right, first, last);
+		return true;
+	};
+
+	// First pass: segments per column and the vertical extent they cover
+	const int segmentCount = m_lines.size() - 1;
+	for (int i = 0; i < segmentCount; ++i) {
+		int first, last;
+		if (!segmentBins(i, &first, &last)) continue;
+		const double top = qMin(m_lines.at(i).y(), m_lines.at(i + 1).y());
+		const double bottom = qMax(m_lines.at(i).y(), m_lines.at(i + 1).y());
+		for (int c = first; c <= last; ++c) {
+			++m_binStart[c + 1];
+			m_binTop[c] = qMin(m_binTop[c], top);
+			m_binBottom[c] = qMax(m_binBottom[c], bottom);
+		}
+	}
+	for (int c = 0; c < m_binCount; ++c) m_binStart[c + 1] += m_binStart[c];
+
+	// Second pass: segment lists, each column filled from its end down to its start
+	m_binSegments.resize(m_binStart[m_binCount]);
+	for (int i = segmentCount - 1; i >= 0; --i) {
+		int first, last;
+		if (!segmentBins(i, &first, &last)) continue;
+		for (int c = first; c <= last; ++c) m_binSegments[--m_binStart[c + 1]] = i;
+	}
+	// Each m_binStart[c + 1] was counted down to the start of column c
+	for (int c = 0; c < m_binCount; ++c) m_binStart[c] = m_binStart[c + 1];
+	m_binStart[m_binCount] = int(m_binSegments.size());
+
+	m_indexAxisRect = axisRect;
+	m_indexKeyRange = mKeyAxis->range();
+	m_indexValueRange = mValueAxis->range();
+	m_indexDataCount = mDataContainer->size();
+	m_indexValid = true;
+}
+
+bool IndexedGraph::indexCurrent() const
+{
+	return m_indexValid && mKeyAxis && mValueAxis
+		&& mKeyAxis->axisRect()->rect() == m_indexAxisRect
+		&& mKeyAxis->range() == m_indexKeyRange
+		&& mValueAxis->range() == m_indexValueRange
+		&& mDataContainer->size() == m_indexDataCount
+		&& !mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect);
+}
+
+int IndexedGraph::nearestDataIndex(double pixelKey) const
+{
+	const QCPGraphDataContainer::const_iterator begin = mDataContainer->constBegin();
+	QCPGraphDataContainer::const_iterator it = mDataContainer->findBegin(mKeyAxis->pixelToCoord(pixelKey), false);
+	if (it == mDataContainer->constEnd()) {
+		--it;
+	} else if (it != begin && qAbs(mKeyAxis->coordToPixel((it - 1)->key) - pixelKey) < qAbs(mKeyAxis->coordToPixel(it->key) - pixelKey)) {
+		--it;
+	}
+	return int(it - begin);
+}
+
+// --- Hit testing ---
+
+double IndexedGraph::selectTest(const QPointF& pos, bool onlySelectable, QVariant* details) const
+{
+	if (!indexCurrent()) return QCPGraph::selectTest(pos, onlySelectable, details);
+	if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty()) return -1;
+	if (!m_indexAxisRect.contains(pos.toPoint())) return -1;
+
+	const double tolerance = mParentPlot->selectionTolerance();
+	int first, last;
+	binSpan(pos.x() - tolerance, pos.x() + tolerance, &first, &last);
+	const QCPVector2D p(pos);
+	double minDistSqr = std::numeric_limits<double>::max();
+	QPointF closestVertex;
+	for (int c = first; c <= last; ++c) {
+		if (pos.y() < m_binTop[c] - tolerance || pos.y() > m_binBottom[c] + tolerance) continue;
+		for (int k = m_binStart[c]; k < m_binStart[c + 1]; ++k) {
+			const QPointF& a = m_lines.at(m_binSegments[k]);
+			const QPointF& b = m_lines.at(m_binSegments[k] + 1);
+			const double distSqr = p.distanceSquaredToLine(a, b);
+			if (distSqr < minDistSqr) {
+				minDistSqr = distSqr;
+				closestVertex = ((QCPVector2D(a) - p).lengthSquared() <= (QCPVector2D(b) - p).lengthSquared()) ? a : b;
+			}
+		}
+	}
+	if (minDistSqr == std::numeric_limits<double>::max()) return -1; // Nothing within the tolerance
+
+	if (details) {
+		const int index = nearestDataIndex(closestVertex.x());
+		details->setValue(QCPDataSelection(QCPDataRange(index, index + 1)));
+	}
+	return std::sqrt(minDistSqr);
+}
+
+QCPDataSelection IndexedGraph::selectTestRect(const QRectF& rect, bool onlySelectable) const
+{
+	const QRectF r = rect.normalized();
+	if (!indexCurrent() || r.left() < m_binOrigin || r.right() > m_binOrigin + m_indexAxisRect.width()) {
+		return QCPGraph::selectTestRect(rect, onlySelectable);
+	}
+	QCPDataSelection result;
+	if ((onlySelectable && mSelectable == QCP::stNone) || mDataContainer->isEmpty()) return result;
+
+	// Only runs of columns whose segments reach into the rect can hold selected points
+	auto overlaps = [&](int c) { return m_binBottom[c] >= r.top() && m_binTop[c] <= r.bottom(); };
+	const double width = Constants::HIT_INDEX_BIN_WIDTH_PX;
+	const QCPRange valueRange(mValueAxis->pixelToCoord(r.top()), mValueAxis->pixelToCoord(r.bottom()));
+	const QCPGraphDataContainer::const_iterator begin = mDataContainer->constBegin();
+	int first, last;
+	binSpan(r.left(), r.right(), &first, &last);
+	for (int c = first; c <= last; ++c) {
+		if (!overlaps(c)) continue;
+		int runEnd = c;
+		while (runEnd < last && overlaps(runEnd + 1)) ++runEnd;
+		const QCPRange keyRange(mKeyAxis->pixelToCoord(qMax(r.left(), m_binOrigin + c * width)),
+								mKeyAxis->pixelToCoord(qMin(r.right(), m_binOrigin + (runEnd + 1) * width)));
+		c = runEnd;
+
+		const QCPGraphDataContainer::const_iterator end = mDataContainer->findEnd(keyRange.upper, false);
+		int segmentBegin = -1;
+		for (QCPGraphDataContainer::const_iterator it = mDataContainer->findBegin(keyRange.lower, false); it != end; ++it) {
+			const bool inside = keyRange.contains(it->key) && valueRange.contains(it->value);
+			if (inside && segmentBegin < 0) {
+				segmentBegin = int(it - begin);
+			} else if (!inside && segmentBegin >= 0) {
+				result.addDataRange(QCPDataRange(segmentBegin, int(it - begin)), false);
+				segmentBegin = -1;
+			}
+		}
+		if (segmentBegin >= 0) result.addDataRange(QCPDataRange(segmentBegin, int(end - begin)), false);
+	}
+	result.simplify();
+	return result;
+}
@@ -0,0 +1,103 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef INDEXEDGRAPH_H
+#define INDEXEDGRAPH_H
+
+#include <QVector>
+#include <QPointF>
+#include <QRect>
+
+#include "qcustomplot.h"
+
+/*
+ * QCPGraph with a pixel-space index of its rendered polyline for hit testing.
+ *
+ * QCPGraph::selectTest rebuilds the line of the whole data set on every click
+ * (pointDistance), and selectTestRect scans every point in the key span of the
+ * rectangle, so with many dense traces each click costs O(points x graphs).
+ *
+ * While drawing, the line segments handed to drawLinePlot are kept and sorted
+ * into columns of HIT_INDEX_BIN_WIDTH_PX pixels, each with the vertical extent
+ * of its segments. A hit test only looks at the columns under the selection
+ * tolerance: graphs whose extent misses the point are rejected in O(1), the
+ * others measure the segments of those columns only. Rectangle selection scans
+ * the data of the columns whose extent overlaps the rectangle.
+ *
+ * The index belongs to the last frame drawn; if the axes, axis rect or data
+ * size changed since then (or for styles the index does not model: scatters,
+ * impulses, vertical key axes), the QCPGraph implementations are used.
+ *
+ * With fast lines on, the line is drawn by MonotoneLineRasterizer instead of
+ * QPainter when it can be: solid antialiased pen, source-over, a translation
+ * at most, a raster image or pixmap device and x not decreasing. Image devices
+ * are drawn into directly; pixmaps (QCustomPlot's paint buffers) through a
+ * scratch layer shared by all graphs, composited with one drawImage.
+ */
+class IndexedGraph : public QCPGraph
+{
+	Q_OBJECT
+public:
+	IndexedGraph(QCPAxis* keyAxis, QCPAxis* valueAxis);
+
+	void setFastLines(bool enabled) { m_fastLines = enabled; }
+	bool fastLines() const { return m_fastLines; }
+
+	double selectTest(const QPointF& pos, bool onlySelectable, QVariant* details = nullptr) const override;
+	QCPDataSelection selectTestRect(const QRectF& rect, bool onlySelectable) const override;
+
+protected:
+	void draw(QCPPainter* painter) override;
+	void drawLinePlot(QCPPainter* painter, const QVector<QPointF>& lines) const override;
+
+private:
+	bool drawRasterizedLine(QCPPainter* painter, const QVector<QPointF>& lines) const;
+	void buildIndex();
+	bool indexCurrent() const;
+	void binSpan(double left, double right, int* first, int* last) const;
+	int nearestDataIndex(double pixelKey) const;
+
+	// Filled by drawLinePlot during draw(); NaN points separate the polylines of different segments
+	mutable QVector<QPointF> m_lines;
+	mutable bool m_collecting = false;
+	bool m_fastLines = false;
+
+	// Column index (CSR layout): segments starting at m_lines[i] are listed per column
+	QVector<int> m_binStart;
+	QVector<int> m_binSegments;
+	QVector<double> m_binTop;
+	QVector<double> m_binBottom;
+	int m_binCount = 0;
+	double m_binOrigin = 0.0;
+
+	// State the index was built for
+	bool m_indexValid = false;
+	QRect m_indexAxisRect;
+	QCPRange m_indexKeyRange;
+	QCPRange m_indexValueRange;
+	int m_indexDataCount = 0;
+};
+
+#endif // INDEXEDGRAPH_H
@@ -0,0 +1,385 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "legendpanel.h"
+
+#include <QComboBox>
+#include <QDir>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHash>
+#include <QItemSelectionModel>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSet>
+#include <QSortFilterProxyModel>
+#include <QTreeView>
+#include <QVBoxLayout>
+
+// --- DatasetListModel ---
+// Top level indexes have internalId 0; dataset rows inside a group carry group row + 1.
+
+DatasetListModel::DatasetListModel(const DatasetRegistry* registry, QObject* parent)
+	: QAbstractItemModel(parent), m_registry(registry)
+{
+}
+
+void DatasetListModel::setGrouping(Grouping grouping)
+{
+	if (grouping == m_grouping) return;
+	m_grouping = grouping;
+	rebuild();
+}
+
+QString DatasetListModel::groupKey(DatasetRegistry::Handle handle) const
+{
+	if (m_grouping == Grouping::Folder) {
+		return QDir::toNativeSeparators(QFileInfo(m_registry->filename(handle)).absolutePath());
+	}
+	// Name prefix: text before the first separator, e.g. "osc1" for "osc1_run42"
+	const QString& name = m_registry->displayName(handle);
+	for (int i = 1; i < name.size(); ++i) {
+		const QChar c = name.at(i);
+		if (c == '_' || c == '-' || c == ' ' || c == '.') {
+			return name.left(i);
+		}
+	}
+	return name;
+}
+
+void DatasetListModel::rebuild()
+{
+	beginResetModel();
+	m_groups.clear();
+	m_flat.clear();
+	if (m_grouping == Grouping::None) {
+		m_flat = m_registry->handles();
+	} else {
+		QHash<QString, int> groupRows;
+		for (DatasetRegistry::Handle handle : m_registry->handles()) {
+			const QString key = groupKey(handle);
+			auto it = groupRows.constFind(key);
+			if (it == groupRows.constEnd()) {
+				it = groupRows.insert(key, m_groups.size());
+				m_groups.append(Group{key, {}});
+			}
+			m_groups[it.value()].members.append(handle);
+		}
+	}
+	endResetModel();
+}
+
+void DatasetListModel::refreshState()
+{
+	const QVector<int> roles = { Qt::CheckStateRole, Qt::DecorationRole };
+	if (m_grouping == Grouping::None) {
+		if (!m_flat.isEmpty()) {
+			emit dataChanged(index(0, 0), index(m_flat.size() - 1, 0), roles);
+		}
+		return;
+	}
+	if (m_groups.isEmpty()) return;
+	emit dataChanged(index(0, 0), index(m_groups.size() - 1, 0), roles);
+	for (int row = 0; row < m_groups.size(); ++row) {
+		const QModelIndex groupIndex = index(row, 0);
+		emit dataChanged(index(0, 0, groupIndex), index(m_groups[row].members.size() - 1, 0, groupIndex), roles);
+	}
+}
+
+bool DatasetListModel::isGroupIndex(const QModelIndex& index) const
+{
+	return index.isValid() && m_grouping != Grouping::None && index.internalId() == 0;
+}
+
+DatasetRegistry::Handle DatasetListModel::handleOf(const QModelIndex& index) const
+{
+	if (!index.isValid() || isGroupIndex(index)) return DatasetRegistry::InvalidHandle;
+	if (m_grouping == Grouping::None) return m_flat.value(index.row(), DatasetRegistry::InvalidHandle);
+	const int groupRow = int(index.internalId()) - 1;
+	return m_groups[groupRow].members.value(index.row(), DatasetRegistry::InvalidHandle);
+}
+
+QVector<DatasetRegistry::Handle> DatasetListModel::handlesAt(const QModelIndex& index) const
+{
+	if (isGroupIndex(index)) return m_groups[index.row()].members;
+	const DatasetRegistry::Handle handle = handleOf(index);
+	if (handle == DatasetRegistry::InvalidHandle) return {};
+	return { handle };
+}
+
+Qt::CheckState DatasetListModel::groupCheckState(const Group& group) const
+{
+	int visibleCount = 0;
+	for (DatasetRegistry::Handle handle : group.members) {
+		if (m_registry->isVisible(handle)) ++visibleCount;
+	}
+	if (visibleCount == 0) return Qt::Unchecked;
+	return visibleCount == group.members.size() ? Qt::Checked : Qt::PartiallyChecked;
+}
+
+QModelIndex DatasetListModel::index(int row, int column, const QModelIndex& parent) const
+{
+	if (column != 0 || row < 0) return QModelIndex();
+	if (!parent.isValid()) {
+		const int count = (m_grouping == Grouping::None) ? m_flat.size() : m_groups.size();
+		return row < count ? createIndex(row, 0, quintptr(0)) : QModelIndex();
+	}
+	if (!isGroupIndex(parent) || row >= m_groups[parent.row()].members.size()) return QModelIndex();
+	return createIndex(row, 0, quintptr(parent.row() + 1));
+}
+
+QModelIndex DatasetListModel::parent(const QModelIndex& child) const
+{
+	if (!child.isValid() || child.internalId() == 0) return QModelIndex();
+	return createIndex(int(child.internalId()) - 1, 0, quintptr(0));
+}
+
+int DatasetListModel::rowCount(const QModelIndex& parent) const
+{
+	if (!parent.isValid()) {
+		return (m_grouping == Grouping::None) ? m_flat.size() : m_groups.size();
+	}
+	return isGroupIndex(parent) ? m_groups[parent.row()].members.size() : 0;
+}
+
+int DatasetListModel::columnCount(const QModelIndex& parent) const
+{
+	Q_UNUSED(parent)
+	return 1;
+}
+
+QVariant DatasetListModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid()) return QVariant();
+
+	if (isGroupIndex(index)) {
+		const Group& group = m_groups[index.row()];
+		switch (role) {
+		case Qt::DisplayRole: return QString("%1 (%2)").arg(group.key).arg(group.members.size());
+		case Qt::ToolTipRole:
+		case GroupRole: return group.key;
+		case Qt::CheckStateRole: return groupCheckState(group);
+		case HandleRole: return DatasetRegistry::InvalidHandle;
+		default: return QVariant();
+		}
+	}
+
+	const DatasetRegistry::Handle handle = handleOf(index);
+	if (!m_registry->contains(handle)) return QVariant();
+	switch (role) {
+	case Qt::DisplayRole: return m_registry->displayName(handle);
+	case Qt::ToolTipRole: return QDir::toNativeSeparators(m_registry->filename(handle));
+	case Qt::DecorationRole: return m_registry->measuredColor(handle); // Drawn as a color swatch
+	case Qt::CheckStateRole: return m_registry->isVisible(handle) ? Qt::Checked : Qt::Unchecked;
+	case HandleRole: return handle;
+	case GroupRole: return (m_grouping == Grouping::None) ? QString() : m_groups[int(index.internalId()) - 1].key;
+	default: return QVariant();
+	}
+}
+
+bool DatasetListModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+	if (role != Qt::CheckStateRole || !index.isValid()) return false;
+
+	const bool visible = (value.toInt() == Qt::Checked);
+	DatasetVisibilityChanges changes;
+	for (DatasetRegistry::Handle handle : handlesAt(index)) {
+		if (m_registry->isVisible(handle) != visible) {
+			changes.append(qMakePair(handle, visible));
+		}
+	}
+	if (!changes.isEmpty()) {
+		emit visibilityChangeRequested(changes); // Owner applies and calls refreshState()
+	}
+	return true;
+}
+
+Qt::ItemFlags DatasetListModel::flags(const QModelIndex& index) const
+{
+	if (!index.isValid()) return Qt::NoItemFlags;
+	return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+}
+
+// --- LegendPanel ---
+
+LegendPanel::LegendPanel(const DatasetRegistry* registry, QWidget* parent)
+	: QWidget(parent), m_registry(registry)
+{
+	m_model = new DatasetListModel(registry, this);
+	connect(m_model, &DatasetListModel::visibilityChangeRequested, this, &LegendPanel::visibilityChangeRequested);
+
+	m_proxy = new QSortFilterProxyModel(this);
+	m_proxy->setSourceModel(m_model);
+	m_proxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+	m_proxy->setRecursiveFilteringEnabled(true); // Keep groups that contain a match
+
+	QVBoxLayout* layout = new QVBoxLayout(this);
+	layout->setContentsMargins(4, 4, 4, 4);
+
+	QHBoxLayout* filterLayout = new QHBoxLayout();
+	m_filterEdit = new QLineEdit(this);
+	m_filterEdit->setPlaceholderText("Search datasets...");
+	m_filterEdit->setClearButtonEnabled(true);
+	connect(m_filterEdit, &QLineEdit::textChanged, this, &LegendPanel::onFilterTextChanged);
+	filterLayout->addWidget(m_filterEdit, 1);
+
+	m_groupCombo = new QComboBox(this);
+	m_groupCombo->addItem("No Grouping");
+	m_groupCombo->addItem("Group by Folder");
+	m_groupCombo->addItem("Group by Name Prefix");
+	connect(m_groupCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &LegendPanel::onGroupingChanged);
+	filterLayout->addWidget(m_groupCombo);
+	layout->addLayout(filterLayout);
+
+	m_view = new QTreeView(this);
+	m_view->setModel(m_proxy);
+	m_view->setHeaderHidden(true);
+	m_view->setUniformRowHeights(true); // Lets the view skip measuring every row
+	m_view->setRootIsDecorated(false);
+	m_view->setSelectionMode(QAbstractItemView::ExtendedSelection);
+	m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	connect(m_view, &QTreeView::doubleClicked, this, &LegendPanel::onActivated);
+	layout->addWidget(m_view, 1);
+
+	QHBoxLayout* buttonLayout = new QHBoxLayout();
+	QPushButton* showButton = new QPushButton("Show", this);
+	QPushButton* hideButton = new QPushButton("Hide", this);
+	QPushButton* toggleButton = new QPushButton("Toggle", this);
+	QPushButton* onlyButton = new QPushButton("Only", this);
+	showButton->setToolTip("Show the selected datasets");
+	hideButton->setToolTip("Hide the selected datasets");
+	toggleButton->setToolTip("Invert the visibility of the selected datasets");
+	onlyButton->setToolTip("Show the selected datasets and hide all others");
+	connect(showButton, &QPushButton::clicked, this, [this]() { applyToSelection(BulkAction::Show); });
+	connect(hideButton, &QPushButton::clicked, this, [this]() { applyToSelection(BulkAction::Hide); });
+	connect(toggleButton, &QPushButton::clicked, this, [this]() { applyToSelection(BulkAction::Toggle); });
+	connect(onlyButton, &QPushButton::clicked, this, [this]() { applyToSelection(BulkAction::Only); });
+	buttonLayout->addWidget(showButton);
+	buttonLayout->addWidget(hideButton);
+	buttonLayout->addWidget(toggleButton);
+	buttonLayout->addWidget(onlyButton);
+	layout->addLayout(buttonLayout);
+
+	m_countLabel = new QLabel(this);
+	layout->addWidget(m_countLabel);
+
+	rebuild();
+}
+
+void LegendPanel::rebuild()
+{
+	m_model->rebuild();
+	if (m_model->grouping() != DatasetListModel::Grouping::None) {
+		m_view->expandAll();
+	}
+	updateCountLabel();
+}
+
+void LegendPanel::refreshState()
+{
+	m_model->refreshState();
+	updateCountLabel();
+}
+
+void LegendPanel::onFilterTextChanged(const QString& text)
+{
+	m_proxy->setFilterFixedString(text);
+	if (m_model->grouping() != DatasetListModel::Grouping::None) {
+		m_view->expandAll();
+	}
+}
+
+void LegendPanel::onGroupingChanged(int index)
+{
+	const DatasetListModel::Grouping grouping = (index == 1) ? DatasetListModel::Grouping::Folder
+											  : (index == 2) ? DatasetListModel::Grouping::NamePrefix
+															 : DatasetListModel::Grouping::None;
+	m_model->setGrouping(grouping);
+	m_view->setRootIsDecorated(grouping != DatasetListModel::Grouping::None);
+	if (grouping != DatasetListModel::Grouping::None) {
+		m_view->expandAll();
+	}
+}
+
+void LegendPanel::onActivated(const QModelIndex& proxyIndex)
+{
+	const DatasetRegistry::Handle handle = proxyIndex.data(DatasetListModel::HandleRole).toInt();
+	if (handle != DatasetRegistry::InvalidHandle) {
+		emit activateRequested(handle);
+	}
+}
+
+QVector<DatasetRegistry::Handle> LegendPanel::selectedHandles() const
+{
+	QVector<DatasetRegistry::Handle> handles;
+	QSet<DatasetRegistry::Handle> seen; // A dataset may be selected both directly and through its group
+	const QModelIndexList rows = m_view->selectionModel()->selectedRows();
+	for (const QModelIndex& proxyIndex : rows) {
+		for (DatasetRegistry::Handle handle : m_model->handlesAt(m_proxy->mapToSource(proxyIndex))) {
+			if (!seen.contains(handle)) {
+				seen.insert(handle);
+				handles.append(handle);
+			}
+		}
+	}
+	return handles;
+}
+
+void LegendPanel::applyToSelection(BulkAction action)
+{
+	const QVector<DatasetRegistry::Handle> selected = selectedHandles();
+	if (selected.isEmpty()) return;
+
+	// Only datasets whose state actually changes are reported
+	DatasetVisibilityChanges changes;
+	if (action == BulkAction::Only) {
+		const QSet<DatasetRegistry::Handle> keep(selected.cbegin(), selected.cend());
+		for (DatasetRegistry::Handle handle : m_registry->handles()) {
+			const bool visible = keep.contains(handle);
+			if (m_registry->isVisible(handle) != visible) changes.append(qMakePair(handle, visible));
+		}
+	} else {
+		for (DatasetRegistry::Handle handle : selected) {
+			const bool current = m_registry->isVisible(handle);
+			const bool visible = (action == BulkAction::Show) ? true
+							   : (action == BulkAction::Hide) ? false
+															  : !current;
+			if (current != visible) changes.append(qMakePair(handle, visible));
+		}
+	}
+	if (!changes.isEmpty()) {
+		emit visibilityChangeRequested(changes);
+	}
+}
+
+void LegendPanel::updateCountLabel()
+{
+	int visibleCount = 0;
+	for (DatasetRegistry::Handle handle : m_registry->handles()) {
+		if (m_registry->isVisible(handle)) ++visibleCount;
+	}
+	m_countLabel->setText(QString("%1 of %2 datasets visible").arg(visibleCount).arg(m_registry->size()));
+}
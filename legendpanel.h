@@ -0,0 +1,139 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef LEGENDPANEL_H
+#define LEGENDPANEL_H
+
+#include <QAbstractItemModel>
+#include <QPair>
+#include <QVector>
+#include <QWidget>
+
+#include "datasetregistry.h"
+
+class QComboBox;
+class QLineEdit;
+class QSortFilterProxyModel;
+class QTreeView;
+class QLabel;
+
+// Requested visibility per dataset, applied by the owner with a single plot update
+using DatasetVisibilityChanges = QVector<QPair<DatasetRegistry::Handle, bool>>;
+
+/*
+ * Item model over the datasets of a DatasetRegistry.
+ * Flat list, or two levels (group -> datasets) when grouping is enabled. The model
+ * only reads the registry: check state edits are turned into visibilityChangeRequested()
+ * so the owner can apply them and replot once. Group rows are tristate and toggle
+ * all their members in one request.
+ */
+class DatasetListModel : public QAbstractItemModel
+{
+	Q_OBJECT
+public:
+	enum Role {
+		HandleRole = Qt::UserRole + 1, // Dataset handle, InvalidHandle for group rows
+		GroupRole                      // Group key of the dataset or group row
+	};
+	enum class Grouping { None, Folder, NamePrefix };
+
+	explicit DatasetListModel(const DatasetRegistry* registry, QObject* parent = nullptr);
+
+	void setGrouping(Grouping grouping);
+	Grouping grouping() const { return m_grouping; }
+
+	void rebuild();      // Datasets were added or removed
+	void refreshState(); // Visibility or colors changed, same datasets
+
+	// Handles under an index (one dataset, or all members of a group row)
+	QVector<DatasetRegistry::Handle> handlesAt(const QModelIndex& index) const;
+
+	QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+	QModelIndex parent(const QModelIndex& child) const override;
+	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+	Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+signals:
+	void visibilityChangeRequested(const DatasetVisibilityChanges& changes);
+
+private:
+	struct Group {
+		QString key;
+		QVector<DatasetRegistry::Handle> members;
+	};
+
+	QString groupKey(DatasetRegistry::Handle handle) const;
+	bool isGroupIndex(const QModelIndex& index) const;
+	DatasetRegistry::Handle handleOf(const QModelIndex& index) const;
+	Qt::CheckState groupCheckState(const Group& group) const;
+
+	const DatasetRegistry* m_registry;
+	Grouping m_grouping = Grouping::None;
+	QVector<Group> m_groups; // Grouped mode only
+	QVector<DatasetRegistry::Handle> m_flat; // Ungrouped mode only
+};
+
+/*
+ * Out-of-plot legend: searchable, groupable dataset list with bulk visibility.
+ * The tree view only creates paint work for visible rows, so it stays responsive
+ * with thousands of datasets where the in-plot QCPLegend lays out every item.
+ */
+class LegendPanel : public QWidget
+{
+	Q_OBJECT
+public:
+	explicit LegendPanel(const DatasetRegistry* registry, QWidget* parent = nullptr);
+
+	void rebuild();
+	void refreshState();
+
+signals:
+	void visibilityChangeRequested(const DatasetVisibilityChanges& changes);
+	void activateRequested(DatasetRegistry::Handle handle); // Double click: make it the active dataset
+
+private slots:
+	void onFilterTextChanged(const QString& text);
+	void onGroupingChanged(int index);
+	void onActivated(const QModelIndex& proxyIndex);
+
+private:
+	enum class BulkAction { Show, Hide, Toggle, Only };
+	void applyToSelection(BulkAction action);
+	QVector<DatasetRegistry::Handle> selectedHandles() const;
+	void updateCountLabel();
+
+	const DatasetRegistry* m_registry;
+	DatasetListModel* m_model = nullptr;
+	QSortFilterProxyModel* m_proxy = nullptr;
+	QTreeView* m_view = nullptr;
+	QLineEdit* m_filterEdit = nullptr;
+	QComboBox* m_groupCombo = nullptr;
+	QLabel* m_countLabel = nullptr;
+};
+
+#endif // LEGENDPANEL_H
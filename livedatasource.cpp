@@ -0,0 +1,161 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "livedatasource.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+#include <chrono>
+#include <utility>
+
+LiveDataSource::LiveDataSource(int bufferFrames)
+	: m_buffer(size_t(qMax(2, bufferFrames)))
+{
+}
+
+LiveDataSource::~LiveDataSource()
+{
+	// Subclasses already stopped the thread; this only catches a missing stop()
+	Q_ASSERT(!m_thread);
+}
+
+qint64 LiveDataSource::nowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool LiveDataSource::start(QString* errorString)
+{
+	if (m_thread) {
+		if (errorString) *errorString = QStringLiteral("%1 is already running").arg(name());
+		return false;
+	}
+	{
+		QMutexLocker locker(&m_errorMutex);
+		m_error.clear();
+	}
+	m_stopRequested.store(false, std::memory_order_release);
+	m_running.store(true, std::memory_order_release);
+	m_thread = QThread::create([this]() { run(); });
+	m_thread->setObjectName(name());
+	m_thread->start();
+	return true;
+}
+
+void LiveDataSource::stop()
+{
+	if (!m_thread) return;
+	m_stopRequested.store(true, std::memory_order_release);
+	m_thread->wait();
+	delete m_thread;
+	m_thread = nullptr;
+}
+
+QString LiveDataSource::lastError() const
+{
+	QMutexLocker locker(&m_errorMutex);
+	return m_error;
+}
+
+void LiveDataSource::run()
+{
+	QString error;
+	if (open(&error)) {
+		while (!isStopRequested()) {
+			SweepFrame frame;
+			if (!acquire(&frame, &error)) break;
+			frame.sequence = m_sequence++;
+			if (frame.acquiredNs == 0) frame.acquiredNs = nowNs();
+			if (m_buffer.tryPush(std::move(frame))) {
+				m_produced.fetch_add(1, std::memory_order_relaxed);
+			} else {
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		close();
+	}
+
+	if (!error.isEmpty()) {
+		qWarning().noquote() << name() << "stopped:" << error;
+		QMutexLocker locker(&m_errorMutex);
+		m_error = error;
+	}
+	m_running.store(false, std::memory_order_release);
+}
+
+bool LiveDataSource::open(QString* errorString)
+{
+	Q_UNUSED(errorString)
+	return true;
+}
+
+void LiveDataSource::close()
+{
+}
+
+void LiveDataSource::consumed(const SweepFrame& frame)
+{
+	m_consumed++;
+	m_lastLatencyMs = double(nowNs() - frame.acquiredNs) / 1e6;
+	m_maxLatencyMs = qMax(m_maxLatencyMs, m_lastLatencyMs);
+}
+
+int LiveDataSource::drain(QVector<SweepFrame>* frames, int maxFrames)
+{
+	int count = 0;
+	SweepFrame frame;
+	while (count < maxFrames && m_buffer.tryPop(frame)) {
+		consumed(frame);
+		frames->append(std::move(frame));
+		count++;
+	}
+	return count;
+}
+
+bool LiveDataSource::takeLatest(SweepFrame* frame)
+{
+	bool any = false;
+	SweepFrame next;
+	while (m_buffer.tryPop(next)) {
+		if (any) m_skipped++;
+		*frame = std::move(next);
+		any = true;
+	}
+	if (any) consumed(*frame);
+	return any;
+}
+
+LiveDataSource::Stats LiveDataSource::stats() const
+{
+	Stats stats;
+	stats.produced = m_produced.load(std::memory_order_relaxed);
+	stats.dropped = m_dropped.load(std::memory_order_relaxed);
+	stats.consumed = m_consumed;
+	stats.skipped = m_skipped;
+	stats.lastLatencyMs = m_lastLatencyMs;
+	stats.maxLatencyMs = m_maxLatencyMs;
+	return stats;
+}
@@ -0,0 +1,121 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef LIVEDATASOURCE_H
+#define LIVEDATASOURCE_H
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+#include "spscringbuffer.h"
+
+class QThread;
+
+// One complete sweep as delivered by an acquisition source
+struct SweepFrame {
+	quint64 sequence = 0;
+	qint64 acquiredNs = 0; // LiveDataSource::nowNs() when the sweep was complete
+	bool hasReferenceData = false;
+	QVector<double> frequencyOffset;
+	QVector<double> phaseNoise;
+	QVector<double> referenceNoise;
+};
+
+/*
+ * Base class of the live acquisition sources (simulator, instrument drivers).
+ *
+ * start() runs acquire() in a loop on a dedicated producer thread and pushes every
+ * sweep into a lock-free single-producer / single-consumer ring buffer. The consumer
+ * (the GUI, at display rate) calls takeLatest() or drain() from one thread only; it
+ * never waits for the producer. When the consumer falls behind and the buffer is
+ * full, new sweeps are dropped and counted rather than blocking the acquisition.
+ *
+ * Subclasses implement acquire() and may override open() / close(), which run on the
+ * producer thread. They must call stop() in their destructor, since the producer
+ * thread calls their virtual functions.
+ */
+class LiveDataSource
+{
+public:
+	struct Stats {
+		quint64 produced = 0;
+		quint64 dropped = 0;   // Buffer full
+		quint64 consumed = 0;
+		quint64 skipped = 0;   // Consumed but superseded by a newer sweep in takeLatest()
+		double lastLatencyMs = 0.0; // Acquisition to consumption of the last sweep
+		double maxLatencyMs = 0.0;
+	};
+
+	explicit LiveDataSource(int bufferFrames);
+	virtual ~LiveDataSource();
+
+	virtual QString name() const = 0;
+
+	bool start(QString* errorString = nullptr);
+	void stop(); // Waits for the producer thread
+	bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+	QString lastError() const; // Why the producer stopped on its own, empty otherwise
+
+	// Consumer side: one thread only
+	int drain(QVector<SweepFrame>* frames, int maxFrames);
+	bool takeLatest(SweepFrame* frame); // Newest sweep, older ones are skipped
+	Stats stats() const;
+
+	static qint64 nowNs(); // Monotonic clock used for SweepFrame::acquiredNs
+
+protected:
+	virtual bool open(QString* errorString);
+	// Blocks until the next sweep is complete. False ends the acquisition: with an
+	// empty errorString on end of data or stop request, with the reason otherwise.
+	virtual bool acquire(SweepFrame* frame, QString* errorString) = 0;
+	virtual void close();
+
+	bool isStopRequested() const { return m_stopRequested.load(std::memory_order_acquire); }
+
+private:
+	void run();
+	void consumed(const SweepFrame& frame);
+
+	SpscRingBuffer<SweepFrame> m_buffer;
+	QThread* m_thread = nullptr;
+	std::atomic<bool> m_running{false};
+	std::atomic<bool> m_stopRequested{false};
+	std::atomic<quint64> m_produced{0};
+	std::atomic<quint64> m_dropped{0};
+	quint64 m_sequence = 0; // Producer thread only
+
+	// Consumer thread only
+	quint64 m_consumed = 0;
+	quint64 m_skipped = 0;
+	double m_lastLatencyMs = 0.0;
+	double m_maxLatencyMs = 0.0;
+
+	mutable QMutex m_errorMutex;
+	QString m_error;
+};
+
+#endif // LIVEDATASOURCE_H
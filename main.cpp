@@ -26,25 +26,66 @@
 #include "phasenoiseanalyzerapp.h"
 #include "constants.h"
 #include "version.h"
+#include "startupprofiler.h"
+#include "singleinstance.h"
+#include "stallwatchdog.h"
+#include "allocprofiler.h"
+#include "batchprocessor.h"
+#include "datasetparser.h"
+#include "packfile.h"
 
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
+#include <QDir>
 #include <QFileInfo>
+#include <QStandardPaths>
 #include <QDebug>
 #include <QStyleFactory>
 
-int main(int argc, char *argv[])
+#include <cstring>
+
+// Also matches "name=value"
+static bool hasArgument(int argc, char *argv[], const char* name)
 {
-	QApplication app(argc, argv);
-	QApplication::setApplicationName(VER_FILEDESCRIPTION_STR);
-	QApplication::setApplicationVersion(VER_FILEVERSION_STR);
-	QApplication::setOrganizationName(VER_LEGALCOPYRIGHT_STR);
+	const size_t length = std::strlen(name);
+	for (int i = 1; i < argc; ++i) {
+		if (std::strncmp(argv[i], name, length) == 0 && (argv[i][length] == '\0' || argv[i][length] == '=')) return true;
+	}
+	return false;
+}
 
-	// Load the icon from the resource system
-	QIcon appIcon(":/images/pna.svg");
-	// Optionally, also set the application-wide icon
-	app.setWindowIcon(appIcon);
+// --overlap value; *out is left unchanged for an unknown policy
+static bool overlapFromArgument(const QString& argument, DatasetParser::StitchOptions::Overlap* out)
+{
+	if (argument == QLatin1String("later")) {
+		*out = DatasetParser::StitchOptions::Overlap::PreferLater;
+	} else if (argument == QLatin1String("average")) {
+		*out = DatasetParser::StitchOptions::Overlap::AveragePower;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+// --value-storage value; *out is left unchanged for an unknown type
+static bool valueStorageFromArgument(const QString& argument, ValueStorage* out)
+{
+	if (argument == QLatin1String("float64")) {
+		*out = ValueStorage::Float64;
+	} else if (argument == QLatin1String("float32")) {
+		*out = ValueStorage::Float32;
+	} else if (argument == QLatin1String("int16")) {
+		*out = ValueStorage::CentiDb16;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	StartupProfiler::start();
 
 	// Command line parsing
 	QCommandLineParser parser;
@@ -53,7 +94,7 @@ int main(int argc, char *argv[])
 	parser.addVersionOption();
 
 	// Define options
-	QCommandLineOption inputFileOption(QStringList() << "i" << "input", "Path to input CSV file(s). Can be specified multiple times.", "csv_filename");
+	QCommandLineOption inputFileOption(QStringList() << "i" << "input", "Path to input CSV file(s). Can be specified multiple times. '-' or a named pipe is read continuously as a stream of sweeps.", "csv_filename");
 	parser.addOption(inputFileOption);
 
 	QCommandLineOption noplotRefenceOption("noplotref", "Do not plot reference.");
@@ -65,6 +106,215 @@ int main(int argc, char *argv[])
 	QCommandLineOption dpiOption("dpi", "DPI for output image", "dpi", QString::number(Constants::DEFAULT_DPI));
 	parser.addOption(dpiOption);
 
+	QCommandLineOption startupReportOption("startup-report", "Print startup timing of each stage once the window is ready.");
+	parser.addOption(startupReportOption);
+
+	QCommandLineOption noRestoreOption("no-restore", "Do not restore the auto-saved workspace when no input file is given.");
+	parser.addOption(noRestoreOption);
+
+	QCommandLineOption memoryBudgetOption("memory-budget", "Memory budget in MB for filtered data and plot caches (0 = unlimited).", "megabytes", QString::number(Constants::DEFAULT_MEMORY_BUDGET_MB));
+	parser.addOption(memoryBudgetOption);
+
+	QCommandLineOption stallThresholdOption("stall-threshold", "Log GUI stalls longer than this many milliseconds with the operation that caused them (0 = off).", "ms", QString::number(Constants::STALL_THRESHOLD_MS));
+	parser.addOption(stallThresholdOption);
+
+	QCommandLineOption singleInstanceOption("single-instance", "Send the input files to an already running instance instead of opening a new window.");
+	parser.addOption(singleInstanceOption);
+
+	QCommandLineOption simulateOption("simulate", "Start the live simulator (Leeson-model sweeps with spurs) at this many sweeps per second, 0 = as fast as possible.", "sweeps_per_second");
+	parser.addOption(simulateOption);
+	QCommandLineOption sweepDelimiterOption("sweep-delimiter", "Streaming input: line that ends a sweep (default: a blank line).", "line");
+	parser.addOption(sweepDelimiterOption);
+	QCommandLineOption overlapOption("overlap", "Files with overlapping sweep segments or repeated sweeps: 'later' keeps the later segment where they overlap, 'average' averages them in power.", "policy", "later");
+	parser.addOption(overlapOption);
+	QCommandLineOption splitSweepsOption("split-sweeps", "Load each sweep of a file with several concatenated sweeps (frequency restarting) as its own dataset instead of merging them.");
+	parser.addOption(splitSweepsOption);
+	QCommandLineOption streamSweepsOption("stream-sweeps", "Streaming input: 'rolling' updates one dataset with each sweep, 'append' adds a dataset per sweep.", "mode", "rolling");
+	parser.addOption(streamSweepsOption);
+	QCommandLineOption fastLinesOption("fast-lines", "Draw the measured traces with the built-in line rasterizer instead of QPainter (meant for replots of dense traces without a GPU, speedup not measured yet, see benchmarks/linebench; antialiasing differs slightly).");
+	parser.addOption(fastLinesOption);
+
+	// Headless batch processing
+	QCommandLineOption batchOption("batch", "Process the input files (and positional files or directories) without a window: filter, spur removal, spot noise, integrated noise. Writes per-file results and batch_summary.csv.");
+	parser.addOption(batchOption);
+	QCommandLineOption outputDirOption("output-dir", "Batch: directory for the results (default: next to each input, summary in the current directory).", "directory");
+	parser.addOption(outputDirOption);
+	QCommandLineOption filterOption("filter", "Batch: filter to apply (moving-average, median, savitzky-golay).", "filter");
+	parser.addOption(filterOption);
+	QCommandLineOption filterWindowOption("filter-window", "Batch: filter window size in points.", "points", "5");
+	parser.addOption(filterWindowOption);
+	QCommandLineOption removeSpursOption("remove-spurs", "Batch: remove spurs (files with a reference column).");
+	parser.addOption(removeSpursOption);
+	QCommandLineOption integrateFromOption("integrate-from", "Batch: lower integration limit in Hz (default: first data point).", "hz");
+	parser.addOption(integrateFromOption);
+	QCommandLineOption integrateToOption("integrate-to", "Batch: upper integration limit in Hz (default: last data point).", "hz");
+	parser.addOption(integrateToOption);
+	QCommandLineOption carrierOption("carrier", "Batch: carrier frequency in Hz, adds RMS jitter to the summary.", "hz");
+	parser.addOption(carrierOption);
+	QCommandLineOption threadsOption("threads", "Batch: worker threads (default: one per core).", "count", "0");
+	parser.addOption(threadsOption);
+	QCommandLineOption valueStorageOption("value-storage", "Batch: in-memory type of the noise columns, float64, float32 (half size) or int16 (centi-dB, quarter size, <= 0.005 dB error).", "type", "float64");
+	parser.addOption(valueStorageOption);
+	QCommandLineOption summaryOnlyOption("summary-only", "Batch: only write batch_summary.csv.");
+	parser.addOption(summaryOnlyOption);
+	QCommandLineOption maskOption("mask", "Batch: limit mask file (frequency Hz, limit dBc/Hz per line), adds a pass/fail verdict.", "mask_file");
+	parser.addOption(maskOption);
+	QCommandLineOption manifestOption("manifest", "Batch: file listing the inputs, one path per line.", "manifest_file");
+	parser.addOption(manifestOption);
+	QCommandLineOption shardOption("shard", "Batch: process only shard i of n of the inputs (e.g. 3/16) and write a partial result.", "i/n");
+	parser.addOption(shardOption);
+	QCommandLineOption partialOption("partial", "Batch: partial result file (default: <output-dir>/batch_shard_<i>_of_<n>.pnapart).", "partial_file");
+	parser.addOption(partialOption);
+	QCommandLineOption mergeOption("merge", "Merge the partial result files given as arguments into the final report in --output-dir.");
+	parser.addOption(mergeOption);
+
+	// Pack archives (.pnapack): many small captures in one mapped file
+	QCommandLineOption packAppendOption("pack-append", "Parse the input files (and positional files or directories) and append them to this pack, which is created if needed.", "pack_file");
+	parser.addOption(packAppendOption);
+	QCommandLineOption packListOption("pack-list", "List the members of a pack: points, frequency range, spot noise, source file size and time.", "pack_file");
+	parser.addOption(packListOption);
+	QCommandLineOption packExtractOption("pack-extract", "Write the members of a pack named as arguments (all if none) as CSV files into --output-dir.", "pack_file");
+	parser.addOption(packExtractOption);
+	QCommandLineOption packCompactOption("pack-compact", "Rewrite a pack without the space left by earlier appends.", "pack_file");
+	parser.addOption(packCompactOption);
+	parser.addPositionalArgument("files", "Batch and pack append: input files or directories. Merge: partial result files. Pack extract: member names.", "[files...]");
+
+	if (hasArgument(argc, argv, "--merge")) {
+		QCoreApplication mergeApp(argc, argv);
+		QCoreApplication::setApplicationName(VER_FILEDESCRIPTION_STR);
+		QCoreApplication::setApplicationVersion(VER_FILEVERSION_STR);
+		parser.process(mergeApp);
+		return BatchProcessor::merge(parser.positionalArguments(), parser.value(outputDirOption));
+	}
+
+	if (hasArgument(argc, argv, "--pack-append") || hasArgument(argc, argv, "--pack-list") || hasArgument(argc, argv, "--pack-extract")
+		|| hasArgument(argc, argv, "--pack-compact")) {
+		QCoreApplication packApp(argc, argv);
+		QCoreApplication::setApplicationName(VER_FILEDESCRIPTION_STR);
+		QCoreApplication::setApplicationVersion(VER_FILEVERSION_STR);
+		parser.process(packApp);
+
+		if (parser.isSet(packListOption)) {
+			return PackArchive::list(parser.value(packListOption));
+		}
+		if (parser.isSet(packExtractOption)) {
+			return PackArchive::extract(parser.value(packExtractOption), parser.positionalArguments(), parser.value(outputDirOption));
+		}
+		if (parser.isSet(packCompactOption)) {
+			return PackArchive::compact(parser.value(packCompactOption));
+		}
+		DatasetParser::StitchOptions stitch;
+		if (!overlapFromArgument(parser.value(overlapOption), &stitch.overlap)) {
+			qWarning() << "Unknown overlap policy, expected later or average:" << parser.value(overlapOption);
+			return 2;
+		}
+		QStringList inputs = parser.values(inputFileOption) + parser.positionalArguments();
+		if (parser.isSet(manifestOption)) {
+			QString errorString;
+			const QStringList listed = BatchProcessor::readManifest(parser.value(manifestOption), &errorString);
+			if (!errorString.isEmpty()) {
+				qWarning() << "Could not read manifest:" << errorString;
+				return 2;
+			}
+			inputs += listed;
+		}
+		return PackArchive::append(parser.value(packAppendOption), BatchProcessor::expandInputs(inputs), stitch);
+	}
+
+	if (hasArgument(argc, argv, "--batch")) {
+		// No QApplication: no platform plugin, no display needed
+		QCoreApplication batchApp(argc, argv);
+		QCoreApplication::setApplicationName(VER_FILEDESCRIPTION_STR);
+		QCoreApplication::setApplicationVersion(VER_FILEVERSION_STR);
+		parser.process(batchApp);
+
+		BatchOptions options;
+		options.outputDir = parser.value(outputDirOption);
+		if (parser.isSet(filterOption)) {
+			options.filterType = BatchProcessor::filterTypeFromArgument(parser.value(filterOption));
+			if (options.filterType.isEmpty()) {
+				qWarning() << "Unknown filter:" << parser.value(filterOption);
+				return 2;
+			}
+		}
+		options.filterWindow = qMax(1, parser.value(filterWindowOption).toInt());
+		options.removeSpurs = parser.isSet(removeSpursOption);
+		options.integrateFrom = parser.value(integrateFromOption).toDouble();
+		options.integrateTo = parser.value(integrateToOption).toDouble();
+		options.carrierFrequency = parser.value(carrierOption).toDouble();
+		options.threads = parser.value(threadsOption).toInt();
+		if (!valueStorageFromArgument(parser.value(valueStorageOption), &options.valueStorage)) {
+			qWarning() << "Unknown value storage, expected float64, float32 or int16:" << parser.value(valueStorageOption);
+			return 2;
+		}
+		options.writePerFile = !parser.isSet(summaryOnlyOption);
+		if (!overlapFromArgument(parser.value(overlapOption), &options.overlap)) {
+			qWarning() << "Unknown overlap policy, expected later or average:" << parser.value(overlapOption);
+			return 2;
+		}
+		if (parser.isSet(maskOption)) {
+			QString errorString;
+			if (!DatasetParser::parseMaskFile(parser.value(maskOption), &options.mask, &errorString)) {
+				qWarning().noquote() << errorString;
+				return 2;
+			}
+			options.maskName = QFileInfo(parser.value(maskOption)).fileName();
+		}
+		if (parser.isSet(shardOption)) {
+			const QStringList shard = parser.value(shardOption).split('/');
+			bool okIndex = false, okCount = false;
+			options.shardIndex = shard.value(0).toInt(&okIndex);
+			options.shardCount = shard.value(1).toInt(&okCount);
+			if (shard.size() != 2 || !okIndex || !okCount || options.shardCount < 1
+				|| options.shardIndex < 0 || options.shardIndex >= options.shardCount) {
+				qWarning() << "Invalid shard, expected i/n with 0 <= i < n:" << parser.value(shardOption);
+				return 2;
+			}
+			const QString dir = options.outputDir.isEmpty() ? QDir::currentPath() : options.outputDir;
+			options.partialPath = QString("%1/batch_shard_%2_of_%3.pnapart").arg(dir).arg(options.shardIndex).arg(options.shardCount);
+		}
+		if (parser.isSet(partialOption)) {
+			options.partialPath = parser.value(partialOption);
+		}
+
+		QStringList inputs = parser.values(inputFileOption) + parser.positionalArguments();
+		if (parser.isSet(manifestOption)) {
+			QString errorString;
+			const QStringList listed = BatchProcessor::readManifest(parser.value(manifestOption), &errorString);
+			if (!errorString.isEmpty()) {
+				qWarning() << "Could not read manifest:" << errorString;
+				return 2;
+			}
+			inputs += listed;
+		}
+		return BatchProcessor::run(inputs, options);
+	}
+
+	// Single-instance fast path: hand the files over and exit before paying for
+	// QApplication (platform plugin, styles, fonts). Only a QCoreApplication is needed.
+	const bool singleInstance = hasArgument(argc, argv, "--single-instance");
+	if (singleInstance) {
+		QCoreApplication probeApp(argc, argv);
+		if (parser.parse(QCoreApplication::arguments()) && !parser.isSet("help") && !parser.isSet("version")
+			&& !parser.values(inputFileOption).contains("-") // Our stdin, not the running instance's
+			&& SingleInstance::forwardToRunningInstance(parser.values(inputFileOption),
+														Constants::SINGLE_INSTANCE_CONNECT_TIMEOUT_MS,
+														Constants::SINGLE_INSTANCE_ACK_TIMEOUT_MS)) {
+			return 0;
+		}
+	}
+
+	QApplication app(argc, argv);
+	StartupProfiler::mark("QApplication");
+	QApplication::setApplicationName(VER_FILEDESCRIPTION_STR);
+	QApplication::setApplicationVersion(VER_FILEVERSION_STR);
+	QApplication::setOrganizationName(VER_LEGALCOPYRIGHT_STR);
+
+	// Load the icon from the resource system
+	QIcon appIcon(":/images/pna.svg");
+	// Optionally, also set the application-wide icon
+	app.setWindowIcon(appIcon);
+
 	// Process arguments
 	parser.process(app);
 
@@ -79,11 +329,68 @@ int main(int argc, char *argv[])
 		qWarning() << "Invalid DPI value provided, using default:" << dpi;
 	}
 
-	// Set Fusion style for consistent look, especially needed for dark theme palettes
+	// Set Fusion style for consistent look, especially needed for dark theme palettes.
+	// This is the only place the style is set, applyTheme() only changes the palette.
 	app.setStyle(QStyleFactory::create("Fusion"));
+	StartupProfiler::mark("command line and style");
+
+	// Armed by the first heartbeat, i.e. once the event loop runs
+	bool stallThresholdOk = false;
+	const int stallThresholdMs = parser.value(stallThresholdOption).toInt(&stallThresholdOk);
+	if (!stallThresholdOk || stallThresholdMs < 0) {
+		qWarning() << "Invalid stall threshold, using default:" << Constants::STALL_THRESHOLD_MS;
+	}
+	StallWatchdog::instance().start(stallThresholdOk && stallThresholdMs >= 0 ? stallThresholdMs : Constants::STALL_THRESHOLD_MS,
+									QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/stalls.log");
 
 	// Create main window
 	PhaseNoiseAnalyzerApp mainWindow(csvFilenames, noplotRefence, useDarkTheme, dpi);
+	StartupProfiler::mark("main window constructed");
+	mainWindow.setRestoreWorkspaceOnStartup(!parser.isSet(noRestoreOption));
+	bool budgetOk = false;
+	const qint64 memoryBudgetMb = parser.value(memoryBudgetOption).toLongLong(&budgetOk);
+	if (budgetOk && memoryBudgetMb >= 0) {
+		mainWindow.setMemoryBudget(memoryBudgetMb * 1024 * 1024);
+	} else {
+		qWarning() << "Invalid memory budget, using unlimited";
+	}
+
+	const QString streamSweeps = parser.value(streamSweepsOption);
+	if (streamSweeps != "rolling" && streamSweeps != "append") {
+		qWarning() << "Invalid --stream-sweeps mode, using rolling:" << streamSweeps;
+	}
+	mainWindow.setStreamOptions(parser.value(sweepDelimiterOption).toUtf8(), streamSweeps == "append");
+
+	DatasetParser::StitchOptions stitch;
+	if (!overlapFromArgument(parser.value(overlapOption), &stitch.overlap)) {
+		qWarning() << "Invalid --overlap policy, using later:" << parser.value(overlapOption);
+	}
+	stitch.splitRestarts = parser.isSet(splitSweepsOption);
+	mainWindow.setStitchOptions(stitch);
+	mainWindow.setFastLines(parser.isSet(fastLinesOption));
+
+	if (parser.isSet(simulateOption)) {
+		bool rateOk = false;
+		const double rate = parser.value(simulateOption).toDouble(&rateOk);
+		if (rateOk && rate >= 0 && rate <= Constants::SIMULATOR_MAX_RATE) {
+			mainWindow.startLiveSimulator(rate);
+		} else {
+			qWarning() << "Invalid simulator rate:" << parser.value(simulateOption);
+		}
+	}
+
+	if (parser.isSet(startupReportOption)) {
+		QObject::connect(&mainWindow, &PhaseNoiseAnalyzerApp::startupFinished, &mainWindow, []() {
+			qInfo().noquote() << StartupProfiler::report();
+		});
+	}
+
+	// First instance: accept files from later invocations
+	SingleInstance instanceServer;
+	if (singleInstance && instanceServer.listen()) {
+		QObject::connect(&instanceServer, &SingleInstance::filesReceived,
+						 &mainWindow, &PhaseNoiseAnalyzerApp::openFilesFromOtherInstance);
+	}
 
 	// Set the application window icon
 	mainWindow.setWindowIcon(appIcon);
@@ -93,5 +400,10 @@ int main(int argc, char *argv[])
 	// Delay maximization slightly to ensure proper rendering after show()
 	mainWindow.m_startupTimer->start(10); // Use the timer created in the constructor
 
-	return app.exec();
+	const int exitCode = app.exec();
+	if (AllocProfiler::Enabled) {
+		// Diagnostics build (CONFIG+=alloc_profiling): allocations per instrumented scope
+		qInfo().noquote() << "Heap allocations per scope:\n" + AllocProfiler::report();
+	}
+	return exitCode;
 }
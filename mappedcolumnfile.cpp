@@ -0,0 +1,595 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "mappedcolumnfile.h"
+
+#include "datasetparser.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr char FileMagic[8] = {'P', 'N', 'A', 'C', 'O', 'L', '\r', '\n'};
+constexpr quint32 FormatVersion = 2;      // 2: compact value storage and quantization error
+constexpr quint32 ByteOrderMark = 0x01020304; // Written natively, detects foreign byte order
+constexpr qint64 HeaderSizeV1 = 128;
+constexpr qint64 HeaderSize = 160;
+constexpr int SummaryBlockSize = 1024;   // Points per (min, max) summary entry
+constexpr int SpoolChunkPoints = 65536;  // Points buffered before hitting the disk
+constexpr qint64 ReadChunkBytes = 1 << 20; // CSV bytes per read while converting
+
+struct FileHeader {
+	char magic[8];
+	quint32 version;
+	quint32 byteOrderMark;
+	quint64 pointCount;
+	quint32 valueColumnCount;
+	quint32 summaryBlockSize;
+	quint64 keyOffset;
+	quint64 valueOffset;   // Value column c starts at valueOffset + c * alignTo8(pointCount * bytesPerValue)
+	quint64 summaryOffset; // Summary of column c starts at summaryOffset + c * blockCount * 16
+	double keyMin;
+	double keyMax;
+	double valueMin[MappedColumnFile::MaxValueColumns];
+	double valueMax[MappedColumnFile::MaxValueColumns];
+	// Version 2 (zero in version 1 files, which means float64 storage)
+	quint32 valueStorage;
+	quint32 reserved;
+	double valueOffsetDb[MappedColumnFile::MaxValueColumns];
+	double maxQuantizationError[MappedColumnFile::MaxValueColumns];
+	double rmsQuantizationError[MappedColumnFile::MaxValueColumns];
+};
+static_assert(sizeof(FileHeader) == HeaderSize, "Column file header must be 160 bytes");
+
+inline quint64 alignTo8(quint64 value)
+{
+	return (value + 7) & ~quint64(7);
+}
+
+inline quint64 blockCountFor(quint64 pointCount, quint32 blockSize)
+{
+	return (pointCount + blockSize - 1) / blockSize;
+}
+
+// [offset, offset + length) lies inside a file of fileSize bytes. Never forms the sum:
+// offsets come from the file and may be anything.
+inline bool rangeFits(quint64 offset, quint64 length, quint64 fileSize)
+{
+	return offset <= fileSize && length <= fileSize - offset;
+}
+
+} // namespace
+
+// --- MappedColumnFile ---
+
+MappedColumnFile::~MappedColumnFile()
+{
+	if (m_map) {
+		m_file.unmap(m_map);
+	}
+}
+
+int MappedColumnFile::bytesPerValue(ValueStorage storage)
+{
+	switch (storage) {
+	case ValueStorage::Float32: return 4;
+	case ValueStorage::CentiDb16: return 2;
+	default: return 8;
+	}
+}
+
+QString MappedColumnFile::storageName(ValueStorage storage)
+{
+	switch (storage) {
+	case ValueStorage::Float32: return QStringLiteral("float32");
+	case ValueStorage::CentiDb16: return QStringLiteral("int16 centi-dB");
+	default: return QStringLiteral("float64");
+	}
+}
+
+QSharedPointer<MappedColumnFile> MappedColumnFile::open(const QString& path, QString* errorString)
+{
+	auto fail = [errorString](const QString& message) {
+		if (errorString) *errorString = message;
+		return QSharedPointer<MappedColumnFile>();
+	};
+
+	QSharedPointer<MappedColumnFile> f(new MappedColumnFile);
+	f->m_filename = path;
+	f->m_file.setFileName(path);
+	if (!f->m_file.open(QIODevice::ReadOnly)) {
+		return fail(f->m_file.errorString());
+	}
+	const qint64 fileSize = f->m_file.size();
+	if (fileSize < HeaderSizeV1) {
+		return fail(QStringLiteral("Not a column file (too small)"));
+	}
+
+	// The whole file is mapped; pages are only read when touched
+	f->m_map = f->m_file.map(0, fileSize);
+	if (!f->m_map) {
+		return fail(QStringLiteral("Could not map file into memory: %1").arg(f->m_file.errorString()));
+	}
+
+	FileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(&header, f->m_map, size_t(qMin<qint64>(fileSize, HeaderSize)));
+	if (std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0) {
+		return fail(QStringLiteral("Not a column file"));
+	}
+	if (header.byteOrderMark != ByteOrderMark) {
+		return fail(QStringLiteral("Column file was written on a machine with a different byte order"));
+	}
+	if (header.version < 1 || header.version > FormatVersion) {
+		return fail(QStringLiteral("Unsupported column file version %1").arg(header.version));
+	}
+	if (header.version == 1) {
+		// Version 1 had reserved zero bytes here: float64 values, no quantization
+		std::memset(reinterpret_cast<char*>(&header) + HeaderSizeV1, 0, size_t(HeaderSize - HeaderSizeV1));
+		header.valueStorage = quint32(ValueStorage::Float64);
+	}
+	if (header.valueColumnCount < 1 || header.valueColumnCount > quint32(MaxValueColumns)
+		|| header.summaryBlockSize == 0 || header.pointCount == 0
+		|| header.pointCount > quint64(std::numeric_limits<int>::max())
+		|| header.valueStorage > quint32(ValueStorage::CentiDb16)) {
+		return fail(QStringLiteral("Corrupted column file header"));
+	}
+
+	const ValueStorage storage = ValueStorage(header.valueStorage);
+	const quint64 n = header.pointCount;
+	const quint64 blocks = blockCountFor(n, header.summaryBlockSize);
+	const quint64 valueColumnBytes = alignTo8(n * quint64(bytesPerValue(storage)));
+	const bool aligned = (header.keyOffset % 8 == 0) && (header.valueOffset % 8 == 0) && (header.summaryOffset % 8 == 0);
+	// Lengths cannot overflow: n <= INT_MAX and at most MaxValueColumns columns
+	if (!aligned
+		|| !rangeFits(header.keyOffset, n * sizeof(double), quint64(fileSize))
+		|| !rangeFits(header.valueOffset, header.valueColumnCount * valueColumnBytes, quint64(fileSize))
+		|| !rangeFits(header.summaryOffset, header.valueColumnCount * blocks * 2 * sizeof(double), quint64(fileSize))) {
+		return fail(QStringLiteral("Column file is truncated or corrupted"));
+	}
+
+	f->m_count = int(n);
+	f->m_valueColumnCount = int(header.valueColumnCount);
+	f->m_blockSize = int(header.summaryBlockSize);
+	f->m_storage = storage;
+	f->m_keys = reinterpret_cast<const double*>(f->m_map + header.keyOffset);
+	for (int c = 0; c < f->m_valueColumnCount; ++c) {
+		f->m_values[c] = f->m_map + header.valueOffset + c * valueColumnBytes;
+		f->m_summary[c] = reinterpret_cast<const double*>(f->m_map + header.summaryOffset + c * blocks * 2 * sizeof(double));
+		f->m_offset[c] = header.valueOffsetDb[c];
+		f->m_valueMin[c] = header.valueMin[c];
+		f->m_valueMax[c] = header.valueMax[c];
+		f->m_maxError[c] = header.maxQuantizationError[c];
+		f->m_rmsError[c] = header.rmsQuantizationError[c];
+	}
+	f->m_keyMin = header.keyMin;
+	f->m_keyMax = header.keyMax;
+	return f;
+}
+
+double MappedColumnFile::value(int column, int index) const
+{
+	switch (m_storage) {
+	case ValueStorage::Float32:
+		return ValueCodec<float>::decode(static_cast<const float*>(m_values[column])[index], 0.0);
+	case ValueStorage::CentiDb16:
+		return ValueCodec<qint16>::decode(static_cast<const qint16*>(m_values[column])[index], m_offset[column]);
+	default:
+		return static_cast<const double*>(m_values[column])[index];
+	}
+}
+
+int MappedColumnFile::lowerBound(double key, int first, int last) const
+{
+	return int(std::lower_bound(m_keys + first, m_keys + last, key) - m_keys);
+}
+
+int MappedColumnFile::upperBound(double key, int first, int last) const
+{
+	return int(std::upper_bound(m_keys + first, m_keys + last, key) - m_keys);
+}
+
+// Min/max over raw samples in the stored type; only the two extremes are decoded
+template <typename T>
+void MappedColumnFile::scanRange(int column, int begin, int end, double& minValue, double& maxValue) const
+{
+	const T* values = static_cast<const T*>(m_values[column]);
+	bool found = false;
+	T lo = T(), hi = T();
+	for (int i = begin; i < end; ++i) {
+		const T v = values[i];
+		if (ValueCodec<T>::missing(v)) continue;
+		if (!found) {
+			lo = hi = v;
+			found = true;
+		} else {
+			if (v < lo) lo = v;
+			if (v > hi) hi = v;
+		}
+	}
+	if (found) {
+		minValue = qMin(minValue, ValueCodec<T>::decode(lo, m_offset[column]));
+		maxValue = qMax(maxValue, ValueCodec<T>::decode(hi, m_offset[column]));
+	}
+}
+
+bool MappedColumnFile::minMax(int column, int begin, int end, double* minValue, double* maxValue) const
+{
+	double lo = std::numeric_limits<double>::infinity();
+	double hi = -std::numeric_limits<double>::infinity();
+	auto scan = [&](int first, int last) {
+		if (first >= last) return;
+		switch (m_storage) {
+		case ValueStorage::Float32: scanRange<float>(column, first, last, lo, hi); break;
+		case ValueStorage::CentiDb16: scanRange<qint16>(column, first, last, lo, hi); break;
+		default: scanRange<double>(column, first, last, lo, hi); break;
+		}
+	};
+
+	// Raw samples for the partial blocks at both ends, the summary for whole blocks in between
+	const int firstFullBlock = (begin + m_blockSize - 1) / m_blockSize;
+	const int lastFullBlock = end / m_blockSize; // Exclusive
+	if (firstFullBlock < lastFullBlock) {
+		scan(begin, firstFullBlock * m_blockSize);
+		const double* summary = m_summary[column];
+		for (int b = firstFullBlock; b < lastFullBlock; ++b) {
+			if (summary[2 * b] < lo) lo = summary[2 * b];
+			if (summary[2 * b + 1] > hi) hi = summary[2 * b + 1];
+		}
+		scan(lastFullBlock * m_blockSize, end);
+	} else {
+		scan(begin, end);
+	}
+
+	*minValue = lo;
+	*maxValue = hi;
+	return lo <= hi;
+}
+
+bool MappedColumnFile::convertCsv(const QString& csvPath, const QString& outPath, ValueStorage storage,
+								  const std::function<bool(qint64, qint64)>& progress, QString* errorString)
+{
+	QFile file(csvPath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		if (errorString) *errorString = file.errorString();
+		return false;
+	}
+
+	// The loader's tokenizer and skipping rules; rows go straight to the writer
+	DatasetParser::StreamParser parser;
+	QScopedPointer<MappedColumnWriter> writer;
+	bool failed = false;
+	double lastFrequency = 0.0;
+	parser.setRowSink([&](double frequency, double noise, double reference) {
+		if (failed) return;
+		if (!writer) {
+			// First data line decides the column layout, like the CSV loader
+			writer.reset(new MappedColumnWriter(parser.hasReferenceData() ? 2 : 1, storage));
+			if (!writer->open(outPath, errorString)) {
+				failed = true;
+				return;
+			}
+		}
+		if (frequency < lastFrequency) {
+			// The loader stitches such files in memory, which is what conversion avoids
+			if (errorString) {
+				*errorString = QStringLiteral("Line %1: frequencies must be in ascending order; files with descending "
+											  "or restarting sweeps can be opened, but not converted")
+								   .arg(parser.lineCount());
+			}
+			failed = true;
+			return;
+		}
+		lastFrequency = frequency;
+		const double values[MaxValueColumns] = {noise, reference};
+		if (!writer->append(frequency, values)) {
+			if (errorString) *errorString = QStringLiteral("Line %1: %2").arg(parser.lineCount()).arg(writer->errorString());
+			failed = true;
+		}
+	});
+
+	QByteArray chunk(int(ReadChunkBytes), Qt::Uninitialized);
+	while (!failed && parser.errorString().isEmpty()) {
+		const qint64 bytes = file.read(chunk.data(), chunk.size());
+		if (bytes < 0) {
+			if (errorString) *errorString = file.errorString();
+			failed = true;
+			break;
+		}
+		if (bytes == 0) break;
+		parser.feed(chunk.constData(), bytes);
+		if (!failed && progress && !progress(file.pos(), file.size())) {
+			if (errorString) *errorString = QStringLiteral("Conversion cancelled");
+			failed = true;
+		}
+	}
+	if (!failed) parser.finish(); // Unterminated last line
+	if (!failed && !parser.errorString().isEmpty()) {
+		if (errorString) *errorString = parser.errorString();
+		failed = true;
+	}
+
+	if (failed) {
+		if (writer) writer->cancel();
+		return false;
+	}
+	if (!writer) {
+		if (errorString) *errorString = QStringLiteral("No valid data points found");
+		return false;
+	}
+	return writer->finish(errorString);
+}
+
+// --- MappedColumnWriter ---
+
+MappedColumnWriter::MappedColumnWriter(int valueColumnCount, MappedColumnFile::ValueStorage storage)
+	: m_valueColumnCount(qBound(1, valueColumnCount, int(MappedColumnFile::MaxValueColumns))),
+	  m_storage(storage)
+{
+	for (int c = 0; c < MappedColumnFile::MaxValueColumns; ++c) {
+		m_valueMin[c] = std::numeric_limits<double>::infinity();
+		m_valueMax[c] = -std::numeric_limits<double>::infinity();
+	}
+}
+
+MappedColumnWriter::~MappedColumnWriter()
+{
+	cancel();
+}
+
+bool MappedColumnWriter::open(const QString& path, QString* errorString)
+{
+	QDir().mkpath(QFileInfo(path).absolutePath());
+	m_file.reset(new QSaveFile(path));
+	if (!m_file->open(QIODevice::WriteOnly)) {
+		if (errorString) *errorString = m_file->errorString();
+		m_file.reset();
+		return false;
+	}
+	m_file->write(QByteArray(int(HeaderSize), '\0')); // Rewritten by finish()
+
+	for (int c = 0; c < m_valueColumnCount; ++c) {
+		m_valueSpool[c].reset(new QTemporaryFile());
+		if (!m_valueSpool[c]->open()) {
+			if (errorString) *errorString = m_valueSpool[c]->errorString();
+			cancel();
+			return false;
+		}
+		m_valueBuffer[c].reserve(SpoolChunkPoints);
+	}
+	m_keyBuffer.reserve(SpoolChunkPoints);
+	return true;
+}
+
+bool MappedColumnWriter::append(double key, const double* values)
+{
+	if (!m_file) {
+		m_error = QStringLiteral("Writer is not open");
+		return false;
+	}
+	if (std::isnan(key) || (m_count > 0 && key < m_lastKey)) {
+		m_error = QStringLiteral("Frequencies must be in ascending order");
+		return false;
+	}
+	if (m_count >= std::numeric_limits<int>::max()) {
+		m_error = QStringLiteral("Too many data points for one column file");
+		return false;
+	}
+
+	if (m_count == 0) m_keyMin = key;
+	m_keyMax = m_lastKey = key;
+	m_keyBuffer.append(key);
+	for (int c = 0; c < m_valueColumnCount; ++c) {
+		const double v = values[c];
+		m_valueBuffer[c].append(v);
+		if (v < m_valueMin[c]) m_valueMin[c] = v;
+		if (v > m_valueMax[c]) m_valueMax[c] = v;
+	}
+	++m_count;
+
+	if (m_keyBuffer.size() >= SpoolChunkPoints) {
+		return flushBuffers();
+	}
+	return true;
+}
+
+bool MappedColumnWriter::flushBuffers()
+{
+	const qint64 bytes = qint64(m_keyBuffer.size()) * qint64(sizeof(double));
+	bool ok = (m_file->write(reinterpret_cast<const char*>(m_keyBuffer.constData()), bytes) == bytes);
+	for (int c = 0; c < m_valueColumnCount && ok; ++c) {
+		ok = (m_valueSpool[c]->write(reinterpret_cast<const char*>(m_valueBuffer[c].constData()), bytes) == bytes);
+		m_valueBuffer[c].clear();
+	}
+	m_keyBuffer.clear();
+	if (!ok) {
+		m_error = QStringLiteral("Write error: %1").arg(m_file->errorString());
+	}
+	return ok;
+}
+
+// Converts one spooled float64 column to the stored type. The block summary and the
+// quantization error are computed from the values as they will be read back.
+template <typename T>
+bool MappedColumnWriter::writeValueColumn(int column, double offset, QVector<double>& summary, double& maxError, double& sumSquaredError, qint64& measured)
+{
+	QTemporaryFile* spool = m_valueSpool[column].data();
+	spool->seek(0);
+	QVector<double> input(SpoolChunkPoints);
+	QVector<T> output(SpoolChunkPoints);
+	double blockMin = std::numeric_limits<double>::infinity();
+	double blockMax = -std::numeric_limits<double>::infinity();
+	int blockFill = 0;
+	qint64 written = 0;
+
+	while (written < m_count) {
+		const int chunk = int(qMin<qint64>(SpoolChunkPoints, m_count - written));
+		const qint64 bytes = qint64(chunk) * qint64(sizeof(double));
+		if (spool->read(reinterpret_cast<char*>(input.data()), bytes) != bytes) {
+			m_error = QStringLiteral("Read error on temporary file: %1").arg(spool->errorString());
+			return false;
+		}
+		for (int i = 0; i < chunk; ++i) {
+			const double original = input[i];
+			const T stored = ValueCodec<T>::encode(original, offset);
+			output[i] = stored;
+			if (!ValueCodec<T>::missing(stored)) { // Missing stays missing, nothing to measure
+				const double decoded = ValueCodec<T>::decode(stored, offset);
+				const double error = qAbs(decoded - original);
+				maxError = qMax(maxError, error);
+				sumSquaredError += error * error;
+				++measured;
+				if (decoded < blockMin) blockMin = decoded;
+				if (decoded > blockMax) blockMax = decoded;
+			}
+			if (++blockFill == SummaryBlockSize) {
+				summary << blockMin << blockMax;
+				blockMin = std::numeric_limits<double>::infinity();
+				blockMax = -std::numeric_limits<double>::infinity();
+				blockFill = 0;
+			}
+		}
+		const qint64 outBytes = qint64(chunk) * qint64(sizeof(T));
+		if (m_file->write(reinterpret_cast<const char*>(output.constData()), outBytes) != outBytes) {
+			m_error = QStringLiteral("Write error: %1").arg(m_file->errorString());
+			return false;
+		}
+		written += chunk;
+	}
+	if (blockFill > 0) {
+		summary << blockMin << blockMax;
+	}
+
+	// Keep every column 8-byte aligned
+	const qint64 columnBytes = m_count * qint64(sizeof(T));
+	const qint64 padding = qint64(alignTo8(quint64(columnBytes))) - columnBytes;
+	if (padding > 0) {
+		m_file->write(QByteArray(int(padding), '\0'));
+	}
+	return true;
+}
+
+bool MappedColumnWriter::finish(QString* errorString)
+{
+	auto fail = [this, errorString](const QString& message) {
+		if (errorString) *errorString = message;
+		cancel();
+		return false;
+	};
+
+	if (!m_file) return fail(QStringLiteral("Writer is not open"));
+	if (m_count == 0) return fail(QStringLiteral("No valid data points found"));
+	if (!flushBuffers()) return fail(m_error);
+
+	FileHeader header;
+	std::memset(&header, 0, sizeof(header));
+
+	// Value columns after the keys, converted to the requested storage
+	QVector<double> summaries[MappedColumnFile::MaxValueColumns];
+	for (int c = 0; c < m_valueColumnCount; ++c) {
+		const bool anyValue = m_valueMin[c] <= m_valueMax[c];
+		double offset = 0.0;
+		if (m_storage == MappedColumnFile::ValueStorage::CentiDb16 && anyValue) {
+			if (!ValueCodec<qint16>::offsetFor(m_valueMin[c], m_valueMax[c], &offset)) {
+				return fail(QStringLiteral("Value range %1 .. %2 dB is too wide for int16 centi-dB storage, use float32")
+								.arg(m_valueMin[c]).arg(m_valueMax[c]));
+			}
+		}
+
+		double maxError = 0.0, sumSquaredError = 0.0;
+		qint64 measured = 0;
+		bool ok = false;
+		switch (m_storage) {
+		case MappedColumnFile::ValueStorage::Float32: ok = writeValueColumn<float>(c, offset, summaries[c], maxError, sumSquaredError, measured); break;
+		case MappedColumnFile::ValueStorage::CentiDb16: ok = writeValueColumn<qint16>(c, offset, summaries[c], maxError, sumSquaredError, measured); break;
+		default: ok = writeValueColumn<double>(c, offset, summaries[c], maxError, sumSquaredError, measured); break;
+		}
+		if (!ok) return fail(m_error);
+
+		header.valueOffsetDb[c] = offset;
+		header.maxQuantizationError[c] = maxError;
+		header.rmsQuantizationError[c] = measured > 0 ? std::sqrt(sumSquaredError / double(measured)) : 0.0;
+		// Bounds of the values as stored, columns without any finite value store NaN
+		double storedMin = std::numeric_limits<double>::infinity(), storedMax = -std::numeric_limits<double>::infinity();
+		for (int b = 0; b < summaries[c].size(); b += 2) {
+			storedMin = qMin(storedMin, summaries[c][b]);
+			storedMax = qMax(storedMax, summaries[c][b + 1]);
+		}
+		header.valueMin[c] = anyValue ? storedMin : std::numeric_limits<double>::quiet_NaN();
+		header.valueMax[c] = anyValue ? storedMax : std::numeric_limits<double>::quiet_NaN();
+	}
+	for (int c = m_valueColumnCount; c < MappedColumnFile::MaxValueColumns; ++c) {
+		header.valueMin[c] = header.valueMax[c] = std::numeric_limits<double>::quiet_NaN();
+	}
+	for (int c = 0; c < m_valueColumnCount; ++c) {
+		const qint64 bytes = qint64(summaries[c].size()) * qint64(sizeof(double));
+		if (m_file->write(reinterpret_cast<const char*>(summaries[c].constData()), bytes) != bytes) {
+			return fail(QStringLiteral("Write error: %1").arg(m_file->errorString()));
+		}
+	}
+
+	std::memcpy(header.magic, FileMagic, sizeof(FileMagic));
+	header.version = FormatVersion;
+	header.byteOrderMark = ByteOrderMark;
+	header.pointCount = quint64(m_count);
+	header.valueColumnCount = quint32(m_valueColumnCount);
+	header.summaryBlockSize = quint32(SummaryBlockSize);
+	header.keyOffset = quint64(HeaderSize);
+	header.valueOffset = header.keyOffset + quint64(m_count) * sizeof(double);
+	header.summaryOffset = header.valueOffset
+						 + quint64(m_valueColumnCount) * alignTo8(quint64(m_count) * quint64(MappedColumnFile::bytesPerValue(m_storage)));
+	header.keyMin = m_keyMin;
+	header.keyMax = m_keyMax;
+	header.valueStorage = quint32(m_storage);
+
+	if (!m_file->seek(0) || m_file->write(reinterpret_cast<const char*>(&header), sizeof(header)) != qint64(sizeof(header))) {
+		return fail(QStringLiteral("Write error: %1").arg(m_file->errorString()));
+	}
+	if (!m_file->commit()) {
+		return fail(m_file->errorString());
+	}
+	m_file.reset();
+	qInfo() << "Wrote column file with" << m_count << "points," << MappedColumnFile::storageName(m_storage)
+			<< "values, max quantization error" << header.maxQuantizationError[0] << "dB";
+	cancel(); // Releases the spool files
+	return true;
+}
+
+void MappedColumnWriter::cancel()
+{
+	if (m_file) {
+		m_file->cancelWriting();
+		m_file.reset();
+	}
+	for (int c = 0; c < MappedColumnFile::MaxValueColumns; ++c) {
+		m_valueSpool[c].reset();
+	}
+}
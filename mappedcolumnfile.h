@@ -0,0 +1,167 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef MAPPEDCOLUMNFILE_H
+#define MAPPEDCOLUMNFILE_H
+
+#include <QFile>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QString>
+#include <QTemporaryFile>
+#include <QVector>
+#include <functional>
+
+#include "compactcolumn.h"
+
+/*
+ * Read-only, memory-mapped column file (.pnacol) for traces larger than RAM.
+ *
+ * Layout (native byte order, checked through a byte order mark):
+ *   header | keys (double[count], ascending) | value columns (count elements each, 8-byte aligned)
+ *   | summary: per value column, (min, max) doubles for every block of summaryBlockSize points
+ *
+ * Keys are always float64. Value columns (noise in dBc/Hz) can be stored compactly:
+ * float32, or int16 centi-dB around a per-column offset (0.01 dB steps, about the
+ * meaningful resolution of a phase noise measurement). The writer records the
+ * quantization error it introduced so the accuracy cost is known per file.
+ *
+ * Nothing is read up front: the OS pages in what is touched. Range queries binary
+ * search the keys and min/max queries use the block summary for whole blocks, so a
+ * zoomed-out view of a multi-gigabyte trace only reads the small summary region.
+ * Partial blocks are scanned in the stored type, only the extremes are decoded.
+ */
+class MappedColumnFile
+{
+public:
+	static constexpr int MaxValueColumns = 2; // Measured noise and optional reference noise
+
+	using ValueStorage = ::ValueStorage; // Shared with the in-memory CompactColumn
+	static constexpr qint16 Missing16 = ValueCodec<qint16>::Missing;
+
+	~MappedColumnFile();
+
+	static QSharedPointer<MappedColumnFile> open(const QString& path, QString* errorString = nullptr);
+
+	// Streaming CSV conversion with the CSV loader's parser (DatasetParser::StreamParser), never holds
+	// the trace in memory. Frequencies must ascend: unlike the loader it cannot stitch sweeps.
+	// progress(bytesRead, totalBytes) may return false to cancel.
+	static bool convertCsv(const QString& csvPath, const QString& outPath, ValueStorage storage,
+						   const std::function<bool(qint64, qint64)>& progress, QString* errorString = nullptr);
+
+	static int bytesPerValue(ValueStorage storage);
+	static QString storageName(ValueStorage storage);
+
+	const QString& filename() const { return m_filename; }
+	int count() const { return m_count; }
+	int valueColumnCount() const { return m_valueColumnCount; }
+	int summaryBlockSize() const { return m_blockSize; }
+	ValueStorage valueStorage() const { return m_storage; }
+	const double* keys() const { return m_keys; }
+	double value(int column, int index) const; // Decoded, NaN for missing samples
+
+	double keyMin() const { return m_keyMin; }
+	double keyMax() const { return m_keyMax; }
+	double valueMin(int column) const { return m_valueMin[column]; }
+	double valueMax(int column) const { return m_valueMax[column]; }
+
+	// Error introduced by compact storage, in dB (0 for float64)
+	double maxQuantizationError(int column) const { return m_maxError[column]; }
+	double rmsQuantizationError(int column) const { return m_rmsError[column]; }
+
+	// Index of the first key >= key (lowerBound) or > key (upperBound) within [first, last)
+	int lowerBound(double key, int first, int last) const;
+	int upperBound(double key, int first, int last) const;
+
+	// Min/max of a value column over [begin, end), NaN ignored. Returns false if no finite value.
+	bool minMax(int column, int begin, int end, double* minValue, double* maxValue) const;
+
+private:
+	MappedColumnFile() = default;
+	Q_DISABLE_COPY(MappedColumnFile)
+
+	template <typename T>
+	void scanRange(int column, int begin, int end, double& minValue, double& maxValue) const;
+
+	QString m_filename;
+	QFile m_file;
+	uchar* m_map = nullptr;
+	int m_count = 0;
+	int m_valueColumnCount = 0;
+	int m_blockSize = 0;
+	ValueStorage m_storage = ValueStorage::Float64;
+	const double* m_keys = nullptr;
+	const void* m_values[MaxValueColumns] = {};
+	const double* m_summary[MaxValueColumns] = {}; // Interleaved min, max per block
+	double m_offset[MaxValueColumns] = {};         // CentiDb16 only
+	double m_keyMin = 0.0;
+	double m_keyMax = 0.0;
+	double m_valueMin[MaxValueColumns] = {};
+	double m_valueMax[MaxValueColumns] = {};
+	double m_maxError[MaxValueColumns] = {};
+	double m_rmsError[MaxValueColumns] = {};
+};
+
+// Writes a .pnacol file point by point. Keys must be non-decreasing.
+// Values are spooled as float64 to temporary files and converted to the requested
+// storage in finish(), once the value range (and so the centi-dB offset) is known.
+// Memory use is bounded by the write buffers and the block summary.
+class MappedColumnWriter
+{
+public:
+	MappedColumnWriter(int valueColumnCount, MappedColumnFile::ValueStorage storage = MappedColumnFile::ValueStorage::Float64);
+	~MappedColumnWriter();
+
+	bool open(const QString& path, QString* errorString = nullptr);
+	bool append(double key, const double* values); // false if the key goes backwards or the file is full
+	bool finish(QString* errorString = nullptr);
+	void cancel();
+
+	qint64 count() const { return m_count; }
+	const QString& errorString() const { return m_error; }
+
+private:
+	Q_DISABLE_COPY(MappedColumnWriter)
+	bool flushBuffers();
+	template <typename T>
+	bool writeValueColumn(int column, double offset, QVector<double>& summary, double& maxError, double& sumSquaredError, qint64& measured);
+
+	int m_valueColumnCount;
+	MappedColumnFile::ValueStorage m_storage;
+	QScopedPointer<QSaveFile> m_file;
+	QScopedPointer<QTemporaryFile> m_valueSpool[MappedColumnFile::MaxValueColumns];
+	QVector<double> m_keyBuffer;
+	QVector<double> m_valueBuffer[MappedColumnFile::MaxValueColumns];
+	qint64 m_count = 0;
+	double m_lastKey = 0.0;
+	double m_keyMin = 0.0;
+	double m_keyMax = 0.0;
+	double m_valueMin[MappedColumnFile::MaxValueColumns];
+	double m_valueMax[MappedColumnFile::MaxValueColumns];
+	QString m_error;
+};
+
+#endif // MAPPEDCOLUMNFILE_H
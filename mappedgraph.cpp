@@ -0,0 +1,254 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "mappedgraph.h"
+
+#include <cmath>
+#include <limits>
+
+MappedGraph::MappedGraph(QCPAxis* keyAxis, QCPAxis* valueAxis, QSharedPointer<const MappedColumnFile> file, int column)
+	: QCPAbstractPlottable(keyAxis, valueAxis),
+	  m_file(std::move(file)),
+	  m_column(column)
+{
+	setSelectable(QCP::stNone); // View only
+	setBrush(Qt::NoBrush);
+}
+
+// --- QCPPlottableInterface1D ---
+
+int MappedGraph::dataCount() const
+{
+	return m_file ? m_file->count() : 0;
+}
+
+double MappedGraph::dataMainKey(int index) const
+{
+	return m_file->keys()[index];
+}
+
+double MappedGraph::dataSortKey(int index) const
+{
+	return m_file->keys()[index];
+}
+
+double MappedGraph::dataMainValue(int index) const
+{
+	return m_file->value(m_column, index);
+}
+
+QCPRange MappedGraph::dataValueRange(int index) const
+{
+	const double value = dataMainValue(index);
+	return QCPRange(value, value);
+}
+
+QPointF MappedGraph::dataPixelPosition(int index) const
+{
+	return coordsToPixels(dataMainKey(index), dataMainValue(index));
+}
+
+int MappedGraph::findBegin(double sortKey, bool expandedRange) const
+{
+	if (!m_file || m_file->count() == 0) return 0;
+	int index = m_file->lowerBound(sortKey, 0, m_file->count());
+	if (expandedRange && index > 0) --index; // Include the point just outside so lines reach the edge
+	return index;
+}
+
+int MappedGraph::findEnd(double sortKey, bool expandedRange) const
+{
+	if (!m_file || m_file->count() == 0) return 0;
+	int index = m_file->upperBound(sortKey, 0, m_file->count());
+	if (expandedRange && index < m_file->count()) ++index;
+	return index;
+}
+
+void MappedGraph::keyIndexRange(double key1, double key2, int* begin, int* end) const
+{
+	if (key1 > key2) qSwap(key1, key2);
+	*begin = m_file->lowerBound(key1, 0, m_file->count());
+	*end = m_file->upperBound(key2, *begin, m_file->count());
+}
+
+QCPDataSelection MappedGraph::selectTestRect(const QRectF& rect, bool onlySelectable) const
+{
+	if ((onlySelectable && mSelectable == QCP::stNone) || !m_file || m_file->count() == 0) return QCPDataSelection();
+	if (!mKeyAxis || !mValueAxis) return QCPDataSelection();
+
+	// Coarse: every point in the key span of the rect whose value span overlaps it
+	double key1, key2, value1, value2;
+	pixelsToCoords(rect.topLeft(), key1, value1);
+	pixelsToCoords(rect.bottomRight(), key2, value2);
+	int begin, end;
+	keyIndexRange(key1, key2, &begin, &end);
+	double lo, hi;
+	if (begin >= end || !m_file->minMax(m_column, begin, end, &lo, &hi)) return QCPDataSelection();
+	if (hi < qMin(value1, value2) || lo > qMax(value1, value2)) return QCPDataSelection();
+	return QCPDataSelection(QCPDataRange(begin, end));
+}
+
+// --- QCPAbstractPlottable ---
+
+double MappedGraph::selectTest(const QPointF& pos, bool onlySelectable, QVariant* details) const
+{
+	if ((onlySelectable && mSelectable == QCP::stNone) || !m_file || m_file->count() == 0) return -1;
+	if (!mKeyAxis || !mValueAxis || !mKeyAxis->axisRect()->rect().contains(pos.toPoint())) return -1;
+
+	// Distance along the value axis to the value span of the points under the cursor
+	const double tolerance = mParentPlot->selectionTolerance();
+	double key1, key2, dummy;
+	pixelsToCoords(pos - QPointF(tolerance, tolerance), key1, dummy);
+	pixelsToCoords(pos + QPointF(tolerance, tolerance), key2, dummy);
+	int begin, end;
+	keyIndexRange(key1, key2, &begin, &end);
+	double lo, hi;
+	if (begin >= end || !m_file->minMax(m_column, begin, end, &lo, &hi)) return -1;
+
+	const bool horizontal = (mKeyAxis->orientation() == Qt::Horizontal);
+	const QPointF loPixel = coordsToPixels(m_file->keys()[begin], lo);
+	const QPointF hiPixel = coordsToPixels(m_file->keys()[begin], hi);
+	double spanStart = horizontal ? loPixel.y() : loPixel.x();
+	double spanEnd = horizontal ? hiPixel.y() : hiPixel.x();
+	if (spanStart > spanEnd) qSwap(spanStart, spanEnd);
+	const double posValuePixel = horizontal ? pos.y() : pos.x();
+
+	if (details) details->setValue(QCPDataSelection(QCPDataRange(begin, end)));
+	if (posValuePixel < spanStart) return spanStart - posValuePixel;
+	if (posValuePixel > spanEnd) return posValuePixel - spanEnd;
+	return 0.0;
+}
+
+QCPRange MappedGraph::getKeyRange(bool& foundRange, QCP::SignDomain inSignDomain) const
+{
+	foundRange = false;
+	if (!m_file || m_file->count() == 0) return QCPRange();
+
+	const int n = m_file->count();
+	const double* keys = m_file->keys();
+	QCPRange range(m_file->keyMin(), m_file->keyMax());
+	if (inSignDomain == QCP::sdPositive) {
+		const int first = m_file->upperBound(0.0, 0, n);
+		if (first >= n) return QCPRange();
+		range.lower = keys[first];
+	} else if (inSignDomain == QCP::sdNegative) {
+		const int last = m_file->lowerBound(0.0, 0, n) - 1;
+		if (last < 0) return QCPRange();
+		range.upper = keys[last];
+	}
+	foundRange = true;
+	return range;
+}
+
+QCPRange MappedGraph::getValueRange(bool& foundRange, QCP::SignDomain inSignDomain, const QCPRange& inKeyRange) const
+{
+	foundRange = false;
+	if (!m_file || m_file->count() == 0) return QCPRange();
+
+	double lo = m_file->valueMin(m_column);
+	double hi = m_file->valueMax(m_column);
+	if (inKeyRange != QCPRange()) {
+		int begin, end;
+		keyIndexRange(inKeyRange.lower, inKeyRange.upper, &begin, &end);
+		if (begin >= end || !m_file->minMax(m_column, begin, end, &lo, &hi)) return QCPRange();
+	}
+	if (std::isnan(lo) || std::isnan(hi)) return QCPRange();
+
+	// Coarse sign domain handling: the smallest positive/negative magnitude is not indexed
+	if (inSignDomain == QCP::sdPositive) {
+		if (hi <= 0) return QCPRange();
+		if (lo <= 0) lo = hi * 1e-3;
+	} else if (inSignDomain == QCP::sdNegative) {
+		if (lo >= 0) return QCPRange();
+		if (hi >= 0) hi = lo * 1e-3;
+	}
+	foundRange = true;
+	return QCPRange(lo, hi);
+}
+
+void MappedGraph::flushSegment(QCPPainter* painter)
+{
+	if (m_lineBuffer.size() >= 2) {
+		painter->drawPolyline(m_lineBuffer.constData(), m_lineBuffer.size());
+	}
+	m_lineBuffer.clear();
+}
+
+void MappedGraph::draw(QCPPainter* painter)
+{
+	QCPAxis* keyAxis = mKeyAxis.data();
+	if (!keyAxis || !mValueAxis || !m_file || m_file->count() == 0 || mPen.style() == Qt::NoPen) return;
+
+	const QCPRange visibleKeys = keyAxis->range();
+	const int begin = findBegin(visibleKeys.lower);
+	const int end = findEnd(visibleKeys.upper);
+	if (end - begin < 2) return;
+
+	const double* keys = m_file->keys();
+	applyDefaultAntialiasingHint(painter);
+	painter->setPen(mPen);
+	painter->setBrush(Qt::NoBrush);
+	m_lineBuffer.clear();
+
+	const double pixelSpan = qAbs(keyAxis->coordToPixel(visibleKeys.upper) - keyAxis->coordToPixel(visibleKeys.lower));
+	if (end - begin <= 2 * int(pixelSpan) + 2) {
+		// Few enough points: draw them all, NaN (missing reference samples) breaks the line
+		for (int i = begin; i < end; ++i) {
+			const double value = m_file->value(m_column, i);
+			if (std::isnan(value)) {
+				flushSegment(painter);
+			} else {
+				m_lineBuffer.append(coordsToPixels(keys[i], value));
+			}
+		}
+		flushSegment(painter);
+		return;
+	}
+
+	// Dense: one (min, max) pair per key-axis pixel column. Each column is located with a binary
+	// search, and the min/max comes from the block summary for whole blocks, so only the pages of
+	// partial blocks at column edges are read when zoomed out.
+	const double direction = (keyAxis->coordToPixel(keys[end - 1]) >= keyAxis->coordToPixel(keys[begin])) ? 1.0 : -1.0;
+	int i = begin;
+	while (i < end) {
+		const double pixel = std::floor(keyAxis->coordToPixel(keys[i]));
+		const double boundaryKey = keyAxis->pixelToCoord(pixel + direction);
+		const int j = m_file->lowerBound(boundaryKey, qMin(i + 1, end), end);
+		double lo, hi;
+		if (m_file->minMax(m_column, i, qMax(j, i + 1), &lo, &hi)) {
+			m_lineBuffer.append(coordsToPixels(keys[i], lo));
+			if (hi != lo) m_lineBuffer.append(coordsToPixels(keys[i], hi));
+		}
+		i = qMax(j, i + 1);
+	}
+	flushSegment(painter);
+}
+
+void MappedGraph::drawLegendIcon(QCPPainter* painter, const QRectF& rect) const
+{
+	applyDefaultAntialiasingHint(painter);
+	painter->setPen(mPen);
+	painter->drawLine(QLineF(rect.left(), rect.top() + rect.height() / 2.0, rect.right() + 5, rect.top() + rect.height() / 2.0));
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef MAPPEDGRAPH_H
+#define MAPPEDGRAPH_H
+
+#include <QSharedPointer>
+#include <QVector>
+#include <QPointF>
+
+#include "qcustomplot.h"
+#include "mappedcolumnfile.h"
+
+/*
+ * Read-only line plottable over one value column of a MappedColumnFile.
+ *
+ * QCPGraph needs its data in a QCPGraphDataContainer in memory, so large mapped
+ * traces get their own plottable implementing QCPPlottableInterface1D directly.
+ * findBegin()/findEnd() binary search the mapped keys, and draw() reduces the
+ * visible index range to one min/max pair per key-axis pixel, reading whole
+ * blocks from the file summary. Only pages covering the visible range are touched.
+ */
+class MappedGraph : public QCPAbstractPlottable, public QCPPlottableInterface1D
+{
+	Q_OBJECT
+public:
+	MappedGraph(QCPAxis* keyAxis, QCPAxis* valueAxis, QSharedPointer<const MappedColumnFile> file, int column);
+
+	QSharedPointer<const MappedColumnFile> file() const { return m_file; }
+	int column() const { return m_column; }
+
+	// QCPPlottableInterface1D
+	int dataCount() const override;
+	double dataMainKey(int index) const override;
+	double dataSortKey(int index) const override;
+	double dataMainValue(int index) const override;
+	QCPRange dataValueRange(int index) const override;
+	QPointF dataPixelPosition(int index) const override;
+	bool sortKeyIsMainKey() const override { return true; }
+	QCPDataSelection selectTestRect(const QRectF& rect, bool onlySelectable) const override;
+	int findBegin(double sortKey, bool expandedRange = true) const override;
+	int findEnd(double sortKey, bool expandedRange = true) const override;
+
+	// QCPAbstractPlottable
+	double selectTest(const QPointF& pos, bool onlySelectable, QVariant* details = nullptr) const override;
+	QCPPlottableInterface1D* interface1D() override { return this; }
+	QCPRange getKeyRange(bool& foundRange, QCP::SignDomain inSignDomain = QCP::sdBoth) const override;
+	QCPRange getValueRange(bool& foundRange, QCP::SignDomain inSignDomain = QCP::sdBoth, const QCPRange& inKeyRange = QCPRange()) const override;
+
+protected:
+	void draw(QCPPainter* painter) override;
+	void drawLegendIcon(QCPPainter* painter, const QRectF& rect) const override;
+
+private:
+	void keyIndexRange(double key1, double key2, int* begin, int* end) const;
+	void flushSegment(QCPPainter* painter);
+
+	QSharedPointer<const MappedColumnFile> m_file;
+	int m_column;
+	QVector<QPointF> m_lineBuffer; // Reused between replots
+};
+
+#endif // MAPPEDGRAPH_H
@@ -0,0 +1,118 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "memorybudget.h"
+#include "qcustomplot.h"
+
+#include <QLocale>
+#include <algorithm>
+
+namespace MemoryAccounting {
+
+qint64 columnBytes(const QVector<double>& column)
+{
+	return qint64(column.capacity()) * qint64(sizeof(double));
+}
+
+// QCPDataContainer keeps removed points as preallocation and does not expose its
+// capacity; the member pointer taken through a derived class reads the storage
+struct GraphStorage : QCPGraphDataContainer {
+	static int capacity(const QCPGraphDataContainer& container) { return (container.*(&GraphStorage::mData)).capacity(); }
+};
+
+static qint64 graphBytes(const QCPGraph* graph)
+{
+	return graph ? qint64(GraphStorage::capacity(*graph->data())) * qint64(sizeof(QCPGraphData)) : 0;
+}
+
+DatasetMemoryUsage measure(const DatasetColumns& columns, const DatasetGraphs& graphs)
+{
+	DatasetMemoryUsage usage;
+	usage.raw = columnBytes(columns.frequencyOffset) + columnBytes(columns.phaseNoise) + columnBytes(columns.referenceNoise);
+	usage.raw += columns.phaseNoiseCompact.bytes() + columns.referenceNoiseCompact.bytes();
+	if (columns.phaseNoiseFiltered.constData() != columns.phaseNoise.constData()) {
+		usage.derived += columnBytes(columns.phaseNoiseFiltered);
+	}
+	if (columns.referenceNoiseFiltered.constData() != columns.referenceNoise.constData()) {
+		usage.derived += columnBytes(columns.referenceNoiseFiltered);
+	}
+	usage.render = graphBytes(graphs.measured) + graphBytes(graphs.reference)
+				 + graphBytes(graphs.referenceOutline) + graphBytes(graphs.referenceBase);
+	return usage;
+}
+
+QString formatBytes(qint64 bytes)
+{
+	return QLocale::c().formattedDataSize(bytes, 1, QLocale::DataSizeTraditionalFormat);
+}
+
+} // namespace MemoryAccounting
+
+void MemoryBudget::forget(DatasetRegistry::Handle handle)
+{
+	m_lastUse.remove(handle);
+	m_derivedEvicted.remove(handle);
+	m_renderEvicted.remove(handle);
+}
+
+void MemoryBudget::clear()
+{
+	m_lastUse.clear();
+	m_derivedEvicted.clear();
+	m_renderEvicted.clear();
+}
+
+void MemoryBudget::setDerivedEvicted(DatasetRegistry::Handle handle, bool evicted)
+{
+	if (evicted) {
+		if (!m_derivedEvicted.contains(handle)) {
+			m_derivedEvicted.insert(handle);
+			++m_evictionCount;
+		}
+	} else {
+		m_derivedEvicted.remove(handle);
+	}
+}
+
+void MemoryBudget::setRenderEvicted(DatasetRegistry::Handle handle, bool evicted)
+{
+	if (evicted) {
+		if (!m_renderEvicted.contains(handle)) {
+			m_renderEvicted.insert(handle);
+			++m_evictionCount;
+		}
+	} else {
+		m_renderEvicted.remove(handle);
+	}
+}
+
+QVector<DatasetRegistry::Handle> MemoryBudget::leastRecentlyUsed(const QVector<DatasetRegistry::Handle>& handles) const
+{
+	QVector<DatasetRegistry::Handle> order = handles;
+	std::stable_sort(order.begin(), order.end(), [this](DatasetRegistry::Handle a, DatasetRegistry::Handle b) {
+		return m_lastUse.value(a, 0) < m_lastUse.value(b, 0);
+	});
+	return order;
+}
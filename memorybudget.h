@@ -0,0 +1,99 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef MEMORYBUDGET_H
+#define MEMORYBUDGET_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include "datasetregistry.h"
+
+// Bytes held by one dataset, split by kind
+struct DatasetMemoryUsage {
+	qint64 raw = 0;     // Parsed columns
+	qint64 derived = 0; // Filter / spur removal results that are not shared with the raw columns
+	qint64 render = 0;  // QCPGraph data containers (allocated, including preallocation)
+	qint64 total() const { return raw + derived + render; }
+
+	DatasetMemoryUsage& operator+=(const DatasetMemoryUsage& other) {
+		raw += other.raw; derived += other.derived; render += other.render;
+		return *this;
+	}
+};
+
+namespace MemoryAccounting {
+
+// Allocated bytes of a column (capacity, not size); shared columns are reported by each owner
+qint64 columnBytes(const QVector<double>& column);
+
+// Filtered columns that still share the raw storage (implicit sharing) are not counted as derived
+DatasetMemoryUsage measure(const DatasetColumns& columns, const DatasetGraphs& graphs);
+
+QString formatBytes(qint64 bytes);
+
+} // namespace MemoryAccounting
+
+/*
+ * Least-recently-used bookkeeping for the memory budget.
+ *
+ * Only derived data and render caches are ever evicted: raw columns are the source
+ * of truth. A dataset with evicted derived data has its filtered columns aliased to
+ * the raw ones and is recomputed by PhaseNoiseAnalyzerApp::ensureDerived() the next
+ * time it is needed. Render-evicted datasets are hidden ones whose graphs are kept
+ * without data until they are shown again.
+ */
+class MemoryBudget
+{
+public:
+	void setBudget(qint64 bytes) { m_budget = qMax<qint64>(0, bytes); }
+	qint64 budget() const { return m_budget; } // 0 = unlimited
+
+	void touch(DatasetRegistry::Handle handle) { m_lastUse[handle] = ++m_clock; }
+	void forget(DatasetRegistry::Handle handle);
+	void clear();
+
+	bool isDerivedEvicted(DatasetRegistry::Handle handle) const { return m_derivedEvicted.contains(handle); }
+	void setDerivedEvicted(DatasetRegistry::Handle handle, bool evicted);
+	bool isRenderEvicted(DatasetRegistry::Handle handle) const { return m_renderEvicted.contains(handle); }
+	void setRenderEvicted(DatasetRegistry::Handle handle, bool evicted);
+
+	// Oldest first; datasets never touched come before everything else
+	QVector<DatasetRegistry::Handle> leastRecentlyUsed(const QVector<DatasetRegistry::Handle>& handles) const;
+
+	int evictionCount() const { return m_evictionCount; }
+
+private:
+	qint64 m_budget = 0;
+	quint64 m_clock = 0;
+	int m_evictionCount = 0;
+	QHash<DatasetRegistry::Handle, quint64> m_lastUse;
+	QSet<DatasetRegistry::Handle> m_derivedEvicted;
+	QSet<DatasetRegistry::Handle> m_renderEvicted;
+};
+
+#endif // MEMORYBUDGET_H
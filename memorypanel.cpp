@@ -0,0 +1,136 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "memorypanel.h"
+
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QSpinBox>
+#include <QStringList>
+#include <QTableWidget>
+#include <QTableWidgetItem>
+#include <QVBoxLayout>
+
+MemoryPanel::MemoryPanel(QWidget* parent)
+	: QWidget(parent)
+{
+	QVBoxLayout* layout = new QVBoxLayout(this);
+	layout->setContentsMargins(4, 4, 4, 4);
+
+	QFormLayout* form = new QFormLayout();
+	m_budgetSpin = new QSpinBox(this);
+	m_budgetSpin->setRange(0, 1024 * 1024);
+	m_budgetSpin->setSingleStep(64);
+	m_budgetSpin->setSuffix(" MB");
+	m_budgetSpin->setSpecialValueText("Unlimited");
+	m_budgetSpin->setToolTip("Above this, filtered data and plot caches of the least recently used datasets are released and recomputed when needed");
+	connect(m_budgetSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int megabytes) {
+		emit budgetChanged(qint64(megabytes) * 1024 * 1024);
+	});
+	form->addRow("Budget:", m_budgetSpin);
+	layout->addLayout(form);
+
+	m_totalsLabel = new QLabel(this);
+	m_totalsLabel->setWordWrap(true);
+	layout->addWidget(m_totalsLabel);
+
+	m_cacheLabel = new QLabel(this);
+	m_cacheLabel->setWordWrap(true);
+	m_cacheLabel->setToolTip("Parsed files kept so that re-loading an unchanged file does not parse it again");
+	layout->addWidget(m_cacheLabel);
+
+	m_table = new QTableWidget(0, 5, this);
+	m_table->setHorizontalHeaderLabels({"Dataset", "Raw", "Derived", "Render", "State"});
+	m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+	m_table->verticalHeader()->setVisible(false);
+	m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	m_table->setSelectionMode(QAbstractItemView::NoSelection);
+	layout->addWidget(m_table, 1);
+}
+
+void MemoryPanel::setBudget(qint64 bytes)
+{
+	const QSignalBlocker blocker(m_budgetSpin);
+	m_budgetSpin->setValue(int(bytes / (1024 * 1024)));
+}
+
+void MemoryPanel::showUsage(const QVector<Row>& rows, qint64 mappedBytes, const QStringList& mappedDetails, qint64 budget, int evictionCount)
+{
+	DatasetMemoryUsage total;
+	m_table->setRowCount(rows.size());
+	for (int i = 0; i < rows.size(); ++i) {
+		const Row& row = rows[i];
+		total += row.usage;
+		QStringList state;
+		if (row.derivedEvicted) state << "derived evicted";
+		if (row.renderEvicted) state << "render evicted";
+		const QString cells[] = {
+			row.name,
+			MemoryAccounting::formatBytes(row.usage.raw),
+			MemoryAccounting::formatBytes(row.usage.derived),
+			MemoryAccounting::formatBytes(row.usage.render),
+			state.join(", ")
+		};
+		for (int column = 0; column < 5; ++column) {
+			QTableWidgetItem* item = m_table->item(i, column);
+			if (!item) {
+				item = new QTableWidgetItem();
+				if (column > 0 && column < 4) item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+				m_table->setItem(i, column, item);
+			}
+			item->setText(cells[column]);
+		}
+	}
+
+	QString text = QString("Raw: %1 | Derived: %2 | Render: %3<br><b>Total: %4</b>")
+					   .arg(MemoryAccounting::formatBytes(total.raw), MemoryAccounting::formatBytes(total.derived),
+							MemoryAccounting::formatBytes(total.render), MemoryAccounting::formatBytes(total.total()));
+	if (budget > 0) {
+		text += QString(" of %1").arg(MemoryAccounting::formatBytes(budget));
+		if (total.total() > budget) text += " <b>(over budget)</b>";
+	}
+	if (mappedBytes > 0) {
+		text += QString("<br>Mapped traces: %1 on disk, paged in on demand").arg(MemoryAccounting::formatBytes(mappedBytes));
+		for (const QString& detail : mappedDetails) {
+			text += "<br>&nbsp;&nbsp;" + detail.toHtmlEscaped();
+		}
+	}
+	text += QString("<br>Evictions: %1").arg(evictionCount);
+	m_totalsLabel->setText(text);
+}
+
+void MemoryPanel::showParseCache(const DatasetCache::Stats& stats)
+{
+	QString text = QString("Parse cache: %1 file(s), %2").arg(stats.entries).arg(MemoryAccounting::formatBytes(stats.bytes));
+	if (stats.budget > 0) {
+		text += QString(" of %1").arg(MemoryAccounting::formatBytes(stats.budget));
+	} else {
+		text += " (disabled)";
+	}
+	text += QString("<br>Hits: %1 (%2 by content) | Misses: %3 | Hit rate: %4%")
+				.arg(stats.hits).arg(stats.hashHits).arg(stats.misses).arg(stats.hitRate() * 100.0, 0, 'f', 1);
+	m_cacheLabel->setText(text);
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef MEMORYPANEL_H
+#define MEMORYPANEL_H
+
+#include <QStringList>
+#include <QVector>
+#include <QWidget>
+
+#include "datasetcache.h"
+#include "memorybudget.h"
+
+class QLabel;
+class QSpinBox;
+class QTableWidget;
+
+// Memory diagnostics: per-dataset and total usage, budget setting and eviction state
+class MemoryPanel : public QWidget
+{
+	Q_OBJECT
+public:
+	struct Row {
+		QString name;
+		DatasetMemoryUsage usage;
+		bool derivedEvicted = false;
+		bool renderEvicted = false;
+	};
+
+	explicit MemoryPanel(QWidget* parent = nullptr);
+
+	void setBudget(qint64 bytes); // Does not emit budgetChanged()
+	// mappedDetails: one line per mapped trace (storage type, quantization error)
+	void showUsage(const QVector<Row>& rows, qint64 mappedBytes, const QStringList& mappedDetails, qint64 budget, int evictionCount);
+	void showParseCache(const DatasetCache::Stats& stats);
+
+signals:
+	void budgetChanged(qint64 bytes); // 0 = unlimited
+
+private:
+	QLabel* m_totalsLabel = nullptr;
+	QLabel* m_cacheLabel = nullptr;
+	QSpinBox* m_budgetSpin = nullptr;
+	QTableWidget* m_table = nullptr;
+};
+
+#endif // MEMORYPANEL_H
@@ -0,0 +1,236 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "monotonelinerasterizer.h"
+
+#include <cmath>
+#include <limits>
+
+#include "constants.h"
+
+namespace {
+
+constexpr int Subsamples = Constants::LINE_RASTER_SUBSAMPLES;
+
+// Each channel of a premultiplied pixel times a / 255, rounded
+inline uint byteMul(uint x, uint a)
+{
+	uint t = (x & 0xff00ff) * a;
+	t = ((t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8) & 0xff00ff;
+	x = ((x >> 8) & 0xff00ff) * a;
+	x = (x + ((x >> 8) & 0xff00ff) + 0x800080) & 0xff00ff00;
+	return x | t;
+}
+
+} // namespace
+
+bool MonotoneLineRasterizer::drawPolyline(QImage* image, const QRect& clip, const QPointF* points, int count,
+										  double width, QRgb color, bool squareCap)
+{
+	for (int i = 1; i < count; ++i) {
+		if (points[i].x() < points[i - 1].x()) return false;
+	}
+	Q_ASSERT(image->format() == QImage::Format_ARGB32_Premultiplied || image->format() == QImage::Format_RGB32);
+	m_clip = clip & image->rect();
+	if (count < 2 || m_clip.isEmpty()) return true;
+
+	// Scratch arrays are left cleared by blendColumns(), only a new size needs a fill
+	const int windowCount = m_clip.width() * Subsamples;
+	if (m_windowTop.size() < windowCount) {
+		m_windowTop.fill(std::numeric_limits<float>::max(), windowCount);
+		m_windowBottom.fill(std::numeric_limits<float>::lowest(), windowCount);
+	}
+	if (m_cover.size() < m_clip.height() + 1) {
+		m_cover.fill(0.0f, m_clip.height() + 1);
+		m_delta.fill(0.0f, m_clip.height() + 1);
+	}
+	if (m_touchedTop.size() != image->width()) {
+		m_touchedTop.fill(std::numeric_limits<int>::max(), image->width());
+		m_touchedBottom.fill(-1, image->width());
+		m_touchedLeft = image->width();
+		m_touchedRight = -1;
+	}
+
+	const double radius = width / 2.0;
+	m_firstWindow = windowCount;
+	m_lastWindow = -1;
+	for (int i = 0; i + 1 < count; ++i) {
+		sampleSegment(points[i], points[i + 1], radius, squareCap && i == 0, squareCap && i + 2 == count);
+	}
+	blendColumns(image, color);
+	return true;
+}
+
+void MonotoneLineRasterizer::sampleSegment(QPointF p0, QPointF p1, double radius, bool capStart, bool capEnd)
+{
+	double dx = p1.x() - p0.x();
+	double dy = p1.y() - p0.y();
+	double length = std::sqrt(dx * dx + dy * dy);
+	if (length > 0.0 && (capStart || capEnd)) {
+		// Square caps: the ends of the polyline extended by half the pen width
+		const QPointF extension(dx / length * radius, dy / length * radius);
+		if (capStart) p0 -= extension;
+		if (capEnd) p1 += extension;
+		dx = p1.x() - p0.x();
+		dy = p1.y() - p0.y();
+		length = std::sqrt(dx * dx + dy * dy);
+	}
+	// Box half extents: a horizontal, b vertical (a*sin + b*cos = radius across the segment)
+	const double a = length > 0.0 ? radius * std::abs(dy) / length : radius;
+	const double b = length > 0.0 ? radius * dx / length : radius;
+
+	// Sample windows whose center x is within a of the segment
+	const double left = m_clip.left();
+	const int windowCount = m_clip.width() * Subsamples;
+	const double firstWindow = std::ceil((p0.x() - a - left) * Subsamples - 0.5);
+	const double lastWindow = std::floor((p1.x() + a - left) * Subsamples - 0.5);
+	if (!(lastWindow >= 0.0) || !(firstWindow < windowCount)) return;
+	const int first = firstWindow < 0.0 ? 0 : int(firstWindow);
+	const int last = lastWindow >= windowCount ? windowCount - 1 : int(lastWindow);
+	if (first > last) return;
+
+	const double slope = dx > 0.0 ? dy / dx : 0.0;
+	for (int k = first; k <= last; ++k) {
+		const double center = left + (k + 0.5) / Subsamples;
+		double top;
+		double bottom;
+		if (dx > 0.0) {
+			// The part of the segment within a of the sample, as y range
+			const double from = qMax(p0.x(), center - a);
+			const double to = qMin(p1.x(), center + a);
+			if (from > to) continue;
+			const double y0 = p0.y() + (from - p0.x()) * slope;
+			const double y1 = p0.y() + (to - p0.x()) * slope;
+			top = qMin(y0, y1);
+			bottom = qMax(y0, y1);
+		} else {
+			top = qMin(p0.y(), p1.y());
+			bottom = qMax(p0.y(), p1.y());
+		}
+		m_windowTop[k] = qMin(m_windowTop[k], float(top - b));
+		m_windowBottom[k] = qMax(m_windowBottom[k], float(bottom + b));
+	}
+	m_firstWindow = qMin(m_firstWindow, first);
+	m_lastWindow = qMax(m_lastWindow, last);
+}
+
+void MonotoneLineRasterizer::blendColumns(QImage* image, QRgb color)
+{
+	if (m_firstWindow > m_lastWindow) return;
+	const int rows = m_clip.height();
+	const float weight = 1.0f / Subsamples;
+	const bool opaqueImage = image->format() == QImage::Format_RGB32;
+	uchar* bits = image->bits();
+	const qsizetype bytesPerLine = image->bytesPerLine();
+
+	for (int column = m_firstWindow / Subsamples; column <= m_lastWindow / Subsamples; ++column) {
+		// Coverage of the column: partial rows at the interval ends, full rows as +/- steps
+		int firstRow = rows;
+		int lastRow = -1;
+		for (int k = column * Subsamples; k < (column + 1) * Subsamples; ++k) {
+			const float top = qMax(m_windowTop[k] - m_clip.top(), 0.0f);
+			const float bottom = qMin(m_windowBottom[k] - m_clip.top(), float(rows));
+			m_windowTop[k] = std::numeric_limits<float>::max();
+			m_windowBottom[k] = std::numeric_limits<float>::lowest();
+			if (!(top < bottom)) continue;
+			const int topRow = int(top);
+			const int bottomRow = int(bottom);
+			if (topRow == bottomRow) {
+				m_cover[topRow] += (bottom - top) * weight;
+			} else {
+				m_cover[topRow] += (topRow + 1 - top) * weight;
+				m_delta[topRow + 1] += weight;
+				m_delta[bottomRow] -= weight;
+				m_cover[bottomRow] += (bottom - bottomRow) * weight;
+			}
+			firstRow = qMin(firstRow, topRow);
+			lastRow = qMax(lastRow, bottomRow);
+		}
+		if (lastRow < 0) continue;
+
+		const int x = m_clip.left() + column;
+		uchar* pixelRow = bits + qsizetype(m_clip.top() + firstRow) * bytesPerLine + x * 4;
+		float full = 0.0f;
+		int drawnTop = -1;
+		int drawnBottom = -1;
+		for (int row = firstRow; row <= lastRow; ++row, pixelRow += bytesPerLine) {
+			full += m_delta[row];
+			const float coverage = full + m_cover[row];
+			m_delta[row] = 0.0f;
+			m_cover[row] = 0.0f;
+			if (row == rows) break; // Only the closing step of an interval ending at the clip bottom
+			const uint alpha = coverage >= 1.0f ? 255u : uint(qMax(coverage, 0.0f) * 255.0f + 0.5f);
+			if (alpha == 0) continue;
+			QRgb* pixel = reinterpret_cast<QRgb*>(pixelRow);
+			const uint source = alpha == 255 ? color : byteMul(color, alpha);
+			uint result = source + byteMul(*pixel, 255 - qAlpha(source));
+			if (opaqueImage) result |= 0xff000000;
+			*pixel = result;
+			if (drawnTop < 0) drawnTop = row;
+			drawnBottom = row;
+		}
+		if (drawnTop < 0) continue;
+		m_touchedTop[x] = qMin(m_touchedTop[x], m_clip.top() + drawnTop);
+		m_touchedBottom[x] = qMax(m_touchedBottom[x], m_clip.top() + drawnBottom);
+		m_touchedLeft = qMin(m_touchedLeft, x);
+		m_touchedRight = qMax(m_touchedRight, x);
+	}
+}
+
+// --- Touched pixels ---
+
+QRect MonotoneLineRasterizer::touchedRect() const
+{
+	int top = std::numeric_limits<int>::max();
+	int bottom = -1;
+	for (int x = m_touchedLeft; x <= m_touchedRight; ++x) {
+		top = qMin(top, m_touchedTop.at(x));
+		bottom = qMax(bottom, m_touchedBottom.at(x));
+	}
+	if (bottom < 0) return QRect();
+	return QRect(QPoint(m_touchedLeft, top), QPoint(m_touchedRight, bottom));
+}
+
+void MonotoneLineRasterizer::clearTouched(QImage* image)
+{
+	uchar* bits = image->bits();
+	const qsizetype bytesPerLine = image->bytesPerLine();
+	for (int x = m_touchedLeft; x <= m_touchedRight; ++x) {
+		for (int y = m_touchedTop.at(x); y <= m_touchedBottom.at(x); ++y) {
+			reinterpret_cast<QRgb*>(bits + qsizetype(y) * bytesPerLine)[x] = 0;
+		}
+	}
+	resetTouched();
+}
+
+void MonotoneLineRasterizer::resetTouched()
+{
+	for (int x = m_touchedLeft; x <= m_touchedRight; ++x) {
+		m_touchedTop[x] = std::numeric_limits<int>::max();
+		m_touchedBottom[x] = -1;
+	}
+	m_touchedLeft = m_touchedTop.size();
+	m_touchedRight = -1;
+}
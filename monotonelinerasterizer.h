@@ -0,0 +1,84 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef MONOTONELINERASTERIZER_H
+#define MONOTONELINERASTERIZER_H
+
+#include <QImage>
+#include <QPointF>
+#include <QRect>
+#include <QVector>
+
+/*
+ * Antialiased polyline rasterizer for lines whose x never decreases, as every
+ * sweep drawn on the plot is.
+ *
+ * QPainter turns a pen into an outline path (stroker, joins, caps) and scan
+ * converts it, which is most of a replot of dense traces on machines without
+ * a GPU. Here the stroke of each segment is the segment widened by a box whose
+ * half extents (r*sin, r*cos of the segment angle, r = half the pen width)
+ * keep the perpendicular width at every slope. The stroke is sampled
+ * LINE_RASTER_SUBSAMPLES times per pixel column; since the line is a function
+ * of x each sample is one vertical interval, and a pixel gets the exact length
+ * of the intervals inside it (Wu-style coverage in y, supersampled in x). Each
+ * column is then blended as a single span of rows.
+ *
+ * Draws into Format_ARGB32_Premultiplied and Format_RGB32 images only; callers
+ * use QPainter for other devices, pens and transforms.
+ */
+class MonotoneLineRasterizer
+{
+public:
+	// Blends the polyline (device pixels) with a pen width pixels wide in a premultiplied color,
+	// writing only inside clip. False, with nothing drawn, if x decreases somewhere
+	bool drawPolyline(QImage* image, const QRect& clip, const QPointF* points, int count,
+					  double width, QRgb color, bool squareCap);
+
+	// Pixels written since the last clearTouched() / resetTouched(), for images used as a scratch layer
+	QRect touchedRect() const;
+	void clearTouched(QImage* image); // Makes them transparent again
+	void resetTouched();
+
+private:
+	void sampleSegment(QPointF p0, QPointF p1, double radius, bool capStart, bool capEnd);
+	void blendColumns(QImage* image, QRgb color);
+
+	QRect m_clip;
+	int m_firstWindow = 0;
+	int m_lastWindow = -1;
+	// Per sample window across the clip: vertical interval covered, empty while top > bottom
+	QVector<float> m_windowTop;
+	QVector<float> m_windowBottom;
+	// Per row of the clip, for the column being blended: partial coverage and change of full coverage
+	QVector<float> m_cover;
+	QVector<float> m_delta;
+	// Per image column: rows written, m_touchedTop > m_touchedBottom if none
+	QVector<int> m_touchedTop;
+	QVector<int> m_touchedBottom;
+	int m_touchedLeft = 0;
+	int m_touchedRight = -1;
+};
+
+#endif // MONOTONELINERASTERIZER_H
@@ -0,0 +1,730 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "packfile.h"
+#include "compressedinput.h"
+#include "processing.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+namespace {
+
+constexpr char FileMagic[8] = {'P', 'N', 'A', 'P', 'A', 'C', 'K', '\n'};
+constexpr char FooterMagic[8] = {'P', 'N', 'A', 'P', 'K', 'I', 'D', 'X'};
+constexpr quint32 FormatVersion = 1;
+constexpr quint32 ByteOrderMark = 0x01020304; // Written natively, detects foreign byte order
+constexpr qint64 HeaderSize = 32;
+constexpr qint64 FooterSize = 64;
+constexpr char MemberSeparator[] = ".pnapack#";
+constexpr int PackSuffixLength = 8; // ".pnapack"
+
+struct FileHeader {
+	char magic[8];
+	quint32 version;
+	quint32 byteOrderMark;
+	quint64 footerOffset; // Footer of the last completed write; 0: at the end of the file
+	quint64 reserved;
+};
+static_assert(sizeof(FileHeader) == HeaderSize, "Pack header must be 32 bytes");
+
+struct Footer {
+	char magic[8];
+	quint32 version;
+	quint32 byteOrderMark;
+	quint64 indexOffset;
+	quint64 entryCount;
+	quint64 namesOffset;
+	quint64 namesSize;
+	quint64 hashOffset;
+	quint32 hashSlots; // Power of two, more than entryCount; slot = entry index + 1, 0 = empty
+	quint32 reserved;
+};
+static_assert(sizeof(Footer) == FooterSize, "Pack footer must be 64 bytes");
+static_assert(sizeof(PackFile::IndexEntry) == 136, "Pack index entry must be 136 bytes");
+
+inline quint64 alignTo8(quint64 value)
+{
+	return (value + 7) & ~quint64(7);
+}
+
+// [offset, offset + length) ends at or before limit; offsets come from the file, so offset + length may wrap
+inline bool rangeFits(quint64 offset, quint64 length, quint64 limit)
+{
+	return offset <= limit && length <= limit - offset;
+}
+
+// FNV-1a of the UTF-8 name
+quint32 nameHash(const char* data, int size)
+{
+	quint32 hash = 2166136261u;
+	for (int i = 0; i < size; ++i) {
+		hash = (hash ^ quint8(data[i])) * 16777619u;
+	}
+	return hash;
+}
+
+quint32 hashSlotsFor(int count)
+{
+	quint32 slots = 8;
+	while (slots < quint32(count) * 2) slots <<= 1; // At most half full
+	return slots;
+}
+
+} // namespace
+
+// --- PackFile ---
+
+PackFile::~PackFile()
+{
+	if (m_map) {
+		m_file.unmap(m_map);
+	}
+}
+
+QSharedPointer<PackFile> PackFile::open(const QString& path, QString* errorString)
+{
+	auto fail = [errorString](const QString& message) {
+		if (errorString) *errorString = message;
+		return QSharedPointer<PackFile>();
+	};
+
+	QSharedPointer<PackFile> pack(new PackFile);
+	pack->m_filename = path;
+	pack->m_file.setFileName(path);
+	if (!pack->m_file.open(QIODevice::ReadOnly)) return fail(pack->m_file.errorString());
+	pack->m_size = pack->m_file.size();
+	if (pack->m_size < HeaderSize + FooterSize) return fail(QStringLiteral("File too small for a pack"));
+	pack->m_map = pack->m_file.map(0, pack->m_size);
+	if (!pack->m_map) return fail(QStringLiteral("Could not map file: %1").arg(pack->m_file.errorString()));
+
+	FileHeader header;
+	Footer footer;
+	std::memcpy(&header, pack->m_map, sizeof(header));
+	if (std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0) return fail(QStringLiteral("Not a pack file"));
+	// An append in progress (or interrupted) is past the footer the header points to
+	const quint64 footerOffset = header.footerOffset != 0 ? header.footerOffset : quint64(pack->m_size - FooterSize);
+	if (footerOffset < quint64(HeaderSize) || footerOffset > quint64(pack->m_size - FooterSize)) {
+		return fail(QStringLiteral("Corrupt pack header"));
+	}
+	std::memcpy(&footer, pack->m_map + footerOffset, sizeof(footer));
+	if (header.byteOrderMark != ByteOrderMark || footer.byteOrderMark != ByteOrderMark) {
+		return fail(QStringLiteral("Pack written with a different byte order"));
+	}
+	if (header.version != FormatVersion) return fail(QStringLiteral("Unsupported pack version %1").arg(header.version));
+	if (std::memcmp(footer.magic, FooterMagic, sizeof(FooterMagic)) != 0 || footer.version != FormatVersion) {
+		return fail(QStringLiteral("Pack index missing (incomplete write?)"));
+	}
+
+	// Bounds of the index structures; member columns are checked when read. The lengths
+	// cannot overflow once entryCount <= INT_MAX, hashSlots is 32 bit.
+	const quint64 end = footerOffset;
+	const bool valid = footer.entryCount <= quint64(std::numeric_limits<int>::max())
+					   && footer.indexOffset >= quint64(HeaderSize) && footer.indexOffset % 8 == 0
+					   && rangeFits(footer.indexOffset, footer.entryCount * sizeof(IndexEntry), footer.namesOffset)
+					   && rangeFits(footer.namesOffset, footer.namesSize, footer.hashOffset) && footer.hashOffset % 4 == 0
+					   && rangeFits(footer.hashOffset, quint64(footer.hashSlots) * sizeof(quint32), end)
+					   && footer.hashSlots > footer.entryCount && (footer.hashSlots & (footer.hashSlots - 1)) == 0;
+	if (!valid) return fail(QStringLiteral("Corrupt pack index"));
+
+	pack->m_count = int(footer.entryCount);
+	pack->m_footerOffset = footerOffset;
+	pack->m_indexOffset = footer.indexOffset;
+	pack->m_entries = reinterpret_cast<const IndexEntry*>(pack->m_map + footer.indexOffset);
+	pack->m_names = reinterpret_cast<const char*>(pack->m_map + footer.namesOffset);
+	pack->m_namesSize = footer.namesSize;
+	pack->m_hash = reinterpret_cast<const quint32*>(pack->m_map + footer.hashOffset);
+	pack->m_hashSlots = footer.hashSlots;
+	return pack;
+}
+
+QSharedPointer<PackFile> PackFile::shared(const QString& path, QString* errorString)
+{
+	struct Cached {
+		QSharedPointer<PackFile> pack;
+		qint64 size = 0;
+		qint64 modified = 0;
+	};
+	static QMutex mutex;
+	static QHash<QString, Cached> packs;
+
+	const QFileInfo info(path);
+	const QString key = info.canonicalFilePath();
+	if (key.isEmpty()) {
+		if (errorString) *errorString = QString("Could not open file: %1").arg(path);
+		return QSharedPointer<PackFile>();
+	}
+	const qint64 size = info.size();
+	const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+	QMutexLocker locker(&mutex);
+	const auto it = packs.constFind(key);
+	if (it != packs.cend() && it->size == size && it->modified == modified) {
+		return it->pack;
+	}
+	Cached cached;
+	cached.pack = open(key, errorString);
+	if (!cached.pack) {
+		packs.remove(key);
+		return cached.pack;
+	}
+	cached.size = size;
+	cached.modified = modified;
+	packs.insert(key, cached);
+	return cached.pack;
+}
+
+bool PackFile::isPackFile(const QString& path)
+{
+	return path.endsWith(QLatin1String(MemberSeparator, PackSuffixLength), Qt::CaseInsensitive);
+}
+
+bool PackFile::splitMemberPath(const QString& path, QString* packPath, QString* member)
+{
+	const int separator = path.indexOf(QLatin1String(MemberSeparator), 0, Qt::CaseInsensitive);
+	if (separator < 0 || separator + PackSuffixLength + 1 >= path.size()) return false;
+	if (packPath) *packPath = path.left(separator + PackSuffixLength);
+	if (member) *member = path.mid(separator + PackSuffixLength + 1);
+	return true;
+}
+
+QString PackFile::memberPath(const QString& packPath, const QString& member)
+{
+	return packPath + '#' + member;
+}
+
+int PackFile::find(const QString& name) const
+{
+	if (m_hashSlots == 0) return -1;
+	const QByteArray utf8 = name.toUtf8();
+	const quint32 mask = m_hashSlots - 1;
+	for (quint32 slot = nameHash(utf8.constData(), utf8.size()) & mask;; slot = (slot + 1) & mask) {
+		const quint32 value = m_hash[slot];
+		if (value == 0 || value > quint32(m_count)) return -1;
+		const IndexEntry& entry = m_entries[value - 1];
+		if (entry.nameSize == quint32(utf8.size()) && rangeFits(entry.nameOffset, entry.nameSize, m_namesSize)
+			&& std::memcmp(m_names + entry.nameOffset, utf8.constData(), size_t(utf8.size())) == 0) {
+			return int(value - 1);
+		}
+	}
+}
+
+QString PackFile::name(int index) const
+{
+	const IndexEntry& entry = m_entries[index];
+	if (!rangeFits(entry.nameOffset, entry.nameSize, m_namesSize)) return QString();
+	return QString::fromUtf8(m_names + entry.nameOffset, int(entry.nameSize));
+}
+
+PackFile::MemberInfo PackFile::info(int index) const
+{
+	const IndexEntry& entry = m_entries[index];
+	MemberInfo info;
+	info.name = name(index);
+	info.pointCount = qint64(entry.pointCount);
+	info.hasReferenceData = entry.flags & FlagReference;
+	info.sourceSize = entry.sourceSize;
+	info.sourceModified = entry.sourceModified;
+	info.frequencyMin = entry.frequencyMin;
+	info.frequencyMax = entry.frequencyMax;
+	std::copy(std::begin(entry.spotNoise), std::end(entry.spotNoise), info.spotNoise.begin());
+	return info;
+}
+
+bool PackFile::columnsInFile(int index) const
+{
+	const IndexEntry& entry = m_entries[index];
+	const quint64 columns = (entry.flags & FlagReference) ? 3 : 2;
+	return entry.pointCount <= quint64(std::numeric_limits<int>::max()) && entry.dataOffset % 8 == 0
+		   && entry.dataOffset >= quint64(HeaderSize)
+		   && rangeFits(entry.dataOffset, columns * entry.pointCount * sizeof(double), m_indexOffset);
+}
+
+const double* PackFile::frequencyOffset(int index) const
+{
+	if (!columnsInFile(index)) return nullptr;
+	return reinterpret_cast<const double*>(m_map + m_entries[index].dataOffset);
+}
+
+const double* PackFile::phaseNoise(int index) const
+{
+	const double* keys = frequencyOffset(index);
+	return keys ? keys + m_entries[index].pointCount : nullptr;
+}
+
+const double* PackFile::referenceNoise(int index) const
+{
+	const double* keys = frequencyOffset(index);
+	if (!keys || !(m_entries[index].flags & FlagReference)) return nullptr;
+	return keys + 2 * m_entries[index].pointCount;
+}
+
+bool PackFile::read(int index, ParsedDataset* out) const
+{
+	const double* keys = frequencyOffset(index);
+	if (!keys) return false;
+	const int count = int(m_entries[index].pointCount);
+	const double* noise = keys + count;
+	const double* ref = referenceNoise(index);
+	out->frequencyOffset = QVector<double>(keys, keys + count);
+	out->phaseNoise = QVector<double>(noise, noise + count);
+	out->referenceNoise = ref ? QVector<double>(ref, ref + count) : QVector<double>(count, std::numeric_limits<double>::quiet_NaN());
+	out->hasReferenceData = ref != nullptr;
+	out->sweepStarts.clear();
+	return true;
+}
+
+// --- PackWriter ---
+
+PackWriter::~PackWriter()
+{
+	cancel();
+}
+
+bool PackWriter::open(const QString& path, QString* errorString)
+{
+	auto fail = [this, errorString](const QString& message) {
+		m_error = message;
+		if (errorString) *errorString = message;
+		return false;
+	};
+
+	m_entries.clear();
+	m_names.clear();
+	m_nameSet.clear();
+	m_created = !QFileInfo::exists(path);
+	m_oldSize = 0;
+	if (!m_created) {
+		QString error;
+		const QSharedPointer<PackFile> existing = PackFile::open(path, &error);
+		if (!existing) return fail(error);
+		m_entries.reserve(existing->count());
+		for (int i = 0; i < existing->count(); ++i) {
+			m_entries.append(existing->m_entries[i]);
+			m_nameSet.insert(existing->name(i));
+		}
+		m_names = QByteArray(existing->m_names, int(existing->m_namesSize));
+		m_oldSize = qint64(existing->m_footerOffset) + FooterSize; // Drops what an interrupted append left
+		m_dataEnd = qint64(alignTo8(quint64(m_oldSize))); // After the old footer, which stays valid
+	} else {
+		m_dataEnd = HeaderSize;
+	}
+
+	m_file.setFileName(path);
+	if (!m_file.open(QIODevice::ReadWrite)) return fail(m_file.errorString());
+	if (m_created) {
+		FileHeader header = {};
+		std::memcpy(header.magic, FileMagic, sizeof(FileMagic));
+		header.version = FormatVersion;
+		header.byteOrderMark = ByteOrderMark;
+		if (m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != qint64(sizeof(header))) {
+			const QString message = m_file.errorString();
+			m_file.close();
+			m_file.remove();
+			return fail(message);
+		}
+	} else {
+		// Older packs leave the header pointer at 0 (footer at the end): set it, so readers
+		// keep finding the old footer while this session writes past it
+		const quint64 footerOffset = quint64(m_oldSize - FooterSize);
+		if (!m_file.seek(offsetof(FileHeader, footerOffset))
+			|| m_file.write(reinterpret_cast<const char*>(&footerOffset), sizeof(footerOffset)) != qint64(sizeof(footerOffset))
+			|| !m_file.flush()) {
+			const QString message = m_file.errorString();
+			m_file.close();
+			return fail(message);
+		}
+	}
+	return true;
+}
+
+bool PackWriter::add(const QString& name, const ParsedDataset& data, qint64 sourceSize, qint64 sourceModified)
+{
+	if (!m_file.isOpen()) {
+		m_error = QStringLiteral("Pack not open");
+		return false;
+	}
+	if (m_nameSet.contains(name)) {
+		m_error = QString("A member named %1 is already in the pack").arg(name);
+		return false;
+	}
+	const int count = data.frequencyOffset.size();
+	if (count == 0) {
+		m_error = QString("%1 has no data points").arg(name);
+		return false;
+	}
+
+	PackFile::IndexEntry entry = {};
+	entry.dataOffset = quint64(m_dataEnd);
+	entry.pointCount = quint64(count);
+	entry.flags = data.hasReferenceData ? PackFile::FlagReference : 0;
+	entry.sourceSize = sourceSize;
+	entry.sourceModified = sourceModified;
+	entry.frequencyMin = data.frequencyOffset.first();
+	entry.frequencyMax = data.frequencyOffset.last();
+	std::fill(std::begin(entry.spotNoise), std::end(entry.spotNoise), std::numeric_limits<double>::quiet_NaN());
+	const QVector<SpotNoisePoint> spots = Processing::spotNoise(data.frequencyOffset, data.phaseNoise, entry.frequencyMin, entry.frequencyMax);
+	for (const SpotNoisePoint& spot : spots) {
+		for (int i = 0; i < Constants::FREQ_POINT_COUNT; ++i) {
+			if (spot.targetFrequency == Constants::FREQ_POINTS[i]) entry.spotNoise[i] = spot.noise;
+		}
+	}
+
+	const qint64 columnBytes = qint64(count) * qint64(sizeof(double));
+	bool ok = m_file.seek(m_dataEnd)
+			  && m_file.write(reinterpret_cast<const char*>(data.frequencyOffset.constData()), columnBytes) == columnBytes
+			  && m_file.write(reinterpret_cast<const char*>(data.phaseNoise.constData()), columnBytes) == columnBytes;
+	if (ok && data.hasReferenceData) {
+		ok = m_file.write(reinterpret_cast<const char*>(data.referenceNoise.constData()), columnBytes) == columnBytes;
+	}
+	if (!ok) {
+		m_error = m_file.errorString();
+		return false;
+	}
+	m_dataEnd = m_file.pos();
+
+	const QByteArray utf8 = name.toUtf8();
+	entry.nameOffset = quint64(m_names.size());
+	entry.nameSize = quint32(utf8.size());
+	m_names.append(utf8);
+	m_entries.append(entry);
+	m_nameSet.insert(name);
+	return true;
+}
+
+// Index entries, names, hash table and footer from m_dataEnd, then points the header at
+// the new footer: until that last write, readers use the previous index
+bool PackWriter::writeIndex()
+{
+	Footer footer = {};
+	std::memcpy(footer.magic, FooterMagic, sizeof(FooterMagic));
+	footer.version = FormatVersion;
+	footer.byteOrderMark = ByteOrderMark;
+	footer.indexOffset = alignTo8(quint64(m_dataEnd));
+	footer.entryCount = quint64(m_entries.size());
+	footer.namesOffset = footer.indexOffset + footer.entryCount * sizeof(PackFile::IndexEntry);
+	footer.namesSize = quint64(m_names.size());
+	footer.hashOffset = alignTo8(footer.namesOffset + footer.namesSize);
+	footer.hashSlots = hashSlotsFor(m_entries.size());
+
+	QVector<quint32> slots(int(footer.hashSlots), 0);
+	const quint32 mask = footer.hashSlots - 1;
+	for (int i = 0; i < m_entries.size(); ++i) {
+		const PackFile::IndexEntry& entry = m_entries[i];
+		quint32 slot = nameHash(m_names.constData() + entry.nameOffset, int(entry.nameSize)) & mask;
+		while (slots[int(slot)] != 0) slot = (slot + 1) & mask;
+		slots[int(slot)] = quint32(i + 1);
+	}
+
+	const char padding[8] = {};
+	const qint64 entryBytes = qint64(footer.entryCount * sizeof(PackFile::IndexEntry));
+	const qint64 slotBytes = qint64(slots.size()) * qint64(sizeof(quint32));
+	const bool ok = m_file.seek(m_dataEnd)
+					&& m_file.write(padding, qint64(footer.indexOffset) - m_dataEnd) == qint64(footer.indexOffset) - m_dataEnd
+					&& m_file.write(reinterpret_cast<const char*>(m_entries.constData()), entryBytes) == entryBytes
+					&& m_file.write(m_names) == m_names.size()
+					&& m_file.write(padding, qint64(footer.hashOffset - footer.namesOffset - footer.namesSize))
+						   == qint64(footer.hashOffset - footer.namesOffset - footer.namesSize)
+					&& m_file.write(reinterpret_cast<const char*>(slots.constData()), slotBytes) == slotBytes
+					&& m_file.write(reinterpret_cast<const char*>(&footer), sizeof(footer)) == qint64(sizeof(footer))
+					&& m_file.flush();
+	const quint64 footerOffset = footer.hashOffset + quint64(slotBytes);
+	const bool committed = ok && m_file.seek(offsetof(FileHeader, footerOffset))
+						   && m_file.write(reinterpret_cast<const char*>(&footerOffset), sizeof(footerOffset)) == qint64(sizeof(footerOffset))
+						   && m_file.flush();
+	if (!committed) m_error = m_file.errorString();
+	return committed;
+}
+
+bool PackWriter::finish(QString* errorString)
+{
+	if (!m_file.isOpen()) {
+		m_error = QStringLiteral("Pack not open");
+	} else if (writeIndex()) {
+		m_file.close();
+		return true;
+	}
+	if (errorString) *errorString = m_error;
+	cancel();
+	return false;
+}
+
+void PackWriter::cancel()
+{
+	if (!m_file.isOpen()) return;
+	if (m_created) {
+		m_file.close();
+		m_file.remove();
+	} else {
+		// The old index is untouched: drop this session's columns
+		if (!m_file.resize(m_oldSize)) {
+			qWarning() << "Could not truncate" << m_file.fileName() << ":" << m_file.errorString();
+		}
+		m_file.close();
+	}
+	m_entries.clear();
+	m_names.clear();
+	m_nameSet.clear();
+}
+
+// --- Command line ---
+
+namespace PackArchive {
+
+int append(const QString& packPath, const QStringList& inputs, const DatasetParser::StitchOptions& stitch)
+{
+	PackWriter writer;
+	QString errorString;
+	if (!writer.open(packPath, &errorString)) {
+		qWarning().noquote() << QString("Could not open %1: %2").arg(packPath, errorString);
+		return 1;
+	}
+
+	const QString canonicalPack = QFileInfo(packPath).canonicalFilePath();
+	int added = 0;
+	int failed = 0;
+	for (const QString& input : inputs) {
+		QString sourcePack;
+		QString member;
+		const bool isMember = PackFile::splitMemberPath(input, &sourcePack, &member);
+		if (isMember && QFileInfo(sourcePack).canonicalFilePath() == canonicalPack) {
+			qWarning().noquote() << QString("Skipping %1: already in %2").arg(input, packPath);
+			failed++;
+			continue;
+		}
+		const QString name = isMember ? member : QFileInfo(input).fileName();
+		if (writer.contains(name)) {
+			qWarning().noquote() << QString("Skipping %1: a member named %2 is already in the pack").arg(input, name);
+			failed++;
+			continue;
+		}
+		ParsedDataset parsed;
+		if (!DatasetParser::parseFile(input, &parsed, &errorString, stitch)) {
+			qWarning().noquote() << QString("Skipping %1: %2").arg(input, errorString);
+			failed++;
+			continue;
+		}
+		const QFileInfo info(input);
+		const qint64 modified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+		if (!writer.add(name, parsed, info.size(), modified)) {
+			qWarning().noquote() << QString("Could not add %1: %2").arg(input, writer.errorString());
+			writer.cancel();
+			return 1;
+		}
+		added++;
+		if (added % 1000 == 0) {
+			qInfo().noquote() << QString("Pack: %1/%2").arg(added + failed).arg(inputs.size());
+		}
+	}
+
+	if (!writer.finish(&errorString)) {
+		qWarning().noquote() << QString("Could not write the index of %1: %2").arg(packPath, errorString);
+		return 1;
+	}
+	qInfo().noquote() << QString("Pack: %1 added, %2 skipped, %3 member(s) in %4").arg(added).arg(failed).arg(writer.count()).arg(packPath);
+	return failed == 0 ? 0 : 1;
+}
+
+int list(const QString& packPath)
+{
+	QString errorString;
+	const QSharedPointer<PackFile> pack = PackFile::open(packPath, &errorString);
+	if (!pack) {
+		qWarning().noquote() << QString("Could not open %1: %2").arg(packPath, errorString);
+		return 1;
+	}
+
+	QTextStream out(stdout);
+	out << "Name\tPoints\tReference\tMin Frequency (Hz)\tMax Frequency (Hz)";
+	for (const auto& point : Constants::FREQ_POINT_INFOS) {
+		out << '\t' << point.displayName << " (dBc/Hz)";
+	}
+	out << "\tSource Size\tSource Modified\n";
+	for (int i = 0; i < pack->count(); ++i) {
+		const PackFile::MemberInfo info = pack->info(i);
+		out << info.name << '\t' << info.pointCount << '\t' << (info.hasReferenceData ? "yes" : "no") << '\t'
+			<< QString::number(info.frequencyMin, 'g', 9) << '\t' << QString::number(info.frequencyMax, 'g', 9);
+		for (const double noise : info.spotNoise) {
+			out << '\t' << (std::isnan(noise) ? QString() : QString::number(noise, 'f', 3));
+		}
+		out << '\t' << info.sourceSize << '\t'
+			<< (info.sourceModified > 0 ? QDateTime::fromMSecsSinceEpoch(info.sourceModified).toString(Qt::ISODate) : QString()) << '\n';
+	}
+	return 0;
+}
+
+// "<base name>.csv" per member; members whose base names collide (run.csv, run.txt,
+// run.csv.gz) keep their own name, with ".csv" added if needed, numbered if still taken
+static QStringList extractFileNames(const PackFile& pack, const QVector<int>& indices)
+{
+	auto key = [](const QString& fileName) { return fileName.toLower(); }; // As the file system may compare them
+	QStringList fileNames;
+	fileNames.reserve(indices.size());
+	QHash<QString, int> uses;
+	for (const int index : indices) {
+		fileNames << CompressedInput::baseName(QFileInfo(pack.name(index)).fileName()) + ".csv";
+		uses[key(fileNames.last())]++;
+	}
+
+	QSet<QString> taken;
+	for (const QString& fileName : std::as_const(fileNames)) {
+		if (uses.value(key(fileName)) == 1) taken.insert(key(fileName));
+	}
+	for (int k = 0; k < indices.size(); ++k) {
+		if (uses.value(key(fileNames[k])) == 1) continue;
+		QString own = QFileInfo(pack.name(indices[k])).fileName();
+		if (!own.endsWith(QLatin1String(".csv"), Qt::CaseInsensitive)) own += ".csv";
+		QString fileName = own;
+		for (int n = 2; taken.contains(key(fileName)); ++n) {
+			fileName = own.left(own.size() - 4) + "_" + QString::number(n) + ".csv";
+		}
+		taken.insert(key(fileName));
+		fileNames[k] = fileName;
+	}
+	return fileNames;
+}
+
+int extract(const QString& packPath, const QStringList& members, const QString& outputDir)
+{
+	QString errorString;
+	const QSharedPointer<PackFile> pack = PackFile::open(packPath, &errorString);
+	if (!pack) {
+		qWarning().noquote() << QString("Could not open %1: %2").arg(packPath, errorString);
+		return 1;
+	}
+
+	QVector<int> indices;
+	if (members.isEmpty()) {
+		for (int i = 0; i < pack->count(); ++i) indices.append(i);
+	}
+	int failed = 0;
+	for (const QString& member : members) {
+		const int index = pack->find(member);
+		if (index < 0) {
+			qWarning().noquote() << QString("No member %1 in %2").arg(member, packPath);
+			failed++;
+		} else {
+			indices.append(index);
+		}
+	}
+
+	const QString dir = outputDir.isEmpty() ? QDir::currentPath() : outputDir;
+	QDir().mkpath(dir);
+	const QStringList fileNames = extractFileNames(*pack, indices);
+	int extracted = 0;
+	for (int k = 0; k < indices.size(); ++k) {
+		const int index = indices[k];
+		ParsedDataset data;
+		const QString name = pack->name(index);
+		const QString path = dir + "/" + fileNames[k];
+		QSaveFile file(path);
+		bool ok = pack->read(index, &data) && file.open(QIODevice::WriteOnly | QIODevice::Text);
+		if (ok) {
+			// Full precision: loading the extracted file gives the packed columns exactly
+			QTextStream out(&file);
+			out << "# " << name << " from " << QFileInfo(packPath).fileName() << "\n";
+			out << "# Frequency(Hz),Measured(dBc/Hz)" << (data.hasReferenceData ? ",Reference(dBc/Hz)" : "") << "\n";
+			for (int i = 0; i < data.frequencyOffset.size(); ++i) {
+				out << QString::number(data.frequencyOffset[i], 'g', 17) << "," << QString::number(data.phaseNoise[i], 'g', 17);
+				if (data.hasReferenceData && !std::isnan(data.referenceNoise[i])) {
+					out << "," << QString::number(data.referenceNoise[i], 'g', 17);
+				}
+				out << "\n";
+			}
+			out.flush();
+			ok = file.commit();
+		}
+		if (ok) {
+			extracted++;
+		} else {
+			qWarning().noquote() << QString("Could not extract %1 to %2").arg(name, path);
+			failed++;
+		}
+	}
+	qInfo().noquote() << QString("Pack: %1 member(s) extracted to %2").arg(extracted).arg(dir);
+	return failed == 0 ? 0 : 1;
+}
+
+int compact(const QString& packPath)
+{
+	QString errorString;
+	QSharedPointer<PackFile> pack = PackFile::open(packPath, &errorString);
+	if (!pack) {
+		qWarning().noquote() << QString("Could not open %1: %2").arg(packPath, errorString);
+		return 1;
+	}
+
+	// Rewritten beside the pack, which is only replaced once the copy is complete
+	const QString temporaryPath = packPath + ".compact";
+	QFile::remove(temporaryPath);
+	PackWriter writer;
+	if (!writer.open(temporaryPath, &errorString)) {
+		qWarning().noquote() << QString("Could not create %1: %2").arg(temporaryPath, errorString);
+		return 1;
+	}
+	for (int i = 0; i < pack->count(); ++i) {
+		const PackFile::MemberInfo info = pack->info(i);
+		ParsedDataset data;
+		if (!pack->read(i, &data)) {
+			qWarning().noquote() << QString("Could not read %1 from %2").arg(info.name, packPath);
+			writer.cancel();
+			return 1;
+		}
+		if (!writer.add(info.name, data, info.sourceSize, info.sourceModified)) {
+			qWarning().noquote() << QString("Could not add %1: %2").arg(info.name, writer.errorString());
+			writer.cancel();
+			return 1;
+		}
+	}
+	if (!writer.finish(&errorString)) {
+		qWarning().noquote() << QString("Could not write the index of %1: %2").arg(temporaryPath, errorString);
+		return 1;
+	}
+
+	const qint64 before = QFileInfo(packPath).size();
+	pack.clear(); // Unmapped before the file is replaced
+	if (!QFile::remove(packPath) || !QFile::rename(temporaryPath, packPath)) {
+		qWarning().noquote() << QString("Could not replace %1, the compacted pack is %2").arg(packPath, temporaryPath);
+		return 1;
+	}
+	qInfo().noquote() << QString("Pack: %1 member(s), %2 -> %3 bytes").arg(writer.count()).arg(before).arg(QFileInfo(packPath).size());
+	return 0;
+}
+
+} // namespace PackArchive
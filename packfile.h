@@ -0,0 +1,189 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef PACKFILE_H
+#define PACKFILE_H
+
+#include <QFile>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <array>
+
+#include "coreconstants.h"
+#include "datasetparser.h"
+
+/*
+ * Read-only, memory-mapped archive of many small captures (.pnapack), so that a
+ * scan of 100k files costs one open instead of 100k opens and stats.
+ *
+ * Layout (native byte order, checked through a byte order mark):
+ *   header | member columns... | index entries | names | hash table | footer
+ * Appends add columns, then a new index and footer, after the old footer; the
+ * header points to the footer of the last completed write, so the old index stays
+ * in use until the new one is complete. compact() drops the superseded indexes.
+ *
+ * Each member is its parsed columns as float64: frequency offset, phase noise and,
+ * if present, reference noise. The index entry (fixed size) holds its offset, point
+ * count, source file size and time, frequency range and the spot noise at each
+ * decade, so listing or filtering a pack never touches the columns. The footer
+ * locates the index; the hash table (open addressing on the
+ * member name) finds a member without building anything on open.
+ *
+ * Members are opened as "archive.pnapack#member", anywhere a dataset path is
+ * accepted: DatasetParser::parseFile() reads them through shared().
+ */
+class PackFile
+{
+public:
+	// What the index records about one member
+	struct MemberInfo {
+		QString name;
+		qint64 pointCount = 0;
+		bool hasReferenceData = false;
+		qint64 sourceSize = 0;     // Bytes of the file it was packed from
+		qint64 sourceModified = 0; // ms since epoch, 0 if unknown
+		double frequencyMin = 0.0;
+		double frequencyMax = 0.0;
+		std::array<double, Constants::FREQ_POINT_COUNT> spotNoise; // dBc/Hz per FREQ_POINTS decade, NaN if not covered
+	};
+
+	// Index record as stored in the file (136 bytes)
+	struct IndexEntry {
+		quint64 dataOffset; // Frequency offset column, then phase noise, then reference noise if FlagReference
+		quint64 pointCount;
+		quint64 nameOffset; // UTF-8, in the names block
+		quint32 nameSize;
+		quint32 flags;
+		qint64 sourceSize;
+		qint64 sourceModified;
+		double frequencyMin;
+		double frequencyMax;
+		double spotNoise[Constants::FREQ_POINT_COUNT];
+	};
+	static constexpr quint32 FlagReference = 1;
+
+	~PackFile();
+
+	static QSharedPointer<PackFile> open(const QString& path, QString* errorString = nullptr);
+	// One instance per pack for the loaders, reopened when the file changed on disk
+	static QSharedPointer<PackFile> shared(const QString& path, QString* errorString = nullptr);
+
+	// "archive.pnapack#member"
+	static bool isPackFile(const QString& path);
+	static bool splitMemberPath(const QString& path, QString* packPath, QString* member);
+	static QString memberPath(const QString& packPath, const QString& member);
+
+	const QString& filename() const { return m_filename; }
+	int count() const { return m_count; }
+	int find(const QString& name) const; // -1 if there is no such member
+	QString name(int index) const;
+	MemberInfo info(int index) const;
+
+	// Columns of a member, straight from the mapping (referenceNoise: nullptr without reference)
+	const double* frequencyOffset(int index) const;
+	const double* phaseNoise(int index) const;
+	const double* referenceNoise(int index) const;
+	bool read(int index, ParsedDataset* out) const; // False if the member's columns are outside the file
+
+private:
+	friend class PackWriter;
+
+	PackFile() = default;
+	Q_DISABLE_COPY(PackFile)
+
+	bool columnsInFile(int index) const;
+
+	QString m_filename;
+	QFile m_file;
+	uchar* m_map = nullptr;
+	qint64 m_size = 0;
+	int m_count = 0;
+	quint64 m_footerOffset = 0;
+	quint64 m_indexOffset = 0; // End of the member columns
+	const IndexEntry* m_entries = nullptr;
+	const char* m_names = nullptr;
+	quint64 m_namesSize = 0;
+	const quint32* m_hash = nullptr;
+	quint32 m_hashSlots = 0;
+};
+
+// Adds members to a pack, creating it if needed. The new columns go after the old
+// footer and finish() writes the index of all members after them; cancel() (or
+// destroying an unfinished writer) truncates the file back to the old footer.
+class PackWriter
+{
+public:
+	PackWriter() = default;
+	~PackWriter();
+
+	bool open(const QString& path, QString* errorString = nullptr);
+	bool contains(const QString& name) const { return m_nameSet.contains(name); }
+	bool add(const QString& name, const ParsedDataset& data, qint64 sourceSize, qint64 sourceModified);
+	bool finish(QString* errorString = nullptr);
+	void cancel();
+
+	int count() const { return m_entries.size(); }
+	const QString& errorString() const { return m_error; }
+
+private:
+	Q_DISABLE_COPY(PackWriter)
+	bool writeIndex();
+
+	QFile m_file;
+	bool m_created = false;
+	qint64 m_oldSize = 0; // File size before this session
+	qint64 m_dataEnd = 0;
+	QVector<PackFile::IndexEntry> m_entries;
+	QByteArray m_names;
+	QSet<QString> m_nameSet;
+	QString m_error;
+};
+
+/*
+ * Command line tools on packs (pna_qt --pack-append / --pack-list / --pack-extract).
+ * Each returns the process exit code.
+ */
+namespace PackArchive {
+
+// Parses the inputs (any dataset path, so also compressed files and other packs'
+// members) and appends them, named after their file name. Creates the pack if needed.
+int append(const QString& packPath, const QStringList& inputs, const DatasetParser::StitchOptions& stitch);
+
+// One tab separated line per member: name, points, frequency range, spot noise, source size and time
+int list(const QString& packPath);
+
+// Writes the members (all if none are given) as CSV files into outputDir, named after
+// the member ("run.csv" for run.csv.gz); colliding names keep the whole member name
+int extract(const QString& packPath, const QStringList& members, const QString& outputDir);
+
+// Rewrites the pack without the indexes (and failed appends' space) left by earlier appends
+int compact(const QString& packPath);
+
+} // namespace PackArchive
+
+#endif // PACKFILE_H
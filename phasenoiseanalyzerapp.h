@@ -35,10 +35,19 @@
 #include <QColor>
 #include <QPointF>
 #include <QMenu> // Include for context menu
+#include <QElapsedTimer>
+#include <memory>
 
 #include "qcustomplot.h" // Include QCustomPlot header
 #include "constants.h"
 #include "utils.h"
+#include "datasetregistry.h"
+#include "legendpanel.h"
+#include "memorybudget.h"
+#include "derivedpipeline.h"
+#include "datasetparser.h"
+#include "siaxisticker.h"
+#include "annotationlayer.h"
 
 // Forward declarations for Qt classes to reduce header dependencies
 class QAction;
@@ -58,124 +67,20 @@ class QVBoxLayout;
 class QTimer;
 class QMouseEvent; // Forward declare for event parameter type
 class QContextMenuEvent; // Forward declare for event parameter type
-
-// --- Custom Axis Ticker Definition ---
-
-class QCPAxisTickerSI : public QCPAxisTickerLog
-{
-	// Q_OBJECT // No Q_OBJECT needed if not using signals/slots specifically for this class
-
-public:
-	QCPAxisTickerSI() : QCPAxisTickerLog() {
-		setLogBase(10.0); // Ensure log base is 10 for power-of-10 filtering
-	}
-
-	// Override the main generation function to filter ticks afterwards
-	virtual void generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision,
-						  QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels) Q_DECL_OVERRIDE
-	{
-		// 1. Let the base Log ticker generate everything first
-		QCPAxisTickerLog::generate(range, locale, formatChar, precision, ticks, subTicks, tickLabels);
-
-		// 2. Filter Major Ticks to Keep Only (approx) Powers of 10
-		QVector<double> filteredTicks;
-		const double epsilon = 1e-9; // Tolerance for floating point comparison
-		int originalTickCount = ticks.size(); // Store original count
-
-		if (!ticks.isEmpty()) { // Avoid processing if base class returned nothing
-			for (double tick : std::as_const(ticks)) {
-				// Check positivity for log calculation, handle near-zero carefully
-				if (tick > epsilon) {
-					double log10Tick = std::log10(tick);
-					// Keep if log10 is very close to an integer
-					if (qAbs(log10Tick - std::round(log10Tick)) < epsilon) {
-						// Avoid adding duplicate ticks if filtering brings them too close
-						if (filteredTicks.isEmpty() || qAbs(tick - filteredTicks.last()) > epsilon * qMax(1.0, qAbs(tick))) {
-							filteredTicks.append(tick);
-						}
-					}
-				}
-				// Optionally handle tick == 0 if needed (e.g., return "0 Hz") but unlikely for pure log
-			}
-
-			// Fallback logic if filtering removed all ticks but original had some
-			if (filteredTicks.isEmpty() && originalTickCount > 0) {
-				double firstTick = ticks.first();
-				double lastTick = ticks.last();
-				filteredTicks.append(firstTick); // Keep at least the first
-				// Add last only if distinct from first
-				if (qAbs(lastTick - firstTick) > epsilon * qMax(1.0, qAbs(firstTick))) {
-					filteredTicks.append(lastTick);
-				}
-				// Sort fallback ticks just in case first/last were out of order originally
-				std::sort(filteredTicks.begin(), filteredTicks.end());
-				qWarning() << "QCPAxisTickerSI: Filtering removed all power-of-10 ticks, falling back to first/last original ticks for range:" << range;
-			}
-		}
-		// Replace original ticks with the filtered ones
-		ticks = filteredTicks;
-
-		// 3. Regenerate Labels based *only* on the filtered Ticks
-		if (tickLabels) {
-			tickLabels->clear();
-			for (double tick : std::as_const(ticks)) {
-				// Use our overridden getTickLabel which calls the SI formatter
-				tickLabels->append(getTickLabel(tick, locale, formatChar, precision));
-			}
-		}
-
-		// 4. Subticks: Keep the ones generated by the base class.
-		//    They might look dense relative to the filtered major ticks, but recalculating
-		//    them accurately here is complex. This is usually an acceptable compromise.
-		if (!subTicks) {
-			// No subticks requested
-		} else if (ticks.isEmpty()) {
-			subTicks->clear(); // No major ticks -> no subticks
-		}
-		// else: Keep subTicks as generated by QCPAxisTickerLog::generate
-
-	} // End of generate()
-
-	// Override getTickLabel to use our custom SI formatting function
-	virtual QString getTickLabel(double tick, const QLocale &locale, QChar formatChar, int precision) Q_DECL_OVERRIDE
-	{
-		Q_UNUSED(locale)
-		Q_UNUSED(formatChar)
-		Q_UNUSED(precision)
-
-		// Use Utils::formatFrequencyTick for SI prefixes (Hz, kHz, MHz)
-		// Handle edge case near zero for safety, although log shouldn't generate it
-		if (tick <= 1e-9) return QStringLiteral("0 Hz");
-		// Precision argument to formatFrequencyTick isn't strictly used by its current logic
-		return Utils::formatFrequencyTick(tick, 3);
-	}
-
-}; // End of class QCPAxisTickerSI
-
+class QProgressBar;
+class PlotExporter;
+class MappedGraph;
+class MappedColumnFile;
+class MemoryPanel;
+class StallPanel;
+class LiveDataSource;
+struct SweepFrame;
+class QLabel;
+namespace Workspace { struct State; }
 
 class PhaseNoiseAnalyzerApp : public QMainWindow
 {
 	Q_OBJECT
-	// --- Data Structure for a Single Dataset ---
-	struct PlotData {
-		QString filename;
-		QString displayName; // Short name for legend
-		QVector<double> frequencyOffset;
-		QVector<double> phaseNoise;
-		QVector<double> referenceNoise;
-		QVector<double> phaseNoiseFiltered; // For filtering/spur removal
-		QVector<double> referenceNoiseFiltered; // For filtering
-		bool hasReferenceData = false;
-		bool isVisible = true; // Controlled by legend click
-		QColor measuredColor;
-		QColor referenceColor; // Line color (dark) or fill baseline color (light)
-
-		// QCPGraph pointers associated with this data
-		QCPGraph* graphMeasured = nullptr;
-		QCPGraph* graphReference = nullptr; // Reference line (dark) or fill graph (light)
-		QCPGraph* graphReferenceOutline = nullptr; // Outline for light theme fill
-		QCPGraph* fillReferenceBase = nullptr;  // Baseline for light theme fill
-	};
 
 public:
 	PhaseNoiseAnalyzerApp(const QStringList& csvFilenames = QStringList(),
@@ -188,8 +93,30 @@ public:
 	// Timer for delayed maximization
 	QTimer* m_startupTimer = nullptr;
 
+	// Restore the auto-saved workspace at startup when no input file is given
+	void setRestoreWorkspaceOnStartup(bool restore) { m_restoreWorkspaceOnStartup = restore; }
+
+	// Memory budget for derived data and render caches in bytes, 0 = unlimited
+	void setMemoryBudget(qint64 bytes);
+
+	// Live acquisition
+	bool startLiveSource(std::unique_ptr<LiveDataSource> source, bool appendSweeps = false); // Rolling dataset, or one per sweep
+	void startLiveSimulator(double sweepsPerSecond);
+	void stopLiveSource(); // The last sweep stays as a regular dataset
+	// Streaming inputs ("-i -", named pipes): sweep separator line (empty = blank line),
+	// and whether every sweep becomes a new dataset instead of updating a rolling one
+	void setStreamOptions(const QByteArray& sweepDelimiter, bool appendSweeps);
+	// Files with overlapping segments or several sweeps, see DatasetParser::stitchSweeps()
+	void setStitchOptions(const DatasetParser::StitchOptions& options);
+	// Measured traces drawn by MonotoneLineRasterizer instead of QPainter, see IndexedGraph
+	void setFastLines(bool enabled);
+
 public slots:
 	void showMaximizedWithDelay(); // Slot for delayed maximization
+	void openFilesFromOtherInstance(const QStringList& filenames); // Files forwarded by --single-instance
+
+signals:
+	void startupFinished(); // Emitted once deferred startup work (input files, first plot) is done
 
 protected:
 	void closeEvent(QCloseEvent *event) override;
@@ -200,6 +127,16 @@ private slots:
 	void onSavePlot();
 	void onExportData();
 	void onExportSpotNoise();
+	void onOpenMappedTrace();
+	void onConvertToColumnFile();
+	void onSaveWorkspace();
+	void onOpenWorkspace();
+	void onPlotExportProgress(int jobId, int percent);
+	void onPlotExportFinished(int jobId, bool success, const QString& filename, const QString& errorString);
+	void onDerivedReady(int handle, quint64 version, const DerivedColumns& columns);
+	void onDerivedFailed(int handle, quint64 version, const QString& message);
+	void toggleLiveSimulator(bool checked = false);
+	void onLiveTimer(); // Takes the newest sweep of the live source
 
 	// View Actions
 	void toggleTheme(bool checked = false); // Accept bool for checkbox signal
@@ -207,6 +144,9 @@ private slots:
 	void toggleSpotNoise(bool checked = false);
 	void toggleSpotNoiseTable(bool checked = false);
 	void toggleGrid(bool checked = false);
+	void toggleLegendPanel(bool checked = false);
+	void toggleMemoryPanel(bool checked = false);
+	void toggleStallPanel(bool checked = false);
 
 	// Tool Actions
 	void toggleCrosshair(bool checked = false);
@@ -229,6 +169,7 @@ private slots:
 	void onLegendItemClicked(QCPLegend *legend, QCPAbstractLegendItem *item, QMouseEvent *event);
 	void showPlotContextMenu(const QPoint &pos);
 	void removeSelectedDataset(); // Slot connected to context menu action
+	void applyDatasetVisibility(const DatasetVisibilityChanges& changes); // Bulk toggles from the legend panel
 	void configureSubplots(); // Might just reset view
 
 	// Plot Interaction Slots
@@ -254,14 +195,41 @@ private:
 	void createToolPanels();
 	void centerWindow();
 	void applyTheme(); // Apply current theme (light/dark)
-
-	void loadData(const QString& filename);
+	void applyPalette(); // Apply the light/dark application palette only
+	void finishStartup(); // Deferred startup work, run after the window is shown
+
+	bool loadData(const QString& filename); // Parse and append one file, no plot update
+	void loadFiles(const QStringList& filenames); // Load several files with a single plot update
+	QString choosePackMember(const QString& packPath); // "pack#member" path, empty if cancelled
+	void updateWindowTitle();
+	void loadNextForwardedFile(); // Loads one queued forwarded file per event loop pass
+	bool openMappedTrace(const QString& filename); // View-only trace backed by a .pnacol file
+	void closeMappedTrace(int index);
+	int mappedTraceIndex(const QCPAbstractPlottable* plottable) const; // -1 if not a mapped trace
+	Workspace::State captureWorkspace() const; // Datasets plus processing and view state
+	void restoreWorkspace(Workspace::State& state); // Replaces all datasets, consumes the columns of state
+	bool loadWorkspaceFile(const QString& path, bool reportErrors);
 	void updateDataTable();
 	void initPlot(); // Initialize plot appearance, axes etc.
 	void updatePlot(); // Update plot with current data and settings
 	void calculateSpotNoise(); // Calculate spot noise values from current data
 	void addSpotNoiseTable(); // Add the text table to the plot
-	void applySpurRemoval(); // Apply spur removal algorithm
+	AnnotationLayer* annotationLayer(); // Created on first use, after initPlot() cleared the items
+	void updateAnnotationStyles(); // Marker and label styles of the annotation groups from the current colors
+	void clearMeasurement(); // Removes the measurement points, line and text
+	DerivedSettings derivedSettings() const; // Current filter / spur removal settings
+	void requestDerived(DatasetRegistry::Handle handle); // New version, derived columns recomputed in the background
+	void requestDerivedAll();
+	void computeDerivedNow(DatasetRegistry::Handle handle); // Same, on the GUI thread (export, eviction)
+	void finishPendingDerived(); // Brings every pending dataset up to date before its columns are read out
+	void ensureDerived(DatasetRegistry::Handle handle); // Recompute derived data evicted by the memory budget
+	void refreshDatasetGraphs(DatasetRegistry::Handle handle); // New data in existing graphs, keeps zoom and items
+	DatasetRegistry::Handle addLiveDataset(SweepFrame&& frame, const QString& displayName);
+	void enforceMemoryBudget();
+	void refreshMemoryPanel();
+	void refreshStallPanel();
+	void showCursorReadout(); // Status bar text for the last mouse position
+	void updateReferenceBaselines(double lower); // Light theme fill bottom, rewritten in place
 	QString freqFormatter(double value, int precision); // For axis ticks
 	int findClosestFreqStepIndex(double freq); // Helper for sliders
 
@@ -269,14 +237,30 @@ private:
 	QColor getNextRefColor(int index, bool darkTheme);
 
 	// --- Data Members ---
+	QStringList m_startupFiles; // Input files loaded by finishStartup()
+	QStringList m_forwardedFiles; // Queue of files received from other instances
+	int m_forwardedLoadedCount = 0; // Files of the current queue loaded so far
+	bool m_restoreWorkspaceOnStartup = false;
+	bool m_sessionHadData = false; // Decides whether an empty session overwrites the auto-saved workspace
 	QString m_outputFilename;
 	bool m_plotReferenceDefault; // Initial setting from args/constructor
 	bool m_useDarkTheme;
 	int m_dpi;
 
 	// Data Storage for Multiple Datasets
-	QList<PlotData> m_datasets;
-	int m_activeDatasetIndex = -1; // Index of the active dataset in m_datasets
+	DatasetRegistry m_datasets;
+	DatasetRegistry::Handle m_activeDataset = DatasetRegistry::InvalidHandle; // Dataset used for spot noise and annotations
+	MemoryBudget m_memoryBudget;
+
+	// Out-of-core traces: view only, no filtering, spot noise or export
+	struct MappedTrace {
+		QString displayName;
+		QSharedPointer<const MappedColumnFile> file;
+		MappedGraph* measured = nullptr;  // Owned by QCustomPlot, kept across updatePlot()
+		MappedGraph* reference = nullptr;
+		bool visible = true;
+	};
+	QVector<MappedTrace> m_mappedTraces;
 
 	QVector<double> m_frequencyOffsetFiltered;
 	QVector<double> m_phaseNoiseFiltered;
@@ -293,13 +277,14 @@ private:
 	bool m_showSpotNoiseTable = true;
 	bool m_useCrosshair = false;
 	bool m_measureMode = false;
+	bool m_useLegendPanel = false; // Legend shown in a side panel instead of inside the plot
 	QPointF m_measureStartPoint; // For measurement tool (in axis coords)
 	enum class ActiveTool { None, PanZoom } m_activeTool = ActiveTool::None;
 
 
 	// Axis Range State
 	int m_minFreqSliderIndex = 0;
-	int m_maxFreqSliderIndex = Constants::FREQ_POINTS.size() - 1;
+	int m_maxFreqSliderIndex = Constants::FREQ_POINT_COUNT - 1;
 
 	// Colors
 	QColor m_spotNoiseColor;
@@ -321,17 +306,46 @@ private:
 	QWidget* m_centralWidget = nullptr;
 	QVBoxLayout* m_mainLayout = nullptr;
 	QStatusBar* m_statusBar = nullptr;
+	QProgressBar* m_exportProgressBar = nullptr; // Shown in the status bar while exports are queued
+
+	// Background image export
+	PlotExporter* m_plotExporter = nullptr;
+
+	// Background filtering / spur removal; results are applied if their version is still current
+	DerivedPipeline* m_derivedPipeline = nullptr;
+	QTimer* m_derivedReplotTimer = nullptr; // Coalesces the replots of results arriving together
+
+	// Live acquisition: producer thread -> ring buffer -> m_liveTimer on the GUI thread
+	std::unique_ptr<LiveDataSource> m_liveSource;
+	DatasetRegistry::Handle m_liveDataset = DatasetRegistry::InvalidHandle; // Rolling dataset
+	bool m_liveAppendSweeps = false;
+	QByteArray m_streamDelimiter;
+	bool m_streamAppendSweeps = false;
+	bool m_fastLines = false;
+	DatasetParser::StitchOptions m_stitchOptions;
+	QTimer* m_liveTimer = nullptr;
+	QLabel* m_liveStatusLabel = nullptr;
+	QElapsedTimer m_liveStatsTimer;
+	quint64 m_liveStatsProduced = 0; // Produced count at the last status refresh
 
 	// Menus & Actions
 	QAction* m_openAction = nullptr;
 	QAction* m_savePlotAction = nullptr;
 	QAction* m_exportDataAction = nullptr;
 	QAction* m_exportSpotAction = nullptr;
+	QAction* m_openMappedAction = nullptr;
+	QAction* m_convertMappedAction = nullptr;
+	QAction* m_liveSimulatorAction = nullptr;
+	QAction* m_saveWorkspaceAction = nullptr;
+	QAction* m_openWorkspaceAction = nullptr;
 	QAction* m_exitAction = nullptr;
 	QAction* m_toggleDarkThemeAction = nullptr;
 	QAction* m_toggleReferenceAction = nullptr;
 	QAction* m_toggleSpotNoiseAction = nullptr;
 	QAction* m_toggleSpotNoiseTableAction = nullptr;
+	QAction* m_toggleLegendPanelAction = nullptr;
+	QAction* m_toggleMemoryPanelAction = nullptr;
+	QAction* m_toggleStallPanelAction = nullptr;
 	QAction* m_crosshairAction = nullptr;
 	QAction* m_measureAction = nullptr;
 	QAction* m_filterAction = nullptr; // Menu action for filtering
@@ -354,13 +368,33 @@ private:
 
 	// Plot Objects (managed by QCustomPlot)
 	QCPGraph* m_fillReferenceBelow = nullptr; // Fill area for light theme
-	QVector<QCPItemTracer*> m_spotNoiseMarkers;
-	QVector<QCPItemText*> m_spotNoiseLabels;
 	QCPItemText* m_spotNoiseTableText = nullptr;
-	QCPItemText* m_cursorAnnotation = nullptr;
-	QCPItemTracer* m_cursorTracer = nullptr; // Tracks data point for annotation
-	QVector<QCPAbstractItem*> m_measurementItems; // Holds lines and markers
-	QCPItemText* m_measurementText = nullptr;
+	// Spot noise markers and labels, crosshair tracer and readout, measurement points and text
+	enum AnnotationGroup { SpotNoiseAnnotations, CursorAnnotations, MeasurementPointAnnotations, MeasurementTextAnnotations };
+	AnnotationLayer* m_annotations = nullptr;
+	int m_cursorAnnotation = -1; // AnnotationLayer id of the tracer and its readout
+	double m_cursorAnnotationKey = 0.0; // Data point the annotation text was formatted for
+	double m_cursorX = 0.0; // Last mouse position in plot coordinates, shown by showCursorReadout()
+	double m_cursorY = 0.0;
+	QTimer* m_cursorReadoutTimer = nullptr; // At most one status bar repaint per frame while the mouse moves
+
+	// Text rewritten on every mouse move. Two strings used alternately: the widget shown
+	// last holds one, the other is not shared and is rewritten within its capacity, so
+	// steady-state updates do not allocate (see AllocProfiler).
+	struct ReusedText {
+		QString buffers[2];
+		int current = 0;
+		ReusedText() { buffers[0].reserve(96); buffers[1].reserve(96); }
+		QString& next() {
+			current ^= 1;
+			if (!buffers[current].isDetached() && buffers[current ^ 1].isDetached()) current ^= 1;
+			buffers[current].resize(0);
+			return buffers[current];
+		}
+	};
+	ReusedText m_cursorReadoutText;
+	ReusedText m_cursorAnnotationText;
+	QCPItemLine* m_measurementLine = nullptr; // Between the points, markers and text are annotations
 	QCPTextElement* m_titleElement = nullptr;
 	QCPTextElement* m_subtitleText = nullptr;
 
@@ -369,6 +403,12 @@ private:
 	QWidget* m_plotWidget = nullptr;
 	QVBoxLayout* m_plotLayout = nullptr;
 	QComboBox* m_activeCurveCombo = nullptr;
+	QDockWidget* m_legendDock = nullptr; // Created on first use
+	LegendPanel* m_legendPanel = nullptr;
+	QDockWidget* m_memoryDock = nullptr; // Created on first use
+	MemoryPanel* m_memoryPanel = nullptr;
+	QDockWidget* m_stallDock = nullptr; // Created on first use
+	StallPanel* m_stallPanel = nullptr;
 
 	// Controls within Dock
 	QDoubleSpinBox* m_yMinSpin = nullptr;
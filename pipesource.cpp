@@ -0,0 +1,234 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "pipesource.h"
+#include "coreconstants.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <utility>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int WAIT_TIMEOUT_MS = 100; // Longest wait for input before checking for stop()
+constexpr int READ_BUFFER_BYTES = 64 * 1024;
+
+DatasetParser::StreamParser::SweepMode sweepMode(const QByteArray& delimiter)
+{
+	return delimiter.trimmed().isEmpty() ? DatasetParser::StreamParser::SweepMode::BlankLine
+										 : DatasetParser::StreamParser::SweepMode::Delimiter;
+}
+
+} // namespace
+
+PipeSource::PipeSource(const Settings& settings)
+	: LiveDataSource(Constants::LIVE_BUFFER_FRAMES), m_settings(settings),
+	  m_parser(sweepMode(settings.delimiter), settings.delimiter)
+{
+}
+
+PipeSource::~PipeSource()
+{
+	stop();
+}
+
+QString PipeSource::name() const
+{
+	return m_settings.path == QLatin1String("-") ? QStringLiteral("stdin") : QFileInfo(m_settings.path).fileName();
+}
+
+bool PipeSource::isStreamInput(const QString& path)
+{
+	if (path == QLatin1String("-")) return true;
+#ifdef Q_OS_WIN
+	if (path.startsWith(QLatin1String("\\\\.\\pipe\\"), Qt::CaseInsensitive)) return true;
+#endif
+	const QFileInfo info(path);
+	return info.exists() && !info.isFile() && !info.isDir();
+}
+
+bool PipeSource::open(QString* errorString)
+{
+	m_parser = DatasetParser::StreamParser(sweepMode(m_settings.delimiter), m_settings.delimiter);
+	m_buffer.resize(READ_BUFFER_BYTES);
+	m_endOfInput = false;
+	return openInput(errorString);
+}
+
+void PipeSource::close()
+{
+	closeInput();
+}
+
+bool PipeSource::acquire(SweepFrame* frame, QString* errorString)
+{
+	for (;;) {
+		ParsedDataset sweep;
+		if (m_parser.takeSweep(&sweep)) {
+			frame->hasReferenceData = sweep.hasReferenceData;
+			frame->frequencyOffset = std::move(sweep.frequencyOffset);
+			frame->phaseNoise = std::move(sweep.phaseNoise);
+			frame->referenceNoise = std::move(sweep.referenceNoise);
+			return true;
+		}
+		if (!m_parser.errorString().isEmpty()) {
+			if (errorString) *errorString = QStringLiteral("%1: %2").arg(m_settings.path, m_parser.errorString());
+			return false;
+		}
+		if (m_endOfInput || isStopRequested()) return false;
+
+		switch (readAvailable(errorString)) {
+		case ReadResult::Data:
+		case ReadResult::Timeout:
+			break;
+		case ReadResult::EndOfInput:
+			m_parser.finish(); // The last sweep needs no separator
+			if (!m_ownsHandle) {
+				m_endOfInput = true;
+			} else {
+				// Writer closed the named pipe: wait for the next one
+				closeInput();
+				if (!openInput(errorString)) return false;
+			}
+			break;
+		case ReadResult::Error:
+			return false;
+		}
+	}
+}
+
+#ifdef Q_OS_WIN
+
+bool PipeSource::openInput(QString* errorString)
+{
+	if (m_settings.path == QLatin1String("-")) {
+		m_handle = GetStdHandle(STD_INPUT_HANDLE);
+		m_ownsHandle = false;
+	} else {
+		m_handle = CreateFileW(reinterpret_cast<const wchar_t*>(m_settings.path.utf16()), GENERIC_READ, 0, nullptr,
+							   OPEN_EXISTING, 0, nullptr);
+		m_ownsHandle = true;
+	}
+	if (m_handle == nullptr || m_handle == INVALID_HANDLE_VALUE) {
+		m_handle = nullptr;
+		*errorString = QStringLiteral("Could not open %1 (error %2)").arg(m_settings.path).arg(GetLastError());
+		return false;
+	}
+	return true;
+}
+
+void PipeSource::closeInput()
+{
+	if (m_handle && m_ownsHandle) CloseHandle(m_handle);
+	m_handle = nullptr;
+}
+
+PipeSource::ReadResult PipeSource::readAvailable(QString* errorString)
+{
+	// Pipes are peeked so the read never blocks; other handles (console) read directly
+	DWORD toRead = DWORD(m_buffer.size());
+	if (GetFileType(m_handle) == FILE_TYPE_PIPE) {
+		DWORD available = 0;
+		if (!PeekNamedPipe(m_handle, nullptr, 0, nullptr, &available, nullptr)) {
+			if (GetLastError() == ERROR_BROKEN_PIPE) return ReadResult::EndOfInput;
+			*errorString = QStringLiteral("Could not read %1 (error %2)").arg(m_settings.path).arg(GetLastError());
+			return ReadResult::Error;
+		}
+		if (available == 0) {
+			QThread::msleep(10);
+			return ReadResult::Timeout;
+		}
+		toRead = qMin(toRead, available);
+	}
+
+	DWORD bytes = 0;
+	if (!ReadFile(m_handle, m_buffer.data(), toRead, &bytes, nullptr)) {
+		if (GetLastError() == ERROR_BROKEN_PIPE) return ReadResult::EndOfInput;
+		*errorString = QStringLiteral("Could not read %1 (error %2)").arg(m_settings.path).arg(GetLastError());
+		return ReadResult::Error;
+	}
+	if (bytes == 0) return ReadResult::EndOfInput;
+	m_parser.feed(m_buffer.constData(), qint64(bytes));
+	return ReadResult::Data;
+}
+
+#else
+
+bool PipeSource::openInput(QString* errorString)
+{
+	if (m_settings.path == QLatin1String("-")) {
+		m_fd = STDIN_FILENO;
+		m_ownsHandle = false;
+		return true;
+	}
+	// Non-blocking: opening a FIFO without a writer must not block the thread
+	m_fd = ::open(QFile::encodeName(m_settings.path).constData(), O_RDONLY | O_NONBLOCK);
+	m_ownsHandle = true;
+	if (m_fd < 0) {
+		*errorString = QStringLiteral("Could not open %1: %2").arg(m_settings.path, QString::fromLocal8Bit(strerror(errno)));
+		return false;
+	}
+	return true;
+}
+
+void PipeSource::closeInput()
+{
+	if (m_fd >= 0 && m_ownsHandle) ::close(m_fd);
+	m_fd = -1;
+}
+
+PipeSource::ReadResult PipeSource::readAvailable(QString* errorString)
+{
+	pollfd descriptor = {m_fd, POLLIN, 0};
+	const int ready = ::poll(&descriptor, 1, WAIT_TIMEOUT_MS);
+	if (ready == 0 || (ready < 0 && errno == EINTR)) return ReadResult::Timeout;
+	if (ready < 0) {
+		*errorString = QStringLiteral("Could not wait for %1: %2").arg(m_settings.path, QString::fromLocal8Bit(strerror(errno)));
+		return ReadResult::Error;
+	}
+
+	const ssize_t bytes = ::read(m_fd, m_buffer.data(), size_t(m_buffer.size()));
+	if (bytes > 0) {
+		m_parser.feed(m_buffer.constData(), qint64(bytes));
+		return ReadResult::Data;
+	}
+	if (bytes == 0) return ReadResult::EndOfInput;
+	if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return ReadResult::Timeout;
+	*errorString = QStringLiteral("Could not read %1: %2").arg(m_settings.path, QString::fromLocal8Bit(strerror(errno)));
+	return ReadResult::Error;
+}
+
+#endif
@@ -0,0 +1,87 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef PIPESOURCE_H
+#define PIPESOURCE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "datasetparser.h"
+#include "livedatasource.h"
+
+/*
+ * Live source reading "freq,noise[,ref]" lines from standard input ("-") or a named
+ * pipe, so capture scripts can feed the window without temporary files.
+ *
+ * The producer thread waits for input with a short timeout (poll() on Unix, peeking
+ * the pipe on Windows), so stop() never hangs on a silent writer. Bytes go through
+ * DatasetParser::StreamParser, the tokenizer used for files; a blank line or the
+ * configured delimiter line completes a sweep. At the end of standard input the
+ * last sweep is delivered and the source stops. A named pipe is reopened when its
+ * writer closes, so successive runs of a capture script feed the same window.
+ */
+class PipeSource : public LiveDataSource
+{
+public:
+	struct Settings {
+		QString path = QStringLiteral("-"); // "-" for standard input
+		QByteArray delimiter;               // Sweep separator line, empty for a blank line
+	};
+
+	explicit PipeSource(const Settings& settings);
+	~PipeSource() override;
+
+	QString name() const override;
+
+	// "-", or an existing path that is neither a regular file nor a directory (FIFO, device)
+	static bool isStreamInput(const QString& path);
+
+protected:
+	bool open(QString* errorString) override;
+	bool acquire(SweepFrame* frame, QString* errorString) override;
+	void close() override;
+
+private:
+	enum class ReadResult { Data, Timeout, EndOfInput, Error };
+
+	bool openInput(QString* errorString);
+	void closeInput();
+	ReadResult readAvailable(QString* errorString);
+
+	Settings m_settings;
+	DatasetParser::StreamParser m_parser;
+	QByteArray m_buffer;
+	bool m_ownsHandle = false; // False for standard input
+	bool m_endOfInput = false;
+
+#ifdef Q_OS_WIN
+	void* m_handle = nullptr; // HANDLE
+#else
+	int m_fd = -1;
+#endif
+};
+
+#endif // PIPESOURCE_H
@@ -0,0 +1,269 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "plotexporter.h"
+#include "pngstreamwriter.h"
+#include "constants.h"
+#include "qcustomplot.h"
+
+#include <QThread>
+#include <QFile>
+#include <QSaveFile>
+#include <QImage>
+#include <QImageWriter>
+#include <QPainter>
+#include <QtEndian>
+#include <QDebug>
+
+namespace {
+
+// Upper bound for one rendered band (RGB32), about 16 MB
+constexpr qint64 MaxBandPixels = 4 * 1024 * 1024;
+
+} // namespace
+
+// --- PlotExportWorker ---
+
+void PlotExportWorker::process(const PlotExportJob& job)
+{
+	const QSize outputSize(qMax(1, qRound(job.logicalSize.width() * job.scale)),
+						   qMax(1, qRound(job.logicalSize.height() * job.scale)));
+	QString errorString;
+	bool success = false;
+
+	if (job.format == "png") {
+		success = writePng(job, outputSize, &errorString);
+	} else if (job.format == "bmp") {
+		success = writeBmp(job, outputSize, &errorString);
+	} else {
+		success = writeWhole(job, outputSize, &errorString);
+	}
+
+	if (m_abortFlag->loadRelaxed()) {
+		success = false;
+		errorString = QStringLiteral("Export cancelled");
+	}
+	emit finished(job.id, success, job.filename, errorString);
+}
+
+// Replays the recorded picture into consecutive full-width bands and hands each
+// one to the sink. Only one band is alive at any time.
+template <typename Sink>
+bool PlotExportWorker::renderBands(const PlotExportJob& job, const QSize& outputSize, int bandHeight, Sink sink)
+{
+	QImage band(outputSize.width(), bandHeight, QImage::Format_RGB32);
+	if (band.isNull()) return false;
+
+	for (int y0 = 0; y0 < outputSize.height(); y0 += bandHeight) {
+		if (m_abortFlag->loadRelaxed()) return false;
+
+		band.fill(Qt::white);
+		QPainter painter(&band);
+		painter.translate(0, -y0);
+		painter.scale(job.scale, job.scale);
+		painter.drawPicture(0, 0, job.picture);
+		painter.end();
+
+		const int rows = qMin(bandHeight, outputSize.height() - y0);
+		if (!sink(band, rows)) return false;
+		emit progress(job.id, static_cast<int>(100LL * (y0 + rows) / outputSize.height()));
+	}
+	return true;
+}
+
+bool PlotExportWorker::writePng(const PlotExportJob& job, const QSize& outputSize, QString* errorString)
+{
+	QSaveFile file(job.filename);
+	if (!file.open(QIODevice::WriteOnly)) {
+		*errorString = file.errorString();
+		return false;
+	}
+
+	PngStreamWriter writer(&file);
+	if (!writer.begin(outputSize.width(), outputSize.height(), job.dpi)) {
+		*errorString = writer.errorString();
+		return false;
+	}
+
+	const int bandHeight = static_cast<int>(qBound<qint64>(1, MaxBandPixels / outputSize.width(), outputSize.height()));
+	const bool rendered = renderBands(job, outputSize, bandHeight, [&writer](const QImage& band, int rows) {
+		return writer.writeRows(band, rows);
+	});
+	if (!rendered || !writer.finish()) {
+		*errorString = writer.errorString().isEmpty() ? QStringLiteral("Rendering failed") : writer.errorString();
+		return false;
+	}
+	if (!file.commit()) {
+		*errorString = file.errorString();
+		return false;
+	}
+	return true;
+}
+
+// 24-bit top-down BMP, written row by row like the PNG path
+bool PlotExportWorker::writeBmp(const PlotExportJob& job, const QSize& outputSize, QString* errorString)
+{
+	const qint64 rowBytes = (static_cast<qint64>(outputSize.width()) * 3 + 3) & ~qint64(3);
+	const qint64 imageBytes = rowBytes * outputSize.height();
+	if (54 + imageBytes > 0xffffffffLL) {
+		*errorString = QStringLiteral("Image too large for the BMP format, use PNG instead");
+		return false;
+	}
+
+	QSaveFile file(job.filename);
+	if (!file.open(QIODevice::WriteOnly)) {
+		*errorString = file.errorString();
+		return false;
+	}
+
+	const qint32 pixelsPerMeter = qRound(job.dpi / 0.0254);
+	char header[54] = {};
+	header[0] = 'B';
+	header[1] = 'M';
+	qToLittleEndian<quint32>(static_cast<quint32>(54 + imageBytes), header + 2);
+	qToLittleEndian<quint32>(54, header + 10);
+	qToLittleEndian<quint32>(40, header + 14);
+	qToLittleEndian<qint32>(outputSize.width(), header + 18);
+	qToLittleEndian<qint32>(-outputSize.height(), header + 22); // Negative height: rows stored top-down
+	qToLittleEndian<quint16>(1, header + 26);
+	qToLittleEndian<quint16>(24, header + 28);
+	qToLittleEndian<quint32>(static_cast<quint32>(imageBytes), header + 34);
+	qToLittleEndian<qint32>(pixelsPerMeter, header + 38);
+	qToLittleEndian<qint32>(pixelsPerMeter, header + 42);
+	if (file.write(header, sizeof(header)) != static_cast<qint64>(sizeof(header))) {
+		*errorString = file.errorString();
+		return false;
+	}
+
+	QByteArray row(static_cast<int>(rowBytes), '\0');
+	const int bandHeight = static_cast<int>(qBound<qint64>(1, MaxBandPixels / outputSize.width(), outputSize.height()));
+	const bool rendered = renderBands(job, outputSize, bandHeight, [&file, &row, &outputSize](const QImage& band, int rows) {
+		for (int y = 0; y < rows; ++y) {
+			const QRgb* src = reinterpret_cast<const QRgb*>(band.constScanLine(y));
+			uchar* dst = reinterpret_cast<uchar*>(row.data());
+			for (int x = 0; x < outputSize.width(); ++x) {
+				dst[3 * x] = static_cast<uchar>(qBlue(src[x]));
+				dst[3 * x + 1] = static_cast<uchar>(qGreen(src[x]));
+				dst[3 * x + 2] = static_cast<uchar>(qRed(src[x]));
+			}
+			if (file.write(row) != row.size()) return false;
+		}
+		return true;
+	});
+	if (!rendered) {
+		*errorString = file.error() != QFileDevice::NoError ? file.errorString() : QStringLiteral("Rendering failed");
+		return false;
+	}
+	if (!file.commit()) {
+		*errorString = file.errorString();
+		return false;
+	}
+	return true;
+}
+
+// JPEG cannot be streamed through QImageWriter, so the whole image is rendered at
+// once. This still runs off the GUI thread but memory grows with the resolution.
+bool PlotExportWorker::writeWhole(const PlotExportJob& job, const QSize& outputSize, QString* errorString)
+{
+	QImage image;
+	const bool rendered = renderBands(job, outputSize, outputSize.height(), [&image](const QImage& band, int rows) {
+		Q_UNUSED(rows)
+		image = band;
+		return true;
+	});
+	if (!rendered || image.isNull()) {
+		*errorString = QStringLiteral("Not enough memory to render a %1x%2 image").arg(outputSize.width()).arg(outputSize.height());
+		return false;
+	}
+
+	const int dotsPerMeter = qRound(job.dpi / 0.0254);
+	image.setDotsPerMeterX(dotsPerMeter);
+	image.setDotsPerMeterY(dotsPerMeter);
+
+	QImageWriter writer(job.filename, job.format);
+	if (!writer.write(image)) {
+		*errorString = writer.errorString();
+		return false;
+	}
+	return true;
+}
+
+// --- PlotExporter ---
+
+PlotExporter::PlotExporter(QObject* parent)
+	: QObject(parent),
+	m_thread(new QThread(this)),
+	m_worker(new PlotExportWorker(&m_abort))
+{
+	m_worker->moveToThread(m_thread);
+	connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+	connect(m_worker, &PlotExportWorker::progress, this, &PlotExporter::progress);
+	connect(m_worker, &PlotExportWorker::finished, this, &PlotExporter::onWorkerFinished);
+	m_thread->start(QThread::LowPriority);
+}
+
+PlotExporter::~PlotExporter()
+{
+	// Abandon queued work; the band loop checks the flag between bands
+	m_abort.storeRelaxed(1);
+	m_thread->quit();
+	m_thread->wait();
+}
+
+PlotExportJob PlotExporter::captureJob(QCustomPlot* plot, const QString& filename, const QByteArray& format, int dpi)
+{
+	PlotExportJob job;
+	job.filename = filename;
+	job.format = format;
+	job.dpi = dpi > 0 ? dpi : Constants::EXPORT_REFERENCE_DPI;
+	job.logicalSize = plot->viewport().size();
+	job.scale = static_cast<double>(job.dpi) / Constants::EXPORT_REFERENCE_DPI;
+
+	QCPPainter painter;
+	if (painter.begin(&job.picture)) {
+		// Scale cosmetic pens with the output, as QCustomPlot::toPixmap does for scale > 1
+		painter.setMode(QCPPainter::pmNonCosmetic);
+		plot->toPainter(&painter, job.logicalSize.width(), job.logicalSize.height());
+		painter.end();
+	} else {
+		qWarning() << "PlotExporter: could not record plot snapshot for" << filename;
+	}
+	return job;
+}
+
+int PlotExporter::enqueue(PlotExportJob job)
+{
+	job.id = ++m_lastJobId;
+	++m_pendingCount;
+	PlotExportWorker* worker = m_worker;
+	QMetaObject::invokeMethod(worker, [worker, job]() { worker->process(job); }, Qt::QueuedConnection);
+	return job.id;
+}
+
+void PlotExporter::onWorkerFinished(int jobId, bool success, const QString& filename, const QString& errorString)
+{
+	m_pendingCount = qMax(0, m_pendingCount - 1);
+	emit jobFinished(jobId, success, filename, errorString);
+}
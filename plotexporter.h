@@ -0,0 +1,108 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef PLOTEXPORTER_H
+#define PLOTEXPORTER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QPicture>
+#include <QSize>
+#include <QString>
+
+class QCustomPlot;
+class QImage;
+class QThread;
+
+// Everything needed to render one image export, captured on the GUI thread
+struct PlotExportJob {
+	int id = 0;
+	QString filename;
+	QByteArray format;   // "png", "jpg" or "bmp"
+	QPicture picture;    // Vector recording of the plot at its on-screen size
+	QSize logicalSize;   // Size of the recorded plot in device independent pixels
+	double scale = 1.0;  // Output pixels per recorded pixel
+	int dpi = 96;        // Resolution written to the file metadata
+};
+
+// Renders export jobs on a background thread, one band of rows at a time
+class PlotExportWorker : public QObject
+{
+	Q_OBJECT
+public:
+	explicit PlotExportWorker(const QAtomicInt* abortFlag) : m_abortFlag(abortFlag) {}
+
+	void process(const PlotExportJob& job);
+
+signals:
+	void progress(int jobId, int percent);
+	void finished(int jobId, bool success, const QString& filename, const QString& errorString);
+
+private:
+	template <typename Sink>
+	bool renderBands(const PlotExportJob& job, const QSize& outputSize, int bandHeight, Sink sink);
+	bool writePng(const PlotExportJob& job, const QSize& outputSize, QString* errorString);
+	bool writeBmp(const PlotExportJob& job, const QSize& outputSize, QString* errorString);
+	bool writeWhole(const PlotExportJob& job, const QSize& outputSize, QString* errorString);
+
+	const QAtomicInt* m_abortFlag;
+};
+
+/*
+ * Queues image exports so saving never blocks the GUI thread.
+ * The plot is recorded into a QPicture (cheap, resolution independent) and the
+ * worker replays it band by band into a streaming encoder, so memory stays bounded
+ * whatever the output DPI. Jobs run one after the other in submission order.
+ */
+class PlotExporter : public QObject
+{
+	Q_OBJECT
+public:
+	explicit PlotExporter(QObject* parent = nullptr);
+	~PlotExporter();
+
+	// Snapshot the current plot state; must be called on the GUI thread
+	static PlotExportJob captureJob(QCustomPlot* plot, const QString& filename, const QByteArray& format, int dpi);
+
+	int enqueue(PlotExportJob job); // Returns the job id
+	int pendingCount() const { return m_pendingCount; }
+
+signals:
+	void progress(int jobId, int percent);
+	void jobFinished(int jobId, bool success, const QString& filename, const QString& errorString);
+
+private slots:
+	void onWorkerFinished(int jobId, bool success, const QString& filename, const QString& errorString);
+
+private:
+	QThread* m_thread = nullptr;
+	PlotExportWorker* m_worker = nullptr;
+	QAtomicInt m_abort;
+	int m_lastJobId = 0;
+	int m_pendingCount = 0;
+};
+
+#endif // PLOTEXPORTER_H
@@ -0,0 +1,98 @@
+QT += core gui widgets printsupport svg network
+
+CONFIG += c++17 // Use C++17 features
+
+# Check for Qt6 and MinGW
+greaterThan(QT_MAJOR_VERSION, 5) {
+    # We're using Qt6
+    win32-g++ {
+        # We're using MinGW on Windows
+        QMAKE_CXXFLAGS += -Wa,-mbig-obj
+        message("Adding -mbig-obj flag for MinGW with Qt6")
+    }
+}
+
+# GUI application, built from pna_qt.pro after the analysis core library
+TARGET = pna_qt
+TEMPLATE = app
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API for details on how to replace it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# You can also make your code fail to compile if you use deprecated APIs.
+# In order to do so, uncomment the following line.
+# You can also select to disable deprecated APIs only up to a certain version of Qt.#
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+SOURCES += \
+    main.cpp \
+    phasenoiseanalyzerapp.cpp \
+    qcustomplot.cpp \
+    plotexporter.cpp \
+    startupprofiler.cpp \
+    singleinstance.cpp \
+    workspace.cpp \
+    datasetregistry.cpp \
+    legendpanel.cpp \
+    mappedgraph.cpp \
+    memorybudget.cpp \
+    memorypanel.cpp \
+    stallwatchdog.cpp \
+    stallpanel.cpp \
+    siaxisticker.cpp \
+    indexedgraph.cpp \
+    monotonelinerasterizer.cpp \
+    annotationlayer.cpp \
+    pngstreamwriter.cpp
+
+HEADERS += \
+    phasenoiseanalyzerapp.h \
+    constants.h \
+    resources.rc \
+    qcustomplot.h \
+    plotexporter.h \
+    startupprofiler.h \
+    singleinstance.h \
+    workspace.h \
+    datasetregistry.h \
+    legendpanel.h \
+    mappedgraph.h \
+    memorybudget.h \
+    memorypanel.h \
+    stallwatchdog.h \
+    stallpanel.h \
+    siaxisticker.h \
+    indexedgraph.h \
+    monotonelinerasterizer.h \
+    annotationlayer.h \
+    pngstreamwriter.h \
+    allocprofiler.h \
+    version.h
+
+# Diagnostics build: qmake CONFIG+=alloc_profiling replaces the global allocation functions
+# to count heap allocations per instrumented scope, see allocprofiler.h
+alloc_profiling {
+    DEFINES += PNA_ALLOC_PROFILING
+    SOURCES += allocprofiler.cpp
+}
+
+# libpnacore (core/pnacore.pro): parser, filters, spur removal, spot noise, column files, batch
+win32:CONFIG(release, debug|release): PNACORE_DIR = $$OUT_PWD/core/release
+else:win32:CONFIG(debug, debug|release): PNACORE_DIR = $$OUT_PWD/core/debug
+else: PNACORE_DIR = $$OUT_PWD/core
+LIBS += -L$$PNACORE_DIR -lpnacore
+zstd: LIBS += -lzstd
+win32-msvc*: PRE_TARGETDEPS += $$PNACORE_DIR/pnacore.lib
+else: PRE_TARGETDEPS += $$PNACORE_DIR/libpnacore.a
+
+RESOURCES += phasenoiseanalyzerapp.qrc
+
+RC_FILE = resources.rc
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
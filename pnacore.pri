@@ -0,0 +1,45 @@
+# Sources of libpnacore: everything that does not need QtGui / QtWidgets.
+# Used by core/pnacore.pro and by the stand-alone benchmarks.
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/utils.cpp \
+    $$PWD/compactcolumn.cpp \
+    $$PWD/compressedinput.cpp \
+    $$PWD/datasetparser.cpp \
+    $$PWD/datasetcache.cpp \
+    $$PWD/processing.cpp \
+    $$PWD/derivedpipeline.cpp \
+    $$PWD/batchprocessor.cpp \
+    $$PWD/batchstatistics.cpp \
+    $$PWD/mappedcolumnfile.cpp \
+    $$PWD/packfile.cpp \
+    $$PWD/livedatasource.cpp \
+    $$PWD/simulatorsource.cpp \
+    $$PWD/pipesource.cpp
+
+HEADERS += \
+    $$PWD/coreconstants.h \
+    $$PWD/utils.h \
+    $$PWD/compactcolumn.h \
+    $$PWD/datasetcolumns.h \
+    $$PWD/compressedinput.h \
+    $$PWD/datasetparser.h \
+    $$PWD/datasetcache.h \
+    $$PWD/processing.h \
+    $$PWD/derivedpipeline.h \
+    $$PWD/batchprocessor.h \
+    $$PWD/batchstatistics.h \
+    $$PWD/mappedcolumnfile.h \
+    $$PWD/packfile.h \
+    $$PWD/spscringbuffer.h \
+    $$PWD/livedatasource.h \
+    $$PWD/simulatorsource.h \
+    $$PWD/pipesource.h
+
+# gzip input is decoded by compressedinput.cpp itself; .zst input needs libzstd:
+# qmake CONFIG+=zstd
+zstd {
+    DEFINES += PNA_HAVE_ZSTD
+    LIBS += -lzstd
+}
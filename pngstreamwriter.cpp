@@ -0,0 +1,413 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "pngstreamwriter.h"
+
+#include <QIODevice>
+#include <QImage>
+#include <QtEndian>
+#include <QtMath>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+ * Minimal zlib stream encoder: greedy LZ77 with hash chains and the fixed
+ * Huffman code table. Plots are mostly flat background, so this gets close to
+ * zlib's ratio while keeping the project free of an external zlib dependency.
+ */
+class PngDeflater
+{
+public:
+	PngDeflater()
+	{
+		std::fill(m_head, m_head + HashSize, -1);
+		std::fill(m_prev, m_prev + WindowSize, -1);
+		// zlib header: deflate, 32K window, no preset dictionary
+		m_out.push_back(0x78);
+		m_out.push_back(0x01);
+		// One open-ended block using the fixed Huffman codes
+		writeBits(0, 1); // BFINAL
+		writeBits(1, 2); // BTYPE = fixed Huffman
+	}
+
+	void write(const uint8_t* data, size_t size)
+	{
+		updateAdler(data, size);
+		m_buf.insert(m_buf.end(), data, data + size);
+		compress(false);
+	}
+
+	void finish()
+	{
+		compress(true);
+		writeLiteralLength(256); // End of block
+		writeBits(1, 1); // Empty final block
+		writeBits(1, 2);
+		writeLiteralLength(256);
+		if (m_bitCount > 0) {
+			m_out.push_back(static_cast<uint8_t>(m_bitBuffer));
+			m_bitBuffer = 0;
+			m_bitCount = 0;
+		}
+		const uint32_t adler = (m_adlerB << 16) | m_adlerA;
+		m_out.push_back(static_cast<uint8_t>(adler >> 24));
+		m_out.push_back(static_cast<uint8_t>(adler >> 16));
+		m_out.push_back(static_cast<uint8_t>(adler >> 8));
+		m_out.push_back(static_cast<uint8_t>(adler));
+	}
+
+	// Compressed bytes produced so far; the caller drains them into IDAT chunks
+	std::vector<uint8_t>& output() { return m_out; }
+
+private:
+	static constexpr int WindowSize = 32768;
+	static constexpr int WindowMask = WindowSize - 1;
+	static constexpr int HashBits = 15;
+	static constexpr int HashSize = 1 << HashBits;
+	static constexpr int MinMatch = 3;
+	static constexpr int MaxMatch = 258;
+	static constexpr int MaxChainDepth = 16;
+
+	void writeBits(uint32_t value, int count)
+	{
+		m_bitBuffer |= value << m_bitCount;
+		m_bitCount += count;
+		while (m_bitCount >= 8) {
+			m_out.push_back(static_cast<uint8_t>(m_bitBuffer));
+			m_bitBuffer >>= 8;
+			m_bitCount -= 8;
+		}
+	}
+
+	// Huffman codes are defined MSB first while the stream is packed LSB first
+	void writeCode(uint32_t code, int length)
+	{
+		uint32_t reversed = 0;
+		for (int i = 0; i < length; ++i) {
+			reversed = (reversed << 1) | (code & 1);
+			code >>= 1;
+		}
+		writeBits(reversed, length);
+	}
+
+	void writeLiteralLength(int symbol)
+	{
+		if (symbol < 144) writeCode(0x30 + symbol, 8);
+		else if (symbol < 256) writeCode(0x190 + (symbol - 144), 9);
+		else if (symbol < 280) writeCode(symbol - 256, 7);
+		else writeCode(0xC0 + (symbol - 280), 8);
+	}
+
+	void writeMatch(int length, int distance)
+	{
+		static const uint16_t lengthBase[29] = {3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258};
+		static const uint8_t lengthExtra[29] = {0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0};
+		static const uint16_t distBase[30] = {1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577};
+		static const uint8_t distExtra[30] = {0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13};
+
+		int lc = 28;
+		while (lengthBase[lc] > length) --lc;
+		writeLiteralLength(257 + lc);
+		if (lengthExtra[lc]) writeBits(length - lengthBase[lc], lengthExtra[lc]);
+
+		int dc = 29;
+		while (distBase[dc] > distance) --dc;
+		writeCode(dc, 5);
+		if (distExtra[dc]) writeBits(distance - distBase[dc], distExtra[dc]);
+	}
+
+	int hashAt(size_t i) const
+	{
+		const uint32_t v = (uint32_t(m_buf[i]) << 16) | (uint32_t(m_buf[i + 1]) << 8) | m_buf[i + 2];
+		return static_cast<int>((v * 2654435761u) >> (32 - HashBits));
+	}
+
+	void insertHash(int64_t pos)
+	{
+		const size_t i = static_cast<size_t>(pos - m_bufStart);
+		if (i + MinMatch > m_buf.size()) return;
+		const int h = hashAt(i);
+		m_prev[pos & WindowMask] = m_head[h];
+		m_head[h] = pos;
+	}
+
+	// Greedy LZ77 over the buffered input. Unless flushing, keep MaxMatch bytes of
+	// lookahead so matches can extend into data that has not arrived yet.
+	void compress(bool flush)
+	{
+		const int64_t end = m_bufStart + static_cast<int64_t>(m_buf.size());
+		const int64_t limit = flush ? end : end - MaxMatch;
+		while (m_pos < limit) {
+			const size_t i = static_cast<size_t>(m_pos - m_bufStart);
+			int bestLength = 0;
+			int bestDistance = 0;
+			if (i + MinMatch <= m_buf.size()) {
+				const int maxLength = static_cast<int>(std::min<int64_t>(MaxMatch, end - m_pos));
+				int64_t candidate = m_head[hashAt(i)];
+				int depth = MaxChainDepth;
+				while (candidate >= 0 && m_pos - candidate <= WindowSize && depth-- > 0) {
+					const size_t c = static_cast<size_t>(candidate - m_bufStart);
+					if (m_buf[c + bestLength] == m_buf[i + bestLength]) {
+						int length = 0;
+						while (length < maxLength && m_buf[c + length] == m_buf[i + length]) ++length;
+						if (length > bestLength) {
+							bestLength = length;
+							bestDistance = static_cast<int>(m_pos - candidate);
+							if (length == maxLength) break;
+						}
+					}
+					candidate = m_prev[candidate & WindowMask];
+				}
+			}
+
+			if (bestLength >= MinMatch) {
+				writeMatch(bestLength, bestDistance);
+				for (int k = 0; k < bestLength; ++k) insertHash(m_pos + k);
+				m_pos += bestLength;
+			} else {
+				writeLiteralLength(m_buf[i]);
+				insertHash(m_pos);
+				++m_pos;
+			}
+		}
+
+		// Drop input that has slid out of the window
+		const int64_t keepFrom = m_pos - WindowSize;
+		if (keepFrom - m_bufStart > WindowSize) {
+			const size_t drop = static_cast<size_t>(keepFrom - m_bufStart);
+			m_buf.erase(m_buf.begin(), m_buf.begin() + drop);
+			m_bufStart += static_cast<int64_t>(drop);
+		}
+	}
+
+	void updateAdler(const uint8_t* data, size_t size)
+	{
+		// 5552 is the largest block for which the sums cannot overflow 32 bits
+		while (size > 0) {
+			const size_t block = std::min<size_t>(size, 5552);
+			for (size_t i = 0; i < block; ++i) {
+				m_adlerA += data[i];
+				m_adlerB += m_adlerA;
+			}
+			m_adlerA %= 65521;
+			m_adlerB %= 65521;
+			data += block;
+			size -= block;
+		}
+	}
+
+	std::vector<uint8_t> m_buf;
+	std::vector<uint8_t> m_out;
+	int64_t m_bufStart = 0;
+	int64_t m_pos = 0;
+	int64_t m_head[HashSize];
+	int64_t m_prev[WindowSize];
+	uint32_t m_bitBuffer = 0;
+	int m_bitCount = 0;
+	uint32_t m_adlerA = 1;
+	uint32_t m_adlerB = 0;
+};
+
+namespace {
+
+constexpr int IdatChunkSize = 64 * 1024;
+
+quint32 crc32(const char* data, int size, quint32 crc = 0xffffffffu)
+{
+	static const std::array<quint32, 256> table = [] {
+		std::array<quint32, 256> t{};
+		for (quint32 n = 0; n < 256; ++n) {
+			quint32 c = n;
+			for (int k = 0; k < 8; ++k) c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+			t[n] = c;
+		}
+		return t;
+	}();
+	for (int i = 0; i < size; ++i) {
+		crc = table[(crc ^ static_cast<quint8>(data[i])) & 0xff] ^ (crc >> 8);
+	}
+	return crc;
+}
+
+// Sum of absolute signed residuals, the usual heuristic for picking a PNG filter
+int filterCost(const QByteArray& row)
+{
+	int cost = 0;
+	const char* p = row.constData();
+	for (int i = 1; i < row.size(); ++i) cost += qAbs(static_cast<int>(static_cast<qint8>(p[i])));
+	return cost;
+}
+
+} // namespace
+
+PngStreamWriter::PngStreamWriter(QIODevice* device)
+	: m_device(device)
+{
+}
+
+PngStreamWriter::~PngStreamWriter()
+{
+}
+
+bool PngStreamWriter::begin(int width, int height, int dotsPerInch)
+{
+	if (!m_device || !m_device->isWritable()) {
+		m_errorString = QStringLiteral("Output device is not writable");
+		return false;
+	}
+	if (width <= 0 || height <= 0) {
+		m_errorString = QStringLiteral("Invalid image size %1x%2").arg(width).arg(height);
+		return false;
+	}
+
+	m_width = width;
+	m_height = height;
+	m_rowsWritten = 0;
+	m_deflater.reset(new PngDeflater);
+	m_previousRow = QByteArray(width * 3, '\0');
+	m_currentRow.resize(width * 3);
+	m_filteredRow.resize(width * 3 + 1);
+	m_candidateRow.resize(width * 3 + 1);
+
+	static const char signature[8] = {'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n'};
+	if (m_device->write(signature, 8) != 8) {
+		m_errorString = m_device->errorString();
+		return false;
+	}
+
+	QByteArray ihdr(13, '\0');
+	qToBigEndian<quint32>(static_cast<quint32>(width), ihdr.data());
+	qToBigEndian<quint32>(static_cast<quint32>(height), ihdr.data() + 4);
+	ihdr[8] = 8;  // Bit depth
+	ihdr[9] = 2;  // Truecolor RGB
+	ihdr[10] = 0; // Deflate
+	ihdr[11] = 0; // Adaptive filtering
+	ihdr[12] = 0; // No interlace
+	if (!writeChunk("IHDR", ihdr)) return false;
+
+	if (dotsPerInch > 0) {
+		const quint32 dotsPerMeter = static_cast<quint32>(qRound(dotsPerInch / 0.0254));
+		QByteArray phys(9, '\0');
+		qToBigEndian<quint32>(dotsPerMeter, phys.data());
+		qToBigEndian<quint32>(dotsPerMeter, phys.data() + 4);
+		phys[8] = 1; // Unit is the meter
+		if (!writeChunk("pHYs", phys)) return false;
+	}
+	return true;
+}
+
+bool PngStreamWriter::writeRows(const QImage& image, int rowCount)
+{
+	if (!m_deflater) {
+		m_errorString = QStringLiteral("begin() was not called");
+		return false;
+	}
+	if (image.width() != m_width || image.format() != QImage::Format_RGB32) {
+		m_errorString = QStringLiteral("Band does not match the image geometry");
+		return false;
+	}
+	rowCount = qMin(rowCount, qMin(image.height(), m_height - m_rowsWritten));
+
+	const int rowBytes = m_width * 3;
+	for (int y = 0; y < rowCount; ++y) {
+		const QRgb* src = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+		uchar* cur = reinterpret_cast<uchar*>(m_currentRow.data());
+		for (int x = 0; x < m_width; ++x) {
+			cur[3 * x] = static_cast<uchar>(qRed(src[x]));
+			cur[3 * x + 1] = static_cast<uchar>(qGreen(src[x]));
+			cur[3 * x + 2] = static_cast<uchar>(qBlue(src[x]));
+		}
+		const uchar* prev = reinterpret_cast<const uchar*>(m_previousRow.constData());
+
+		// Filter 1 (Sub) collapses flat runs, filter 2 (Up) collapses repeated rows
+		uchar* sub = reinterpret_cast<uchar*>(m_filteredRow.data());
+		sub[0] = 1;
+		for (int i = 0; i < rowBytes; ++i) sub[i + 1] = static_cast<uchar>(cur[i] - (i >= 3 ? cur[i - 3] : 0));
+		uchar* up = reinterpret_cast<uchar*>(m_candidateRow.data());
+		up[0] = 2;
+		for (int i = 0; i < rowBytes; ++i) up[i + 1] = static_cast<uchar>(cur[i] - prev[i]);
+		if (filterCost(m_candidateRow) < filterCost(m_filteredRow)) {
+			m_filteredRow.swap(m_candidateRow);
+		}
+
+		m_deflater->write(reinterpret_cast<const uint8_t*>(m_filteredRow.constData()), static_cast<size_t>(rowBytes + 1));
+		m_previousRow.swap(m_currentRow);
+		++m_rowsWritten;
+	}
+	return flushCompressed(false);
+}
+
+bool PngStreamWriter::finish()
+{
+	if (!m_deflater) {
+		m_errorString = QStringLiteral("begin() was not called");
+		return false;
+	}
+	if (m_rowsWritten != m_height) {
+		m_errorString = QStringLiteral("Only %1 of %2 rows were written").arg(m_rowsWritten).arg(m_height);
+		return false;
+	}
+	m_deflater->finish();
+	if (!flushCompressed(true)) return false;
+	m_deflater.reset();
+	return writeChunk("IEND", QByteArray());
+}
+
+bool PngStreamWriter::flushCompressed(bool all)
+{
+	std::vector<uint8_t>& out = m_deflater->output();
+	size_t offset = 0;
+	while (out.size() - offset >= static_cast<size_t>(IdatChunkSize) || (all && offset < out.size())) {
+		const int size = static_cast<int>(qMin<size_t>(out.size() - offset, IdatChunkSize));
+		if (!writeChunk("IDAT", QByteArray::fromRawData(reinterpret_cast<const char*>(out.data() + offset), size))) {
+			return false;
+		}
+		offset += static_cast<size_t>(size);
+	}
+	out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(offset));
+	return true;
+}
+
+bool PngStreamWriter::writeChunk(const char* type, const QByteArray& data)
+{
+	char header[8];
+	qToBigEndian<quint32>(static_cast<quint32>(data.size()), header);
+	memcpy(header + 4, type, 4);
+	quint32 crc = crc32(type, 4);
+	crc = crc32(data.constData(), data.size(), crc) ^ 0xffffffffu;
+	char trailer[4];
+	qToBigEndian<quint32>(crc, trailer);
+
+	if (m_device->write(header, 8) != 8
+		|| m_device->write(data) != data.size()
+		|| m_device->write(trailer, 4) != 4) {
+		m_errorString = m_device->errorString();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,73 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef PNGSTREAMWRITER_H
+#define PNGSTREAMWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QScopedPointer>
+
+class QIODevice;
+class QImage;
+class PngDeflater;
+
+/*
+ * Writes a truecolor PNG incrementally, a band of rows at a time.
+ * Only the previous scanline and the 32 KB deflate window are kept in memory,
+ * so the cost does not depend on the output resolution.
+ */
+class PngStreamWriter
+{
+public:
+	explicit PngStreamWriter(QIODevice* device);
+	~PngStreamWriter();
+
+	// Writes the signature, IHDR and pHYs chunks
+	bool begin(int width, int height, int dotsPerInch);
+	// Appends the first rowCount rows of image (Format_RGB32, same width as begin())
+	bool writeRows(const QImage& image, int rowCount);
+	// Flushes the compressed stream and writes IEND
+	bool finish();
+
+	QString errorString() const { return m_errorString; }
+
+private:
+	bool writeChunk(const char* type, const QByteArray& data);
+	bool flushCompressed(bool all);
+
+	QIODevice* m_device;
+	QScopedPointer<PngDeflater> m_deflater;
+	QByteArray m_previousRow; // Unfiltered RGB bytes of the last row, for the Up filter
+	QByteArray m_currentRow;
+	QByteArray m_filteredRow; // Filter type byte + filtered bytes
+	QByteArray m_candidateRow;
+	int m_width = 0;
+	int m_height = 0;
+	int m_rowsWritten = 0;
+	QString m_errorString;
+};
+
+#endif // PNGSTREAMWRITER_H
@@ -0,0 +1,198 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "processing.h"
+#include "coreconstants.h"
+#include "utils.h"
+
+#include <QDebug>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace Processing {
+
+QStringList filterTypes()
+{
+	return {"Moving Average", "Median Filter", "Savitzky-Golay"};
+}
+
+namespace {
+
+// One filter kernel, instantiated for the storage type of the column
+template <typename Column>
+QVector<double> filterColumn(const Column& column, const QString& filterType, int window)
+{
+	if (filterType == "Moving Average") return Utils::movingAverage(column, window);
+	if (filterType == "Median Filter") return Utils::medianFilter(column, window);
+	if (filterType == "Savitzky-Golay") return Utils::savitzkyGolay(column, window);
+	return Utils::toVector(column); // Should not happen, revert to original if type is unknown
+}
+
+} // namespace
+
+void filterDataset(DatasetColumns& data, bool hasReferenceData, const QString& filterType, int window)
+{
+	if (data.frequencyOffset.isEmpty()) return; // Skip empty datasets
+
+	auto filter = [&](const auto& column) { return filterColumn(column, filterType, window); };
+	data.phaseNoiseFiltered = data.withPhaseNoise(filter);
+	if (hasReferenceData || !filterTypes().contains(filterType)) data.referenceNoiseFiltered = data.withReferenceNoise(filter);
+}
+
+DerivedColumns deriveColumns(const DatasetColumns& data, bool hasReferenceData, const DerivedSettings& settings)
+{
+	auto decoded = [](const auto& column) { return Utils::toVector(column); };
+	DerivedColumns derived;
+	derived.phaseNoiseFiltered = data.withPhaseNoise(decoded);
+	derived.referenceNoiseFiltered = data.withReferenceNoise(decoded);
+	if (data.frequencyOffset.isEmpty()) return derived;
+
+	if (settings.filtering) {
+		auto filter = [&](const auto& column) { return filterColumn(column, settings.filterType, settings.filterWindow); };
+		derived.phaseNoiseFiltered = data.withPhaseNoise(filter);
+		if (hasReferenceData) derived.referenceNoiseFiltered = data.withReferenceNoise(filter);
+	}
+	if (settings.spurRemoval && hasReferenceData) {
+		const QVector<double>& frequency = data.frequencyOffset;
+		if (settings.filtering) {
+			derived.phaseNoiseFiltered = removeSpurs(frequency, derived.phaseNoiseFiltered, derived.referenceNoiseFiltered);
+		} else {
+			// Both kernels read the raw columns in their stored type
+			derived.phaseNoiseFiltered = data.withPhaseNoise([&](const auto& measured) {
+				return data.withReferenceNoise([&](const auto& reference) { return removeSpurs(frequency, measured, reference); });
+			});
+		}
+	}
+	return derived;
+}
+
+DerivedColumns deriveColumns(const QVector<double>& frequency, const QVector<double>& phaseNoise,
+							 const QVector<double>& referenceNoise, bool hasReferenceData, const DerivedSettings& settings)
+{
+	DatasetColumns data;
+	data.frequencyOffset = frequency;
+	data.phaseNoise = phaseNoise;
+	data.referenceNoise = referenceNoise;
+	return deriveColumns(data, hasReferenceData, settings);
+}
+
+QVector<SpotNoisePoint> spotNoise(const QVector<double>& frequency, const QVector<double>& noise, double minFreq, double maxFreq)
+{
+	QVector<SpotNoisePoint> points;
+	const int n = qMin(frequency.size(), noise.size());
+	for (const auto& freqInfo : Constants::FREQ_POINT_INFOS) {
+		double targetFreq = freqInfo.value;
+
+		// Check if frequency is within the requested range
+		if (targetFreq < minFreq || targetFreq > maxFreq) {
+			continue;
+		}
+
+		// Find the closest data point to the target frequency
+		double minDist = std::numeric_limits<double>::max();
+		int closest = -1;
+		for (int i = 0; i < n; ++i) {
+			double dist = qAbs(qLn(frequency[i]) - qLn(targetFreq)); // Use log distance for better search on log scale
+			if (dist < minDist) {
+				minDist = dist;
+				closest = i;
+			}
+		}
+
+		if (closest >= 0) {
+			// Check if the found frequency is reasonably close (e.g., within half a decade)
+			if (minDist < qLn(5.0)) { // Within factor of 5
+				points.append({QLatin1String(freqInfo.displayName), targetFreq, frequency[closest], noise[closest]});
+			} else {
+				qWarning() << "Spot noise target" << targetFreq << "Hz - closest data point" << frequency[closest] << "Hz is too far, skipping.";
+			}
+		}
+	}
+	return points;
+}
+
+IntegratedNoise integrateNoise(const QVector<double>& frequency, const QVector<double>& noise, double from, double to)
+{
+	IntegratedNoise result;
+	const int n = qMin(frequency.size(), noise.size());
+	if (n < 2 || !(to > from)) return result;
+
+	result.from = qMax(from, frequency.first());
+	result.to = qMin(to, frequency[n - 1]);
+	double ssbPower = 0.0; // Integral of L(f), linear
+	for (int i = 0; i + 1 < n; ++i) {
+		double f1 = frequency[i], f2 = frequency[i + 1];
+		if (std::isnan(noise[i]) || std::isnan(noise[i + 1]) || f2 <= f1 || f2 <= result.from || f1 >= result.to) continue;
+
+		// L(f) follows a power law a * f^b between two points (a straight line on the log-log plot)
+		const double l1 = qPow(10.0, noise[i] / 10.0);
+		const double l2 = qPow(10.0, noise[i + 1] / 10.0);
+		const double b = std::log(l2 / l1) / std::log(f2 / f1);
+		const double a = l1 / qPow(f1, b);
+		f1 = qMax(f1, result.from);
+		f2 = qMin(f2, result.to);
+		if (qAbs(b + 1.0) < 1e-9) {
+			ssbPower += a * std::log(f2 / f1);
+		} else {
+			ssbPower += a / (b + 1.0) * (qPow(f2, b + 1.0) - qPow(f1, b + 1.0));
+		}
+	}
+	if (ssbPower <= 0.0) return result;
+
+	result.integratedDbc = 10.0 * std::log10(ssbPower);
+	result.rmsPhaseRad = std::sqrt(2.0 * ssbPower);
+	result.valid = true;
+	return result;
+}
+
+MaskVerdict checkMask(const QVector<double>& frequency, const QVector<double>& noise, const QVector<MaskPoint>& mask)
+{
+	MaskVerdict verdict;
+	const int n = qMin(frequency.size(), noise.size());
+	if (mask.size() < 2 || n == 0) return verdict;
+
+	int segment = 0;
+	for (int i = 0; i < n; ++i) {
+		const double f = frequency[i];
+		if (std::isnan(noise[i]) || f < mask.first().frequency || f > mask.last().frequency) continue;
+		while (segment + 2 < mask.size() && f > mask[segment + 1].frequency) ++segment;
+		const MaskPoint& a = mask[segment];
+		const MaskPoint& b = mask[segment + 1];
+		const double limit = (b.frequency > a.frequency)
+								 ? Utils::linearInterpolate(qLn(a.frequency), a.limit, qLn(b.frequency), b.limit, qLn(f))
+								 : qMin(a.limit, b.limit);
+		const double margin = limit - noise[i];
+		if (!verdict.checked || margin < verdict.worstMargin) {
+			verdict.worstMargin = margin;
+			verdict.worstFrequency = f;
+		}
+		verdict.checked = true;
+	}
+	verdict.pass = !verdict.checked || verdict.worstMargin >= 0.0;
+	return verdict;
+}
+
+} // namespace Processing
@@ -0,0 +1,239 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef PROCESSING_H
+#define PROCESSING_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtMath>
+#include <cmath>
+
+#include "coreconstants.h"
+#include "datasetcolumns.h"
+#include "utils.h"
+
+// Measured noise at one of the Constants::FREQ_POINT_INFOS decade points
+struct SpotNoisePoint {
+	QString label;          // Display name, e.g. "10 kHz"
+	double targetFrequency; // Decade point
+	double frequency;       // Closest data point
+	double noise;           // dBc/Hz at that point
+};
+
+// Limit line: the noise must stay at or below limit (dBc/Hz), interpolated in log frequency
+struct MaskPoint {
+	double frequency;
+	double limit;
+};
+
+struct MaskVerdict {
+	bool checked = false;     // Data overlapped the mask
+	bool pass = true;
+	double worstMargin = 0.0; // limit - noise at the worst point, negative on failure
+	double worstFrequency = 0.0;
+};
+
+// Phase noise integrated over a frequency range
+struct IntegratedNoise {
+	double from = 0.0;         // Hz, clipped to the data
+	double to = 0.0;
+	double integratedDbc = 0.0; // 10*log10 of the integrated SSB power
+	double rmsPhaseRad = 0.0;   // sqrt(2 * integral of L(f))
+	bool valid = false;
+};
+
+// Settings that determine the derived (filtered / spur-free) columns of a dataset
+struct DerivedSettings {
+	bool filtering = false;
+	QString filterType;
+	int filterWindow = 0;
+	bool spurRemoval = false;
+};
+
+struct DerivedColumns {
+	QVector<double> phaseNoiseFiltered;
+	QVector<double> referenceNoiseFiltered;
+};
+
+/*
+ * Analysis steps shared by the GUI and the headless batch mode.
+ * Pure functions on columns: no widgets, no global state, safe to run on any thread.
+ */
+namespace Processing {
+
+// Filter names as shown in the filter combo box
+QStringList filterTypes();
+
+// Fill phaseNoiseFiltered / referenceNoiseFiltered from the raw columns (float64 or compact)
+void filterDataset(DatasetColumns& data, bool hasReferenceData, const QString& filterType, int window);
+
+// Spur removal: points where the reference rises more than Constants::SPUR_THRESHOLD above
+// its rolling median, or between a rising and a falling reference edge, are interpolated
+// from their neighbours. Returns the cleaned measurement. Defined below: the measured and
+// reference columns are QVector<double> or CompactView (see Utils::movingAverage).
+template <typename MeasuredColumn, typename ReferenceColumn>
+QVector<double> removeSpurs(const QVector<double>& frequency, const MeasuredColumn& measured, const ReferenceColumn& reference);
+
+// Filtering then spur removal (reference data only), as applied to the plotted curves.
+// The kernels read compact raw columns in place. Unused steps alias float64 raw columns,
+// so nothing is copied when both are disabled (compact columns are decoded).
+DerivedColumns deriveColumns(const DatasetColumns& data, bool hasReferenceData, const DerivedSettings& settings);
+DerivedColumns deriveColumns(const QVector<double>& frequency, const QVector<double>& phaseNoise,
+							 const QVector<double>& referenceNoise, bool hasReferenceData, const DerivedSettings& settings);
+
+// Closest point (in log frequency, within a factor of 5) to each decade point in [minFreq, maxFreq]
+QVector<SpotNoisePoint> spotNoise(const QVector<double>& frequency, const QVector<double>& noise, double minFreq, double maxFreq);
+
+// Integration of L(f) in dBc/Hz over [from, to] (clipped to the data), power law between points
+IntegratedNoise integrateNoise(const QVector<double>& frequency, const QVector<double>& noise, double from, double to);
+
+// Compares every data point inside the mask's frequency span with the mask (sorted by frequency)
+MaskVerdict checkMask(const QVector<double>& frequency, const QVector<double>& noise, const QVector<MaskPoint>& mask);
+
+// RMS jitter in seconds for a carrier frequency in Hz
+inline double rmsJitter(const IntegratedNoise& integrated, double carrierFrequency) {
+	return (integrated.valid && carrierFrequency > 0) ? integrated.rmsPhaseRad / (2.0 * M_PI * carrierFrequency) : 0.0;
+}
+
+// --- Templates ---
+
+template <typename MeasuredColumn, typename ReferenceColumn>
+QVector<double> removeSpurs(const QVector<double>& frequency, const MeasuredColumn& measured, const ReferenceColumn& reference)
+{
+	// Work on a copy of the measurement data that will become the new filtered measurement data
+	QVector<double> processedMeas = Utils::toVector(measured);
+
+	int N = reference.size();
+	if (N < 3) {
+		return processedMeas; // Not enough data to process
+	}
+
+	// --- Method 1: Baseline comparison ---
+	QVector<double> baseline = Utils::rollingMedian(reference, Constants::DEFAULT_SPUR_WINDOW_SIZE);
+	QVector<bool> isSpur(N, false);
+	for(int i=0; i<N; ++i) {
+		if (!std::isnan(reference[i]) && !std::isnan(baseline[i]) &&
+			(reference[i] - baseline[i]) > Constants::SPUR_THRESHOLD) {
+			isSpur[i] = true;
+		}
+	}
+
+	int i = 0;
+	while (i < N) {
+		if (isSpur[i]) {
+			int start = i;
+			while (i < N && isSpur[i]) {
+				i++;
+			}
+			int end = i - 1; // Inclusive end index of spur segment
+
+			// Find valid neighbors for interpolation
+			int left = start - 1;
+			while (left >= 0 && isSpur[left]) left--; // Find first non-spur to the left
+			if (left < 0) left = 0; // Clamp to beginning if needed
+
+			int right = end + 1;
+			while (right < N && isSpur[right]) right++; // Find first non-spur to the right
+			if (right >= N) right = N - 1; // Clamp to end if needed
+
+			double leftVal = processedMeas[left];
+			double rightVal = processedMeas[right];
+			double leftFreq = frequency[left];
+			double rightFreq = frequency[right];
+
+			// Interpolate over the segment [start, end] using neighbors [left, right]
+			for (int j = start; j <= end; ++j) {
+				// Check if neighbors are distinct to avoid division by zero
+				if (right > left && qAbs(rightFreq - leftFreq) > 1e-9) { // Check freq diff
+					processedMeas[j] = Utils::linearInterpolate(leftFreq, leftVal, rightFreq, rightVal, frequency[j]);
+				} else {
+					// If neighbors are the same point or too close, just use the left value
+					processedMeas[j] = leftVal;
+				}
+			}
+			// Continue search after the processed segment ('i' is already advanced)
+		} else {
+			i++; // Move to next point if not a spur
+		}
+	}
+
+	// --- Method 2: Edge Detection (applied *after* baseline method) ---
+	// Use the intermediate processed measurement and original reference for detection
+	const ReferenceColumn& currentRef = reference; // Use original/filtered ref for detection edges
+	QVector<double> finalMeas = processedMeas; // Operate on the result of method 1
+
+	i = 1;
+	while (i < N - 1) {
+		// Check for rising edge in reference noise
+		if (!std::isnan(currentRef[i]) && !std::isnan(currentRef[i-1]) &&
+			(currentRef[i] - currentRef[i - 1]) > Constants::SPUR_THRESHOLD)
+		{
+			int start = i; // Start of potential spur region
+			int j = start + 1;
+			// Find the corresponding falling edge
+			while (j < N) {
+				if (!std::isnan(currentRef[j]) && !std::isnan(currentRef[j-1]) &&
+					(currentRef[j-1] - currentRef[j]) > Constants::SPUR_THRESHOLD)
+				{
+					break; // Found falling edge
+				}
+				j++;
+			}
+
+			if (j < N) { // Found a falling edge at index j
+				// Interpolate measured data from point start-1 to j
+				double leftVal = finalMeas[start - 1];
+				double rightVal = finalMeas[j];
+				double leftFreq = frequency[start-1];
+				double rightFreq = frequency[j];
+
+				for (int k = start; k < j; ++k) { // Interpolate up to (but not including) the end point j
+					if (qFabs(rightFreq-leftFreq) > 1e-9) { // Avoid division by zero
+						finalMeas[k] = Utils::linearInterpolate(leftFreq, leftVal, rightFreq, rightVal, frequency[k]);
+					} else {
+						finalMeas[k] = leftVal; // Assign left value if frequencies are too close
+					}
+				}
+				i = j; // Continue search after the falling edge
+			} else {
+				// No falling edge found, extend left value to the end
+				double leftVal = finalMeas[start - 1];
+				for (int k = start; k < N; ++k) {
+					finalMeas[k] = leftVal;
+				}
+				i = N; // End the loop
+			}
+		} else {
+			i++; // Move to the next point
+		}
+	}
+	return finalMeas;
+}
+
+} // namespace Processing
+
+#endif // PROCESSING_H
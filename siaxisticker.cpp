@@ -0,0 +1,119 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "siaxisticker.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "utils.h"
+#include "allocprofiler.h"
+
+namespace {
+
+// Relative tolerance for ticks sitting exactly on a range bound
+constexpr double BoundTolerance = 1e-9;
+
+// Copies source into target element by element, reusing target's buffer.
+// Returns false (and leaves target, possibly still shared, untouched) when they are equal.
+template<typename T>
+bool assignIfChanged(QVector<T>& target, const QVector<T>& source)
+{
+	if (target == source) return false;
+	target.resize(source.size());
+	std::copy(source.cbegin(), source.cend(), target.begin());
+	return true;
+}
+
+} // namespace
+
+QCPAxisTickerSI::QCPAxisTickerSI()
+	: QCPAxisTickerLog()
+{
+	setLogBase(10.0);
+	for (int i = 0; i < ExponentCount; ++i)
+		m_powers[i] = std::pow(10.0, MinExponent + i);
+}
+
+const QString& QCPAxisTickerSI::label(int exponent, int mantissa)
+{
+	QString& cached = m_labels[exponent - MinExponent][mantissa - 1];
+	if (cached.isNull())
+		cached = Utils::formatFrequencyTick(tickValue(exponent, mantissa), 3);
+	return cached;
+}
+
+void QCPAxisTickerSI::generate(const QCPRange& range, const QLocale& locale, QChar formatChar, int precision,
+							   QVector<double>& ticks, QVector<double>* subTicks, QVector<QString>* tickLabels)
+{
+	AllocProfiler::Scope allocScope("siTicker");
+	const double lower = range.lower;
+	const double upper = range.upper;
+	// One exponent past each end absorbs log10 rounding; the bound checks below decide
+	const int first = (lower > 0.0) ? int(std::floor(std::log10(lower))) - 1 : MinExponent - 1;
+	const int last = (upper > lower) ? int(std::floor(std::log10(upper))) + 1 : MinExponent - 1;
+	if (first < MinExponent || last > MaxExponent || last < first || last - first > MaxDecades + 2) {
+		QCPAxisTickerLog::generate(range, locale, formatChar, precision, ticks, subTicks, tickLabels);
+		return;
+	}
+	const double low = lower * (1.0 - BoundTolerance);
+	const double high = upper * (1.0 + BoundTolerance);
+
+	bool decadeInRange = false;
+	for (int k = first; k <= last && !decadeInRange; ++k) {
+		const double decade = tickValue(k, 1);
+		decadeInRange = decade >= low && decade <= high;
+	}
+
+	m_ticks.resize(0);
+	m_subTicks.resize(0);
+	m_tickLabels.resize(0);
+	for (int k = first; k <= last; ++k) {
+		for (int m = 1; m <= 9; ++m) {
+			const double value = tickValue(k, m);
+			if (value < low) continue;
+			if (value > high) break;
+			if (m == 1 || !decadeInRange) {
+				m_ticks.append(value);
+				if (tickLabels) m_tickLabels.append(label(k, m));
+			} else {
+				m_subTicks.append(value);
+			}
+		}
+	}
+
+	assignIfChanged(ticks, m_ticks);
+	if (subTicks) assignIfChanged(*subTicks, m_subTicks);
+	if (tickLabels) assignIfChanged(*tickLabels, m_tickLabels);
+}
+
+QString QCPAxisTickerSI::getTickLabel(double tick, const QLocale& locale, QChar formatChar, int precision)
+{
+	Q_UNUSED(locale)
+	Q_UNUSED(formatChar)
+	Q_UNUSED(precision)
+	if (tick <= 1e-9) return QStringLiteral("0 Hz");
+	return Utils::formatFrequencyTick(tick, 3);
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef SIAXISTICKER_H
+#define SIAXISTICKER_H
+
+#include <QString>
+#include <QVector>
+
+#include "qcustomplot.h"
+
+/*
+ * Logarithmic frequency ticker with SI labels (100, 1k, 10M...).
+ *
+ * Major ticks sit on the decades 10^k inside the range, subticks on 2..9 x 10^k,
+ * both computed directly from the range exponents. Zoomed in to less than a
+ * decade, the 1..9 x 10^k steps become the labelled ticks instead.
+ *
+ * Labels are formatted once per (decade, mantissa) and kept; QCPAxis shares the
+ * previous label vector while generating, so an unchanged tick set is left
+ * untouched and panning inside the same decades neither formats nor allocates.
+ * The rendered label pixmaps are cached by QCustomPlot (phCacheLabels), keyed
+ * by the label text. Ranges that are not positive or span more than MaxDecades
+ * fall back to QCPAxisTickerLog with the same label formatting.
+ */
+class QCPAxisTickerSI : public QCPAxisTickerLog
+{
+public:
+	QCPAxisTickerSI();
+
+	void generate(const QCPRange& range, const QLocale& locale, QChar formatChar, int precision,
+				  QVector<double>& ticks, QVector<double>* subTicks, QVector<QString>* tickLabels) override;
+	QString getTickLabel(double tick, const QLocale& locale, QChar formatChar, int precision) override;
+
+private:
+	static constexpr int MinExponent = -15;
+	static constexpr int MaxExponent = 15;
+	static constexpr int MaxDecades = 24;
+	static constexpr int ExponentCount = MaxExponent - MinExponent + 1;
+
+	double tickValue(int exponent, int mantissa) const { return mantissa * m_powers[exponent - MinExponent]; }
+	const QString& label(int exponent, int mantissa);
+
+	double m_powers[ExponentCount];
+	QString m_labels[ExponentCount][9]; // Formatted on first use
+
+	// Scratch vectors reused across calls, copied into QCPAxis's vectors only when they differ
+	QVector<double> m_ticks;
+	QVector<double> m_subTicks;
+	QVector<QString> m_tickLabels;
+};
+
+#endif // SIAXISTICKER_H
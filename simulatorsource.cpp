@@ -0,0 +1,118 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "simulatorsource.h"
+#include "coreconstants.h"
+
+#include <QThread>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// Offsets of the simulated spurs: mains harmonics first, then the reference clock family
+constexpr double SPUR_OFFSETS[] = {50.0, 150.0, 250.0, 12.5e3, 100e3, 1.25e6, 3.2e6, 6.4e6};
+
+} // namespace
+
+SimulatorSource::SimulatorSource(const Settings& settings)
+	: LiveDataSource(Constants::LIVE_BUFFER_FRAMES), m_settings(settings)
+{
+}
+
+SimulatorSource::~SimulatorSource()
+{
+	stop();
+}
+
+bool SimulatorSource::open(QString* errorString)
+{
+	const Settings& s = m_settings;
+	if (s.points < 2 || s.startFrequency <= 0 || s.stopFrequency <= s.startFrequency) {
+		*errorString = QStringLiteral("Invalid simulator frequency grid");
+		return false;
+	}
+
+	m_frequency.resize(s.points);
+	m_model.resize(s.points);
+	const double logStart = std::log10(s.startFrequency);
+	const double logStep = (std::log10(s.stopFrequency) - logStart) / (s.points - 1);
+	for (int i = 0; i < s.points; ++i) {
+		const double f = std::pow(10.0, logStart + i * logStep);
+		const double leeson = 1.0 + (s.leesonFrequency / f) * (s.leesonFrequency / f);
+		const double flicker = 1.0 + s.flickerCorner / f;
+		m_frequency[i] = f;
+		m_model[i] = s.noiseFloor + 10.0 * std::log10(leeson * flicker);
+	}
+
+	// Each spur occupies the grid point closest to its offset
+	m_spurIndices.clear();
+	const int spurCount = qBound(0, s.spurCount, int(sizeof(SPUR_OFFSETS) / sizeof(SPUR_OFFSETS[0])));
+	for (int k = 0; k < spurCount; ++k) {
+		if (SPUR_OFFSETS[k] < s.startFrequency || SPUR_OFFSETS[k] > s.stopFrequency) continue;
+		m_spurIndices.append(qBound(0, qRound((std::log10(SPUR_OFFSETS[k]) - logStart) / logStep), s.points - 1));
+	}
+
+	m_random.seed(s.seed);
+	m_nextDeadlineNs = nowNs();
+	return true;
+}
+
+bool SimulatorSource::acquire(SweepFrame* frame, QString* errorString)
+{
+	Q_UNUSED(errorString)
+	const Settings& s = m_settings;
+
+	// Pace on absolute deadlines so the rate does not drift with the generation time.
+	// Sleep in short slices to notice stop() quickly at low rates.
+	if (s.sweepsPerSecond > 0) {
+		m_nextDeadlineNs += qint64(1e9 / s.sweepsPerSecond);
+		for (qint64 now = nowNs(); now < m_nextDeadlineNs; now = nowNs()) {
+			if (isStopRequested()) return false;
+			QThread::usleep(quint64(qMin<qint64>((m_nextDeadlineNs - now) / 1000, 20000)));
+		}
+		// Fell behind by more than a sweep (slow machine, debugger): restart the schedule
+		if (nowNs() - m_nextDeadlineNs > qint64(1e9 / s.sweepsPerSecond)) m_nextDeadlineNs = nowNs();
+	} else if (isStopRequested()) {
+		return false;
+	}
+
+	std::normal_distribution<double> traceNoise(0.0, s.traceNoise);
+	frame->frequencyOffset = m_frequency;
+	frame->phaseNoise.resize(s.points);
+	frame->hasReferenceData = s.referenceData;
+	if (s.referenceData) frame->referenceNoise.resize(s.points);
+	for (int i = 0; i < s.points; ++i) {
+		frame->phaseNoise[i] = m_model[i] + traceNoise(m_random);
+		if (s.referenceData) frame->referenceNoise[i] = m_model[i] + s.referenceOffset + traceNoise(m_random);
+	}
+	for (int index : std::as_const(m_spurIndices)) {
+		frame->phaseNoise[index] += s.spurLevel;
+		if (s.referenceData) frame->referenceNoise[index] += s.spurLevel;
+	}
+	return true;
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef SIMULATORSOURCE_H
+#define SIMULATORSOURCE_H
+
+#include <QVector>
+#include <random>
+
+#include "livedatasource.h"
+
+/*
+ * Live source generating PN2060C-like sweeps without hardware.
+ *
+ * The noise follows Leeson's model on a log-spaced offset grid:
+ *   L(f) = floor + 10*log10((1 + (fL/f)^2) * (1 + fc/f))
+ * with fL = f0 / (2*Q) the resonator half bandwidth and fc the flicker corner,
+ * plus Gaussian trace noise per point. Spurs (mains harmonics and a few fixed
+ * offsets) appear in both the measurement and the reference channel, so spur
+ * removal has something to find. Sweeps are paced at sweepsPerSecond; 0 generates
+ * them back to back for throughput tests (what the consumer cannot take is dropped).
+ */
+class SimulatorSource : public LiveDataSource
+{
+public:
+	struct Settings {
+		double sweepsPerSecond = 10.0;
+		int points = 2000;
+		double startFrequency = 1.0;   // Hz offset
+		double stopFrequency = 10e6;
+		double noiseFloor = -170.0;    // dBc/Hz far from the carrier
+		double leesonFrequency = 20e3; // f0 / (2*Q), Hz
+		double flickerCorner = 5e3;    // Hz
+		double traceNoise = 0.7;       // dB RMS per point
+		int spurCount = 6;
+		double spurLevel = 18.0;       // dB above the noise at the spur offset
+		bool referenceData = true;
+		double referenceOffset = -12.0; // Reference channel relative to the measurement, dB
+		quint32 seed = 1;
+	};
+
+	explicit SimulatorSource(const Settings& settings = Settings());
+	~SimulatorSource() override;
+
+	QString name() const override { return QStringLiteral("Simulator"); }
+	const Settings& settings() const { return m_settings; }
+
+protected:
+	bool open(QString* errorString) override;
+	bool acquire(SweepFrame* frame, QString* errorString) override;
+
+private:
+	Settings m_settings;
+
+	// Built by open(), then only read by the producer thread
+	QVector<double> m_frequency; // Shared by every frame
+	QVector<double> m_model;     // Noise-free Leeson curve
+	QVector<int> m_spurIndices;
+	std::mt19937 m_random;
+	qint64 m_nextDeadlineNs = 0;
+};
+
+#endif // SIMULATORSOURCE_H
@@ -0,0 +1,179 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "singleinstance.h"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QDebug>
+
+namespace {
+
+constexpr quint32 IpcMagic = 0x504E4131; // "PNA1"
+constexpr quint16 IpcVersion = 1;
+constexpr quint8 IpcAck = 1;
+
+// Same stream format on both sides whatever Qt major version each was built with
+constexpr QDataStream::Version IpcStreamVersion = QDataStream::Qt_5_15;
+
+} // namespace
+
+SingleInstance::SingleInstance(QObject* parent)
+	: QObject(parent)
+{
+}
+
+SingleInstance::~SingleInstance()
+{
+	if (m_server) {
+		m_server->close();
+	}
+}
+
+QString SingleInstance::serverName()
+{
+	QString user = qEnvironmentVariable("USER");
+	if (user.isEmpty()) {
+		user = qEnvironmentVariable("USERNAME");
+	}
+	// Hash the user name to keep the endpoint name short and free of path characters
+	const QByteArray hash = QCryptographicHash::hash(user.toUtf8(), QCryptographicHash::Sha1).toHex().left(12);
+	return QStringLiteral("pna_qt-") + QString::fromLatin1(hash);
+}
+
+bool SingleInstance::forwardToRunningInstance(const QStringList& filenames, int connectTimeoutMs, int ackTimeoutMs)
+{
+	QLocalSocket socket;
+	socket.connectToServer(serverName());
+	if (!socket.waitForConnected(connectTimeoutMs)) {
+		return false; // No instance running (or it is not responding)
+	}
+
+	// The running instance has its own working directory
+	QStringList absolutePaths;
+	absolutePaths.reserve(filenames.size());
+	for (const QString& filename : filenames) {
+		absolutePaths.append(QFileInfo(filename).absoluteFilePath());
+	}
+
+	QByteArray message;
+	QDataStream out(&message, QIODevice::WriteOnly);
+	out.setVersion(IpcStreamVersion);
+	out << IpcMagic << IpcVersion << absolutePaths;
+
+	socket.write(message);
+	if (!socket.waitForBytesWritten(connectTimeoutMs)) {
+		qWarning() << "Single instance: failed to send files:" << socket.errorString();
+		return false;
+	}
+	// Once written the message stays in the socket buffer until the running instance
+	// reads it, so a missing acknowledge is reported but not treated as a failure:
+	// starting a second window here would load the same files twice.
+	char ack = 0;
+	if (!socket.waitForReadyRead(ackTimeoutMs) || !socket.getChar(&ack) || static_cast<quint8>(ack) != IpcAck) {
+		qWarning() << "Single instance: running instance did not acknowledge the files yet";
+	}
+	socket.disconnectFromServer();
+	return true;
+}
+
+bool SingleInstance::listen()
+{
+	if (!m_server) {
+		m_server = new QLocalServer(this);
+		m_server->setSocketOptions(QLocalServer::UserAccessOption);
+		connect(m_server, &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+	}
+
+	const QString name = serverName();
+	// QLockFile takes over a lock whose owner process has died, so holding it means no
+	// other instance is alive. Without it the endpoint belongs to a running instance,
+	// even one too busy to have answered the client probe, and must not be removed.
+	if (!m_lock) {
+		m_lock.reset(new QLockFile(QDir::temp().filePath(name + QStringLiteral(".lock"))));
+		m_lock->setStaleLockTime(0); // Stale only when the owner is gone, whatever the lock's age
+	}
+	if (!m_lock->isLocked() && !m_lock->tryLock(0)) {
+		qWarning() << "Single instance: another instance owns" << name << "- not accepting files in this one";
+		return false;
+	}
+
+	if (m_server->listen(name)) {
+		return true;
+	}
+	if (m_server->serverError() == QAbstractSocket::AddressInUseError) {
+		// We hold the lock, so this is a leftover from a crashed instance
+		QLocalServer::removeServer(name);
+		if (m_server->listen(name)) {
+			return true;
+		}
+	}
+	qWarning() << "Single instance: cannot listen on" << name << ":" << m_server->errorString();
+	return false;
+}
+
+void SingleInstance::onNewConnection()
+{
+	while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+		connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+		connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readMessage(socket); });
+		// Data may already be buffered before the readyRead connection was made
+		if (socket->bytesAvailable() > 0) {
+			readMessage(socket);
+		}
+	}
+}
+
+void SingleInstance::readMessage(QLocalSocket* socket)
+{
+	QDataStream in(socket);
+	in.setVersion(IpcStreamVersion);
+
+	// The message may arrive in several chunks; wait until it is complete
+	in.startTransaction();
+	quint32 magic = 0;
+	quint16 version = 0;
+	QStringList filenames;
+	in >> magic >> version >> filenames;
+	if (!in.commitTransaction()) {
+		return;
+	}
+
+	if (magic != IpcMagic || version != IpcVersion) {
+		qWarning() << "Single instance: ignoring message with unknown format";
+		socket->disconnectFromServer();
+		return;
+	}
+
+	socket->putChar(static_cast<char>(IpcAck));
+	socket->flush();
+
+	qInfo() << "Single instance: received" << filenames.size() << "file(s) from another process";
+	emit filesReceived(filenames);
+}
@@ -0,0 +1,80 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QLockFile>
+#include <QObject>
+#include <QScopedPointer>
+#include <QStringList>
+
+class QLocalServer;
+class QLocalSocket;
+
+/*
+ * Single-instance support over a local socket (named pipe on Windows, Unix
+ * domain socket elsewhere). The first process calls listen(); later processes
+ * call forwardToRunningInstance() which sends their input files and returns,
+ * so they can exit before any GUI initialization.
+ *
+ * Message: quint32 magic, quint16 protocol version, QStringList absolute paths.
+ * The server answers with a single quint8 acknowledge once the list is queued.
+ *
+ * Ownership of the endpoint is decided by a per-user lock file, not by whether the
+ * running instance answered the probe in time: a busy instance keeps its endpoint.
+ */
+class SingleInstance : public QObject
+{
+	Q_OBJECT
+public:
+	explicit SingleInstance(QObject* parent = nullptr);
+	~SingleInstance();
+
+	// Per-user endpoint name, so different users on one machine do not collide
+	static QString serverName();
+
+	// Client side: blocking, only needs a QCoreApplication.
+	// Returns true if a running instance accepted the connection and the files were sent.
+	static bool forwardToRunningInstance(const QStringList& filenames, int connectTimeoutMs, int ackTimeoutMs);
+
+	// Server side: take the instance lock and start listening, replacing a stale endpoint
+	// left by a crashed instance. Returns false if another live instance holds the lock.
+	bool listen();
+
+signals:
+	void filesReceived(const QStringList& filenames);
+
+private slots:
+	void onNewConnection();
+
+private:
+	void readMessage(QLocalSocket* socket);
+
+	QLocalServer* m_server = nullptr;
+	QScopedPointer<QLockFile> m_lock; // Held while this instance owns the endpoint
+};
+
+#endif // SINGLEINSTANCE_H
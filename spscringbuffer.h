@@ -0,0 +1,103 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * The capacity is rounded up to a power of two so indices wrap with a mask. The
+ * producer only writes m_head and the consumer only writes m_tail; each reads the
+ * other's index with acquire ordering, which publishes the slot contents written
+ * before the matching release store. Indices sit on separate cache lines so the
+ * two threads do not invalidate each other's line on every operation.
+ *
+ * Elements are moved in and out of preallocated slots: no allocation after construction.
+ */
+template <typename T>
+class SpscRingBuffer
+{
+public:
+	explicit SpscRingBuffer(size_t capacity)
+		: m_slots(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)), m_mask(m_slots.size() - 1)
+	{
+	}
+
+	SpscRingBuffer(const SpscRingBuffer&) = delete;
+	SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+	size_t capacity() const { return m_slots.size(); }
+
+	// Producer thread. False (item untouched) when full.
+	bool tryPush(T&& item)
+	{
+		const size_t head = m_head.load(std::memory_order_relaxed);
+		if (head - m_tail.load(std::memory_order_acquire) == m_slots.size()) return false;
+		m_slots[head & m_mask] = std::move(item);
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer thread. False when empty.
+	bool tryPop(T& item)
+	{
+		const size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (m_head.load(std::memory_order_acquire) == tail) return false;
+		item = std::move(m_slots[tail & m_mask]);
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Approximate when called concurrently with the other side, but within [0, capacity()]:
+	// m_tail is read first, and m_head can only have moved further ahead of it since
+	size_t size() const
+	{
+		const size_t tail = m_tail.load(std::memory_order_acquire);
+		const size_t used = m_head.load(std::memory_order_acquire) - tail;
+		return used < m_slots.size() ? used : m_slots.size();
+	}
+	bool isEmpty() const { return size() == 0; }
+
+private:
+	static size_t roundUpToPowerOfTwo(size_t value)
+	{
+		size_t result = 1;
+		while (result < value) result <<= 1;
+		return result;
+	}
+
+	std::vector<T> m_slots;
+	const size_t m_mask;
+	alignas(64) std::atomic<size_t> m_head{0}; // Next slot to write, producer owned
+	alignas(64) std::atomic<size_t> m_tail{0}; // Next slot to read, consumer owned
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -0,0 +1,169 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "stallpanel.h"
+#include "qcustomplot.h"
+
+#include <QHash>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTableWidget>
+#include <QTableWidgetItem>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+static QString formatMs(qint64 ms)
+{
+	return ms < 1000 ? QString("%1 ms").arg(ms) : QString("%1 s").arg(ms / 1000.0, 0, 'f', 1);
+}
+
+StallPanel::StallPanel(QWidget* parent)
+	: QWidget(parent)
+{
+	QVBoxLayout* layout = new QVBoxLayout(this);
+	layout->setContentsMargins(4, 4, 4, 4);
+
+	m_summaryLabel = new QLabel(this);
+	m_summaryLabel->setWordWrap(true);
+	m_summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+	layout->addWidget(m_summaryLabel);
+
+	m_histogram = new QCustomPlot(this);
+	m_histogram->setMinimumHeight(140);
+	m_histogram->yAxis->setLabel("Stalls");
+	m_histogram->xAxis->setLabel("Duration");
+	m_histogram->xAxis->grid()->setVisible(false);
+	m_bars = new QCPBars(m_histogram->xAxis, m_histogram->yAxis);
+	m_bars->setWidth(0.7);
+	m_bars->setPen(Qt::NoPen);
+	m_bars->setBrush(QColor(42, 130, 218));
+	layout->addWidget(m_histogram);
+
+	m_table = new QTableWidget(0, 4, this);
+	m_table->setHorizontalHeaderLabels({"Operation", "Stalls", "Total", "Worst"});
+	m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+	m_table->verticalHeader()->setVisible(false);
+	m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	m_table->setSelectionMode(QAbstractItemView::NoSelection);
+	layout->addWidget(m_table, 1);
+}
+
+void StallPanel::showStalls(const QVector<StallWatchdog::Stall>& stalls, int thresholdMs, const QString& logPath)
+{
+	QString summary;
+	if (thresholdMs <= 0) {
+		summary = "Stall watchdog is off (--stall-threshold 0).";
+	} else {
+		qint64 totalMs = 0;
+		for (const StallWatchdog::Stall& stall : stalls) totalMs += stall.durationMs;
+		summary = QString("%1 stall(s) over %2 ms this session, %3 blocked in total.")
+					  .arg(stalls.size()).arg(thresholdMs).arg(formatMs(totalMs));
+		if (!logPath.isEmpty()) summary += QString("<br>Log: %1").arg(logPath.toHtmlEscaped());
+	}
+	m_summaryLabel->setText(summary);
+
+	// Histogram: [threshold, limit0), [limit0, limit1), ..., [last limit, inf)
+	const QVector<qint64> limits = StallWatchdog::bucketLimits();
+	QVector<double> keys(limits.size() + 1), counts(limits.size() + 1, 0.0);
+	QSharedPointer<QCPAxisTickerText> ticker(new QCPAxisTickerText);
+	qint64 lower = thresholdMs;
+	for (int i = 0; i <= limits.size(); ++i) {
+		keys[i] = i;
+		ticker->addTick(i, i < limits.size() ? QString("%1-%2").arg(formatMs(lower), formatMs(limits[i])) : QString(">%1").arg(formatMs(lower)));
+		if (i < limits.size()) lower = limits[i];
+	}
+	for (const StallWatchdog::Stall& stall : stalls) {
+		const int bucket = int(std::upper_bound(limits.begin(), limits.end(), stall.durationMs) - limits.begin());
+		counts[bucket] += 1.0;
+	}
+	m_bars->setData(keys, counts, true);
+	m_histogram->xAxis->setTicker(ticker);
+	m_histogram->xAxis->setRange(-0.6, limits.size() + 0.6);
+	m_histogram->yAxis->setRange(0, qMax(1.0, *std::max_element(counts.begin(), counts.end())) * 1.1);
+
+	// Follow the widget palette so the panel matches the application theme
+	const QPalette& pal = palette();
+	m_histogram->setBackground(pal.base());
+	for (QCPAxis* axis : {m_histogram->xAxis, m_histogram->yAxis}) {
+		axis->setBasePen(QPen(pal.text().color()));
+		axis->setTickPen(QPen(pal.text().color()));
+		axis->setSubTickPen(QPen(pal.text().color()));
+		axis->setTickLabelColor(pal.text().color());
+		axis->setLabelColor(pal.text().color());
+	}
+	m_histogram->replot();
+
+	// Per operation, the largest total blocking time first
+	struct OperationStats {
+		QString name;
+		int count = 0;
+		qint64 totalMs = 0;
+		qint64 worstMs = 0;
+		int worstDatasets = 0;
+		qint64 worstPoints = 0;
+	};
+	QHash<QString, int> indexOf;
+	QVector<OperationStats> operations;
+	for (const StallWatchdog::Stall& stall : stalls) {
+		const QString name = stall.operation.isEmpty() ? QString("(not instrumented)") : stall.operation;
+		auto it = indexOf.find(name);
+		if (it == indexOf.end()) {
+			it = indexOf.insert(name, operations.size());
+			operations.append(OperationStats());
+			operations.last().name = name;
+		}
+		OperationStats& stats = operations[it.value()];
+		stats.count++;
+		stats.totalMs += stall.durationMs;
+		if (stall.durationMs >= stats.worstMs) {
+			stats.worstMs = stall.durationMs;
+			stats.worstDatasets = stall.datasets;
+			stats.worstPoints = stall.points;
+		}
+	}
+	std::sort(operations.begin(), operations.end(), [](const OperationStats& a, const OperationStats& b) {
+		return a.totalMs > b.totalMs;
+	});
+
+	m_table->setRowCount(operations.size());
+	for (int row = 0; row < operations.size(); ++row) {
+		const OperationStats& stats = operations[row];
+		QString worst = formatMs(stats.worstMs);
+		if (stats.worstPoints > 0) {
+			worst += QString(" (%1 dataset(s), %2 points)").arg(stats.worstDatasets).arg(stats.worstPoints);
+		}
+		const QString cells[] = {stats.name, QString::number(stats.count), formatMs(stats.totalMs), worst};
+		for (int column = 0; column < 4; ++column) {
+			QTableWidgetItem* item = m_table->item(row, column);
+			if (!item) {
+				item = new QTableWidgetItem();
+				if (column > 0) item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+				m_table->setItem(row, column, item);
+			}
+			item->setText(cells[column]);
+		}
+	}
+}
@@ -0,0 +1,55 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef STALLPANEL_H
+#define STALLPANEL_H
+
+#include <QVector>
+#include <QWidget>
+
+#include "stallwatchdog.h"
+
+class QCPBars;
+class QCustomPlot;
+class QLabel;
+class QTableWidget;
+
+// GUI stall diagnostics: duration histogram and the operations that blocked the event loop
+class StallPanel : public QWidget
+{
+	Q_OBJECT
+public:
+	explicit StallPanel(QWidget* parent = nullptr);
+
+	void showStalls(const QVector<StallWatchdog::Stall>& stalls, int thresholdMs, const QString& logPath);
+
+private:
+	QLabel* m_summaryLabel = nullptr;
+	QCustomPlot* m_histogram = nullptr;
+	QCPBars* m_bars = nullptr;
+	QTableWidget* m_table = nullptr;
+};
+
+#endif // STALLPANEL_H
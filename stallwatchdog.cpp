@@ -0,0 +1,221 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "stallwatchdog.h"
+#include "constants.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+
+StallWatchdog::Scope::Scope(const char* name, int datasets, qint64 points)
+{
+	StallWatchdog& watchdog = StallWatchdog::instance();
+	QMutexLocker locker(&watchdog.m_operationMutex);
+	m_depth = watchdog.m_depth++;
+	if (m_depth < MaxDepth) {
+		watchdog.m_operations[m_depth] = {name, datasets, points};
+	}
+}
+
+StallWatchdog::Scope::~Scope()
+{
+	StallWatchdog& watchdog = StallWatchdog::instance();
+	QMutexLocker locker(&watchdog.m_operationMutex);
+	watchdog.m_depth = m_depth;
+}
+
+void StallWatchdog::Scope::setSize(int datasets, qint64 points)
+{
+	if (m_depth >= MaxDepth) return;
+	StallWatchdog& watchdog = StallWatchdog::instance();
+	QMutexLocker locker(&watchdog.m_operationMutex);
+	watchdog.m_operations[m_depth].datasets = datasets;
+	watchdog.m_operations[m_depth].points = points;
+}
+
+StallWatchdog& StallWatchdog::instance()
+{
+	static StallWatchdog watchdog;
+	return watchdog;
+}
+
+StallWatchdog::~StallWatchdog()
+{
+	stop();
+}
+
+void StallWatchdog::start(int thresholdMs, const QString& logPath)
+{
+	stop();
+	if (thresholdMs <= 0) return;
+	m_thresholdMs = thresholdMs;
+	m_logPath = logPath;
+	if (!m_logPath.isEmpty()) {
+		QDir().mkpath(QFileInfo(m_logPath).absolutePath());
+	}
+
+	m_clock.start();
+	m_lastBeatMs.store(-1, std::memory_order_relaxed);
+	if (!m_heartbeat) {
+		m_heartbeat = new QTimer(this);
+		m_heartbeat->setTimerType(Qt::PreciseTimer);
+		m_heartbeat->setInterval(Constants::STALL_HEARTBEAT_MS);
+		connect(m_heartbeat, &QTimer::timeout, this, [this]() {
+			m_lastBeatMs.store(m_clock.elapsed(), std::memory_order_release);
+		});
+		// The static instance outlives QApplication, the thread must not
+		connect(qApp, &QCoreApplication::aboutToQuit, this, &StallWatchdog::stop);
+	}
+	m_heartbeat->start();
+
+	m_stopRequested.store(false, std::memory_order_release);
+	m_thread = QThread::create([this]() { run(); });
+	m_thread->setObjectName("StallWatchdog");
+	m_thread->start();
+}
+
+void StallWatchdog::stop()
+{
+	if (!m_thread) return;
+	m_stopRequested.store(true, std::memory_order_release);
+	m_thread->wait();
+	delete m_thread;
+	m_thread = nullptr;
+	m_heartbeat->stop();
+}
+
+QVector<StallWatchdog::Stall> StallWatchdog::stalls() const
+{
+	QMutexLocker locker(&m_stallMutex);
+	return m_stalls;
+}
+
+QVector<qint64> StallWatchdog::bucketLimits()
+{
+	return {500, 1000, 2000, 5000, 10000};
+}
+
+void StallWatchdog::run()
+{
+	const qint64 heartbeatMs = Constants::STALL_HEARTBEAT_MS;
+	bool stalled = false;
+	bool attributed = false;
+	qint64 stallBeatMs = 0;
+	Stall stall;
+	while (!m_stopRequested.load(std::memory_order_acquire)) {
+		QThread::msleep(Constants::STALL_POLL_MS);
+		const qint64 beatMs = m_lastBeatMs.load(std::memory_order_acquire);
+		if (beatMs < 0) continue; // Event loop not running yet, startup has StartupProfiler
+
+		if (!stalled) {
+			// The next beat was due heartbeatMs after the last one
+			const qint64 lateMs = m_clock.elapsed() - beatMs - heartbeatMs;
+			if (lateMs < m_thresholdMs) continue;
+			stalled = true;
+			stallBeatMs = beatMs;
+			stall = Stall();
+			stall.startedAt = QDateTime::currentDateTime().addMSecs(-lateMs);
+			attributed = captureOperations(&stall);
+		} else if (beatMs != stallBeatMs) {
+			stall.durationMs = beatMs - stallBeatMs - heartbeatMs;
+			record(stall);
+			stalled = false;
+		} else if (!attributed) {
+			// Started in uninstrumented code, maybe an instrumented operation follows
+			attributed = captureOperations(&stall);
+		}
+	}
+}
+
+bool StallWatchdog::captureOperations(Stall* stall) const
+{
+	QMutexLocker locker(&m_operationMutex);
+	if (m_depth == 0) return false;
+	QStringList names;
+	for (int i = 0; i < qMin(m_depth, int(MaxDepth)); ++i) {
+		const ActiveOperation& operation = m_operations[i];
+		names << QString::fromLatin1(operation.name);
+		if (operation.datasets > 0 || operation.points > 0) {
+			stall->datasets = operation.datasets;
+			stall->points = operation.points;
+		}
+	}
+	if (m_depth > MaxDepth) names << "...";
+	stall->operation = names.join(" > ");
+	return true;
+}
+
+void StallWatchdog::record(const Stall& stall)
+{
+	qWarning().noquote() << QString("GUI stalled for %1 ms in %2 (%3 dataset(s), %4 points)")
+								.arg(stall.durationMs)
+								.arg(stall.operation.isEmpty() ? QString("uninstrumented code") : stall.operation)
+								.arg(stall.datasets).arg(stall.points);
+	{
+		QMutexLocker locker(&m_stallMutex);
+		m_stalls.append(stall);
+		if (m_stalls.size() > Constants::STALL_HISTORY_SIZE) {
+			m_stalls.remove(0, m_stalls.size() - Constants::STALL_HISTORY_SIZE);
+		}
+	}
+	appendToLog(stall); // On this thread, the GUI thread must not wait for the disk
+	QMetaObject::invokeMethod(this, [this]() { emit stallRecorded(); }, Qt::QueuedConnection);
+}
+
+// One tab separated line per stall: start time, duration ms, operation, datasets, points.
+// Above STALL_LOG_MAX_BYTES the log becomes .1, .1 becomes .2 and so on; the oldest is dropped.
+void StallWatchdog::appendToLog(const Stall& stall)
+{
+	if (m_logPath.isEmpty()) return;
+
+	if (QFileInfo(m_logPath).size() >= Constants::STALL_LOG_MAX_BYTES) {
+		auto rotated = [this](int index) { return m_logPath + "." + QString::number(index); };
+		QFile::remove(rotated(Constants::STALL_LOG_FILES - 1));
+		for (int index = Constants::STALL_LOG_FILES - 1; index > 1; --index) {
+			QFile::rename(rotated(index - 1), rotated(index));
+		}
+		QFile::rename(m_logPath, rotated(1));
+	}
+
+	QFile file(m_logPath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+		qWarning() << "Could not write stall log" << m_logPath << ":" << file.errorString();
+		return;
+	}
+	const QString line = QString("%1\t%2\t%3\t%4\t%5\n")
+							 .arg(stall.startedAt.toString(Qt::ISODateWithMs))
+							 .arg(stall.durationMs)
+							 .arg(stall.operation.isEmpty() ? QString("-") : stall.operation)
+							 .arg(stall.datasets)
+							 .arg(stall.points);
+	file.write(line.toUtf8());
+}
@@ -0,0 +1,126 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+class QThread;
+class QTimer;
+
+/*
+ * Detects GUI event loop stalls and reports which operation caused them.
+ *
+ * A timer in the GUI thread stamps a heartbeat; a watchdog thread checks that the
+ * heartbeat keeps coming. When it is late by more than the threshold, the stack
+ * of instrumented operations (StallWatchdog::Scope) active at that moment is
+ * captured. Once the event loop is responsive again the stall is recorded with
+ * its duration, kept for the diagnostics panel and appended to a rotating log.
+ * The duration resolution is the heartbeat interval.
+ *
+ * Scopes must only be opened in the GUI thread; everything else is thread safe.
+ */
+class StallWatchdog : public QObject
+{
+	Q_OBJECT
+public:
+	struct Stall {
+		QDateTime startedAt;
+		qint64 durationMs = 0;
+		QString operation; // Outermost first, e.g. "loadData > updatePlot"; empty when nothing instrumented was running
+		int datasets = 0; // Size of the innermost operation that reported one
+		qint64 points = 0;
+	};
+
+	// Marks an instrumented operation for the lifetime of the scope.
+	// name must point to a string literal. Cheap enough for every replot.
+	class Scope
+	{
+	public:
+		explicit Scope(const char* name, int datasets = 0, qint64 points = 0);
+		~Scope();
+		void setSize(int datasets, qint64 points); // Once known, e.g. after parsing
+	private:
+		Q_DISABLE_COPY(Scope)
+		int m_depth;
+	};
+
+	static StallWatchdog& instance();
+
+	// GUI thread. Stalls longer than thresholdMs are recorded, 0 leaves the watchdog off.
+	// logPath may be empty to keep stalls in memory only.
+	void start(int thresholdMs, const QString& logPath);
+	void stop();
+	bool isRunning() const { return m_thread != nullptr; }
+	int thresholdMs() const { return m_thresholdMs; }
+	QString logPath() const { return m_logPath; }
+
+	QVector<Stall> stalls() const; // This session, oldest first, at most Constants::STALL_HISTORY_SIZE
+	static QVector<qint64> bucketLimits(); // Histogram bucket upper bounds in ms, one more open-ended bucket follows
+
+signals:
+	void stallRecorded(); // GUI thread, after the event loop recovered
+
+private:
+	StallWatchdog() = default;
+	~StallWatchdog() override;
+
+	struct ActiveOperation {
+		const char* name = nullptr;
+		int datasets = 0;
+		qint64 points = 0;
+	};
+	static constexpr int MaxDepth = 16; // Deeper scopes are counted but not named
+
+	void run();
+	bool captureOperations(Stall* stall) const;
+	void record(const Stall& stall);
+	void appendToLog(const Stall& stall);
+
+	mutable QMutex m_operationMutex;
+	ActiveOperation m_operations[MaxDepth];
+	int m_depth = 0;
+
+	QElapsedTimer m_clock;
+	QTimer* m_heartbeat = nullptr;
+	QThread* m_thread = nullptr;
+	std::atomic<qint64> m_lastBeatMs{-1}; // -1 until the event loop runs
+	std::atomic<bool> m_stopRequested{false};
+	int m_thresholdMs = 0;
+	QString m_logPath;
+
+	mutable QMutex m_stallMutex;
+	QVector<Stall> m_stalls;
+};
+
+#endif // STALLWATCHDOG_H
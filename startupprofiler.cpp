@@ -0,0 +1,89 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "startupprofiler.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+
+#include <utility>
+
+namespace {
+
+struct StartupMark {
+	const char* stage;
+	qint64 elapsedNs;
+};
+
+QElapsedTimer& startupTimer()
+{
+	static QElapsedTimer timer;
+	return timer;
+}
+
+QVector<StartupMark>& startupMarks()
+{
+	static QVector<StartupMark> marks;
+	return marks;
+}
+
+} // namespace
+
+namespace StartupProfiler {
+
+void start()
+{
+	startupMarks().clear();
+	startupMarks().reserve(16);
+	startupTimer().start();
+}
+
+void mark(const char* stage)
+{
+	if (!startupTimer().isValid()) return;
+	startupMarks().append({stage, startupTimer().nsecsElapsed()});
+}
+
+bool isRunning()
+{
+	return startupTimer().isValid();
+}
+
+QString report()
+{
+	QString text = QStringLiteral("Startup timing:\n");
+	qint64 previousNs = 0;
+	for (const StartupMark& m : std::as_const(startupMarks())) {
+		text += QString("  %1 %2 ms (+%3 ms)\n")
+					.arg(QString::fromLatin1(m.stage), -28)
+					.arg(m.elapsedNs / 1e6, 8, 'f', 2)
+					.arg((m.elapsedNs - previousNs) / 1e6, 0, 'f', 2);
+		previousNs = m.elapsedNs;
+	}
+	text += QString("  %1 %2 ms").arg(QStringLiteral("total"), -28).arg(previousNs / 1e6, 8, 'f', 2);
+	return text;
+}
+
+} // namespace StartupProfiler
@@ -0,0 +1,27 @@
+# Unit tests of libpnacore (QtTest), plus the workspace snapshot format, which needs
+# QtGui for QColor only. Built with pna_qt.pro; run them with
+#   make check
+QT = core gui testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_pnacore
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+win32:CONFIG(release, debug|release): PNACORE_DIR = $$OUT_PWD/../core/release
+else:win32:CONFIG(debug, debug|release): PNACORE_DIR = $$OUT_PWD/../core/debug
+else: PNACORE_DIR = $$OUT_PWD/../core
+LIBS += -L$$PNACORE_DIR -lpnacore
+zstd: LIBS += -lzstd
+win32-msvc*: PRE_TARGETDEPS += $$PNACORE_DIR/pnacore.lib
+else: PRE_TARGETDEPS += $$PNACORE_DIR/libpnacore.a
+
+SOURCES += \
+    tst_pnacore.cpp \
+    ../workspace.cpp
+
+HEADERS += \
+    ../workspace.h
@@ -0,0 +1,1307 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+// Unit tests of libpnacore: the stream parser and its number fast path, filters,
+// spur removal, spot and integrated noise, mask checks, sweep stitching, gzip
+// input and pack archives. Also the workspace snapshot, the one GUI-side file
+// format, which only needs QtGui for its colors.
+
+#include "batchprocessor.h"
+#include "compressedinput.h"
+#include "datasetcache.h"
+#include "datasetparser.h"
+#include "derivedpipeline.h"
+#include "mappedcolumnfile.h"
+#include "packfile.h"
+#include "processing.h"
+#include "spscringbuffer.h"
+#include "utils.h"
+#include "workspace.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QtEndian>
+#include <QtTest>
+#include <algorithm>
+#include <atomic>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+
+namespace {
+
+constexpr int RandomNumbers = 200000; // corebench checks 2M
+
+ParsedDataset parseText(const QByteArray& text, int chunkSize = 0)
+{
+	DatasetParser::StreamParser parser;
+	if (chunkSize <= 0) chunkSize = text.size();
+	for (int i = 0; i < text.size(); i += chunkSize) {
+		parser.feed(text.constData() + i, qMin(chunkSize, text.size() - i));
+	}
+	parser.finish();
+	ParsedDataset parsed;
+	parser.takeSweep(&parsed);
+	return parsed;
+}
+
+bool sameBits(double a, double b)
+{
+	return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+bool sameColumn(const QVector<double>& a, const QVector<double>& b)
+{
+	if (a.size() != b.size()) return false;
+	for (int i = 0; i < a.size(); ++i) {
+		if (!sameBits(a[i], b[i])) return false;
+	}
+	return true;
+}
+
+ParsedDataset makeDataset(const QVector<double>& frequency, const QVector<double>& noise)
+{
+	ParsedDataset data;
+	data.frequencyOffset = frequency;
+	data.phaseNoise = noise;
+	data.referenceNoise = QVector<double>(frequency.size(), std::numeric_limits<double>::quiet_NaN());
+	return data;
+}
+
+QVector<double> logSweep(double from, double to, int points)
+{
+	QVector<double> frequency(points);
+	for (int i = 0; i < points; ++i) {
+		frequency[i] = from * std::pow(to / from, double(i) / (points - 1));
+	}
+	return frequency;
+}
+
+// A capture with a reference column, decade points 1 Hz .. 1 MHz
+QByteArray captureText(int points)
+{
+	QByteArray text = "# Frequency,Measured,Reference\n";
+	const QVector<double> frequency = logSweep(1.0, 1e6, points);
+	for (int i = 0; i < points; ++i) {
+		text += QByteArray::number(frequency[i], 'g', 12) + "," + QByteArray::number(-80.0 - 10.0 * std::log10(frequency[i]), 'f', 3)
+				+ ",-170\n";
+	}
+	return text;
+}
+
+quint32 crc32(const QByteArray& data)
+{
+	quint32 crc = 0xffffffffu;
+	for (const char c : data) {
+		crc ^= quint8(c);
+		for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1u)));
+	}
+	return crc ^ 0xffffffffu;
+}
+
+// gzip member around the raw deflate stream of qCompress (zlib: 4 byte size, 2 byte header, 4 byte Adler-32)
+QByteArray gzipMember(const QByteArray& data, bool corruptCrc = false)
+{
+	const QByteArray zlib = qCompress(data, 9);
+	QByteArray member("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+	member += zlib.mid(6, zlib.size() - 10);
+	uchar trailer[8];
+	qToLittleEndian<quint32>(crc32(data) ^ (corruptCrc ? 1u : 0u), trailer);
+	qToLittleEndian<quint32>(quint32(data.size()), trailer + 4);
+	member += QByteArray(reinterpret_cast<const char*>(trailer), 8);
+	return member;
+}
+
+bool writeFile(const QString& path, const QByteArray& data)
+{
+	QFile file(path);
+	return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+QStringList readLines(const QString& path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return QStringList();
+	return QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts);
+}
+
+} // namespace
+
+class PnaCoreTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	// Parser
+	void parserChunkBoundaries();
+	void parserColumnsAndComments();
+	void parserSkipsBadLines();
+	void parserByteOrderMark();
+	void parserRejectsUtf16();
+	void numberFastPath_data();
+	void numberFastPath();
+	void numberFastPathRandom();
+
+	// Parse cache
+	void cacheContentMatch();
+	void cacheDropsStaleEntry();
+
+	// Formatting
+	void appendFixedIgnoresLocale();
+
+	// Processing
+	void filtersKeepConstantData();
+	void medianFilterRemovesOutlier();
+	void spurRemoval();
+	void spotNoise();
+	void integratedNoise();
+	void maskCheck();
+	void compactColumnRoundTrip();
+	void compactKernelsMatchDecoded();
+	void derivedPipelineSupersedes();
+	void derivedPipelineCancel();
+
+	// Sweep stitching
+	void stitchDescendingSweeps();
+	void stitchOverlapLaterWins();
+	void stitchOverlapAveragePower();
+	void stitchDecadeSegments();
+	void stitchUnorderedRows();
+
+	// Compressed input
+	void gzipInflate();
+	void gzipMultipleMembers();
+	void gzipCorruptCrc();
+
+	// Pack archives
+	void packRoundTrip();
+	void packAppendKeepsOldIndex();
+	void packCompact();
+	void packExtractNames();
+	void packCorruptIndex();
+
+	// Column files
+	void columnFileRoundTrip();
+	void columnFileCorruptHeader();
+	void columnFileConvertCsv();
+
+	// Batch processing
+	void batchShardsMatchSingleRun();
+
+	// Ring buffer
+	void ringBufferWrapAndFull();
+	void ringBufferTwoThreads();
+
+	// Workspace snapshot
+	void workspaceRoundTrip();
+
+private:
+	QTemporaryDir m_dir;
+};
+
+void PnaCoreTest::initTestCase()
+{
+	QVERIFY(m_dir.isValid());
+	std::setlocale(LC_NUMERIC, "C"); // strtod as the reference
+}
+
+// --- Parser ---
+
+void PnaCoreTest::parserChunkBoundaries()
+{
+	const QByteArray text = captureText(500);
+	const ParsedDataset whole = parseText(text);
+	QCOMPARE(whole.frequencyOffset.size(), 500);
+	for (int chunk : {1, 2, 3, 7, 64, 4096}) {
+		const ParsedDataset chunked = parseText(text, chunk);
+		QVERIFY(sameColumn(chunked.frequencyOffset, whole.frequencyOffset));
+		QVERIFY(sameColumn(chunked.phaseNoise, whole.phaseNoise));
+		QVERIFY(sameColumn(chunked.referenceNoise, whole.referenceNoise));
+	}
+}
+
+void PnaCoreTest::parserColumnsAndComments()
+{
+	const ParsedDataset withReference = parseText("# comment\n; comment\n\n10, -100, -150\r\n100\t-110\t-160\n1000 -120 -170");
+	QVERIFY(withReference.hasReferenceData);
+	QCOMPARE(withReference.frequencyOffset, QVector<double>({10.0, 100.0, 1000.0}));
+	QCOMPARE(withReference.phaseNoise, QVector<double>({-100.0, -110.0, -120.0}));
+	QCOMPARE(withReference.referenceNoise, QVector<double>({-150.0, -160.0, -170.0}));
+
+	const ParsedDataset measuredOnly = parseText("10,-100\n100,-110\n");
+	QVERIFY(!measuredOnly.hasReferenceData);
+	QCOMPARE(measuredOnly.frequencyOffset.size(), 2);
+	QVERIFY(std::isnan(measuredOnly.referenceNoise[0]));
+}
+
+void PnaCoreTest::parserSkipsBadLines()
+{
+	DatasetParser::StreamParser parser;
+	const QByteArray text = "10,-100\nfrequency,noise\n0,-100\n-5,-100\n20\n30,-110\n";
+	parser.feed(text.constData(), text.size());
+	parser.finish();
+	ParsedDataset parsed;
+	QVERIFY(parser.takeSweep(&parsed));
+	QCOMPARE(parsed.frequencyOffset, QVector<double>({10.0, 30.0}));
+	QCOMPARE(parser.skippedLines(), qint64(4));
+	QCOMPARE(parser.lineCount(), qint64(6));
+}
+
+void PnaCoreTest::parserByteOrderMark()
+{
+	const QByteArray text = "\xEF\xBB\xBF" "10,-100\n100,-110\n";
+	for (int chunk : {1, 2, 4, 0}) {
+		const ParsedDataset parsed = parseText(text, chunk);
+		QCOMPARE(parsed.frequencyOffset, QVector<double>({10.0, 100.0}));
+	}
+	QCOMPARE(parseText("\xEF\xBB\xBF" "5,-1").frequencyOffset, QVector<double>({5.0}));
+	QCOMPARE(parseText("7\n").frequencyOffset.size(), 0); // Shorter than a byte order mark, still parsed (and skipped)
+	QCOMPARE(parseText("1,2").frequencyOffset, QVector<double>({1.0}));
+}
+
+void PnaCoreTest::parserRejectsUtf16()
+{
+	for (const QByteArray& mark : {QByteArray("\xFF\xFE", 2), QByteArray("\xFE\xFF", 2)}) {
+		DatasetParser::StreamParser parser;
+		const QByteArray text = mark + QByteArray("1\0,\0-\0001\0\n\0", 10);
+		parser.feed(text.constData(), text.size());
+		parser.finish();
+		QVERIFY(!parser.errorString().isEmpty());
+		QVERIFY(!parser.hasSweep());
+	}
+
+	const QString path = m_dir.filePath("utf16.csv");
+	QVERIFY(writeFile(path, QByteArray("\xFF\xFE" "1\0,\0-\0001\0\n\0", 12)));
+	ParsedDataset parsed;
+	QString errorString;
+	QVERIFY(!DatasetParser::parseFile(path, &parsed, &errorString));
+	QVERIFY(errorString.contains("UTF-16"));
+}
+
+void PnaCoreTest::numberFastPath_data()
+{
+	QTest::addColumn<QByteArray>("number");
+	for (const char* number : {"0", "-0", "+1", "1.", ".5", "0.1", "-170.000", "1e-22", "1e22", "123456789012345",
+							   "1234567890123456", "12345678901234567890", "0.30000000000000004", "9007199254740993",
+							   "1.7976931348623157e308", "1e-23", "1e23", "2.2250738585072014e-308",
+							   "6.02214076E+23", "1e0010", "0.000000000000000000000001", "3.14159265358979323846"}) {
+		QTest::newRow(number) << QByteArray(number);
+	}
+}
+
+void PnaCoreTest::numberFastPath()
+{
+	QFETCH(QByteArray, number);
+	const ParsedDataset parsed = parseText("1," + number + "\n");
+	QCOMPARE(parsed.phaseNoise.size(), 1);
+	QVERIFY2(sameBits(parsed.phaseNoise[0], std::strtod(number.constData(), nullptr)), number.constData());
+}
+
+void PnaCoreTest::numberFastPathRandom()
+{
+	std::mt19937_64 random(7);
+	std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+	std::uniform_int_distribution<int> exponent(-30, 30);
+	std::uniform_int_distribution<int> digits(1, 17);
+	QByteArray text;
+	QVector<double> expected;
+	expected.reserve(RandomNumbers);
+	char number[64];
+	for (int i = 0; i < RandomNumbers; ++i) {
+		const double value = mantissa(random) * std::pow(10.0, exponent(random));
+		switch (i % 3) {
+		case 0: std::snprintf(number, sizeof(number), "%.*g", digits(random), value); break;
+		case 1: std::snprintf(number, sizeof(number), "%.*f", digits(random) % 10, value); break;
+		default: std::snprintf(number, sizeof(number), "%.*e", digits(random), value); break;
+		}
+		expected.append(std::strtod(number, nullptr));
+		text += "1,";
+		text += number;
+		text += '\n';
+	}
+	const ParsedDataset parsed = parseText(text);
+	QVERIFY(sameColumn(parsed.phaseNoise, expected));
+}
+
+// --- Parse cache ---
+
+void PnaCoreTest::cacheContentMatch()
+{
+	DatasetCache& cache = DatasetCache::instance();
+	cache.clear();
+	const DatasetCache::Stats before = cache.stats();
+	const QString first = m_dir.filePath("cache_a.csv");
+	const QString copy = m_dir.filePath("cache_b.csv");
+	QVERIFY(writeFile(first, captureText(300)));
+	QVERIFY(writeFile(copy, captureText(300)));
+
+	const QSharedPointer<const ParsedDataset> parsed = cache.load(first);
+	QVERIFY(parsed);
+	QCOMPARE(cache.load(first), parsed); // Size and timestamp match
+	QCOMPARE(cache.load(copy), parsed);  // Other path, same contents: shared, not parsed again
+
+	const DatasetCache::Stats after = cache.stats();
+	QCOMPARE(after.misses - before.misses, 1);
+	QCOMPARE(after.hits - before.hits, 2);
+	QCOMPARE(after.hashHits - before.hashHits, 1);
+	QCOMPARE(after.entries, 2);
+}
+
+void PnaCoreTest::cacheDropsStaleEntry()
+{
+	DatasetCache& cache = DatasetCache::instance();
+	cache.clear();
+	const QString path = m_dir.filePath("cache_stale.csv");
+	QVERIFY(writeFile(path, captureText(300)));
+	QVERIFY(cache.load(path));
+	const qint64 bytes = cache.stats().bytes;
+
+	// Rewritten with other contents that no longer parse: the old entry must not survive
+	QVERIFY(writeFile(path, QByteArray("not a capture\n")));
+	QVERIFY(!cache.load(path));
+	QCOMPARE(cache.stats().entries, 0);
+	QVERIFY(cache.stats().bytes < bytes);
+	QCOMPARE(cache.stats().bytes, qint64(0));
+}
+
+// --- Formatting ---
+
+void PnaCoreTest::appendFixedIgnoresLocale()
+{
+	// The GUI sets the C locale from the environment; a decimal comma must not reach the text
+	bool commaLocale = false;
+	for (const char* name : {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "German_Germany.1252"}) {
+		if (std::setlocale(LC_NUMERIC, name)) {
+			commaLocale = true;
+			break;
+		}
+	}
+	QString text;
+	Utils::appendFixed(text, -123.456, 2);
+	text += ' ';
+	Utils::appendFixed(text, 1.5, 3);
+	text += ' ';
+	Utils::appendFrequencyValue(text, 2500.0);
+	std::setlocale(LC_NUMERIC, "C");
+	QCOMPARE(text, QString("-123.46 1.500 2.50 kHz"));
+
+	text.clear();
+	Utils::appendFixed(text, 1e300, 2); // Longer than the stack buffer
+	QCOMPARE(text, QString::number(1e300, 'f', 2));
+	if (!commaLocale) QSKIP("No decimal comma locale installed, checked in the C locale only");
+}
+
+// --- Processing ---
+
+void PnaCoreTest::filtersKeepConstantData()
+{
+	for (const QString& filter : Processing::filterTypes()) {
+		DatasetColumns data;
+		data.frequencyOffset = logSweep(1.0, 1e6, 101);
+		data.phaseNoise = QVector<double>(101, -120.0);
+		data.referenceNoise = QVector<double>(101, -170.0);
+		Processing::filterDataset(data, true, filter, 11);
+		QCOMPARE(data.phaseNoiseFiltered.size(), 101);
+		QCOMPARE(data.referenceNoiseFiltered.size(), 101);
+		for (int i = 0; i < 101; ++i) {
+			QVERIFY2(qAbs(data.phaseNoiseFiltered[i] + 120.0) < 1e-9, qPrintable(filter));
+			QVERIFY2(qAbs(data.referenceNoiseFiltered[i] + 170.0) < 1e-9, qPrintable(filter));
+		}
+	}
+}
+
+void PnaCoreTest::medianFilterRemovesOutlier()
+{
+	DatasetColumns data;
+	data.frequencyOffset = logSweep(1.0, 1e6, 51);
+	data.phaseNoise = QVector<double>(51, -120.0);
+	data.phaseNoise[25] = -60.0;
+	data.referenceNoise = data.phaseNoise;
+	Processing::filterDataset(data, false, "Median Filter", 5);
+	QCOMPARE(data.phaseNoiseFiltered[25], -120.0);
+}
+
+void PnaCoreTest::spurRemoval()
+{
+	const QVector<double> frequency = logSweep(10.0, 1e6, 200);
+	QVector<double> measured(200);
+	for (int i = 0; i < 200; ++i) measured[i] = -100.0 - 0.1 * i;
+	QVector<double> reference(200, -170.0);
+	measured[100] = -70.0; // Spur on both
+	reference[100] = -140.0;
+
+	const QVector<double> cleaned = Processing::removeSpurs(frequency, measured, reference);
+	QCOMPARE(cleaned.size(), 200);
+	QVERIFY(cleaned[100] < measured[99] && cleaned[100] > measured[101]); // Interpolated between the neighbours
+	for (int i = 0; i < 200; ++i) {
+		if (i != 100) QCOMPARE(cleaned[i], measured[i]);
+	}
+
+	// Without spurs the measurement is returned unchanged
+	QCOMPARE(Processing::removeSpurs(frequency, measured, QVector<double>(200, -170.0)), measured);
+}
+
+void PnaCoreTest::spotNoise()
+{
+	const QVector<double> frequency = logSweep(1.0, 1e6, 601); // 100 points per decade: every decade exactly
+	QVector<double> noise(frequency.size());
+	for (int i = 0; i < noise.size(); ++i) noise[i] = -80.0 - 10.0 * std::log10(frequency[i]);
+
+	const QVector<SpotNoisePoint> spots = Processing::spotNoise(frequency, noise, 0.0, 1e12);
+	QCOMPARE(spots.size(), 7); // 1 Hz .. 1 MHz; 0.1 Hz and 10 MHz are too far from the data
+	for (const SpotNoisePoint& spot : spots) {
+		QVERIFY(qAbs(spot.frequency / spot.targetFrequency - 1.0) < 1e-9);
+		QVERIFY(qAbs(spot.noise - (-80.0 - 10.0 * std::log10(spot.targetFrequency))) < 1e-9);
+	}
+	QCOMPARE(Processing::spotNoise(frequency, noise, 100.0, 1000.0).size(), 2);
+}
+
+void PnaCoreTest::integratedNoise()
+{
+	// Flat -100 dBc/Hz over 1 kHz .. 10 kHz: 1e-10 * 9000
+	const QVector<double> frequency = logSweep(1e3, 1e4, 11);
+	const QVector<double> noise(11, -100.0);
+	const IntegratedNoise integrated = Processing::integrateNoise(frequency, noise, 0.0, 1e9);
+	QVERIFY(integrated.valid);
+	QCOMPARE(integrated.from, 1e3);
+	QCOMPARE(integrated.to, 1e4);
+	QVERIFY(qAbs(integrated.integratedDbc - 10.0 * std::log10(9e-7)) < 1e-9);
+	QVERIFY(qAbs(integrated.rmsPhaseRad - std::sqrt(2.0 * 9e-7)) < 1e-12);
+	QVERIFY(qAbs(Processing::rmsJitter(integrated, 1e8) - integrated.rmsPhaseRad / (2.0 * M_PI * 1e8)) < 1e-24);
+
+	QVERIFY(!Processing::integrateNoise(frequency, noise, 5.0, 5.0).valid);
+}
+
+void PnaCoreTest::maskCheck()
+{
+	const QVector<double> frequency = {10.0, 100.0, 1000.0, 10000.0};
+	const QVector<double> noise = {-95.0, -105.0, -98.0, -125.0};
+	const QVector<MaskPoint> mask = {{10.0, -90.0}, {10000.0, -120.0}}; // -10 dB per decade: -110 at 1 kHz
+
+	const MaskVerdict fail = Processing::checkMask(frequency, noise, mask);
+	QVERIFY(fail.checked);
+	QVERIFY(!fail.pass);
+	QVERIFY(qAbs(fail.worstMargin + 12.0) < 1e-9);
+	QCOMPARE(fail.worstFrequency, 1000.0);
+
+	const MaskVerdict pass = Processing::checkMask(frequency, noise, {{10.0, -80.0}, {10000.0, -110.0}});
+	QVERIFY(pass.checked && pass.pass);
+
+	const MaskVerdict outside = Processing::checkMask(frequency, noise, {{1e6, -150.0}, {1e7, -150.0}});
+	QVERIFY(!outside.checked && outside.pass);
+}
+
+void PnaCoreTest::compactColumnRoundTrip()
+{
+	QVector<double> noise = {-80.123456, -120.0, -175.5, std::numeric_limits<double>::quiet_NaN(), -60.004};
+	const CompactColumn centiDb = CompactColumn::encode(noise, ValueStorage::CentiDb16);
+	QCOMPARE(centiDb.storage(), ValueStorage::CentiDb16);
+	QCOMPARE(centiDb.size(), noise.size());
+	QVERIFY(centiDb.bytes() < qint64(noise.size()) * qint64(sizeof(double)));
+	QVERIFY(centiDb.maxError() <= 0.005 + 1e-12);
+	const QVector<double> decoded = centiDb.decode();
+	for (int i = 0; i < noise.size(); ++i) {
+		if (std::isnan(noise[i])) {
+			QVERIFY(std::isnan(decoded[i]) && std::isnan(centiDb.value(i)));
+		} else {
+			QVERIFY(qAbs(decoded[i] - noise[i]) <= centiDb.maxError());
+			QCOMPARE(centiDb.value(i), decoded[i]);
+		}
+	}
+
+	QCOMPARE(CompactColumn::encode(noise, ValueStorage::Float64).decode().size(), noise.size());
+	// Beyond +-327.67 dB around the centre int16 centi-dB cannot hold the column
+	QCOMPARE(CompactColumn::encode({-400.0, 400.0}, ValueStorage::CentiDb16).storage(), ValueStorage::Float32);
+}
+
+void PnaCoreTest::compactKernelsMatchDecoded()
+{
+	const int n = 3000;
+	std::mt19937 rng(7);
+	std::normal_distribution<double> jitter(0.0, 2.0);
+	DatasetColumns raw;
+	raw.frequencyOffset = logSweep(10.0, 1e7, n);
+	raw.phaseNoise.resize(n);
+	raw.referenceNoise.resize(n);
+	for (int i = 0; i < n; ++i) {
+		raw.phaseNoise[i] = -90.0 - 10.0 * std::log10(raw.frequencyOffset[i]) + jitter(rng);
+		raw.referenceNoise[i] = -160.0 + jitter(rng) + (i % 300 == 150 ? 30.0 : 0.0); // Spurs
+	}
+
+	for (ValueStorage storage : {ValueStorage::Float32, ValueStorage::CentiDb16}) {
+		DatasetColumns compact;
+		compact.frequencyOffset = raw.frequencyOffset;
+		compact.phaseNoise = raw.phaseNoise;
+		compact.referenceNoise = raw.referenceNoise;
+		compact.setStorage(storage);
+		QVERIFY(compact.isCompact() && compact.phaseNoise.isEmpty());
+
+		// The same values as float64: kernels on the views must give identical results
+		DatasetColumns decoded;
+		decoded.frequencyOffset = raw.frequencyOffset;
+		decoded.phaseNoise = compact.phaseNoiseCompact.decode();
+		decoded.referenceNoise = compact.referenceNoiseCompact.decode();
+
+		for (const QString& filter : Processing::filterTypes()) {
+			for (bool filtering : {false, true}) {
+				DerivedSettings settings;
+				settings.filtering = filtering;
+				settings.filterType = filter;
+				settings.filterWindow = 11;
+				settings.spurRemoval = true;
+				const DerivedColumns fromCompact = Processing::deriveColumns(compact, true, settings);
+				const DerivedColumns fromDecoded = Processing::deriveColumns(decoded, true, settings);
+				QCOMPARE(fromCompact.phaseNoiseFiltered, fromDecoded.phaseNoiseFiltered);
+				QCOMPARE(fromCompact.referenceNoiseFiltered, fromDecoded.referenceNoiseFiltered);
+			}
+		}
+
+		compact.setStorage(ValueStorage::Float64);
+		QCOMPARE(compact.phaseNoise, decoded.phaseNoise);
+	}
+}
+
+namespace {
+
+// Capture with its measured noise lowered by shift dB, so each version derives other columns
+DatasetSnapshotPtr captureSnapshot(int handle, quint64 version, double shift)
+{
+	const ParsedDataset data = parseText(captureText(2000));
+	QSharedPointer<DatasetSnapshot> snapshot(new DatasetSnapshot);
+	snapshot->handle = handle;
+	snapshot->version = version;
+	snapshot->hasReferenceData = data.hasReferenceData;
+	snapshot->frequencyOffset = data.frequencyOffset;
+	snapshot->phaseNoise = data.phaseNoise;
+	for (double& value : snapshot->phaseNoise) value -= shift;
+	snapshot->referenceNoise = data.referenceNoise;
+	return snapshot;
+}
+
+DerivedSettings filterSettings()
+{
+	DerivedSettings settings;
+	settings.filtering = true;
+	settings.filterType = Processing::filterTypes().first();
+	settings.filterWindow = 5;
+	return settings;
+}
+
+} // namespace
+
+void PnaCoreTest::derivedPipelineSupersedes()
+{
+	QVector<QPair<int, quint64>> delivered;
+	DerivedColumns columns;
+	DerivedPipeline pipeline;
+	connect(&pipeline, &DerivedPipeline::derivedReady, this, [&](int handle, quint64 version, const DerivedColumns& result) {
+		delivered.append(qMakePair(handle, version));
+		columns = result;
+	});
+	QSignalSpy idle(&pipeline, &DerivedPipeline::idle);
+
+	// Three versions before the event loop runs: only the newest is published, the others dropped
+	const DerivedSettings settings = filterSettings();
+	for (quint64 version = 1; version <= 3; ++version) {
+		pipeline.submit(captureSnapshot(1, version, double(version)), settings);
+	}
+	QCOMPARE(pipeline.pendingCount(), 1);
+	QVERIFY(idle.wait(10000));
+	QTRY_COMPARE(pipeline.droppedCount(), 2);
+	QCOMPARE(idle.count(), 1);
+	QCOMPARE(delivered, (QVector<QPair<int, quint64>>{qMakePair(1, quint64(3))}));
+
+	const DatasetSnapshotPtr newest = captureSnapshot(1, 3, 3.0);
+	const DerivedColumns expected = Processing::deriveColumns(newest->frequencyOffset, newest->phaseNoise, newest->referenceNoise,
+															  newest->hasReferenceData, settings);
+	QVERIFY(sameColumn(columns.phaseNoiseFiltered, expected.phaseNoiseFiltered));
+	QVERIFY(sameColumn(columns.referenceNoiseFiltered, expected.referenceNoiseFiltered));
+}
+
+void PnaCoreTest::derivedPipelineCancel()
+{
+	QVector<QPair<int, quint64>> delivered;
+	DerivedPipeline pipeline;
+	connect(&pipeline, &DerivedPipeline::derivedReady, this,
+			[&](int handle, quint64 version, const DerivedColumns&) { delivered.append(qMakePair(handle, version)); });
+	QSignalSpy idle(&pipeline, &DerivedPipeline::idle);
+	const DerivedSettings settings = filterSettings();
+
+	// A cancelled handle is no longer pending and its late result is dropped; others are unaffected
+	pipeline.submit(captureSnapshot(2, 1, 0.0), settings);
+	pipeline.submit(captureSnapshot(3, 1, 0.0), settings);
+	pipeline.cancel(2);
+	QVERIFY(!pipeline.isPending(2));
+	QVERIFY(pipeline.isPending(3));
+	QCOMPARE(idle.count(), 0);
+	QVERIFY(idle.wait(10000));
+	QTRY_COMPARE(pipeline.droppedCount(), 1);
+	QCOMPARE(delivered, (QVector<QPair<int, quint64>>{qMakePair(3, quint64(1))}));
+
+	// cancelAll() goes idle at once, nothing is delivered afterwards
+	pipeline.submit(captureSnapshot(4, 1, 0.0), settings);
+	pipeline.submit(captureSnapshot(3, 2, 1.0), settings);
+	pipeline.cancelAll();
+	QCOMPARE(pipeline.pendingCount(), 0);
+	QCOMPARE(idle.count(), 2);
+	QTRY_COMPARE(pipeline.droppedCount(), 3);
+	QCOMPARE(delivered.size(), 1);
+}
+
+// --- Sweep stitching ---
+
+void PnaCoreTest::stitchDescendingSweeps()
+{
+	QVector<double> sweep = logSweep(10.0, 1e6, 100);
+	std::reverse(sweep.begin(), sweep.end());
+	const QVector<double> frequency = sweep + sweep;
+	QVector<double> noise(frequency.size());
+	for (int i = 0; i < noise.size(); ++i) noise[i] = i < 100 ? -100.0 : -110.0;
+
+	DatasetParser::StitchOptions options;
+	options.splitRestarts = true;
+	ParsedDataset split = makeDataset(frequency, noise);
+	DatasetParser::stitchSweeps(&split, options);
+	QCOMPARE(split.sweepStarts, QVector<int>({0, 100}));
+	QCOMPARE(split.frequencyOffset.size(), 200);
+	QVERIFY(std::is_sorted(split.frequencyOffset.begin(), split.frequencyOffset.begin() + 100));
+	QCOMPARE(split.phaseNoise[0], -100.0);
+	QCOMPARE(split.phaseNoise[100], -110.0);
+
+	options.splitRestarts = false;
+	ParsedDataset merged = makeDataset(frequency, noise);
+	DatasetParser::stitchSweeps(&merged, options);
+	QVERIFY(merged.sweepStarts.isEmpty());
+	QCOMPARE(merged.frequencyOffset.size(), 100);
+	QVERIFY(std::is_sorted(merged.frequencyOffset.begin(), merged.frequencyOffset.end()));
+	QCOMPARE(merged.phaseNoise.first(), -110.0); // The later sweep wins
+}
+
+void PnaCoreTest::stitchOverlapLaterWins()
+{
+	ParsedDataset data = makeDataset({1, 2, 3, 4, 5, 3, 4, 5, 6, 7}, {1, 1, 1, 1, 1, 2, 2, 2, 2, 2});
+	DatasetParser::stitchSweeps(&data, DatasetParser::StitchOptions());
+	QCOMPARE(data.frequencyOffset, QVector<double>({1, 2, 3, 4, 5, 6, 7}));
+	QCOMPARE(data.phaseNoise, QVector<double>({1, 1, 2, 2, 2, 2, 2}));
+}
+
+void PnaCoreTest::stitchOverlapAveragePower()
+{
+	ParsedDataset data = makeDataset({1, 2, 3, 4, 5, 3, 4, 5, 6, 7}, {-100, -100, -100, -100, -100, -110, -110, -110, -110, -110});
+	DatasetParser::StitchOptions options;
+	options.overlap = DatasetParser::StitchOptions::Overlap::AveragePower;
+	DatasetParser::stitchSweeps(&data, options);
+	const double average = 10.0 * std::log10((1e-10 + 1e-11) / 2.0);
+	QCOMPARE(data.frequencyOffset, QVector<double>({1, 2, 3, 4, 5, 6, 7}));
+	QCOMPARE(data.phaseNoise[1], -100.0);
+	for (int i = 2; i <= 4; ++i) QVERIFY(qAbs(data.phaseNoise[i] - average) < 1e-9);
+	QCOMPARE(data.phaseNoise[5], -110.0);
+}
+
+void PnaCoreTest::stitchDecadeSegments()
+{
+	// Five decade segments overlapping by 10 %, recorded twice
+	QVector<double> frequency;
+	for (int decade = 1; decade <= 5; ++decade) {
+		frequency += logSweep(0.9 * std::pow(10.0, decade), std::pow(10.0, decade + 1), 50);
+	}
+	frequency += frequency;
+	const QVector<double> noise(frequency.size(), -120.0);
+
+	DatasetParser::StitchOptions options;
+	options.splitRestarts = true;
+	ParsedDataset data = makeDataset(frequency, noise);
+	DatasetParser::stitchSweeps(&data, options);
+	QCOMPARE(data.sweepStarts.size(), 2);
+	const int sweepSize = data.sweepStarts[1];
+	QCOMPARE(data.frequencyOffset.size(), 2 * sweepSize);
+	QVERIFY(sweepSize < 250 && sweepSize > 200);
+	QVERIFY(std::is_sorted(data.frequencyOffset.begin(), data.frequencyOffset.begin() + sweepSize));
+	QVERIFY(std::is_sorted(data.frequencyOffset.begin() + sweepSize, data.frequencyOffset.end()));
+}
+
+void PnaCoreTest::stitchUnorderedRows()
+{
+	QVector<double> frequency = logSweep(1.0, 1e6, 1000);
+	frequency += QVector<double>{frequency[10], frequency[20]}; // Repeated frequencies
+	std::mt19937 random(3);
+	std::shuffle(frequency.begin(), frequency.end(), random);
+	QVector<double> noise(frequency.size());
+	for (int i = 0; i < noise.size(); ++i) noise[i] = -10.0 * std::log10(frequency[i]);
+
+	ParsedDataset data = makeDataset(frequency, noise);
+	DatasetParser::stitchSweeps(&data, DatasetParser::StitchOptions());
+	QCOMPARE(data.frequencyOffset.size(), 1000); // Nothing lost but the repeats
+	QVERIFY(std::adjacent_find(data.frequencyOffset.begin(), data.frequencyOffset.end(), std::greater_equal<double>())
+			== data.frequencyOffset.end());
+	for (int i = 0; i < data.frequencyOffset.size(); ++i) {
+		QCOMPARE(data.phaseNoise[i], -10.0 * std::log10(data.frequencyOffset[i]));
+	}
+}
+
+// --- Compressed input ---
+
+void PnaCoreTest::gzipInflate()
+{
+	const QByteArray text = captureText(2000);
+	const QString plain = m_dir.filePath("capture.csv");
+	const QString gzip = m_dir.filePath("capture.csv.gz");
+	QVERIFY(writeFile(plain, text));
+	QVERIFY(writeFile(gzip, gzipMember(text)));
+	QCOMPARE(CompressedInput::detect(gzip), CompressedInput::Format::Gzip);
+	QCOMPARE(CompressedInput::baseName(gzip), QString("capture"));
+
+	QByteArray inflated;
+	QVERIFY(CompressedInput::read(gzip, [&inflated](const char* data, qint64 size) { inflated.append(data, int(size)); }));
+	QCOMPARE(inflated, text);
+
+	ParsedDataset fromPlain, fromGzip;
+	QVERIFY(DatasetParser::parseFile(plain, &fromPlain));
+	QVERIFY(DatasetParser::parseFile(gzip, &fromGzip));
+	QVERIFY(sameColumn(fromGzip.frequencyOffset, fromPlain.frequencyOffset));
+	QVERIFY(sameColumn(fromGzip.phaseNoise, fromPlain.phaseNoise));
+}
+
+void PnaCoreTest::gzipMultipleMembers()
+{
+	const QByteArray first = "10,-100\n100,-110\n";
+	const QByteArray second = "1000,-120\n";
+	const QString path = m_dir.filePath("members.csv.gz");
+	QVERIFY(writeFile(path, gzipMember(first) + gzipMember(second)));
+	QByteArray inflated;
+	QVERIFY(CompressedInput::read(path, [&inflated](const char* data, qint64 size) { inflated.append(data, int(size)); }));
+	QCOMPARE(inflated, first + second);
+}
+
+void PnaCoreTest::gzipCorruptCrc()
+{
+	const QString path = m_dir.filePath("corrupt.csv.gz");
+	QVERIFY(writeFile(path, gzipMember(captureText(100), true)));
+	QString errorString;
+	QVERIFY(!CompressedInput::read(path, [](const char*, qint64) {}, &errorString));
+	QVERIFY(!errorString.isEmpty());
+}
+
+// --- Pack archives ---
+
+void PnaCoreTest::packRoundTrip()
+{
+	const QString path = m_dir.filePath("roundtrip.pnapack");
+	const ParsedDataset a = parseText(captureText(300));
+	const ParsedDataset b = parseText("10,-100\n100,-110\n1000,-120\n");
+
+	PackWriter writer;
+	QVERIFY(writer.open(path));
+	QVERIFY(writer.add("a.csv", a, 1234, 5678));
+	QVERIFY(writer.add("b.csv", b, 0, 0));
+	QVERIFY(!writer.add("a.csv", b, 0, 0)); // Names are unique
+	QVERIFY(writer.finish());
+
+	const QSharedPointer<PackFile> pack = PackFile::open(path);
+	QVERIFY(pack);
+	QCOMPARE(pack->count(), 2);
+	QCOMPARE(pack->find("b.csv"), 1);
+	QCOMPARE(pack->find("c.csv"), -1);
+	const PackFile::MemberInfo info = pack->info(0);
+	QCOMPARE(info.name, QString("a.csv"));
+	QCOMPARE(info.pointCount, qint64(300));
+	QVERIFY(info.hasReferenceData);
+	QCOMPARE(info.sourceSize, qint64(1234));
+	QCOMPARE(info.sourceModified, qint64(5678));
+
+	ParsedDataset read;
+	QVERIFY(pack->read(0, &read));
+	QVERIFY(sameColumn(read.frequencyOffset, a.frequencyOffset));
+	QVERIFY(sameColumn(read.phaseNoise, a.phaseNoise));
+	QVERIFY(sameColumn(read.referenceNoise, a.referenceNoise));
+	QVERIFY(pack->read(1, &read));
+	QVERIFY(!read.hasReferenceData);
+	QVERIFY(sameColumn(read.phaseNoise, b.phaseNoise));
+
+	ParsedDataset member;
+	QVERIFY(DatasetParser::parseFile(PackFile::memberPath(path, "b.csv"), &member));
+	QVERIFY(sameColumn(member.frequencyOffset, b.frequencyOffset));
+}
+
+void PnaCoreTest::packAppendKeepsOldIndex()
+{
+	const QString path = m_dir.filePath("append.pnapack");
+	const ParsedDataset data = parseText(captureText(100));
+	{
+		PackWriter writer;
+		QVERIFY(writer.open(path));
+		QVERIFY(writer.add("first.csv", data, 0, 0));
+		QVERIFY(writer.finish());
+	}
+	const qint64 sizeBefore = QFileInfo(path).size();
+
+	// While an append is in progress, and after it is cancelled, the old index is used
+	{
+		PackWriter writer;
+		QVERIFY(writer.open(path));
+		QVERIFY(writer.add("second.csv", data, 0, 0));
+		const QSharedPointer<PackFile> during = PackFile::open(path);
+		QVERIFY(during);
+		QCOMPARE(during->count(), 1);
+		ParsedDataset read;
+		QVERIFY(during->read(0, &read));
+		QVERIFY(sameColumn(read.phaseNoise, data.phaseNoise));
+		writer.cancel();
+	}
+	QCOMPARE(QFileInfo(path).size(), sizeBefore);
+	QCOMPARE(PackFile::open(path)->count(), 1);
+
+	PackWriter writer;
+	QVERIFY(writer.open(path));
+	QVERIFY(writer.add("second.csv", data, 0, 0));
+	QVERIFY(writer.finish());
+	const QSharedPointer<PackFile> after = PackFile::open(path);
+	QVERIFY(after);
+	QCOMPARE(after->count(), 2);
+	ParsedDataset read;
+	QVERIFY(after->read(after->find("first.csv"), &read));
+	QVERIFY(sameColumn(read.frequencyOffset, data.frequencyOffset));
+}
+
+void PnaCoreTest::packCompact()
+{
+	const QString path = m_dir.filePath("compact.pnapack");
+	const ParsedDataset data = parseText(captureText(50));
+	for (int i = 0; i < 5; ++i) {
+		PackWriter writer;
+		QVERIFY(writer.open(path));
+		QVERIFY(writer.add(QString("m%1.csv").arg(i), data, 0, 0));
+		QVERIFY(writer.finish());
+	}
+	const qint64 sizeBefore = QFileInfo(path).size();
+	QCOMPARE(PackArchive::compact(path), 0);
+	QVERIFY(QFileInfo(path).size() < sizeBefore);
+
+	const QSharedPointer<PackFile> pack = PackFile::open(path);
+	QVERIFY(pack);
+	QCOMPARE(pack->count(), 5);
+	for (int i = 0; i < 5; ++i) {
+		ParsedDataset read;
+		QVERIFY(pack->read(pack->find(QString("m%1.csv").arg(i)), &read));
+		QVERIFY(sameColumn(read.phaseNoise, data.phaseNoise));
+	}
+}
+
+void PnaCoreTest::packExtractNames()
+{
+	const QString path = m_dir.filePath("names.pnapack");
+	const ParsedDataset data = parseText("10,-100\n100,-110\n");
+	PackWriter writer;
+	QVERIFY(writer.open(path));
+	for (const char* name : {"run.csv", "run.txt", "run.csv.gz", "other.txt"}) {
+		QVERIFY(writer.add(name, data, 0, 0));
+	}
+	QVERIFY(writer.finish());
+
+	const QString out = m_dir.filePath("extracted");
+	QCOMPARE(PackArchive::extract(path, QStringList(), out), 0);
+	QStringList files = QDir(out).entryList(QDir::Files, QDir::Name);
+	QCOMPARE(files, QStringList({"other.csv", "run.csv", "run.csv.gz.csv", "run.txt.csv"}));
+	ParsedDataset read;
+	QVERIFY(DatasetParser::parseFile(QDir(out).filePath("run.txt.csv"), &read));
+	QVERIFY(sameColumn(read.phaseNoise, data.phaseNoise));
+}
+
+void PnaCoreTest::packCorruptIndex()
+{
+	const QString path = m_dir.filePath("corrupt_source.pnapack");
+	const ParsedDataset data = parseText(captureText(300));
+	{
+		PackWriter writer;
+		QVERIFY(writer.open(path));
+		QVERIFY(writer.add("a.csv", data, 0, 0));
+		QVERIFY(writer.finish());
+	}
+	QFile source(path);
+	QVERIFY(source.open(QIODevice::ReadOnly));
+	const QByteArray bytes = source.readAll();
+
+	// The footer (64 bytes) ends the file: indexOffset, namesOffset, namesSize, hashOffset at 16, 32, 40, 48
+	const int footer = int(bytes.size()) - 64;
+	auto field = [&](int offset) {
+		quint64 value;
+		std::memcpy(&value, bytes.constData() + offset, sizeof(value));
+		return value;
+	};
+	auto corrupted = [&](const QString& name, int offset, quint64 value) {
+		QByteArray copy = bytes;
+		std::memcpy(copy.data() + offset, &value, sizeof(value));
+		const QString corruptPath = m_dir.filePath(name);
+		return writeFile(corruptPath, copy) ? corruptPath : QString();
+	};
+	const quint64 namesOffset = field(footer + 32);
+	quint32 hashSlots;
+	std::memcpy(&hashSlots, bytes.constData() + footer + 56, sizeof(hashSlots));
+
+	// Offsets whose sum with the length wraps to 0, which passes a plain "sum <= limit" check
+	const QVector<QPair<int, quint64>> footerCases = {
+		{footer + 16, quint64(0) - sizeof(PackFile::IndexEntry)},
+		{footer + 40, quint64(0) - namesOffset},
+		{footer + 48, quint64(0) - quint64(hashSlots) * sizeof(quint32)},
+	};
+	for (const auto& corruption : footerCases) {
+		QString error;
+		const QString corruptPath = corrupted(QString("corrupt_footer_%1.pnapack").arg(corruption.first), corruption.first, corruption.second);
+		QVERIFY(!corruptPath.isEmpty());
+		QVERIFY(!PackFile::open(corruptPath, &error));
+		QVERIFY(!error.isEmpty());
+	}
+
+	// Member entry: dataOffset and nameOffset at 0 and 16; the pack opens, the member does not read
+	const int entry = int(field(footer + 16));
+	const quint64 columnBytes = 3 * 300 * sizeof(double);
+	const QSharedPointer<PackFile> badData = PackFile::open(corrupted("corrupt_data.pnapack", entry, quint64(0) - columnBytes));
+	QVERIFY(badData);
+	QVERIFY(!badData->frequencyOffset(0));
+	ParsedDataset read;
+	QVERIFY(!badData->read(0, &read));
+	const QSharedPointer<PackFile> badName = PackFile::open(corrupted("corrupt_name.pnapack", entry + 16, quint64(0) - 5));
+	QVERIFY(badName);
+	QVERIFY(badName->name(0).isEmpty());
+	QCOMPARE(badName->find("a.csv"), -1);
+}
+
+// --- Column files ---
+
+namespace {
+
+// Measured and reference columns over 5000 points, with one missing sample
+QString writeColumnFile(const QString& path, ValueStorage storage)
+{
+	MappedColumnWriter writer(2, storage);
+	if (!writer.open(path)) return QString();
+	for (int i = 0; i < 5000; ++i) {
+		const double values[2] = {i == 1234 ? std::numeric_limits<double>::quiet_NaN() : -80.0 - i * 0.01, -150.0 + (i % 7)};
+		if (!writer.append(10.0 + i, values)) return QString();
+	}
+	QString error;
+	return writer.finish(&error) ? path : QString();
+}
+
+} // namespace
+
+void PnaCoreTest::columnFileRoundTrip()
+{
+	for (ValueStorage storage : {ValueStorage::Float64, ValueStorage::Float32, ValueStorage::CentiDb16}) {
+		const QString path = writeColumnFile(m_dir.filePath(QString("columns_%1.pnacol").arg(int(storage))), storage);
+		QVERIFY(!path.isEmpty());
+		QString error;
+		const QSharedPointer<MappedColumnFile> file = MappedColumnFile::open(path, &error);
+		QVERIFY2(file, qPrintable(error));
+		QCOMPARE(file->count(), 5000);
+		QCOMPARE(file->valueColumnCount(), 2);
+		QCOMPARE(file->valueStorage(), storage);
+		const double tolerance = storage == ValueStorage::Float64 ? 0.0 : 0.005 + 1e-9;
+		QVERIFY(file->maxQuantizationError(0) <= tolerance);
+		for (int i = 0; i < 5000; i += 37) {
+			QCOMPARE(file->keys()[i], 10.0 + i);
+			QVERIFY(qAbs(file->value(1, i) - (-150.0 + (i % 7))) <= tolerance);
+		}
+		QVERIFY(std::isnan(file->value(0, 1234)));
+
+		QCOMPARE(file->lowerBound(100.0, 0, file->count()), 90);
+		QCOMPARE(file->upperBound(100.0, 0, file->count()), 91);
+		double lo = 0.0, hi = 0.0;
+		QVERIFY(file->minMax(0, 1000, 3000, &lo, &hi)); // Spans whole summary blocks and partial ones
+		QVERIFY(qAbs(hi - (-90.0)) <= tolerance);
+		QVERIFY(qAbs(lo - (-80.0 - 2999 * 0.01)) <= tolerance);
+	}
+}
+
+void PnaCoreTest::columnFileCorruptHeader()
+{
+	const QString path = writeColumnFile(m_dir.filePath("valid.pnacol"), ValueStorage::Float64);
+	QVERIFY(!path.isEmpty());
+	QFile valid(path);
+	QVERIFY(valid.open(QIODevice::ReadOnly));
+	const QByteArray bytes = valid.readAll();
+	const int fileSize = int(bytes.size());
+	QVERIFY(MappedColumnFile::open(path));
+
+	// keyOffset, valueOffset and summaryOffset are the quint64 fields at 32, 40 and 48
+	auto corrupted = [&](const QString& name, int field, quint64 value) {
+		QByteArray copy = bytes;
+		std::memcpy(copy.data() + field, &value, sizeof(value));
+		const QString corruptPath = m_dir.filePath(name);
+		return writeFile(corruptPath, copy) ? corruptPath : QString();
+	};
+	const quint64 wrapping = ~quint64(7); // 8-aligned, wraps any offset + length sum
+	for (int field : {32, 40, 48}) {
+		for (quint64 offset : {wrapping, wrapping - 4096, quint64(fileSize)}) {
+			QString error;
+			const QString corruptPath = corrupted(QString("corrupt_%1_%2.pnacol").arg(field).arg(offset), field, offset);
+			QVERIFY(!corruptPath.isEmpty());
+			QVERIFY(!MappedColumnFile::open(corruptPath, &error));
+			QVERIFY(!error.isEmpty());
+		}
+	}
+
+	// Truncated anywhere after the header, and inside the header
+	for (int size : {fileSize - 8, fileSize / 2, 200, 100, 10}) {
+		const QString truncated = m_dir.filePath(QString("truncated_%1.pnacol").arg(size));
+		QVERIFY(writeFile(truncated, bytes.left(size)));
+		QVERIFY(!MappedColumnFile::open(truncated));
+	}
+}
+
+void PnaCoreTest::columnFileConvertCsv()
+{
+	// The loader's rules: byte order mark, comments, mixed separators, bad lines and f <= 0 skipped
+	const QString csvPath = m_dir.filePath("convert.csv");
+	QVERIFY(writeFile(csvPath, "\xEF\xBB\xBF# comment\n10, -80, -150\r\n20\t-81\t-151\nbad line\n30 -82 -152\n-5 -83 -153\n40,-84,-154"));
+	const QString outPath = m_dir.filePath("convert.pnacol");
+	QString error;
+	QVERIFY2(MappedColumnFile::convertCsv(csvPath, outPath, ValueStorage::Float64, nullptr, &error), qPrintable(error));
+	const QSharedPointer<MappedColumnFile> file = MappedColumnFile::open(outPath, &error);
+	QVERIFY2(file, qPrintable(error));
+	QCOMPARE(file->count(), 4);
+	QCOMPARE(file->valueColumnCount(), 2);
+	ParsedDataset loaded;
+	QVERIFY(DatasetParser::parseFile(csvPath, &loaded));
+	QCOMPARE(loaded.frequencyOffset.size(), 4);
+	for (int i = 0; i < 4; ++i) {
+		QCOMPARE(file->keys()[i], loaded.frequencyOffset[i]);
+		QCOMPARE(file->value(0, i), loaded.phaseNoise[i]);
+		QCOMPARE(file->value(1, i), loaded.referenceNoise[i]);
+	}
+
+	// Descending sweeps are only stitched by the loader
+	QVERIFY(writeFile(csvPath, "1000 -80\n100 -90\n10 -100\n"));
+	QVERIFY(!MappedColumnFile::convertCsv(csvPath, outPath, ValueStorage::Float64, nullptr, &error));
+	QVERIFY(error.contains("ascending"));
+	const QSharedPointer<MappedColumnFile> kept = MappedColumnFile::open(outPath);
+	QVERIFY(kept && kept->count() == 4); // The earlier output is left alone
+}
+
+// --- Batch processing ---
+
+void PnaCoreTest::batchShardsMatchSingleRun()
+{
+	// Seven captures at different noise levels, split over three shards
+	const QString inputDir = m_dir.filePath("batch_inputs");
+	QVERIFY(QDir().mkpath(inputDir));
+	const QVector<double> frequency = logSweep(1.0, 1e6, 400);
+	for (int k = 0; k < 7; ++k) {
+		QByteArray text;
+		for (double f : frequency) {
+			text += QByteArray::number(f, 'g', 12) + "," + QByteArray::number(-80.0 - 1.7 * k - 10.0 * std::log10(f), 'f', 3) + "\n";
+		}
+		QVERIFY(writeFile(QString("%1/capture_%2.csv").arg(inputDir).arg(k), text));
+	}
+
+	BatchOptions options;
+	options.writePerFile = false;
+	options.outputDir = m_dir.filePath("batch_single");
+	QCOMPARE(BatchProcessor::run({inputDir}, options), 0);
+
+	QStringList partials;
+	for (int shard = 0; shard < 3; ++shard) {
+		BatchOptions shardOptions = options;
+		shardOptions.shardIndex = shard;
+		shardOptions.shardCount = 3;
+		shardOptions.partialPath = m_dir.filePath(QString("batch_shard_%1.pnapart").arg(shard));
+		QCOMPARE(BatchProcessor::run({inputDir}, shardOptions), 0);
+		partials.prepend(shardOptions.partialPath); // Merged in shard order whatever the argument order
+	}
+	const QString mergedDir = m_dir.filePath("batch_merged");
+	QCOMPARE(BatchProcessor::merge(partials, mergedDir), 0);
+
+	// Summary: the same rows, apart from the processing time at the end
+	auto withoutTime = [](const QStringList& lines) {
+		QStringList rows;
+		for (const QString& line : lines) rows << line.section(',', 0, -2);
+		return rows;
+	};
+	const QStringList summary = readLines(options.outputDir + "/batch_summary.csv");
+	QCOMPARE(summary.size(), 8);
+	QCOMPARE(withoutTime(readLines(mergedDir + "/batch_summary.csv")), withoutTime(summary));
+
+	// Statistics: names and counts exact, values within the printed resolution (mean and
+	// variance are combined in another order than in the single run)
+	const QStringList statistics = readLines(options.outputDir + "/batch_statistics.csv");
+	const QStringList merged = readLines(mergedDir + "/batch_statistics.csv");
+	QVERIFY(!statistics.isEmpty());
+	QCOMPARE(merged.size(), statistics.size());
+	for (int i = 0; i < statistics.size(); ++i) {
+		const QStringList expected = statistics[i].split(',');
+		const QStringList actual = merged[i].split(',');
+		QCOMPARE(actual.size(), expected.size());
+		QCOMPARE(actual.mid(0, 2), expected.mid(0, 2));
+		for (int j = 2; j < expected.size(); ++j) {
+			QVERIFY2(qAbs(actual[j].toDouble() - expected[j].toDouble()) <= 0.0011, qPrintable(merged[i] + " vs " + statistics[i]));
+		}
+	}
+}
+
+// --- Ring buffer ---
+
+void PnaCoreTest::ringBufferWrapAndFull()
+{
+	SpscRingBuffer<int> buffer(3);
+	QCOMPARE(buffer.capacity(), size_t(4));
+	int next = 0;
+	int expected = 0;
+	int item = 0;
+	// Three in, two out per round: the indices wrap the four slots many times at every offset
+	for (int round = 0; round < 20; ++round) {
+		while (buffer.size() < buffer.capacity()) {
+			int pushed = next++;
+			QVERIFY(buffer.tryPush(std::move(pushed)));
+		}
+		int refused = -1;
+		QVERIFY(!buffer.tryPush(std::move(refused)));
+		QCOMPARE(refused, -1); // Left untouched
+		for (int i = 0; i < 2 + round % 3; ++i) {
+			QVERIFY(buffer.tryPop(item));
+			QCOMPARE(item, expected++);
+		}
+	}
+	while (buffer.tryPop(item)) QCOMPARE(item, expected++);
+	QCOMPARE(expected, next);
+	QVERIFY(buffer.isEmpty());
+}
+
+void PnaCoreTest::ringBufferTwoThreads()
+{
+	constexpr qint64 Count = 100000;
+	SpscRingBuffer<qint64> buffer(8);
+	std::atomic<int> refusals{0};
+	std::unique_ptr<QThread> producer(QThread::create([&buffer, &refusals]() {
+		for (qint64 i = 0; i < Count;) {
+			qint64 item = i;
+			if (buffer.tryPush(std::move(item))) {
+				++i;
+			} else {
+				refusals.fetch_add(1, std::memory_order_relaxed);
+				QThread::yieldCurrentThread();
+			}
+		}
+	}));
+	producer->start();
+
+	bool inOrder = true;
+	bool sizeInRange = true;
+	bool fullWhenRefused = true;
+	for (qint64 expected = 0; expected < Count;) {
+		// Now and then stop consuming until the producer finds the buffer full
+		if (expected % 1000 == 0 && expected + qint64(buffer.capacity()) < Count) {
+			const int before = refusals.load(std::memory_order_relaxed);
+			while (refusals.load(std::memory_order_relaxed) == before) QThread::yieldCurrentThread();
+			fullWhenRefused = fullWhenRefused && buffer.size() == buffer.capacity();
+		}
+		qint64 item = -1;
+		if (buffer.tryPop(item)) {
+			inOrder = inOrder && item == expected;
+			++expected;
+		} else {
+			QThread::yieldCurrentThread(); // Single-core machines: let the producer run
+		}
+		sizeInRange = sizeInRange && buffer.size() <= buffer.capacity();
+	}
+	QVERIFY(producer->wait(30000));
+	QVERIFY(inOrder);
+	QVERIFY(sizeInRange);
+	QVERIFY(fullWhenRefused);
+	QVERIFY(buffer.isEmpty());
+}
+
+// --- Workspace snapshot ---
+
+void PnaCoreTest::workspaceRoundTrip()
+{
+	Workspace::State state;
+	state.filterType = QStringLiteral("Median Filter");
+	state.filterWindow = 7;
+	state.activeDatasetIndex = 1;
+	state.spotNoiseColor = QColor(10, 20, 30);
+	for (int i = 0; i < 2; ++i) {
+		Workspace::DatasetState d;
+		d.filename = QString("/data/capture_%1.csv").arg(i);
+		d.displayName = QString("capture_%1").arg(i);
+		d.hasReferenceData = true;
+		d.measuredColor = QColor(Qt::red);
+		d.frequencyOffset = logSweep(1.0, 1e6, 1000);
+		d.phaseNoise = QVector<double>(1000, -100.0 - i);
+		d.referenceNoise = QVector<double>(1000, -150.0);
+		// The first dataset is unfiltered: its derived columns share the raw ones
+		d.phaseNoiseFiltered = i == 0 ? d.phaseNoise : QVector<double>(1000, -101.5);
+		d.referenceNoiseFiltered = d.referenceNoise;
+		state.datasets.append(d);
+	}
+
+	const QString path = m_dir.filePath("round.pnaws");
+	QString error;
+	QVERIFY2(Workspace::save(path, state, &error), qPrintable(error));
+	// Three raw columns per dataset plus the one filtered column that is not shared: 7000 doubles, not 10000
+	QVERIFY(QFileInfo(path).size() < qint64(7000) * qint64(sizeof(double)) + 4096);
+
+	Workspace::State loaded;
+	QVERIFY2(Workspace::load(path, &loaded, &error), qPrintable(error));
+	QCOMPARE(loaded.filterType, state.filterType);
+	QCOMPARE(loaded.filterWindow, 7);
+	QCOMPARE(loaded.activeDatasetIndex, 1);
+	QCOMPARE(loaded.spotNoiseColor, state.spotNoiseColor);
+	QCOMPARE(loaded.datasets.size(), 2);
+	for (int i = 0; i < 2; ++i) {
+		const Workspace::DatasetState& a = state.datasets[i];
+		const Workspace::DatasetState& b = loaded.datasets[i];
+		QCOMPARE(b.displayName, a.displayName);
+		QCOMPARE(b.measuredColor, a.measuredColor);
+		QVERIFY(sameColumn(b.frequencyOffset, a.frequencyOffset));
+		QVERIFY(sameColumn(b.phaseNoise, a.phaseNoise));
+		QVERIFY(sameColumn(b.referenceNoise, a.referenceNoise));
+		QVERIFY(sameColumn(b.phaseNoiseFiltered, a.phaseNoiseFiltered));
+		QVERIFY(sameColumn(b.referenceNoiseFiltered, a.referenceNoiseFiltered));
+		QVERIFY(b.referenceNoiseFiltered.constData() == b.referenceNoise.constData());
+	}
+	QVERIFY(loaded.datasets[0].phaseNoiseFiltered.constData() == loaded.datasets[0].phaseNoise.constData());
+	QVERIFY(loaded.datasets[1].phaseNoiseFiltered.constData() != loaded.datasets[1].phaseNoise.constData());
+
+	// Truncated files fail cleanly
+	QFile file(path);
+	QVERIFY(file.open(QIODevice::ReadWrite));
+	QVERIFY(file.resize(file.size() - 8));
+	file.close();
+	QVERIFY(!Workspace::load(path, &loaded, &error));
+}
+
+QTEST_GUILESS_MAIN(PnaCoreTest)
+#include "tst_pnacore.moc"
@@ -28,24 +28,157 @@
 
 #include <QVector>
 #include <QString>
+#include <algorithm>
+#include <vector>
 
 namespace Utils {
 
 // Frequency formatting
 QString formatFrequencyTick(double freq, int precision); // For axis ticks
 QString formatFrequencyValue(double freq); // For display values (like spot noise)
-
-// Data Filtering (Basic Implementations)
-QVector<double> movingAverage(const QVector<double>& data, int windowSize);
-QVector<double> medianFilter(const QVector<double>& data, int windowSize);
-QVector<double> savitzkyGolay(const QVector<double>& data, int windowSize, int polyOrder = 3);
-
-// Spur Removal Helper
-QVector<double> rollingMedian(const QVector<double>& data, int windowSize);
+void appendFrequencyValue(QString& out, double freq); // Same, no temporaries: allocates only when out lacks capacity
+void appendFixed(QString& out, double value, int decimals); // Fixed notation, always a '.' whatever the locale, appended in place
 
 // Interpolation
 double linearInterpolate(double x1, double y1, double x2, double y2, double x);
 
+// Data Filtering (Basic Implementations) and the spur removal helper. Templates over the
+// column type: QVector<double>, or a CompactView reading compact storage in place.
+
+// Column as a QVector<double>: shared for a QVector, decoded for a view
+template <typename Column>
+QVector<double> toVector(const Column& column) {
+	QVector<double> values(column.size());
+	for (int i = 0; i < column.size(); ++i) values[i] = column[i];
+	return values;
+}
+inline QVector<double> toVector(const QVector<double>& column) { return column; }
+
+template <typename Column>
+QVector<double> movingAverage(const Column& data, int windowSize) {
+	if (windowSize % 2 == 0) windowSize++; // Ensure odd
+	if (windowSize < 3 || data.isEmpty()) return toVector(data);
+
+	int halfWindow = windowSize / 2;
+	QVector<double> smoothed(data.size());
+	QVector<double> validData; // Handle potential NaNs if necessary
+
+	// Simple padding at edges: replicate edge value
+	for (int i = 0; i < data.size(); ++i) {
+		double currentSum = 0;
+		int count = 0;
+		for (int j = -halfWindow; j <= halfWindow; ++j) {
+			int index = i + j;
+			if (index >= 0 && index < data.size()) {
+				// Assuming data doesn't contain NaN/inf here
+				currentSum += data[index];
+				count++;
+			}
+		}
+		if (count > 0) {
+			smoothed[i] = currentSum / count;
+		} else {
+			smoothed[i] = data[i]; // Should not happen with valid window/data
+		}
+	}
+	return smoothed;
+}
+
+// Simple (less efficient) median filter implementation
+template <typename Column>
+QVector<double> medianFilter(const Column& data, int windowSize) {
+	if (windowSize % 2 == 0) windowSize++; // Ensure odd
+	if (windowSize < 3 || data.isEmpty()) return toVector(data);
+
+	int halfWindow = windowSize / 2;
+	QVector<double> filtered(data.size());
+	std::vector<double> window; // Use std::vector for sorting
+
+	for (int i = 0; i < data.size(); ++i) {
+		window.clear();
+		for (int j = -halfWindow; j <= halfWindow; ++j) {
+			int index = i + j;
+			// Edge handling: Clamp index to valid range (like some median filter implementations)
+			index = std::max(0, std::min(static_cast<int>(data.size()) - 1, index));
+			// Assuming data doesn't contain NaN/inf
+			window.push_back(data[index]);
+		}
+		// Sort the window and pick the median
+		std::sort(window.begin(), window.end());
+		filtered[i] = window[window.size() / 2];
+	}
+	return filtered;
+}
+
+// Basic Rolling Median - similar to medianFilter above, for spur removal baseline
+template <typename Column>
+QVector<double> rollingMedian(const Column& data, int windowSize) {
+	// This is functionally the same as the medianFilter provided above for simplicity.
+	// A more efficient implementation would use sliding window data structures.
+	return medianFilter(data, windowSize);
+}
+
+// Savitzky-Golay Filter - Basic Implementation using precomputed coefficients (common cases)
+// WARNING: This is a very simplified version. A robust implementation requires
+// calculating coefficients based on window, order, and derivative.
+// This example uses coefficients for smoothing (0th derivative), polyorder 3.
+template <typename Column>
+QVector<double> savitzkyGolay(const Column& data, int windowSize, int polyOrder = 3) {
+	if (windowSize % 2 == 0) windowSize++; // Ensure odd
+	if (windowSize < 5 || polyOrder >= windowSize || data.size() < windowSize) {
+		// Return original data if parameters are invalid or data is too small
+		// A more robust version might try lower order/window or throw error
+		return toVector(data);
+	}
+
+	// Coefficients for smoothing (0th derivative), polyorder=3
+	// Source: Numerical Recipes or online calculators
+	// These need to be adjusted or calculated if windowSize/polyOrder changes significantly.
+	// Example for windowSize=5, polyOrder=3 (or 2):
+	const std::vector<double> coeffs_5 = {-3, 12, 17, 12, -3}; double norm_5 = 35.0;
+	// Example for windowSize=7, polyOrder=3:
+	const std::vector<double> coeffs_7 = {-2, 3, 6, 7, 6, 3, -2}; double norm_7 = 21.0;
+	// Example for windowSize=11, polyOrder=3:
+	const std::vector<double> coeffs_11 = {-36, 9, 44, 69, 84, 89, 84, 69, 44, 9, -36}; double norm_11 = 429.0;
+	// Example for windowSize=21, polyOrder=3 (might need higher precision):
+	// Coefficients get complex, better to calculate dynamically. Using 11 as fallback.
+
+	const std::vector<double>* coeffs_ptr;
+	double norm;
+
+	// Select coefficients based on window size (add more cases as needed)
+	if (windowSize == 5) { coeffs_ptr = &coeffs_5; norm = norm_5; }
+	else if (windowSize == 7) { coeffs_ptr = &coeffs_7; norm = norm_7; }
+	else if (windowSize >=9 && windowSize <= 15 ) { coeffs_ptr = &coeffs_11; norm = norm_11; windowSize = 11; } // Approximation
+	else if (windowSize > 15) { coeffs_ptr = &coeffs_11; norm = norm_11; windowSize = 11; } // Approximation
+	else { return toVector(data); } // Unsupported size for this simple implementation
+
+	const std::vector<double>& coeffs = *coeffs_ptr;
+	int halfWindow = windowSize / 2;
+	QVector<double> smoothed(data.size());
+
+	for (int i = 0; i < data.size(); ++i) {
+		double sum = 0;
+		for (int j = -halfWindow; j <= halfWindow; ++j) {
+			int index = i + j;
+			// Edge handling: Reflect indices
+			if (index < 0) index = -index;
+			if (index >= data.size()) index = 2 * (data.size() - 1) - index;
+			// Ensure index is still valid after reflection
+			index = std::max(0, std::min(static_cast<int>(data.size()) - 1, index));
+			sum += coeffs[j + halfWindow] * data[index];
+		}
+		smoothed[i] = sum / norm;
+	}
+
+	// Handle edges more carefully (e.g., copy original values for first/last halfWindow points)
+	// This simple version might have edge artifacts.
+	for(int i=0; i<halfWindow; ++i) smoothed[i] = data[i];
+	for(int i=data.size()-halfWindow; i<data.size(); ++i) smoothed[i] = data[i];
+
+	return smoothed;
+}
+
 } // namespace Utils
 
 #endif // UTILS_H
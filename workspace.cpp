@@ -0,0 +1,295 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#include "workspace.h"
+
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <array>
+#include <cstring>
+
+namespace {
+
+constexpr char FileMagic[8] = {'P', 'N', 'A', 'W', 'S', '\r', '\n', '\x1a'};
+constexpr quint32 FormatVersion = 2; // 2: derived columns that alias the raw ones are not stored
+constexpr quint32 MinFormatVersion = 1;
+constexpr quint32 ByteOrderMark = 0x01020304; // Written natively, detects foreign byte order
+constexpr qint64 HeaderSize = 32;
+constexpr QDataStream::Version MetadataStreamVersion = QDataStream::Qt_5_15;
+constexpr int ColumnsPerDataset = 5;
+
+struct FileHeader {
+	char magic[8];
+	quint32 version;
+	quint32 byteOrderMark;
+	quint64 metadataSize;
+	quint64 dataOffset;
+};
+static_assert(sizeof(FileHeader) == HeaderSize, "Workspace header must be 32 bytes");
+
+// Where each column lives, relative to the start of the column data
+struct ColumnRef {
+	quint64 offset = 0;
+	quint64 count = 0;
+};
+
+inline qint64 alignTo8(qint64 value)
+{
+	return (value + 7) & ~qint64(7);
+}
+
+std::array<const QVector<double>*, ColumnsPerDataset> columnsOf(const Workspace::DatasetState& d)
+{
+	return {&d.frequencyOffset, &d.phaseNoise, &d.referenceNoise, &d.phaseNoiseFiltered, &d.referenceNoiseFiltered};
+}
+
+std::array<QVector<double>*, ColumnsPerDataset> columnsOf(Workspace::DatasetState& d)
+{
+	return {&d.frequencyOffset, &d.phaseNoise, &d.referenceNoise, &d.phaseNoiseFiltered, &d.referenceNoiseFiltered};
+}
+
+// Raw column a column of columnsOf() may share its storage with (unfiltered data), -1 for none
+constexpr int AliasOf[ColumnsPerDataset] = {-1, -1, -1, 1, 2};
+
+// Bit c set: column c shares the storage of column AliasOf[c] and is not written
+quint8 aliasMask(const Workspace::DatasetState& d)
+{
+	const auto columns = columnsOf(d);
+	quint8 mask = 0;
+	for (int c = 0; c < ColumnsPerDataset; ++c) {
+		if (AliasOf[c] >= 0 && columns[c]->constData() == columns[AliasOf[c]]->constData()
+			&& columns[c]->size() == columns[AliasOf[c]]->size()) {
+			mask |= quint8(1u << c);
+		}
+	}
+	return mask;
+}
+
+} // namespace
+
+namespace Workspace {
+
+QString autosavePath()
+{
+	return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/workspace.pnaws");
+}
+
+bool save(const QString& path, const State& state, QString* errorString)
+{
+	// Metadata first: column offsets are known up front since every column is a plain double array
+	QByteArray metadata;
+	{
+		QDataStream out(&metadata, QIODevice::WriteOnly);
+		out.setVersion(MetadataStreamVersion);
+		out << qint32(state.activeDatasetIndex)
+			<< state.filteringEnabled << state.filterType << qint32(state.filterWindow) << state.spurRemovalEnabled
+			<< state.darkTheme << state.showReference << state.showSpotNoise << state.showSpotNoiseTable << state.showGrid
+			<< state.spotNoiseColor << qint32(state.minFreqSliderIndex) << qint32(state.maxFreqSliderIndex)
+			<< state.yMinSetting << state.yMaxSetting
+			<< state.xViewMin << state.xViewMax << state.yViewMin << state.yViewMax
+			<< state.outputFilename;
+
+		out << quint32(state.datasets.size());
+		quint64 columnOffset = 0;
+		for (const DatasetState& d : state.datasets) {
+			const quint8 aliased = aliasMask(d);
+			out << d.filename << d.displayName << d.hasReferenceData << d.isVisible
+				<< d.measuredColor << d.referenceColor << aliased;
+			const auto columns = columnsOf(d);
+			for (int c = 0; c < ColumnsPerDataset; ++c) {
+				if (aliased & (1u << c)) continue;
+				out << columnOffset << quint64(columns[c]->size());
+				columnOffset += quint64(columns[c]->size()) * sizeof(double);
+			}
+		}
+	}
+
+	FileHeader header;
+	std::memcpy(header.magic, FileMagic, sizeof(FileMagic));
+	header.version = FormatVersion;
+	header.byteOrderMark = ByteOrderMark;
+	header.metadataSize = quint64(metadata.size());
+	header.dataOffset = quint64(alignTo8(HeaderSize + metadata.size()));
+
+	QDir().mkpath(QFileInfo(path).absolutePath());
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly)) {
+		if (errorString) *errorString = file.errorString();
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(metadata);
+	const qint64 padding = qint64(header.dataOffset) - HeaderSize - metadata.size();
+	if (padding > 0) {
+		file.write(QByteArray(int(padding), '\0'));
+	}
+	for (const DatasetState& d : state.datasets) {
+		const quint8 aliased = aliasMask(d);
+		const auto columns = columnsOf(d);
+		for (int c = 0; c < ColumnsPerDataset; ++c) {
+			if (!(aliased & (1u << c)) && !columns[c]->isEmpty()) {
+				file.write(reinterpret_cast<const char*>(columns[c]->constData()), qint64(columns[c]->size()) * qint64(sizeof(double)));
+			}
+		}
+	}
+
+	if (!file.commit()) {
+		if (errorString) *errorString = file.errorString();
+		return false;
+	}
+	return true;
+}
+
+bool load(const QString& path, State* state, QString* errorString)
+{
+	auto fail = [errorString](const QString& message) {
+		if (errorString) *errorString = message;
+		return false;
+	};
+
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return fail(file.errorString());
+	}
+	const qint64 fileSize = file.size();
+	if (fileSize < HeaderSize) {
+		return fail(QStringLiteral("File is too small to be a workspace"));
+	}
+
+	// Map the whole file; fall back to a plain read where mapping is not possible
+	QByteArray fallback;
+	const uchar* base = file.map(0, fileSize);
+	const bool mapped = (base != nullptr);
+	if (!mapped) {
+		fallback = file.readAll();
+		if (fallback.size() != fileSize) {
+			return fail(file.errorString());
+		}
+		base = reinterpret_cast<const uchar*>(fallback.constData());
+	}
+	struct Unmapper {
+		QFile& file;
+		const uchar* base;
+		bool mapped;
+		~Unmapper() { if (mapped) file.unmap(const_cast<uchar*>(base)); }
+	} unmapper{file, base, mapped};
+
+	FileHeader header;
+	std::memcpy(&header, base, sizeof(header));
+	if (std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0) {
+		return fail(QStringLiteral("Not a workspace file"));
+	}
+	if (header.version < MinFormatVersion || header.version > FormatVersion) {
+		return fail(QString("Unsupported workspace version %1").arg(header.version));
+	}
+	if (header.byteOrderMark != ByteOrderMark) {
+		return fail(QStringLiteral("Workspace was written on a machine with a different byte order"));
+	}
+	if (header.metadataSize > quint64(fileSize - HeaderSize) || header.dataOffset > quint64(fileSize)
+		|| header.dataOffset < quint64(HeaderSize) + header.metadataSize) {
+		return fail(QStringLiteral("Workspace file is truncated or corrupt"));
+	}
+
+	State result;
+	QVector<std::array<ColumnRef, ColumnsPerDataset>> columnRefs;
+	QVector<quint8> aliasMasks;
+	{
+		const QByteArray metadata = QByteArray::fromRawData(reinterpret_cast<const char*>(base + HeaderSize), int(header.metadataSize));
+		QDataStream in(metadata);
+		in.setVersion(MetadataStreamVersion);
+
+		qint32 activeIndex, filterWindow, minSlider, maxSlider;
+		in >> activeIndex
+			>> result.filteringEnabled >> result.filterType >> filterWindow >> result.spurRemovalEnabled
+			>> result.darkTheme >> result.showReference >> result.showSpotNoise >> result.showSpotNoiseTable >> result.showGrid
+			>> result.spotNoiseColor >> minSlider >> maxSlider
+			>> result.yMinSetting >> result.yMaxSetting
+			>> result.xViewMin >> result.xViewMax >> result.yViewMin >> result.yViewMax
+			>> result.outputFilename;
+		result.activeDatasetIndex = activeIndex;
+		result.filterWindow = filterWindow;
+		result.minFreqSliderIndex = minSlider;
+		result.maxFreqSliderIndex = maxSlider;
+
+		quint32 datasetCount = 0;
+		in >> datasetCount;
+		// Each dataset takes well over 8 bytes of metadata, so this bounds a corrupt count
+		if (in.status() != QDataStream::Ok || datasetCount > header.metadataSize / 8) {
+			return fail(QStringLiteral("Workspace metadata is corrupt"));
+		}
+		result.datasets.resize(int(datasetCount));
+		columnRefs.resize(int(datasetCount));
+		aliasMasks.fill(0, int(datasetCount));
+		for (quint32 i = 0; i < datasetCount; ++i) {
+			DatasetState& d = result.datasets[int(i)];
+			in >> d.filename >> d.displayName >> d.hasReferenceData >> d.isVisible
+				>> d.measuredColor >> d.referenceColor;
+			if (header.version >= 2) {
+				in >> aliasMasks[int(i)];
+			}
+			for (int c = 0; c < ColumnsPerDataset; ++c) {
+				if (aliasMasks[int(i)] & (1u << c)) continue;
+				in >> columnRefs[int(i)][c].offset >> columnRefs[int(i)][c].count;
+			}
+		}
+		if (in.status() != QDataStream::Ok) {
+			return fail(QStringLiteral("Workspace metadata is corrupt"));
+		}
+	}
+
+	// Copy the column blocks, checking every range against the file size
+	const quint64 dataSize = quint64(fileSize) - header.dataOffset;
+	const uchar* data = base + header.dataOffset;
+	for (int i = 0; i < result.datasets.size(); ++i) {
+		const auto columns = columnsOf(result.datasets[i]);
+		for (int c = 0; c < ColumnsPerDataset; ++c) {
+			if (aliasMasks[i] & (1u << c)) {
+				if (AliasOf[c] < 0) {
+					return fail(QStringLiteral("Workspace metadata is corrupt"));
+				}
+				*columns[c] = *columns[AliasOf[c]]; // Shared again, as when it was saved
+				continue;
+			}
+			const ColumnRef& ref = columnRefs[i][c];
+			if (ref.offset > dataSize || ref.count > (dataSize - ref.offset) / sizeof(double)) {
+				return fail(QStringLiteral("Workspace column data is truncated"));
+			}
+			columns[c]->resize(int(ref.count));
+			if (ref.count > 0) {
+				std::memcpy(columns[c]->data(), data + ref.offset, ref.count * sizeof(double));
+			}
+		}
+	}
+
+	*state = std::move(result);
+	return true;
+}
+
+} // namespace Workspace
@@ -0,0 +1,101 @@
+/***************************************************************************
+**                                                                        **
+**  Phase Noise Analyser                                                  **
+**  Copyright (C) 2025 Benjamin VERNOUX                                   **
+**                                                                        **
+**  This program is free software: you can redistribute it and/or modify  **
+**  it under the terms of the GNU General Public License as published by  **
+**  the Free Software Foundation, either version 3 of the License, or     **
+**  (at your option) any later version.                                   **
+**                                                                        **
+**  This program is distributed in the hope that it will be useful,       **
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of        **
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         **
+**  GNU General Public License for more details.                          **
+**                                                                        **
+**  You should have received a copy of the GNU General Public License     **
+**  along with this program.  If not, see http://www.gnu.org/licenses/.   **
+**                                                                        **
+****************************************************************************
+**           Author: Benjamin VERNOUX                                     **
+**          Contact: https://github.com/bvernoux                          **
+**             Date: 17 Oct 2026                                          **
+**          Version: 1.0.1.0                                              **
+****************************************************************************/
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <QColor>
+#include <QString>
+#include <QVector>
+
+/*
+ * Workspace snapshot: every loaded dataset with its parsed (and filtered)
+ * columns plus the processing and view state, so a session can be restored
+ * without re-reading any CSV.
+ *
+ * File layout (.pnaws):
+ *   Header (32 bytes)  magic "PNAWS\r\n\x1a", format version, byte-order mark,
+ *                      metadata size, offset of the column data
+ *   Metadata           QDataStream: settings, then per dataset the names, flags,
+ *                      colors, a mask of the filtered columns that share the raw
+ *                      ones (unfiltered data, version 2) and (offset, count) of
+ *                      every other column
+ *   Column data        raw native doubles, 8-byte aligned, one block per stored column
+ *
+ * Loading maps the file and copies the column blocks straight into the vectors.
+ */
+namespace Workspace {
+
+struct DatasetState {
+	QString filename;
+	QString displayName;
+	bool hasReferenceData = false;
+	bool isVisible = true;
+	QColor measuredColor;
+	QColor referenceColor;
+	QVector<double> frequencyOffset;
+	QVector<double> phaseNoise;
+	QVector<double> referenceNoise;
+	QVector<double> phaseNoiseFiltered;
+	QVector<double> referenceNoiseFiltered;
+};
+
+struct State {
+	QVector<DatasetState> datasets;
+	int activeDatasetIndex = -1;
+
+	// Processing
+	bool filteringEnabled = false;
+	QString filterType;
+	int filterWindow = 0;
+	bool spurRemovalEnabled = false;
+
+	// View
+	bool darkTheme = false;
+	bool showReference = true;
+	bool showSpotNoise = true;
+	bool showSpotNoiseTable = true;
+	bool showGrid = true;
+	QColor spotNoiseColor;
+	int minFreqSliderIndex = 0;
+	int maxFreqSliderIndex = 0;
+	double yMinSetting = 0.0; // Y range spin boxes
+	double yMaxSetting = 0.0;
+	double xViewMin = 0.0;    // Actual axis ranges (may differ after zoom/pan)
+	double xViewMax = 0.0;
+	double yViewMin = 0.0;
+	double yViewMax = 0.0;
+	QString outputFilename;
+};
+
+// Default snapshot written on exit and restored on startup
+QString autosavePath();
+
+bool save(const QString& path, const State& state, QString* errorString);
+bool load(const QString& path, State* state, QString* errorString);
+
+} // namespace Workspace
+
+#endif // WORKSPACE_H